@@ -739,6 +739,7 @@ if(onnxruntime_BUILD_BENCHMARKS)
   add_executable(onnxruntime_benchmark
     ${BENCHMARK_DIR}/main.cc
     ${BENCHMARK_DIR}/modeltest.cc
+    ${BENCHMARK_DIR}/model_ops.cc
     ${BENCHMARK_DIR}/pooling.cc
     ${BENCHMARK_DIR}/batchnorm.cc
     ${BENCHMARK_DIR}/batchnorm2.cc
@@ -746,7 +747,8 @@ if(onnxruntime_BUILD_BENCHMARKS)
     ${BENCHMARK_DIR}/eigen.cc
     ${BENCHMARK_DIR}/gelu.cc
     ${BENCHMARK_DIR}/activation.cc
-    ${BENCHMARK_DIR}/reduceminmax.cc)
+    ${BENCHMARK_DIR}/reduceminmax.cc
+    ${BENCHMARK_DIR}/tree_ensemble.cc)
   target_include_directories(onnxruntime_benchmark PRIVATE ${ONNXRUNTIME_ROOT} ${onnxruntime_graph_header} ${ONNXRUNTIME_ROOT}/core/mlas/inc)
   if(WIN32)
     target_compile_options(onnxruntime_benchmark PRIVATE "$<$<COMPILE_LANGUAGE:CUDA>:-Xcompiler /wd4141>"
@@ -13,6 +13,7 @@
 #include "core/framework/ml_value.h"
 #include "core/framework/op_kernel_info.h"
 #include "core/framework/op_node_proto_helper.h"
+#include "core/framework/prepacked_weights.h"
 #include "core/framework/tensor.h"
 #include "core/framework/sparse_tensor.h"
 #include "core/graph/constants.h"
@@ -51,25 +52,52 @@ class OpKernel {
 
   // Override this function to PrePack initialized constant tensor to the format as needed.
   // For example, MatMul kernel can pack the input B if it is constant like code below.
-  //   Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override {
+  //   Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc, bool& is_packed,
+  //                  PrePackedWeights* prepacked_weights) override {
   //     is_packed = false;
   //     if (input_idx == 1) {
-  //       this.Pack(tensor, this.buffer_);
+  //       this.Pack(tensor, alloc, this.buffer_);
   //       is_packed = true;
+  //       if (prepacked_weights != nullptr) {
+  //         prepacked_weights->buffers_.push_back(std::move(this.buffer_));
+  //         prepacked_weights->buffer_sizes_.push_back(this.buffer_size_);
+  //       }
   //     }
   //     return Status::OK();
   //   }
   // Please refer to MatMulIntegerToFloatBase for a complete example
-  // @param tesnor: The initialized constant tensor
+  // @param tensor: The initialized constant tensor
   // @param input_idx: The input index of the tensor in this kernel
+  // @param alloc: The allocator to allocate the packed buffers with
   // @param is_packed: Set it to true if the kernel packed the tensor or to false
   //                   The kernel is responsible keep the packed data and related metadata if is_packed is set to true
   //                   And the original intialized constant tensor will be released and not accessible anymore in Compute function.
-  virtual Status PrePack(const Tensor& /*tensor*/, int /*input_idx*/, bool& is_packed) {
+  // @param prepacked_weights: If not nullptr, the packed weights are shared with other kernel instances and the
+  //                   kernel must move the packed buffers into it. They are handed back to the kernel by a call to
+  //                   UseSharedPrePackedBuffers.
+  virtual Status PrePack(const Tensor& /*tensor*/, int /*input_idx*/, AllocatorPtr /*alloc*/,
+                         /*out*/ bool& is_packed, /*out*/ PrePackedWeights* /*prepacked_weights*/) {
     is_packed = false;
     return Status::OK();
   }
 
+  // Override this function to use the buffers of a tensor that was pre-packed by another kernel instance with the
+  // same op, attributes and execution provider, e.g. in another session that loaded the same model.
+  // The buffers are owned by the PrePackedWeightsContainer and their deleters must not free them.
+  // @param prepacked_buffers: The buffers the kernel moved into PrePackedWeights::buffers_ in PrePack
+  // @param prepacked_buffer_sizes: The sizes of the buffers, e.g. to check they were packed in the layout the kernel
+  //                   uses
+  // @param tensor: The initialized constant tensor, e.g. to set up the shape metadata kept alongside the packed data
+  // @param input_idx: The input index of the tensor in this kernel
+  // @param used_shared_buffers: Set it to true if the kernel uses the buffers. If false PrePack is called instead.
+  virtual Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                           const std::vector<size_t>& /*prepacked_buffer_sizes*/,
+                                           const Tensor& /*tensor*/, int /*input_idx*/,
+                                           /*out*/ bool& used_shared_buffers) {
+    used_shared_buffers = false;
+    return Status::OK();
+  }
+
   const OrtMemoryInfo& Allocator(int id, OrtMemType mem_type) const {
     return op_kernel_info_.GetMemoryInfo(id, mem_type);
   }
@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+// The buffers a kernel produced when pre-packing an initialized constant tensor.
+// Filled in by OpKernel::PrePack when the packed weights are going to be shared across sessions.
+struct PrePackedWeights final {
+  // Some kernels pack a weight into more than one buffer (e.g. one for each direction of an RNN).
+  std::vector<BufferUniquePtr> buffers_;
+  // Size in bytes of each buffer in buffers_.
+  std::vector<size_t> buffer_sizes_;
+};
+
+}  // namespace onnxruntime
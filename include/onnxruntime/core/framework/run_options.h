@@ -26,6 +26,17 @@ struct OrtRunOptions {
   // So it is possible that only some of the nodes are executed.
   bool only_execute_path_to_fetches = false;
 
+  // Set to 'true' to return memory that is not in use from the session's memory arenas to the devices
+  // once the Run() call completes.
+  bool shrink_memory_arenas = false;
+
+  // Set to 'true' to start profiling the session before the Run() call if it isn't being profiled, writing to a file
+  // with the session's profile_file_prefix.
+  bool start_profiling = false;
+
+  // Set to 'true' to end profiling the session and write the profile file once the Run() call completes.
+  bool end_profiling = false;
+
 #ifdef ENABLE_TRAINING
   // Set to 'true' to run in training mode.
   bool training_mode = true;
@@ -1051,10 +1051,13 @@ class Graph {
   virtual ~Graph();
 
 #if defined(ENABLE_ORT_FORMAT_LOAD)
+  // If can_use_flatbuffer_for_initializers is true, initializers reference the data in fbs_graph instead of copying
+  // it, so the flatbuffer must outlive the Graph.
   static common::Status LoadFromOrtFormat(
       const onnxruntime::experimental::fbs::Graph& fbs_graph, const Model& owning_model,
       const std::unordered_map<std::string, int>& domain_to_version,
-      const logging::Logger& logger, std::unique_ptr<Graph>& graph);
+      const logging::Logger& logger, bool can_use_flatbuffer_for_initializers,
+      std::unique_ptr<Graph>& graph);
 
   // deserialize a subgraph
   static Status LoadFromOrtFormat(const onnxruntime::experimental::fbs::Graph& fbs_graph,
@@ -1361,6 +1364,11 @@ class Graph {
 
   // distinguishes between graph loaded from model file and graph created from scratch
   const bool is_loaded_from_model_file_;
+
+#if defined(ENABLE_ORT_FORMAT_LOAD)
+  // initializers loaded from ORT format reference the flatbuffer data instead of a copy of it
+  bool can_use_flatbuffer_for_initializers_ = false;
+#endif
 };
 
 #if !defined(ORT_MINIMAL_BUILD)
@@ -122,6 +122,20 @@ class ThreadPool {
   // working in combination with the thread initiating the loop.
   static int DegreeOfParallelism(const concurrency::ThreadPool* tp);
 
+  // Limits the degree of parallelism returned by DegreeOfParallelism to the calling thread, and hence the number of
+  // threads the loops it starts are split across (including the OpenMP loops), while the object is alive. Used by
+  // the ParallelExecutor to share the intra-op threads between the nodes running concurrently. A limit <= 0 means no
+  // limit.
+  class ScopedParallelismLimit {
+   public:
+    explicit ScopedParallelismLimit(int max_degree_of_parallelism);
+    ~ScopedParallelismLimit();
+
+   private:
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ScopedParallelismLimit);
+    const int previous_limit_;
+  };
+
   // Directly schedule the 'total' tasks to the underlying threadpool, without
   // cutting them by halves
   void SimpleParallelFor(std::ptrdiff_t total, const std::function<void(std::ptrdiff_t)>& fn);
@@ -129,8 +143,7 @@ class ThreadPool {
   inline static void TrySimpleParallelFor(ThreadPool* tp, std::ptrdiff_t total,
                                           const std::function<void(std::ptrdiff_t)>& fn) {
 #ifdef _OPENMP
-    ORT_UNUSED_PARAMETER(tp);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(DegreeOfParallelism(tp))
     for (std::ptrdiff_t i = 0; i < total; ++i) {
       fn(i);
     }
@@ -159,9 +172,8 @@ class ThreadPool {
   template <typename F>
   inline static void TryBatchParallelFor(ThreadPool* tp, std::ptrdiff_t total, F&& fn, std::ptrdiff_t num_batches) {
 #ifdef _OPENMP
-    ORT_UNUSED_PARAMETER(tp);
     ORT_UNUSED_PARAMETER(num_batches);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(DegreeOfParallelism(tp))
     for (std::ptrdiff_t i = 0; i < total; ++i) {
       fn(i);
     }
@@ -192,6 +204,15 @@ class ThreadPool {
       return;
     }
 
+    if (tp->thread_options_.dynamic_block_base > 0) {
+      tp->ParallelForDynamicBlocks(total, num_batches, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; i++) {
+          fn(i);
+        }
+      });
+      return;
+    }
+
     tp->SimpleParallelFor(num_batches, [&](std::ptrdiff_t batch_index) {
       auto work = PartitionWork(batch_index, num_batches, total);
       for (std::ptrdiff_t i = work.start; i < work.end; i++) {
@@ -252,9 +273,15 @@ class ThreadPool {
   // When (i+1)*block_size > total, fn(i*block_size, total) is called instead.
   // Here, k = NumShardsUsedByFixedBlockSizeScheduling(total, block_size).
   // Requires 0 < block_size <= total.
+  // If max_work_items is greater than 0, no more than max_work_items threads take part in the loop.
   void ParallelForFixedBlockSizeScheduling(std::ptrdiff_t total, std::ptrdiff_t block_size,
-                                           const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn);
+                                           const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn,
+                                           std::ptrdiff_t max_work_items = 0);
 
+  // Runs the range [0, total) on up to num_batches threads, with the threads dynamically claiming blocks of
+  // about total / (num_batches * dynamic_block_base) iterations. See ThreadOptions::dynamic_block_base.
+  void ParallelForDynamicBlocks(std::ptrdiff_t total, std::ptrdiff_t num_batches,
+                                const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn);
 
   // Return whether or not the calling thread should run a loop of
   // num_iterations divided in chunks of block_size in parallel.  If not,
@@ -174,6 +174,7 @@ ORT_RUNTIME_CLASS(SequenceTypeInfo);
 ORT_RUNTIME_CLASS(ModelMetadata);
 ORT_RUNTIME_CLASS(ThreadPoolParams);
 ORT_RUNTIME_CLASS(ThreadingOptions);
+ORT_RUNTIME_CLASS(PrepackedWeightsContainer);
 
 #ifdef _WIN32
 typedef _Return_type_success_(return == 0) OrtStatus* OrtStatusPtr;
@@ -210,6 +211,14 @@ typedef void(ORT_API_CALL* OrtLoggingFunction)(
     void* param, OrtLoggingLevel severity, const char* category, const char* logid, const char* code_location,
     const char* message);
 
+// Invoked by OrtApi::RunAsync when the run completes.
+// On success status is nullptr and outputs holds num_outputs values in the order of the requested output names.
+// On failure status holds the error, outputs is nullptr and num_outputs is 0.
+// Ownership of status and of each output value is passed to the callback, which must release them with
+// OrtApi::ReleaseStatus and OrtApi::ReleaseValue. The outputs array itself is only valid during the call.
+typedef void(ORT_API_CALL* RunAsyncCallbackFn)(void* user_data, OrtValue** outputs, size_t num_outputs,
+                                               OrtStatusPtr status);
+
 // Set Graph optimization level.
 // Refer https://github.com/microsoft/onnxruntime/blob/master/docs/ONNX_Runtime_Graph_Optimizations.md
 // for in-depth undersrtanding of Graph Optimizations in ORT
@@ -1105,6 +1114,109 @@ struct OrtApi {
    * and that's recommended because turning this option on may hurt model accuracy.
    */
   ORT_API2_STATUS(SetGlobalDenormalAsZero, _Inout_ OrtThreadingOptions* tp_options);
+
+  /**
+   * Request that the memory arenas used by the session return all memory that isn't in use to the device
+   * when a Run call using these options completes. Use it after a request that needed an unusually large amount
+   * of memory so that it doesn't stay allocated for the lifetime of the session.
+   * \param shrink_arenas 1 to enable, 0 to disable (default)
+   */
+  ORT_API2_STATUS(RunOptionsSetShrinkArenas, _Inout_ OrtRunOptions* options, int shrink_arenas);
+
+  /**
+   * Return all memory held by the memory arenas of the session that isn't currently in use to the device.
+   * This may be called while Run calls on the session are in progress.
+   */
+  ORT_API2_STATUS(SessionShrinkArenas, _Inout_ OrtSession* sess);
+
+  /**
+   * Schedule a Run and return without waiting for it to complete. Output values are always allocated by the run.
+   * The run executes on one of the session's thread pools, so the session must be created with more than one
+   * intra-op thread (or with global thread pools). run_async_callback is invoked with user_data on the thread that
+   * executed the run. It may be invoked before RunAsync returns if the thread pool can't queue the run.
+   * Inputs are referenced, not copied, by the scheduled run and must not be modified until the callback is invoked.
+   * run_options, if given, must stay valid until the callback is invoked; OrtApi::RunOptionsSetTerminate can be
+   * used to cancel the run. The session waits for all scheduled runs when it is released, so it must not be
+   * released from within the callback.
+   */
+  ORT_API2_STATUS(RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                  _In_reads_(input_len) const char* const* input_names,
+                  _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  _In_ RunAsyncCallbackFn run_async_callback, _In_opt_ void* user_data);
+
+  /**
+   * Use this API to pin the threads of the global intra-op thread pool, see CreateEnvWithGlobalThreadPools, to
+   * logical processors.
+   * \param affinity One of
+   *   "none" to not pin the threads,
+   *   "physical" for one logical processor of each physical core the process may run on,
+   *   "numa:<n>" for all logical processors of NUMA node n,
+   *   "numa:<n>:physical" for one logical processor of each physical core of NUMA node n, or
+   *   a list of logical processor ids and ranges, e.g. "0,2,4-7".
+   * Each thread is pinned to one processor of the list. If the number of threads isn't set, the pool gets one
+   * thread per processor. "physical" and "numa" are only supported on Linux. A pool of one thread runs its work on
+   * the calling thread, which isn't pinned, so creating the environment fails if such a pool has an affinity.
+   */
+  ORT_API2_STATUS(SetGlobalIntraOpThreadAffinity, _Inout_ OrtThreadingOptions* tp_options, _In_ const char* affinity);
+
+  /**
+   * Use this API to pin the threads of the global inter-op thread pool to logical processors.
+   * See SetGlobalIntraOpThreadAffinity for the format of affinity.
+   */
+  ORT_API2_STATUS(SetGlobalInterOpThreadAffinity, _Inout_ OrtThreadingOptions* tp_options, _In_ const char* affinity);
+
+  /**
+   * Creates a container for the weights pre-packed by the kernels of sessions, e.g. the B matrix of a MatMul with
+   * a constant B. Sessions created with the same container share a single copy of the packed weights when their
+   * kernels pack identical initializers, which saves memory and initialization time when the same model is loaded
+   * by several sessions. The container must be released after all sessions using it.
+   */
+  ORT_API2_STATUS(CreatePrepackedWeightsContainer, _Outptr_ OrtPrepackedWeightsContainer** out);
+
+  ORT_CLASS_RELEASE(PrepackedWeightsContainer);
+
+  /**
+   * Same as CreateSession, but the pre-packed weights of the session are shared with all other sessions created
+   * with prepacked_weights_container.
+   */
+  ORT_API2_STATUS(CreateSessionWithPrepackedWeightsContainer, _In_ const OrtEnv* env, _In_ const ORTCHAR_T* model_path,
+                  _In_ const OrtSessionOptions* options,
+                  _Inout_ OrtPrepackedWeightsContainer* prepacked_weights_container, _Outptr_ OrtSession** out);
+
+  /**
+   * Same as CreateSessionFromArray, but the pre-packed weights of the session are shared with all other sessions
+   * created with prepacked_weights_container.
+   */
+  ORT_API2_STATUS(CreateSessionFromArrayWithPrepackedWeightsContainer, _In_ const OrtEnv* env,
+                  _In_ const void* model_data, size_t model_data_length, _In_ const OrtSessionOptions* options,
+                  _Inout_ OrtPrepackedWeightsContainer* prepacked_weights_container, _Outptr_ OrtSession** out);
+
+  /**
+   * Get the execution counters of the nodes of the session, enabled by setting the "session.enable_node_metrics"
+   * session config entry to "1": the number of calls, the total, shortest and longest kernel time and the total size of
+   * the outputs of each node and of each op type, in the Prometheus text exposition format. The counters are updated
+   * by every Run call and can be read while Run calls are in progress.
+   * \param allocator used to allocate the returned string
+   * \param out the metrics as a null terminated string
+   */
+  ORT_API2_STATUS(SessionGetNodeMetrics, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  /**
+   * Start and/or end profiling the session with the Run calls using these options, without recreating the session.
+   * \param start_profiling if non-zero, profiling starts before the run if the session isn't being profiled. The
+   * profile is written to a file with the profile file prefix of the session options.
+   * \param end_profiling if non-zero, profiling ends and the profile file is written once the run completes.
+   */
+  ORT_API2_STATUS(RunOptionsSetProfiling, _Inout_ OrtRunOptions* options, int start_profiling, int end_profiling);
+
+  /**
+   * Get whether the terminate flag of the options is set, e.g. to forward it to Run calls made on behalf of the caller
+   * with other options.
+   * \param out 1 if OrtApi::RunOptionsSetTerminate was called and not undone by OrtApi::RunOptionsUnsetTerminate, else 0
+   */
+  ORT_API2_STATUS(RunOptionsGetTerminate, _In_ const OrtRunOptions* options, _Out_ int* out);
 };
 
 /*
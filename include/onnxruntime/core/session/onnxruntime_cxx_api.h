@@ -98,6 +98,7 @@ ORT_DEFINE_RELEASE(Value);
 ORT_DEFINE_RELEASE(ModelMetadata);
 ORT_DEFINE_RELEASE(ThreadingOptions);
 ORT_DEFINE_RELEASE(IoBinding);
+ORT_DEFINE_RELEASE(PrepackedWeightsContainer);
 
 // This is used internally by the C++ API. This is the common base class used by the wrapper objects.
 template <typename T>
@@ -216,6 +217,11 @@ struct RunOptions : Base<OrtRunOptions> {
   RunOptions& SetTerminate();
   // unset the terminate flag so this RunOptions instance can be used in a new Session::Run call
   RunOptions& UnsetTerminate();
+  bool GetTerminate() const;
+
+  // return memory that isn't in use from the session's memory arenas to the devices when the Run call completes
+  RunOptions& SetShrinkArenas(bool shrink_arenas);
+  RunOptions& SetProfiling(bool start_profiling, bool end_profiling);
 };
 
 struct SessionOptions : Base<OrtSessionOptions> {
@@ -269,10 +275,21 @@ struct ModelMetadata : Base<OrtModelMetadata> {
   int64_t GetVersion() const;
 };
 
+// Shares the pre-packed weights of the sessions created with it. Must outlive these sessions.
+struct PrepackedWeightsContainer : Base<OrtPrepackedWeightsContainer> {
+  PrepackedWeightsContainer();
+  explicit PrepackedWeightsContainer(std::nullptr_t) {}
+  explicit PrepackedWeightsContainer(OrtPrepackedWeightsContainer* p) : Base<OrtPrepackedWeightsContainer>{p} {}
+};
+
 struct Session : Base<OrtSession> {
   explicit Session(std::nullptr_t) {}
   Session(Env& env, const ORTCHAR_T* model_path, const SessionOptions& options);
+  Session(Env& env, const ORTCHAR_T* model_path, const SessionOptions& options,
+          PrepackedWeightsContainer& prepacked_weights_container);
   Session(Env& env, const void* model_data, size_t model_data_length, const SessionOptions& options);
+  Session(Env& env, const void* model_data, size_t model_data_length, const SessionOptions& options,
+          PrepackedWeightsContainer& prepacked_weights_container);
 
   // Run that will allocate the output values
   std::vector<Value> Run(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
@@ -283,6 +300,11 @@ struct Session : Base<OrtSession> {
 
   void Run(const RunOptions& run_options, const struct IoBinding&);
 
+  // Schedule a Run on the session's thread pools and return without waiting for it. See OrtApi::RunAsync.
+  // run_options must stay valid until callback was invoked. callback takes ownership of the outputs and status.
+  void RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
+                const char* const* output_names, size_t output_count, RunAsyncCallbackFn callback, void* user_data);
+
   size_t GetInputCount() const;
   size_t GetOutputCount() const;
   size_t GetOverridableInitializerCount() const;
@@ -292,8 +314,13 @@ struct Session : Base<OrtSession> {
   char* GetOverridableInitializerName(size_t index, OrtAllocator* allocator) const;
   char* EndProfiling(OrtAllocator* allocator) const;
   uint64_t GetProfilingStartTimeNs() const;
+  // node execution counters in the Prometheus text format. requires session.enable_node_metrics to be set.
+  char* GetNodeMetrics(OrtAllocator* allocator) const;
   ModelMetadata GetModelMetadata() const;
 
+  // return memory that isn't in use from the session's memory arenas to the devices
+  void ShrinkArenas();
+
   TypeInfo GetInputTypeInfo(size_t index) const;
   TypeInfo GetOutputTypeInfo(size_t index) const;
   TypeInfo GetOverridableInitializerTypeInfo(size_t index) const;
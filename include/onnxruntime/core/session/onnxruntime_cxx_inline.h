@@ -387,6 +387,22 @@ inline RunOptions& RunOptions::UnsetTerminate() {
   return *this;
 }
 
+inline bool RunOptions::GetTerminate() const {
+  int out;
+  ThrowOnError(GetApi().RunOptionsGetTerminate(p_, &out));
+  return out != 0;
+}
+
+inline RunOptions& RunOptions::SetShrinkArenas(bool shrink_arenas) {
+  ThrowOnError(GetApi().RunOptionsSetShrinkArenas(p_, shrink_arenas ? 1 : 0));
+  return *this;
+}
+
+inline RunOptions& RunOptions::SetProfiling(bool start_profiling, bool end_profiling) {
+  ThrowOnError(GetApi().RunOptionsSetProfiling(p_, start_profiling ? 1 : 0, end_profiling ? 1 : 0));
+  return *this;
+}
+
 inline SessionOptions::SessionOptions() {
   ThrowOnError(GetApi().CreateSessionOptions(&p_));
 }
@@ -484,14 +500,30 @@ inline OrtStatus* SessionOptions::OrtSessionOptionsAppendExecutionProvider_CUDA(
 }
 #endif
 
+inline PrepackedWeightsContainer::PrepackedWeightsContainer() {
+  ThrowOnError(GetApi().CreatePrepackedWeightsContainer(&p_));
+}
+
 inline Session::Session(Env& env, const ORTCHAR_T* model_path, const SessionOptions& options) {
   ThrowOnError(GetApi().CreateSession(env, model_path, options, &p_));
 }
 
+inline Session::Session(Env& env, const ORTCHAR_T* model_path, const SessionOptions& options,
+                        PrepackedWeightsContainer& prepacked_weights_container) {
+  ThrowOnError(GetApi().CreateSessionWithPrepackedWeightsContainer(env, model_path, options,
+                                                                   prepacked_weights_container, &p_));
+}
+
 inline Session::Session(Env& env, const void* model_data, size_t model_data_length, const SessionOptions& options) {
   ThrowOnError(GetApi().CreateSessionFromArray(env, model_data, model_data_length, options, &p_));
 }
 
+inline Session::Session(Env& env, const void* model_data, size_t model_data_length, const SessionOptions& options,
+                        PrepackedWeightsContainer& prepacked_weights_container) {
+  ThrowOnError(GetApi().CreateSessionFromArrayWithPrepackedWeightsContainer(env, model_data, model_data_length, options,
+                                                                            prepacked_weights_container, &p_));
+}
+
 inline std::vector<Value> Session::Run(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
                                        const char* const* output_names, size_t output_names_count) {
   std::vector<Ort::Value> output_values;
@@ -513,6 +545,14 @@ inline void Session::Run(const RunOptions& run_options, const IoBinding& io_bind
   ThrowOnError(GetApi().RunWithBinding(p_, run_options, io_binding));
 }
 
+inline void Session::RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
+                              const char* const* output_names, size_t output_count, RunAsyncCallbackFn callback, void* user_data) {
+  static_assert(sizeof(Value) == sizeof(OrtValue*), "Value is really just an array of OrtValue* in memory, so we can reinterpret_cast safely");
+  auto ort_input_values = reinterpret_cast<const OrtValue**>(const_cast<Value*>(input_values));
+  ThrowOnError(GetApi().RunAsync(p_, run_options, input_names, ort_input_values, input_count, output_names, output_count,
+                                 callback, user_data));
+}
+
 inline size_t Session::GetInputCount() const {
   size_t out;
   ThrowOnError(GetApi().SessionGetInputCount(p_, &out));
@@ -561,12 +601,22 @@ inline uint64_t Session::GetProfilingStartTimeNs() const {
   return out;
 }
 
+inline char* Session::GetNodeMetrics(OrtAllocator* allocator) const {
+  char* out;
+  ThrowOnError(GetApi().SessionGetNodeMetrics(p_, allocator, &out));
+  return out;
+}
+
 inline ModelMetadata Session::GetModelMetadata() const {
   OrtModelMetadata* out;
   ThrowOnError(GetApi().SessionGetModelMetadata(p_, &out));
   return ModelMetadata{out};
 }
 
+inline void Session::ShrinkArenas() {
+  ThrowOnError(GetApi().SessionShrinkArenas(p_));
+}
+
 inline char* ModelMetadata::GetProducerName(OrtAllocator* allocator) const {
   char* out;
   ThrowOnError(GetApi().ModelMetadataGetProducerName(p_, allocator, &out));
@@ -40,3 +40,135 @@ static const char* const kOrtSessionOptionsConfigSaveModelFormat = "session.save
 // Note that an alternative way not using this option at runtime is to train and export a model without denormals
 // and that's recommended because turning this option on may hurt model accuracy.
 static const char* const kOrtSessionOptionsConfigSetDenormalAsZero = "session.set_denormal_as_zero";
+
+// Maximum number of bytes the CPU arena may keep in its thread cache of recently freed chunks.
+// The thread cache sits in front of the shared arena bins so that concurrent Run calls on the same session don't
+// serialize on the arena lock for small, repeated allocations. Chunks held by the cache count as in use.
+// The value is a non-negative integer. "0" disables the cache (default).
+static const char* const kOrtSessionOptionsConfigArenaThreadCacheMaxBytes = "session.arena_thread_cache_max_bytes";
+
+// Maximum number of bytes the CPU arena may keep allocated but unused.
+// When a region of the arena becomes completely free while more than this many bytes are not in use, the region is
+// returned to the system right away instead of being kept for future requests. See also OrtApi::SessionShrinkArenas
+// and OrtApi::RunOptionsSetShrinkArenas to release free regions on demand.
+// The value is a non-negative integer. "0" keeps all memory for the lifetime of the session (default).
+static const char* const kOrtSessionOptionsConfigArenaMaxIdleBytes = "session.arena_max_idle_bytes";
+
+// Maximum number of memory patterns (see SessionOptions.enable_mem_pattern) cached per session (and per subgraph).
+// When the cache is full the least recently used pattern is evicted.
+// The value is a non-negative integer. "0" means unbounded. The default is "128".
+static const char* const kOrtSessionOptionsConfigMemoryPatternCacheCapacity = "session.memory_pattern_cache_capacity";
+
+// Comma separated list of strictly ascending dimension sizes, e.g. "32,64,128,256,512".
+// Input dimensions are rounded up to the next bucket when looking up memory patterns, so a pattern traced for the
+// largest shape seen within a bucket is reused for all smaller shapes in the same bucket. Dimensions larger than the
+// last bucket are matched exactly. Not supported in training builds, where the setting is ignored.
+// The default is "" which disables bucketing, i.e. patterns are only reused for identical input shapes.
+static const char* const kOrtSessionOptionsConfigMemoryPatternDimBuckets = "session.memory_pattern_dim_buckets";
+
+// Number of blocks per thread that loops run with TryBatchParallelFor on the per-session intra-op thread pool are
+// split into. The threads claim the blocks dynamically and steal blocks from each other, which evens out the load when
+// some iterations or threads are slower than others, e.g. on machines with several NUMA nodes.
+// The value is a non-negative integer. "0" gives each thread one fixed range of iterations (default). "4" is a
+// reasonable value to try. Ignored when the session uses the global thread pools or ORT is built with OpenMP.
+static const char* const kOrtSessionOptionsConfigIntraOpDynamicBlockBase = "session.intra_op.dynamic_block_base";
+
+// Logical processors the threads of the per-session intra-op thread pool are pinned to, one processor per thread.
+// The value is one of
+//   "none"               don't pin the threads
+//   "physical"           one logical processor of each physical core the process may run on
+//   "numa:<n>"           all logical processors of NUMA node n
+//   "numa:<n>:physical"  one logical processor of each physical core of NUMA node n
+//   a list of logical processor ids and ranges, e.g. "0,2,4-7"
+// If the number of intra-op threads isn't set, the pool gets one thread per processor. A pool of one thread runs its
+// work on the calling thread, which isn't pinned, so creating the session fails if such a pool has an affinity.
+// "physical" and "numa" are only supported on Linux. The default is "", which pins the threads only if both the number of threads and the execution
+// mode are left at their defaults. See OrtApi::SetGlobalIntraOpThreadAffinity for the global thread pools.
+static const char* const kOrtSessionOptionsConfigIntraOpThreadAffinities = "session.intra_op_thread_affinities";
+
+// Logical processors the threads of the per-session inter-op thread pool are pinned to, see
+// kOrtSessionOptionsConfigIntraOpThreadAffinities for the format. The default is "", which doesn't pin the threads.
+static const char* const kOrtSessionOptionsConfigInterOpThreadAffinities = "session.inter_op_thread_affinities";
+
+// Element type that MatMul weights are pre-packed to for the MLAS SGEMM routines of the default CPU execution provider.
+// The weights are converted back to float one panel at a time while multiplying, so the activations and the
+// accumulation stay in float. Half precision formats halve the memory and bandwidth used by the weights at the cost
+// of precision.
+// The value is one of "float" (default), "float16" or "bfloat16".
+static const char* const kOrtSessionOptionsConfigCpuGemmPackedBFormat = "session.cpu_gemm_packed_b_format";
+
+// Algorithm the TreeEnsembleRegressor and TreeEnsembleClassifier kernels of the default CPU execution provider evaluate
+// the trees with.
+// "traversal": every row walks down every tree from the root to a leaf (default).
+// "quickscorer": the kernels build QuickScorer tables when they are created: the thresholds of all the nodes sorted by
+// feature, each with a bit mask of the leaves of its tree that can't be reached when the condition is false. Blocks of
+// rows are evaluated by and-ing the masks of the nodes whose condition is false into one bitvector per tree and row,
+// feature by feature, without any data dependent branch, and the leaf reached is the first bit left. It's usually
+// faster for batches of rows and trees of up to 64 leaves. The kernels fall back to the traversal for ensembles with
+// other conditions than BRANCH_LEQ, with missing value tracks, or with a tree of more than 64 leaves.
+static const char* const kOrtSessionOptionsConfigCpuTreeEnsembleEvaluation = "session.cpu_tree_ensemble_evaluation";
+
+// Set to "1" to return the scores ZipMap nodes turn into a sequence of maps as tensors. Every output of the model
+// produced by a ZipMap node becomes the tensor of scores of the ZipMap input, of type tensor(float) with one row per
+// input row and one column per label, and a new output with the name of the output and a "_labels" suffix is added
+// right after it, with the labels of the columns as a tensor(string) or tensor(int64). Building the maps allocates
+// a map node and often a key per row and label, which dominates the latency of classifiers with many classes.
+// "0": return sequences of maps as the model specifies (default).
+static const char* const kOrtSessionOptionsConfigZipMapOutputAsTensors = "session.zipmap_output_as_tensors";
+
+// Set to "1" to memory map ORT format model files instead of reading them into a buffer. The raw data of initializers
+// is then used in place as the data of the tensors of initializers deserialized to CPU, instead of being copied twice,
+// and processes loading the same model share the physical pages of the weights through the page cache.
+// The mapping is kept for the lifetime of the session. Doesn't apply to models loaded from a buffer. Initializers are
+// copied if an optimized model is saved, or if their data is not aligned, e.g. in a model saved by an older version.
+// "0": read the model into a buffer and copy the initializers (default).
+static const char* const kOrtSessionOptionsConfigUseMappedOrtModel = "session.use_mapped_ort_model";
+
+// Directory to cache the optimized ORT format models of ONNX models in. The first session that loads a model saves the
+// model after graph optimization, together with the serialized session state, to a file in the directory whose name
+// is a hash of the model, its external data, the ORT version, the session options, the execution providers and the
+// CPU features. Later sessions with the same key load the cached model instead of optimizing the model again.
+// The cache is only used for sessions that only use the CPU execution provider and don't register custom ops or
+// graph transformers. Set kOrtSessionOptionsConfigUseMappedOrtModel to memory map the cached model.
+// The default is "", which disables the cache.
+static const char* const kOrtSessionOptionsConfigOptimizedModelCacheDir = "session.optimized_model_cache_dir";
+
+// How nodes are assigned to execution providers.
+// "greedy": each execution provider in preference order takes all nodes it can run that aren't assigned yet (default).
+// "cost": the nodes are assigned to minimize the estimated cost of the graph, the sum of the compute cost of each node
+//         on its execution provider and the cost of transferring tensors between nodes on different execution
+//         providers. This avoids small islands of nodes on one execution provider surrounded by nodes on another.
+//         The chosen partition is logged at INFO level, and the assignment of each node at VERBOSE level.
+static const char* const kOrtSessionOptionsConfigGraphPartitioningMode = "session.graph_partitioning_mode";
+
+// Relative compute cost of a node on each execution provider for the "cost" partitioning mode, as a list of
+// "<execution provider type>:<cost>" entries separated by ';', e.g.
+// "DnnlExecutionProvider:0.25;CPUExecutionProvider:1". The last execution provider in preference order defaults to 1
+// and all others default to 0.5.
+static const char* const kOrtSessionOptionsConfigGraphPartitioningProviderCosts =
+    "session.graph_partitioning_provider_costs";
+
+// Cost of transferring one tensor element between nodes on different execution providers for the "cost" partitioning
+// mode, relative to the cost of one operation on the CPU execution provider. The default is "1".
+static const char* const kOrtSessionOptionsConfigGraphPartitioningTransferCost =
+    "session.graph_partitioning_transfer_cost";
+
+// Enable aggregated execution counters of each node and op type: the number of calls, the total, shortest and longest
+// kernel time and the total size of the outputs. The counters only add two clock reads and a few atomic additions
+// per node to each run, so they can be left enabled in production, and are read with SessionGetNodeMetrics.
+// "0": disabled (default). "1": enabled.
+static const char* const kOrtSessionOptionsConfigEnableNodeMetrics = "session.enable_node_metrics";
+
+// Profile only one in every N runs when profiling is enabled, to limit its overhead on a session serving production
+// traffic. The other runs record no events. The default is "1", profiling every run.
+static const char* const kOrtSessionOptionsConfigProfilingSamplingRate = "session.profiling_sampling_rate";
+
+// If set to a positive number of microseconds, only keep the events of profiled runs that take at least this long,
+// e.g. to capture the traces of slow requests. The events of each profiled run are buffered until it completes.
+// The default is "0", keeping the events of all profiled runs.
+static const char* const kOrtSessionOptionsConfigProfilingLatencyThresholdUs = "session.profiling_latency_threshold_us";
+
+// If set, the profiler keeps the most recent N events, discarding the oldest events once N events were recorded,
+// so that profiling a long running session has bounded memory usage. By default the profiler stops recording
+// events once the global maximum number of events is reached.
+static const char* const kOrtSessionOptionsConfigProfilingMaxEvents = "session.profiling_max_events";
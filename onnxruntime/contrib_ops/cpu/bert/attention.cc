@@ -22,7 +22,14 @@ class Attention : public OpKernel, public AttentionCPUBase {
 
   Status Compute(OpKernelContext* context) const override;
 #if !defined(USE_MKLML_FOR_BLAS)
-  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   const std::vector<size_t>& prepacked_buffer_sizes,
+                                   const Tensor& tensor, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
 #endif
 
  private:
@@ -48,19 +55,23 @@ AttentionBase::AttentionBase(const OpKernelInfo& info) {
   num_heads_ = static_cast<int>(num_heads);
 
   is_unidirectional_ = info.GetAttrOrDefault<int64_t>("unidirectional", 0) == 1;
+  past_present_share_buffer_ = info.GetAttrOrDefault<int64_t>("past_present_share_buffer", 0) == 1;
 }
 
 Status AttentionBase::CheckInputs(const TensorShape& input_shape,
                                   const TensorShape& weights_shape,
                                   const TensorShape& bias_shape,
                                   const Tensor*& mask_index,
-                                  const Tensor* past) const {
+                                  const Tensor* past,
+                                  const Tensor* past_seq_len) const {
   // Input shapes:
   //   input       : (batch_size, sequence_length, hidden_size)
   //   weights     : (hidden_size, 3 * hidden_size)
   //   bias        : (3 * hidden_size)
   //   mask_index  : nullptr, (batch_size), (2 * batch_size), (batch_size, 1), (1, 1) or (batch_size, past_sequence_length + sequence_length)
   //   past        : (2, batch_size, num_heads, past_sequence_length, head_size)
+  //                 or (2, batch_size, num_heads, max_sequence_length, head_size) if past_present_share_buffer_
+  //   past_seq_len: (1) if past_present_share_buffer_
 
   const auto& dims = input_shape.GetDims();
   if (dims.size() != 3) {
@@ -98,6 +109,11 @@ Status AttentionBase::CheckInputs(const TensorShape& input_shape,
                            "Input 'bias' dimension 0 should have same length as dimension 1 of input 'weights'");
   }
 
+  if (past_present_share_buffer_ && (past == nullptr || past_seq_len == nullptr)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Inputs 'past' and 'past_sequence_length' are required when past_present_share_buffer is 1");
+  }
+
   int past_sequence_length = 0;
   if (past != nullptr) {  // past is optional
     if (!is_unidirectional_) {
@@ -122,6 +138,19 @@ Status AttentionBase::CheckInputs(const TensorShape& input_shape,
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Inputs 'past' dimension 2 shall have length of ", hidden_size / num_heads_);
     }
     past_sequence_length = static_cast<int>(past_dims[3]);
+
+    if (past_present_share_buffer_) {
+      if (past_seq_len->Shape().Size() != 1) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'past_sequence_length' is expected to have 1 element");
+      }
+      const int max_sequence_length = past_sequence_length;
+      past_sequence_length = *past_seq_len->Data<int32_t>();
+      if (past_sequence_length < 0 || past_sequence_length + sequence_length > max_sequence_length) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'past_sequence_length' is ", past_sequence_length,
+                               ", the sum of it and the sequence length shall not exceed dimension 3 of 'past' ",
+                               max_sequence_length);
+      }
+    }
   }
 
   if (mask_index != nullptr) {  // mask_index is optional
@@ -153,13 +182,20 @@ Tensor* AttentionBase::GetPresent(OpKernelContext* context,
                                   int batch_size,
                                   int head_size,
                                   int sequence_length,
-                                  int& past_sequence_length) const {
+                                  int& past_sequence_length,
+                                  const Tensor* past_seq_len) const {
   // Input and output shapes:
   //   past        : (2, batch_size, num_heads, past_sequence_length, head_size)
   //   present     : (2, batch_size, num_heads, past_sequence_length + sequence_length, head_size)
+  // or if past_present_share_buffer_ (checked by CheckInputs):
+  //   past        : (2, batch_size, num_heads, max_sequence_length, head_size)
+  //   present     : (2, batch_size, num_heads, max_sequence_length, head_size)
 
   std::vector<int64_t> present_dims{2, batch_size, num_heads_, sequence_length, head_size};
-  if (nullptr != past) {
+  if (past_present_share_buffer_) {
+    past_sequence_length = *past_seq_len->Data<int32_t>();
+    present_dims = past->Shape().GetDims();
+  } else if (nullptr != past) {
     const auto& past_dims = past->Shape().GetDims();
     past_sequence_length = static_cast<int>(past_dims[3]);
     present_dims[3] += past_dims[3];
@@ -181,7 +217,9 @@ Attention<T>::Attention(const OpKernelInfo& info) : OpKernel(info), AttentionCPU
 #if !defined(USE_MKLML_FOR_BLAS)
 
 template <typename T>
-Status Attention<T>::PrePack(const Tensor& weights, int input_idx, bool& is_packed) {
+Status Attention<T>::PrePack(const Tensor& weights, int input_idx, AllocatorPtr alloc,
+                             /*out*/ bool& is_packed,
+                             /*out*/ PrePackedWeights* prepacked_weights) {
   is_packed = false;
 
   if (1 != input_idx) {
@@ -211,7 +249,6 @@ Status Attention<T>::PrePack(const Tensor& weights, int input_idx, bool& is_pack
   }
 
   const size_t loop_len = 3 * num_heads_;
-  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
   auto* packed_weights_data = static_cast<uint8_t*>(alloc->Alloc(packed_weights_size_ * loop_len));
   packed_weights_ = BufferUniquePtr(packed_weights_data, BufferDeleter(alloc));
 
@@ -222,6 +259,31 @@ Status Attention<T>::PrePack(const Tensor& weights, int input_idx, bool& is_pack
   }
 
   is_packed = true;
+
+  if (prepacked_weights != nullptr) {
+    prepacked_weights->buffers_.push_back(std::move(packed_weights_));
+    prepacked_weights->buffer_sizes_.push_back(packed_weights_size_ * loop_len);
+  }
+  return Status::OK();
+}
+
+template <typename T>
+Status Attention<T>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                               const std::vector<size_t>& /*prepacked_buffer_sizes*/,
+                                               const Tensor& weights, int input_idx,
+                                               /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (1 != input_idx) {
+    return Status::OK();
+  }
+
+  weight_shape_ = weights.Shape();
+  const size_t hidden_size = static_cast<size_t>(weight_shape_[0]);
+  packed_weights_size_ = MlasGemmPackBSize(hidden_size / num_heads_, hidden_size);
+  packed_weights_ = std::move(prepacked_buffers[0]);
+
+  used_shared_buffers = true;
   return Status::OK();
 }
 
@@ -234,12 +296,14 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
   const Tensor* bias = context->Input<Tensor>(2);
   const Tensor* mask_index = context->Input<Tensor>(3);
   const Tensor* past = context->Input<Tensor>(4);
+  const Tensor* past_seq_len = context->Input<Tensor>(5);
 
   ORT_RETURN_IF_ERROR(CheckInputs(input->Shape(),
                                   packed_weights_ ? weight_shape_ : weights->Shape(),
                                   bias->Shape(),
                                   mask_index,
-                                  past));
+                                  past,
+                                  past_seq_len));
 
   const auto& shape = input->Shape().GetDims();
   const int batch_size = static_cast<int>(shape[0]);
@@ -334,7 +398,7 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
   }
 
   // Compute the attention score and apply the score to V
-  return ApplyAttention(Q, K, V, mask_index, past, output,
+  return ApplyAttention(Q, K, V, mask_index, past, past_seq_len, output,
                         batch_size, sequence_length,
                         head_size, hidden_size, context);
 }
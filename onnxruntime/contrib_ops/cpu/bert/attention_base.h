@@ -17,17 +17,20 @@ class AttentionBase {
                      const TensorShape& weights_shape,
                      const TensorShape& bias_shape,
                      const Tensor*& mask_index,  // For dummy mask with shape (1, 1) or (batch_size, 1), it will be updated to nullptr.
-                     const Tensor* past) const;
+                     const Tensor* past,
+                     const Tensor* past_seq_len = nullptr) const;
 
   Tensor* GetPresent(OpKernelContext* context,
                      const Tensor* past,
                      int batch_size,
                      int head_size,
                      int sequence_length,
-                     int& past_sequence_length) const;
+                     int& past_sequence_length,
+                     const Tensor* past_seq_len = nullptr) const;
 
-  int num_heads_;           // number of attention heads
-  bool is_unidirectional_;  // whether every token can only attend to previous tokens.
+  int num_heads_;                   // number of attention heads
+  bool is_unidirectional_;          // whether every token can only attend to previous tokens.
+  bool past_present_share_buffer_;  // whether past and present have max_sequence_length positions and can share a buffer.
 };
 
 }  // namespace contrib
@@ -18,16 +18,17 @@ class AttentionCPUBase : public AttentionBase {
   AttentionCPUBase(const OpKernelInfo& info) : AttentionBase(info) {}
 
   template <typename T>
-  Status ApplyAttention(const T* Q,                // Q data. Its size is BxNxSxH
-                        const T* K,                // K data. Its size is BxNxSxH
-                        const T* V,                // V value with size BxNxSxH
-                        const Tensor* mask_index,  // mask index. nullptr if no mask or its size is B
-                        const Tensor* past,        // past state
-                        Tensor* output,            // output tensor
-                        int batch_size,            // batch size
-                        int sequence_length,       // sequence length
-                        int head_size,             // head size
-                        int hidden_size,           // hidden size
+  Status ApplyAttention(const T* Q,                  // Q data. Its size is BxNxSxH
+                        const T* K,                  // K data. Its size is BxNxSxH
+                        const T* V,                  // V value with size BxNxSxH
+                        const Tensor* mask_index,    // mask index. nullptr if no mask or its size is B
+                        const Tensor* past,          // past state
+                        const Tensor* past_seq_len,  // past sequence length. nullptr unless past_present_share_buffer_
+                        Tensor* output,              // output tensor
+                        int batch_size,              // batch size
+                        int sequence_length,         // sequence length
+                        int head_size,               // head size
+                        int hidden_size,             // hidden size
                         OpKernelContext* context) const {
     AllocatorPtr allocator;
     ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
@@ -35,11 +36,16 @@ class AttentionCPUBase : public AttentionBase {
     auto* tp = context->GetOperatorThreadPool();
 
     int past_sequence_length = 0;
-    Tensor* present = GetPresent(context, past, batch_size, head_size, sequence_length, past_sequence_length);
+    Tensor* present = GetPresent(context, past, batch_size, head_size, sequence_length, past_sequence_length,
+                                 past_seq_len);
 
     // Total sequence length including that of past state: S* = S' + S
     const int all_sequence_length = past_sequence_length + sequence_length;
 
+    // Number of positions of each batch and head in past and present
+    const int max_sequence_length = past_present_share_buffer_ ? static_cast<int>(past->Shape()[3])
+                                                               : all_sequence_length;
+
     // Compute the attention score. It does 2 things:
     //         I. attention_probs(B, N, S, S*) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, S*, H -> B, N, H, S*) +
     //                                           1 x mask_data(B, N, S, S*)
@@ -63,7 +69,7 @@ class AttentionCPUBase : public AttentionBase {
 
     ComputeAttentionProbs<T>(static_cast<T*>(attention_probs), Q, K,
                              mask_index_data, mask_index_dims, static_cast<T*>(mask_data),
-                             batch_size, sequence_length, past_sequence_length, head_size,
+                             batch_size, sequence_length, past_sequence_length, max_sequence_length, head_size,
                              past_data, present_data, tp);
 
     // Compute the attentionScore * Value. It does: out_tmp(B, N, S, H) = attention_probs(B, N, S, S*) x V(B, N, S*, H)
@@ -72,8 +78,8 @@ class AttentionCPUBase : public AttentionBase {
     BufferUniquePtr out_tmp_buffer(out_tmp_data, BufferDeleter(allocator));
 
     ComputeVxAttentionScore(output->template MutableData<T>(), static_cast<T*>(out_tmp_data), static_cast<T*>(attention_probs), V,
-                            batch_size, sequence_length, past_sequence_length, head_size, hidden_size,
-                            past_data, present_data, tp);
+                            batch_size, sequence_length, past_sequence_length, max_sequence_length, head_size,
+                            hidden_size, past_data, present_data, tp);
 
     return Status::OK();
   }
@@ -93,6 +99,7 @@ class AttentionCPUBase : public AttentionBase {
                              int batch_size,                               // batch size of self-attention
                              int sequence_length,                          // sequence length of self-attention
                              int past_sequence_length,                     // sequence length of past state
+                             int max_sequence_length,                      // sequence length of past and present buffers
                              int head_size,                                // head size of self-attention
                              const T* past,                                // past state
                              T* present,                                   // present state
@@ -101,6 +108,7 @@ class AttentionCPUBase : public AttentionBase {
     const size_t past_chunk_length = static_cast<size_t>(past_sequence_length * head_size);  // S' x H
     const size_t input_chunk_length = static_cast<size_t>(sequence_length * head_size);      // S x H
     const size_t present_chunk_length = past_chunk_length + input_chunk_length;              // S* x H
+    const size_t buffer_chunk_length = static_cast<size_t>(max_sequence_length * head_size);  // max_S x H
 
     {
       if (mask_data != nullptr) {
@@ -127,7 +135,10 @@ class AttentionCPUBase : public AttentionBase {
           }
 
           const T* k = K + input_chunk_length * i;
-          if (nullptr != present) {
+          if (past_present_share_buffer_) {
+            // append K to past_K : (BxNx)S'xH, (BxNx)SxH -> (BxNx)S*xH in a buffer with (BxNx)max_SxH
+            k = AppendStateChunk(past, k, present, past_chunk_length, input_chunk_length, buffer_chunk_length, i);
+          } else if (nullptr != present) {
             // concatenate past_K and K : (BxNx)S'xH, (BxNx)SxH -> (BxNx)S*xH
             k = ConcatStateChunk(past, k, present, past_chunk_length, present_chunk_length, i);
           }
@@ -160,6 +171,7 @@ class AttentionCPUBase : public AttentionBase {
                                int batch_size,            // batch size
                                int sequence_length,       // sequence length
                                int past_sequence_length,  // sequence length in past state
+                               int max_sequence_length,   // sequence length of past and present buffers
                                int head_size,             // head size
                                int hidden_size,           // hidden size
                                const T* past,             // past state
@@ -169,13 +181,15 @@ class AttentionCPUBase : public AttentionBase {
     const size_t past_chunk_length = static_cast<size_t>(past_sequence_length * head_size);  // S' x H
     const size_t input_chunk_length = static_cast<size_t>(sequence_length * head_size);      // S x H
     const size_t present_chunk_length = past_chunk_length + input_chunk_length;              // S* x H
+    const size_t buffer_chunk_length = static_cast<size_t>(max_sequence_length * head_size);  // max_S x H
 
     // Move the pointer of past and present to start of v values.
     if (nullptr != past) {
-      past += batch_size * num_heads_ * past_sequence_length * head_size;
+      past += batch_size * num_heads_ * (past_present_share_buffer_ ? max_sequence_length : past_sequence_length) *
+              head_size;
     }
     if (nullptr != present) {
-      present += batch_size * num_heads_ * all_sequence_length * head_size;
+      present += batch_size * num_heads_ * max_sequence_length * head_size;
     }
 
     const double cost =
@@ -184,7 +198,10 @@ class AttentionCPUBase : public AttentionBase {
     ThreadPool::TryParallelFor(tp, batch_size * num_heads_, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
       for (std::ptrdiff_t i = begin; i != end; ++i) {
         const T* v = V + input_chunk_length * i;
-        if (nullptr != present) {
+        if (past_present_share_buffer_) {
+          // append V to past_V: (BxNx)S'xH, (BxNx)SxH -> (BxNx)S*xH in a buffer with (BxNx)max_SxH
+          v = AppendStateChunk(past, v, present, past_chunk_length, input_chunk_length, buffer_chunk_length, i);
+        } else if (nullptr != present) {
           // concatenate past_V and V: (BxNx)S'xH, (BxNx)SxH -> (BxNx)S*xH
           v = ConcatStateChunk(past, v, present, past_chunk_length, present_chunk_length, i);
         }
@@ -140,5 +140,23 @@ T* ConcatStateChunk(const T* past, const T* chunk, T* present, size_t past_chunk
   return start;
 }
 
+// Append an input state chunk SxH to the past state chunk S'xH in a present state buffer chunk max_SxH.
+// When past and present are different buffers, the whole past chunk is copied first, so the positions after S* keep
+// their values from the past state. When they are the same buffer, only the input chunk is written.
+// Returns a pointer to the start of present state chunk.
+template <typename T>
+T* AppendStateChunk(const T* past, const T* chunk, T* present, size_t past_chunk_length, size_t input_chunk_length,
+                    size_t buffer_chunk_length, std::ptrdiff_t i) {
+  T* start = present + i * buffer_chunk_length;
+
+  const T* src_past = past + i * buffer_chunk_length;
+  if (src_past != start) {
+    memcpy(start, src_past, buffer_chunk_length * sizeof(T));
+  }
+
+  memcpy(start + past_chunk_length, chunk, input_chunk_length * sizeof(T));
+  return start;
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -24,7 +24,14 @@ class QAttention : public OpKernel, public AttentionCPUBase {
   Status Compute(OpKernelContext* context) const override;
 
 #ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
-  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   const std::vector<size_t>& prepacked_buffer_sizes,
+                                   const Tensor& tensor, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
 #endif
 
  private:
@@ -53,7 +60,9 @@ QAttention<T>::QAttention(const OpKernelInfo& info) : OpKernel(info), AttentionC
 
 #ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
 template <typename T>
-Status QAttention<T>::PrePack(const Tensor& weights, int input_idx, bool& is_packed) {
+Status QAttention<T>::PrePack(const Tensor& weights, int input_idx, AllocatorPtr alloc,
+                              /*out*/ bool& is_packed,
+                              /*out*/ PrePackedWeights* prepacked_weights) {
   is_packed = false;
 
   if (1 != input_idx) {
@@ -84,7 +93,6 @@ Status QAttention<T>::PrePack(const Tensor& weights, int input_idx, bool& is_pac
   }
 
   const size_t loop_len = 3 * num_heads_;
-  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
   auto* packed_weights_data = static_cast<uint8_t*>(alloc->Alloc(packed_weights_size_ * loop_len));
   packed_weights_ = BufferUniquePtr(packed_weights_data, BufferDeleter(alloc));
 
@@ -95,6 +103,32 @@ Status QAttention<T>::PrePack(const Tensor& weights, int input_idx, bool& is_pac
   }
 
   is_packed = true;
+
+  if (prepacked_weights != nullptr) {
+    prepacked_weights->buffers_.push_back(std::move(packed_weights_));
+    prepacked_weights->buffer_sizes_.push_back(packed_weights_size_ * loop_len);
+  }
+  return Status::OK();
+}
+
+template <typename T>
+Status QAttention<T>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                const std::vector<size_t>& /*prepacked_buffer_sizes*/,
+                                                const Tensor& weights, int input_idx,
+                                                /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (1 != input_idx) {
+    return Status::OK();
+  }
+
+  weight_shape_ = weights.Shape();
+  weights_is_signed_ = weights.IsDataType<int8_t>();
+  const size_t hidden_size = static_cast<size_t>(weight_shape_[0]);
+  packed_weights_size_ = MlasGemmPackBSize(hidden_size / num_heads_, hidden_size, weights_is_signed_);
+  packed_weights_ = std::move(prepacked_buffers[0]);
+
+  used_shared_buffers = true;
   return Status::OK();
 }
 #endif
@@ -245,7 +279,7 @@ Status QAttention<T>::Compute(OpKernelContext* context) const {
   }
 
   // Compute the attention score and apply the score to V
-  return ApplyAttention(Q, K, V, mask_index, past_tensor, output,
+  return ApplyAttention(Q, K, V, mask_index, past_tensor, nullptr, output,
                         batch_size, sequence_length,
                         head_size, hidden_size, context);
 }
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <locale>
+#include <sstream>
+#include <string>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+
+/**
+ * Tries to parse a value from an entire string using the classic ("C") locale.
+ * Leading or trailing characters that are not part of the value cause the parse to fail.
+ * @return Whether the parse was successful. value is only updated on success.
+ */
+template <typename T>
+bool TryParseStringWithClassicLocale(const std::string& str, T& value) {
+  std::istringstream is{str};
+  is.imbue(std::locale::classic());
+  T parsed_value{};
+
+  const bool parse_successful =
+      is >> parsed_value &&
+      is.get() == std::istringstream::traits_type::eof();  // don't allow trailing characters
+
+  if (parse_successful) {
+    value = parsed_value;
+  }
+
+  return parse_successful;
+}
+
+/**
+ * Parses a value from an entire string using the classic ("C") locale.
+ * @return Status::OK() on success, an error status otherwise.
+ */
+template <typename T>
+common::Status ParseStringWithClassicLocale(const std::string& str, T& value) {
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(str, value), "Failed to parse value: \"", str, "\"");
+  return common::Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -9,6 +9,51 @@ using namespace std::chrono;
 
 std::atomic<size_t> Profiler::global_max_num_events_{1000 * 1000};
 
+struct Profiler::RunContext {
+  Profiler* profiler;
+  bool profiled;
+  // events of the run are buffered in events until the run ends
+  bool buffered;
+  TimePoint start_time;
+  OrtMutex mutex;
+  std::vector<EventRecord> events;
+};
+
+// run executing on the current thread
+static thread_local Profiler::RunContext* current_run = nullptr;
+
+Profiler::RunScope::RunScope(Profiler& profiler) : previous_run_{current_run} {
+  const auto& options = profiler.sampling_options_;
+  owned_run_ = onnxruntime::make_unique<RunContext>();
+  owned_run_->profiler = &profiler;
+  owned_run_->profiled = options.sampling_rate <= 1 || profiler.num_runs_++ % options.sampling_rate == 0;
+  owned_run_->buffered = owned_run_->profiled && options.latency_threshold_us > 0 && profiler.enabled_;
+  if (owned_run_->buffered) {
+    owned_run_->start_time = std::chrono::high_resolution_clock::now();
+  }
+
+  current_run = owned_run_.get();
+}
+
+Profiler::RunScope::RunScope(RunContext* run) : previous_run_{current_run} {
+  current_run = run;
+}
+
+Profiler::RunScope::~RunScope() {
+  current_run = previous_run_;
+
+  if (owned_run_ && owned_run_->buffered &&
+      TimeDiffMicroSeconds(owned_run_->start_time) >= owned_run_->profiler->sampling_options_.latency_threshold_us) {
+    for (auto& event : owned_run_->events) {
+      owned_run_->profiler->StoreEvent(event);
+    }
+  }
+}
+
+Profiler::RunContext* Profiler::CurrentRun() {
+  return current_run;
+}
+
 #ifdef ENABLE_STATIC_PROFILER_INSTANCE
 Profiler* Profiler::instance_ = nullptr;
 
@@ -20,10 +65,29 @@ profiling::Profiler::~Profiler() {}
 #endif
 
 ::onnxruntime::TimePoint profiling::Profiler::StartTime() const {
-  ORT_ENFORCE(enabled_);
+  // not checking enabled_ as profiling may end while a run that started with profiling enabled is in progress
   return std::chrono::high_resolution_clock::now();
 }
 
+bool Profiler::IsEnabled() const {
+  if (!enabled_) {
+    return false;
+  }
+
+  const auto* run = current_run;
+  return run == nullptr || run->profiler != this || run->profiled;
+}
+
+void Profiler::SetSamplingOptions(const ProfilingSamplingOptions& options) {
+  sampling_options_ = options;
+}
+
+void Profiler::UseRingBuffer(size_t max_num_events) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  max_num_events_ = max_num_events;
+  use_ring_buffer_ = true;
+}
+
 void Profiler::Initialize(const logging::Logger* session_logger) {
   ORT_ENFORCE(session_logger != nullptr);
   session_logger_ = session_logger;
@@ -39,18 +103,36 @@ void Profiler::Initialize(const logging::Logger* session_logger) {
 
 void Profiler::StartProfiling(const logging::Logger* custom_logger) {
   ORT_ENFORCE(custom_logger != nullptr);
-  enabled_ = true;
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (enabled_) {
+    return;
+  }
+
   profile_with_logger_ = true;
   custom_logger_ = custom_logger;
   profiling_start_time_ = StartTime();
+  enabled_ = true;
 }
 
 template <typename T>
 void Profiler::StartProfiling(const std::basic_string<T>& file_name) {
-  enabled_ = true;
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (enabled_) {
+    if (session_logger_) {
+      LOGS(*session_logger_, WARNING) << "Profiling already started. Writing profiler data to file "
+                                      << profile_stream_file_;
+    }
+
+    return;
+  }
+
   profile_stream_.open(file_name, std::ios::out | std::ios::trunc);
   profile_stream_file_ = ToMBString(file_name);
+  events_.clear();
+  next_event_ = 0;
+  max_events_reached = false;
   profiling_start_time_ = StartTime();
+  enabled_ = true;
 }
 
 template void Profiler::StartProfiling<char>(const std::basic_string<char>& file_name);
@@ -68,29 +150,49 @@ void Profiler::EndTimeAndRecordEvent(EventCategory category,
 
   EventRecord event(category, logging::GetProcessId(),
                     logging::GetThreadId(), event_name, ts, dur, {event_args.begin(), event_args.end()});
+
+  auto* run = current_run;
+  if (run != nullptr && run->profiler == this && run->buffered) {
+    std::lock_guard<OrtMutex> lock(run->mutex);
+    run->events.push_back(std::move(event));
+    return;
+  }
+
+  //TODO: sync_gpu if needed.
+  StoreEvent(event);
+}
+
+void Profiler::StoreEvent(EventRecord& event) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (!enabled_) {
+    // profiling ended while the event was recorded
+    return;
+  }
+
   if (profile_with_logger_) {
     custom_logger_->SendProfileEvent(event);
+  } else if (events_.size() < max_num_events_) {
+    events_.push_back(std::move(event));
+  } else if (use_ring_buffer_ && max_num_events_ > 0) {
+    events_[next_event_] = std::move(event);
+    next_event_ = (next_event_ + 1) % max_num_events_;
   } else {
-    //TODO: sync_gpu if needed.
-    std::lock_guard<OrtMutex> lock(mutex_);
-    if (events_.size() < max_num_events_) {
-      events_.emplace_back(event);
-    } else {
-      if (session_logger_ && !max_events_reached) {
-        LOGS(*session_logger_, ERROR)
-            << "Maximum number of events reached, could not record profile event.";
-        max_events_reached = true;
-      }
+    if (session_logger_ && !max_events_reached) {
+      LOGS(*session_logger_, ERROR)
+          << "Maximum number of events reached, could not record profile event.";
+      max_events_reached = true;
     }
   }
 }
 
 std::string Profiler::EndProfiling() {
+  std::lock_guard<OrtMutex> lock(mutex_);
   if (!enabled_) {
     return std::string();
   }
   if (profile_with_logger_) {
     profile_with_logger_ = false;
+    enabled_ = false;
     return std::string();
   }
 
@@ -98,11 +200,11 @@ std::string Profiler::EndProfiling() {
     LOGS(*session_logger_, INFO) << "Writing profiler data to file " << profile_stream_file_;
   }
 
-  std::lock_guard<OrtMutex> lock(mutex_);
   profile_stream_ << "[\n";
 
   for (size_t i = 0; i < events_.size(); ++i) {
-    auto& rec = events_[i];
+    // the oldest event is at next_event_ if the ring buffer wrapped around
+    auto& rec = events_[(next_event_ + i) % events_.size()];
     profile_stream_ << R"({"cat" : ")" << event_categor_names_[rec.cat] << "\",";
     profile_stream_ << "\"pid\" :" << rec.pid << ",";
     profile_stream_ << "\"tid\" :" << rec.tid << ",";
@@ -126,6 +228,8 @@ std::string Profiler::EndProfiling() {
   }
   profile_stream_ << "]\n";
   profile_stream_.close();
+  events_.clear();
+  next_event_ = 0;
   enabled_ = false;  // will not collect profile after writing.
   return profile_stream_file_;
 }
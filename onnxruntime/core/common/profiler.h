@@ -7,6 +7,7 @@
 #include <fstream>
 #include <initializer_list>
 #include <iostream>
+#include <memory>
 #include <tuple>
 
 #include "core/common/logging/logging.h"
@@ -20,12 +21,48 @@ namespace profiling {
 // note that static profiler instance only works with single session
 //#define ENABLE_STATIC_PROFILER_INSTANCE
 
+/**
+ * Options to limit the overhead of profiling a session that serves production traffic.
+ */
+struct ProfilingSamplingOptions {
+  // profile one in every sampling_rate runs. the other runs record no events.
+  uint64_t sampling_rate = 1;
+  // if not 0, the events of a profiled run are buffered and only kept if the run took at least this long.
+  int64_t latency_threshold_us = 0;
+};
+
 /**
  * Main class for profiling. It continues to accumulate events and produce
  * a corresponding "complete event (X)" in "chrome tracing" format.
  */
 class Profiler {
  public:
+  // State of a Run call. Defined in profiler.cc.
+  struct RunContext;
+
+  /*
+  Marks the calling thread as executing a Run call for the lifetime of the scope. Whether the events of the run are
+  recorded is decided by the sampling options when the run starts.
+  */
+  class RunScope {
+   public:
+    // Starts a run of profiler on the calling thread.
+    explicit RunScope(Profiler& profiler);
+    // Continues a run started on another thread, e.g. when executing its nodes on a thread pool. Doesn't end the run.
+    // run may be nullptr.
+    explicit RunScope(RunContext* run);
+    ~RunScope();
+
+   private:
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunScope);
+
+    std::unique_ptr<RunContext> owned_run_;
+    RunContext* previous_run_;
+  };
+
+  // Returns the run executing on the calling thread, or nullptr.
+  static RunContext* CurrentRun();
+
   /// turned off by default.
   /// Even this function is marked as noexcept, the code inside it may throw exceptions
   Profiler() noexcept {};  //NOLINT
@@ -55,10 +92,20 @@ class Profiler {
 
   /*
   Whether data collection and output from this profiler is enabled.
+  Within a RunScope of this profiler, also whether the run is sampled.
   */
-  bool IsEnabled() const {
-    return enabled_;
-  }
+  bool IsEnabled() const;
+
+  /*
+  Sets the sampling options. Must be called before the first run.
+  */
+  void SetSamplingOptions(const ProfilingSamplingOptions& options);
+
+  /*
+  Keeps the max_num_events most recent events, overwriting the oldest events once the maximum is reached, instead of
+  no longer recording events. Must be called before profiling starts.
+  */
+  void UseRingBuffer(size_t max_num_events);
   /*
   Return the stored start time of profiler.
   On some platforms, this timer may not be as precise as nanoseconds
@@ -81,6 +128,7 @@ class Profiler {
   /*
   Write profile data to the given stream in chrome format defined below.
   https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview#
+  Profiling may be started again afterwards.
   */
   std::string EndProfiling();
 
@@ -118,9 +166,13 @@ class Profiler {
    */
   static std::atomic<size_t> global_max_num_events_;
 
+  // adds an event to events_ or sends it to the custom logger
+  void StoreEvent(EventRecord& event);
+
   // Mutex controlling access to profiler data
   OrtMutex mutex_;
-  bool enabled_{false};
+  // profiling may be started and ended while runs are in progress
+  std::atomic<bool> enabled_{false};
   std::ofstream profile_stream_;
   std::string profile_stream_file_;
   const logging::Logger* session_logger_{nullptr};
@@ -129,7 +181,13 @@ class Profiler {
   std::vector<EventRecord> events_;
   bool max_events_reached{false};
   bool profile_with_logger_{false};
-  const size_t max_num_events_{global_max_num_events_.load()};
+  size_t max_num_events_{global_max_num_events_.load()};
+  // if true, events_ is a ring buffer and next_event_ is the index of the oldest event once it is full
+  bool use_ring_buffer_{false};
+  size_t next_event_{0};
+
+  ProfilingSamplingOptions sampling_options_;
+  std::atomic<uint64_t> num_runs_{0};
 
 #ifdef ENABLE_STATIC_PROFILER_INSTANCE
   static Profiler* instance_;
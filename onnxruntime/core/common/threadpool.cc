@@ -50,8 +50,10 @@ class alignas(CACHE_LINE_BYTES) LoopCounter {
 public:
  LoopCounter(const ThreadPool& tp,
              uint64_t num_iterations,
-             uint64_t block_size = 1) : _tp(tp),
-                                        _block_size(block_size) {
+             uint64_t block_size = 1,
+             bool group_adjacent_threads = false) : _tp(tp),
+                                                    _block_size(block_size),
+                                                    _group_adjacent_threads(group_adjacent_threads) {
    assert(sizeof(LoopCounterShard) == 64);
    assert(block_size != 0);
 
@@ -79,14 +81,16 @@ public:
     assert(my_thread_idx >= 0 && my_thread_idx < d_of_p);
 
     int home_shard;
-    if (d_of_p >= NUM_SHARDS) {
+    if (d_of_p >= NUM_SHARDS && !_group_adjacent_threads) {
       // More threads than shards => allocate them home shards round-robin, aiming to sprace the load across
       // the shards
       home_shard = my_thread_idx % NUM_SHARDS;
     } else {
       // Fewer threads than shards => spread the threads evenly across the shards, so each will work
-      // on a run of successive shards before contention
-      home_shard = (my_thread_idx * NUM_SHARDS) / d_of_p;
+      // on a run of successive shards before contention.  When grouping adjacent threads, the same
+      // mapping is used with more threads than shards, so threads with adjacent ids share a home shard
+      // and move on to neighbouring shards once it is exhausted.
+      home_shard = static_cast<int>((static_cast<int64_t>(my_thread_idx) * NUM_SHARDS) / d_of_p);
     }
     assert(home_shard >= 0 && home_shard < NUM_SHARDS);
     return home_shard;
@@ -120,6 +124,7 @@ private:
   alignas(CACHE_LINE_BYTES) LoopCounterShard _shards[NUM_SHARDS];
   const ThreadPool& _tp;
   const uint64_t _block_size;
+  const bool _group_adjacent_threads;
 };
 
 #ifdef _MSC_VER
@@ -155,7 +160,8 @@ ThreadPool::~ThreadPool() = default;
 // range of indices to run.
 void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
                                                      const std::ptrdiff_t block_size,
-                                                     const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn) {
+                                                     const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn,
+                                                     const std::ptrdiff_t max_work_items) {
   if (total <= 0)
     return;
 
@@ -167,10 +173,16 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
   // Split the work across threads in the pool.  Each work item will run a loop claiming iterations,
   // hence we need at most one for each thread, even if the numberof blocks of iterations is larger.
   auto d_of_p = DegreeOfParallelism(this);
-  int num_work_items = static_cast<int>(std::min(static_cast<std::ptrdiff_t>(d_of_p), total));
+  std::ptrdiff_t max_parallelism = static_cast<std::ptrdiff_t>(d_of_p);
+  if (max_work_items > 0) {
+    max_parallelism = std::min(max_parallelism, max_work_items);
+  }
+  int num_work_items = static_cast<int>(std::min(max_parallelism, total));
   assert(num_work_items > 0);
 
-  LoopCounter lc(*this, total, block_size);
+  // Only loops limited to max_work_items (the dynamic blocks of TryBatchParallelFor) group adjacent threads
+  // on a home shard; other loops keep the round-robin allocation.
+  LoopCounter lc(*this, total, block_size, max_work_items > 0);
   std::function<void()> run_work = [&]() {
     int my_home_shard = lc.GetHomeShard();
     int my_shard = my_home_shard;
@@ -187,6 +199,22 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
   RunInParallel(run_work, num_work_items);
 }
 
+void ThreadPool::ParallelForDynamicBlocks(const std::ptrdiff_t total, const std::ptrdiff_t num_batches,
+                                          const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn) {
+  if (total <= 0)
+    return;
+
+  const std::ptrdiff_t num_blocks = num_batches * thread_options_.dynamic_block_base;
+  const std::ptrdiff_t block_size = std::max<std::ptrdiff_t>(1, total / num_blocks);
+  if (total <= block_size || !ShouldParallelizeLoop(total, block_size)) {
+    fn(0, total);
+    return;
+  }
+
+  // Limit the loop to num_batches threads as that is the parallelism the caller asked for.
+  ParallelForFixedBlockSizeScheduling(total, block_size, fn, num_batches);
+}
+
 void ThreadPool::SimpleParallelFor(std::ptrdiff_t total, const std::function<void(std::ptrdiff_t)>& fn) {
   ParallelForFixedBlockSizeScheduling(total, 1, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
     for (std::ptrdiff_t idx = first; idx < last; idx++) {
@@ -307,9 +335,11 @@ void ThreadPool::ParallelFor(std::ptrdiff_t n, const TensorOpCost& c,
                              const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& f) {
   ORT_ENFORCE(n >= 0);
   Eigen::TensorOpCost cost{c.bytes_loaded, c.bytes_stored, c.compute_cycles};
+  // The blocks are sized for, and the loop split across, no more threads than the limit set by
+  // ScopedParallelismLimit.
   auto d_of_p = DegreeOfParallelism(this);
-  // Compute small problems directly in the caller thread.
-  if ((!ShouldParallelizeLoop(n)) ||
+  // Compute small problems, and loops limited to one thread, directly in the caller thread.
+  if (d_of_p == 1 || (!ShouldParallelizeLoop(n)) ||
       CostModel::numThreads(static_cast<double>(n), cost, d_of_p) == 1) {
     f(0, n);
     return;
@@ -324,6 +354,9 @@ void ThreadPool::ParallelFor(std::ptrdiff_t total, double cost_per_unit,
   ParallelFor(total, TensorOpCost{0, 0, static_cast<double>(cost_per_unit)}, fn);
 }
 
+// Limit set by ScopedParallelismLimit for loops started by the current thread. <= 0 if there is no limit.
+static thread_local int thread_parallelism_limit = 0;
+
 int ThreadPool::DegreeOfParallelism(const concurrency::ThreadPool* tp) {
 #ifdef _OPENMP
   // When using OpenMP, omp_get_num_threads() returns the number of threads in the
@@ -331,12 +364,25 @@ int ThreadPool::DegreeOfParallelism(const concurrency::ThreadPool* tp) {
   // across the number of threads configured.  Otherwise, given that we do not
   // use nested parallelism, we do not parallelise further.
   ORT_UNUSED_PARAMETER(tp);
-  return (omp_get_num_threads() == 1) ? omp_get_max_threads() : 1;
+  int d_of_p = (omp_get_num_threads() == 1) ? omp_get_max_threads() : 1;
 #else
   // When not using OpenMP, we parallelise over the N threads created by the pool
   // tp, plus 1 for the thread entering a loop.
-  return tp ? (tp->NumThreads()+1) : 1;
+  int d_of_p = tp ? (tp->NumThreads() + 1) : 1;
 #endif
+  if (thread_parallelism_limit > 0 && thread_parallelism_limit < d_of_p) {
+    d_of_p = thread_parallelism_limit;
+  }
+  return d_of_p;
+}
+
+ThreadPool::ScopedParallelismLimit::ScopedParallelismLimit(int max_degree_of_parallelism)
+    : previous_limit_(thread_parallelism_limit) {
+  thread_parallelism_limit = max_degree_of_parallelism;
+}
+
+ThreadPool::ScopedParallelismLimit::~ScopedParallelismLimit() {
+  thread_parallelism_limit = previous_limit_;
 }
 
 // Return the number of threads created by the pool.
@@ -388,7 +434,7 @@ void ThreadPool::TryParallelFor(concurrency::ThreadPool* tp, std::ptrdiff_t tota
       return;
     }
 
-#pragma omp parallel for schedule(dynamic,1)
+#pragma omp parallel for schedule(dynamic,1) num_threads(static_cast<int>(num_threads))
     for (std::ptrdiff_t i = 0; i < block_count; i++) {
       const auto start = i * block_size;
       fn(start, std::min(start+block_size, total));
@@ -47,7 +47,9 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
                                            max_mem,
                                            arena_extend_str,
                                            initial_chunk_size_bytes,
-                                           max_dead_bytes_per_chunk));
+                                           max_dead_bytes_per_chunk,
+                                           info.arena_thread_cache_max_bytes,
+                                           info.arena_max_idle_bytes));
 #endif
   }
 
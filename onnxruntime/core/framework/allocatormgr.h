@@ -16,17 +16,25 @@ struct AllocatorCreationInfo {
   AllocatorCreationInfo(AllocatorFactory device_alloc_factory0,
                         OrtDevice::DeviceId device_id0 = 0,
                         bool use_arena0 = true,
-                        OrtArenaCfg arena_cfg0 = {0, -1, -1, -1})
+                        OrtArenaCfg arena_cfg0 = {0, -1, -1, -1},
+                        size_t arena_thread_cache_max_bytes0 = BFCArena::DEFAULT_THREAD_CACHE_MAX_BYTES,
+                        size_t arena_max_idle_bytes0 = BFCArena::DEFAULT_MAX_IDLE_BYTES)
       : device_alloc_factory(device_alloc_factory0),
         device_id(device_id0),
         use_arena(use_arena0),
-        arena_cfg(arena_cfg0) {
+        arena_cfg(arena_cfg0),
+        arena_thread_cache_max_bytes(arena_thread_cache_max_bytes0),
+        arena_max_idle_bytes(arena_max_idle_bytes0) {
   }
 
   AllocatorFactory device_alloc_factory;
   OrtDevice::DeviceId device_id;
   bool use_arena;
   OrtArenaCfg arena_cfg;
+  // Size of the thread cache in front of the BFCArena. 0 disables it.
+  size_t arena_thread_cache_max_bytes;
+  // Fully free arena regions are released while more than this many bytes are idle. 0 disables it.
+  size_t arena_max_idle_bytes;
 };
 
 // Returns an allocator based on the creation info provided.
@@ -27,6 +27,10 @@ class IArenaAllocator : public IAllocator {
   void Free(void* p) override = 0;
   virtual size_t Used() const = 0;
   virtual size_t Max() const = 0;
+  // Return memory that is not currently in use to the underlying device allocator.
+  // Arenas that can't release memory ignore the call.
+  // Shrink call need to be thread safe.
+  virtual Status Shrink() { return Status::OK(); }
   // allocate host pinned memory?
 };
 
@@ -43,6 +47,14 @@ struct AllocatorStats {
                                   // is known. Certain allocator may return 0 to indicate the limit is
                                   // unknown.
   int64_t bytes_limit;
+  int64_t num_arena_shrinkages;  // Number of memory regions returned to the device allocator.
+
+  // Thread cache statistics. Only populated by arenas that have a thread cache enabled.
+  // Bytes held by the thread cache are included in bytes_in_use.
+  int64_t num_thread_cache_hits;     // Allocations served from the thread cache.
+  int64_t num_thread_cache_misses;   // Cacheable allocations that had to go to the shared bins.
+  int64_t num_thread_cache_flushes;  // Batched returns of cached chunks to the shared bins.
+  int64_t bytes_in_thread_cache;     // Number of bytes currently held by the thread cache.
 
   AllocatorStats() { Clear(); }
 
@@ -53,6 +65,11 @@ struct AllocatorStats {
     this->max_alloc_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
+    this->num_arena_shrinkages = 0;
+    this->num_thread_cache_hits = 0;
+    this->num_thread_cache_misses = 0;
+    this->num_thread_cache_flushes = 0;
+    this->bytes_in_thread_cache = 0;
   }
 
   std::string DebugString() const {
@@ -62,7 +79,14 @@ struct AllocatorStats {
        << "TotalAllocated: " << this->total_allocated_bytes << "\n"
        << "MaxInUse:       " << this->max_bytes_in_use << "\n"
        << "NumAllocs:      " << this->num_allocs << "\n"
-       << "MaxAllocSize:   " << this->max_alloc_size << "\n";
+       << "MaxAllocSize:   " << this->max_alloc_size << "\n"
+       << "NumShrinkages:  " << this->num_arena_shrinkages << "\n";
+    if (this->num_thread_cache_hits != 0 || this->num_thread_cache_misses != 0) {
+      ss << "CacheHits:      " << this->num_thread_cache_hits << "\n"
+         << "CacheMisses:    " << this->num_thread_cache_misses << "\n"
+         << "CacheFlushes:   " << this->num_thread_cache_flushes << "\n"
+         << "CacheInUse:     " << this->bytes_in_thread_cache << "\n";
+    }
     return ss.str();
   }
 };
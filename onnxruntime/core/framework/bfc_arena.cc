@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/framework/bfc_arena.h"
+#include <thread>
 #include <type_traits>
 
 namespace onnxruntime {
@@ -9,7 +10,9 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
                    size_t total_memory,
                    ArenaExtendStrategy arena_extend_strategy,
                    int initial_chunk_size_bytes,
-                   int max_dead_bytes_per_chunk)
+                   int max_dead_bytes_per_chunk,
+                   size_t thread_cache_max_bytes,
+                   size_t max_idle_bytes)
     : IArenaAllocator(OrtMemoryInfo(resource_allocator->Info().name,
                                     OrtAllocatorType::OrtArenaAllocator,
                                     resource_allocator->Info().device,
@@ -19,12 +22,16 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       free_chunks_list_(kInvalidChunkHandle),
       next_allocation_id_(1),
       initial_chunk_size_bytes_(initial_chunk_size_bytes),
-      max_dead_bytes_per_chunk_(max_dead_bytes_per_chunk) {
+      max_dead_bytes_per_chunk_(max_dead_bytes_per_chunk),
+      max_idle_bytes_(max_idle_bytes),
+      thread_cache_max_bytes_(thread_cache_max_bytes) {
   LOGS_DEFAULT(INFO) << "Creating BFCArena for " << device_allocator_->Info().name
                      << " with following configs: initial_chunk_size_bytes: " << initial_chunk_size_bytes_
                      << " max_dead_bytes_per_chunk: " << max_dead_bytes_per_chunk_
                      << " memory limit: " << total_memory
-                     << " arena_extend_strategy " << static_cast<int32_t>(arena_extend_strategy);
+                     << " arena_extend_strategy " << static_cast<int32_t>(arena_extend_strategy)
+                     << " thread_cache_max_bytes " << thread_cache_max_bytes_
+                     << " max_idle_bytes " << max_idle_bytes_;
   // static_cast<std::underlying_type_t<ArenaExtendStrategy>>(arena_extend_strategy); doesn't work on this compiler
 
   curr_region_allocation_bytes_ = RoundedBytes(std::min(total_memory, static_cast<size_t>(initial_chunk_size_bytes_)));
@@ -50,6 +57,11 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       ORT_ENFORCE(BinForSize(bin_size * 2) != BinFromIndex(b));
     }
   }
+
+  if (thread_cache_max_bytes_ > 0) {
+    thread_cache_shards_.reset(new ThreadCacheShard[kNumThreadCacheShards]);
+    live_chunk_shards_.reset(new LiveChunkShard[kNumThreadCacheShards]);
+  }
 }
 
 BFCArena::~BFCArena() {
@@ -214,9 +226,142 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
+  if (thread_cache_max_bytes_ > 0 && size > 0 && size <= kMaxThreadCacheChunkSize) {
+    return AllocateThroughThreadCache(size);
+  }
+
   return AllocateRawInternal(size, false);
 }
 
+BFCArena::ThreadCacheShard& BFCArena::CurrentThreadCacheShard() {
+  static thread_local const size_t thread_hash = std::hash<std::thread::id>()(std::this_thread::get_id());
+  return thread_cache_shards_[thread_hash % kNumThreadCacheShards];
+}
+
+BFCArena::LiveChunkShard& BFCArena::LiveChunkShardFor(const void* p) {
+  // the low bits are always zero as chunks are kMinAllocationSize aligned
+  auto p_int = reinterpret_cast<std::uintptr_t>(p) >> kMinAllocationBits;
+  return live_chunk_shards_[p_int % kNumThreadCacheShards];
+}
+
+void* BFCArena::AllocateThroughThreadCache(size_t num_bytes) {
+  size_t rounded_bytes = RoundedBytes(num_bytes);
+  BinNum bin_num = BinNumForSize(rounded_bytes);
+
+  void* ptr = nullptr;
+  size_t chunk_size = 0;
+  {
+    ThreadCacheShard& shard = CurrentThreadCacheShard();
+    std::lock_guard<OrtMutex> lock(shard.mutex);
+    auto& cached = shard.bins[bin_num];
+    // prefer the most recently freed chunk as it is the most likely to still be in the CPU cache
+    for (auto it = cached.rbegin(); it != cached.rend(); ++it) {
+      if (it->size >= rounded_bytes) {
+        ptr = it->ptr;
+        chunk_size = it->size;
+        cached.erase(std::next(it).base());
+        shard.cached_bytes -= chunk_size;
+        break;
+      }
+    }
+  }
+
+  if (ptr != nullptr) {
+    ++thread_cache_hits_;
+    bytes_in_thread_cache_ -= static_cast<int64_t>(chunk_size);
+  } else {
+    ++thread_cache_misses_;
+    ptr = AllocateRawInternal(num_bytes, false, &chunk_size);
+  }
+
+  LiveChunkShard& live = LiveChunkShardFor(ptr);
+  std::lock_guard<OrtMutex> lock(live.mutex);
+  live.chunk_sizes[ptr] = chunk_size;
+  return ptr;
+}
+
+bool BFCArena::FreeToThreadCache(void* p) {
+  size_t chunk_size = 0;
+  {
+    LiveChunkShard& live = LiveChunkShardFor(p);
+    std::lock_guard<OrtMutex> lock(live.mutex);
+    auto it = live.chunk_sizes.find(p);
+    if (it == live.chunk_sizes.end()) {
+      return false;
+    }
+
+    chunk_size = it->second;
+    live.chunk_sizes.erase(it);
+  }
+
+  bytes_in_thread_cache_ += static_cast<int64_t>(chunk_size);
+
+  std::vector<CachedChunk> to_return;
+  {
+    ThreadCacheShard& shard = CurrentThreadCacheShard();
+    std::lock_guard<OrtMutex> lock(shard.mutex);
+    shard.bins[BinNumForSize(chunk_size)].push_back({p, chunk_size});
+    shard.cached_bytes += chunk_size;
+
+    const size_t shard_limit = thread_cache_max_bytes_ / kNumThreadCacheShards;
+    if (shard.cached_bytes > shard_limit) {
+      // Trim down to half of the limit so a steady stream of frees doesn't hit lock_ every time.
+      // Large chunks go first as they are the most expensive to keep around.
+      for (BinNum b = kNumBins - 1; b >= 0 && shard.cached_bytes > shard_limit / 2; --b) {
+        auto& cached = shard.bins[b];
+        size_t num_to_return = 0;
+        while (num_to_return < cached.size() && shard.cached_bytes > shard_limit / 2) {
+          shard.cached_bytes -= cached[num_to_return].size;
+          to_return.push_back(cached[num_to_return]);
+          ++num_to_return;
+        }
+        cached.erase(cached.begin(), cached.begin() + num_to_return);
+      }
+    }
+  }
+
+  if (!to_return.empty()) {
+    ReturnCachedChunksToBins(to_return);
+  }
+
+  return true;
+}
+
+void BFCArena::ReturnCachedChunksToBins(const std::vector<CachedChunk>& chunks) {
+  int64_t returned_bytes = 0;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    for (const auto& chunk : chunks) {
+      DeallocateRawInternal(chunk.ptr);
+      returned_bytes += static_cast<int64_t>(chunk.size);
+    }
+  }
+
+  bytes_in_thread_cache_ -= returned_bytes;
+  ++thread_cache_flushes_;
+}
+
+void BFCArena::FlushThreadCaches() {
+  if (thread_cache_max_bytes_ == 0) {
+    return;
+  }
+
+  std::vector<CachedChunk> to_return;
+  for (size_t i = 0; i < kNumThreadCacheShards; ++i) {
+    ThreadCacheShard& shard = thread_cache_shards_[i];
+    std::lock_guard<OrtMutex> lock(shard.mutex);
+    for (auto& cached : shard.bins) {
+      to_return.insert(to_return.end(), cached.begin(), cached.end());
+      cached.clear();
+    }
+    shard.cached_bytes = 0;
+  }
+
+  if (!to_return.empty()) {
+    ReturnCachedChunksToBins(to_return);
+  }
+}
+
 void* BFCArena::Reserve(size_t size) {
   if (size == 0)
     return nullptr;
@@ -250,7 +395,8 @@ size_t BFCArena::AllocatedSize(const void* ptr) {
 }
 
 void* BFCArena::AllocateRawInternal(size_t num_bytes,
-                                    bool dump_log_on_failure) {
+                                    bool dump_log_on_failure,
+                                    size_t* allocated_size) {
   if (num_bytes == 0) {
     LOGS_DEFAULT(VERBOSE) << "tried to allocate 0 bytes";
     return nullptr;
@@ -266,6 +412,9 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   std::lock_guard<OrtMutex> lock(lock_);
   void* ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
   if (ptr != nullptr) {
+    if (allocated_size != nullptr) {
+      *allocated_size = ChunkFromHandle(region_manager_.get_handle(ptr))->size;
+    }
     return ptr;
   }
 
@@ -277,6 +426,9 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   if (status.IsOK()) {
     ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
     if (ptr != nullptr) {
+      if (allocated_size != nullptr) {
+        *allocated_size = ChunkFromHandle(region_manager_.get_handle(ptr))->size;
+      }
       return ptr;
     } else {
       status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
@@ -300,6 +452,10 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
 void BFCArena::GetStats(AllocatorStats* stats) {
   std::lock_guard<OrtMutex> lock(lock_);
   *stats = stats_;
+  stats->num_thread_cache_hits = thread_cache_hits_;
+  stats->num_thread_cache_misses = thread_cache_misses_;
+  stats->num_thread_cache_flushes = thread_cache_flushes_;
+  stats->bytes_in_thread_cache = bytes_in_thread_cache_;
 }
 
 void* BFCArena::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
@@ -387,6 +543,11 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+
+  if (thread_cache_max_bytes_ > 0 && FreeToThreadCache(p)) {
+    return;
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
@@ -474,6 +635,52 @@ void BFCArena::RemoveFreeChunkFromBin(BFCArena::ChunkHandle h) {
   c->bin_num = kInvalidBinNum;
 }
 
+void BFCArena::ReleaseRegion(BFCArena::ChunkHandle h) {
+  Chunk* c = ChunkFromHandle(h);
+  ORT_ENFORCE(!c->in_use() && (c->bin_num == kInvalidBinNum));
+  ORT_ENFORCE(c->prev == kInvalidChunkHandle && c->next == kInvalidChunkHandle,
+              "Chunk does not span the entire region");
+
+  void* region_ptr = c->ptr;
+  size_t region_size = c->size;
+  DeleteChunk(h);
+  region_manager_.RemoveAllocationRegion(region_ptr);
+  device_allocator_->Free(region_ptr);
+
+  stats_.total_allocated_bytes -= static_cast<int64_t>(region_size);
+  ++stats_.num_arena_shrinkages;
+
+  LOGS_DEFAULT(INFO) << "Released region of " << region_size << " bytes at " << region_ptr
+                     << ". Total allocated bytes: " << stats_.total_allocated_bytes;
+}
+
+Status BFCArena::Shrink() {
+  FlushThreadCaches();
+
+  std::lock_guard<OrtMutex> lock(lock_);
+
+  // chunks are always coalesced on free so a region with nothing in use consists of a single free chunk
+  std::vector<ChunkHandle> free_regions;
+  for (const auto& region : region_manager_.regions()) {
+    ChunkHandle h = region_manager_.get_handle(region.ptr());
+    const Chunk* c = ChunkFromHandle(h);
+    if (!c->in_use() && c->next == kInvalidChunkHandle) {
+      free_regions.push_back(h);
+    }
+  }
+
+  for (ChunkHandle h : free_regions) {
+    RemoveFreeChunkFromBin(h);
+    ReleaseRegion(h);
+  }
+
+  // start growing from the initial size again so a single large request doesn't dictate the size of all
+  // future regions
+  curr_region_allocation_bytes_ = RoundedBytes(std::min(memory_limit_, static_cast<size_t>(initial_chunk_size_bytes_)));
+
+  return Status::OK();
+}
+
 void BFCArena::FreeAndMaybeCoalesce(BFCArena::ChunkHandle h) {
   Chunk* c = ChunkFromHandle(h);
   ORT_ENFORCE(c->in_use() && (c->bin_num == kInvalidBinNum));
@@ -519,6 +726,16 @@ void BFCArena::FreeAndMaybeCoalesce(BFCArena::ChunkHandle h) {
     }
   }
 
+  // If the whole region is free and the arena is holding on to more idle memory than allowed, give it back.
+  if (max_idle_bytes_ > 0) {
+    c = ChunkFromHandle(chunk_to_reassign);
+    if (c->prev == kInvalidChunkHandle && c->next == kInvalidChunkHandle &&
+        static_cast<size_t>(stats_.total_allocated_bytes - stats_.bytes_in_use) > max_idle_bytes_) {
+      ReleaseRegion(chunk_to_reassign);
+      return;
+    }
+  }
+
   InsertFreeChunkIntoBin(chunk_to_reassign);
 }
 
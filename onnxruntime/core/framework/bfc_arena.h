@@ -16,9 +16,12 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
@@ -58,12 +61,23 @@ class BFCArena : public IArenaAllocator {
   static const int DEFAULT_INITIAL_CHUNK_SIZE_BYTES = 1048576;
   static const int DEFAULT_MAX_DEAD_BYTES_PER_CHUNK = 128 * 1024 * 1024;
   static const size_t DEFAULT_MAX_MEM = std::numeric_limits<size_t>::max();
-
+  // 0 disables the thread cache
+  static const size_t DEFAULT_THREAD_CACHE_MAX_BYTES = 0;
+  // 0 disables automatic release of free regions
+  static const size_t DEFAULT_MAX_IDLE_BYTES = 0;
+
+  // thread_cache_max_bytes: if non-zero, recently freed chunks of up to kMaxThreadCacheChunkSize bytes are kept in a
+  // cache sharded by calling thread, so that concurrent Alloc/Free calls don't all serialize on the arena lock.
+  // The value is the upper bound of bytes held by the cache across all shards.
+  // max_idle_bytes: if non-zero, a region that becomes completely free is returned to the device allocator
+  // right away as long as more than max_idle_bytes of the arena are not in use.
   BFCArena(std::unique_ptr<IAllocator> resource_allocator,
            size_t total_memory,
            ArenaExtendStrategy arena_extend_strategy = DEFAULT_ARENA_EXTEND_STRATEGY,
            int initial_chunk_size_bytes = DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
-           int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK);
+           int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+           size_t thread_cache_max_bytes = DEFAULT_THREAD_CACHE_MAX_BYTES,
+           size_t max_idle_bytes = DEFAULT_MAX_IDLE_BYTES);
 
   ~BFCArena() override;
 
@@ -77,6 +91,10 @@ class BFCArena : public IArenaAllocator {
 
   void* Reserve(size_t size) override;
 
+  // Returns every region that has no chunk in use to the device allocator and resets the size of the next
+  // region allocation to the initial chunk size. Chunks held by the thread cache are returned to the bins first.
+  Status Shrink() override;
+
   size_t Used() const override {
     return static_cast<size_t>(stats_.bytes_in_use);
   }
@@ -96,8 +114,12 @@ class BFCArena : public IArenaAllocator {
 
   size_t AllocatedSize(const void* ptr);
 
+  // Returns all chunks held by the thread cache to the shared bins.
+  void FlushThreadCaches();
+
  private:
-  void* AllocateRawInternal(size_t num_bytes, bool dump_log_on_failure);
+  // If allocated_size is not null it is set to the size of the chunk backing the returned pointer.
+  void* AllocateRawInternal(size_t num_bytes, bool dump_log_on_failure, size_t* allocated_size = nullptr);
   void DeallocateRawInternal(void* ptr);
 
   // A ChunkHandle is an index into the chunks_ vector in BFCAllocator
@@ -282,6 +304,13 @@ class BFCArena : public IArenaAllocator {
       regions_.insert(entry, AllocationRegion(ptr, memory_size));
     }
 
+    void RemoveAllocationRegion(void* ptr) {
+      auto entry =
+          std::upper_bound(regions_.begin(), regions_.end(), ptr, &Comparator);
+      ORT_ENFORCE(entry != regions_.end() && entry->ptr() == ptr, "Could not find Region for ", ptr);
+      regions_.erase(entry);
+    }
+
     ChunkHandle get_handle(const void* p) const {
       return RegionFor(p)->get_handle(p);
     }
@@ -346,6 +375,10 @@ class BFCArena : public IArenaAllocator {
   // Adds the chunk 'h' to the proper free bin.
   void InsertFreeChunkIntoBin(ChunkHandle h);
 
+  // Returns the region whose only chunk is the free chunk 'h' to the device allocator.
+  // 'h' must not be in a bin.
+  void ReleaseRegion(ChunkHandle h);
+
   // Removes the free chunk pointed to by 'c' from the set free_chunks.
   void RemoveFreeChunkIterFromBin(Bin::FreeChunkSet* free_chunks,
                                   const Bin::FreeChunkSet::iterator& c);
@@ -428,6 +461,44 @@ class BFCArena : public IArenaAllocator {
 
   Bin* BinForSize(size_t bytes) { return BinFromIndex(BinNumForSize(bytes)); }
 
+  // Thread cache.
+  //
+  // A chunk handed out through the thread cache stays marked as in use in the bins while it sits in the cache,
+  // so the cache can hand it out again without touching lock_. Live chunks are tracked in a table sharded by
+  // address because a buffer is frequently freed on a different thread than the one that allocated it.
+  // When a cache shard grows past its share of thread_cache_max_bytes_ the oldest entries are returned to the
+  // bins in a single batch under lock_.
+  static const size_t kNumThreadCacheShards = 16;
+  static const size_t kMaxThreadCacheChunkSize = 1 << 20;
+
+  struct CachedChunk {
+    void* ptr;
+    size_t size;
+  };
+
+  struct ThreadCacheShard {
+    OrtMutex mutex;
+    // Indexed by BinNumForSize(size). Oldest entries first.
+    std::vector<CachedChunk> bins[kNumBins];
+    size_t cached_bytes = 0;
+  };
+
+  struct LiveChunkShard {
+    OrtMutex mutex;
+    std::unordered_map<const void*, size_t> chunk_sizes;
+  };
+
+  void* AllocateThroughThreadCache(size_t num_bytes);
+
+  // Returns false if p was not handed out by the thread cache.
+  bool FreeToThreadCache(void* p);
+
+  // Takes lock_.
+  void ReturnCachedChunksToBins(const std::vector<CachedChunk>& chunks);
+
+  ThreadCacheShard& CurrentThreadCacheShard();
+  LiveChunkShard& LiveChunkShardFor(const void* p);
+
   char bins_space_[sizeof(Bin) * kNumBins];
 
   // The size of the current region allocation.
@@ -452,6 +523,16 @@ class BFCArena : public IArenaAllocator {
 
   const int initial_chunk_size_bytes_;
   const int max_dead_bytes_per_chunk_;
+  const size_t max_idle_bytes_;
+
+  const size_t thread_cache_max_bytes_;
+  std::unique_ptr<ThreadCacheShard[]> thread_cache_shards_;
+  std::unique_ptr<LiveChunkShard[]> live_chunk_shards_;
+
+  std::atomic<int64_t> thread_cache_hits_{0};
+  std::atomic<int64_t> thread_cache_misses_{0};
+  std::atomic<int64_t> thread_cache_flushes_{0};
+  std::atomic<int64_t> bytes_in_thread_cache_{0};
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BFCArena);
 };
@@ -10,6 +10,11 @@
 #include "core/framework/execution_providers.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/func_kernel.h"
+#include "core/framework/node_cost_model.h"
+#include "core/common/logging/logging.h"
+
+#include <algorithm>
+#include <sstream>
 
 // uncomment this line to count non-CUDA ops in ONNX domain
 //#define COUNT_NON_CUDA_OPS
@@ -105,6 +110,321 @@ static Node* PlaceNode(Graph& graph, std::unique_ptr<IndexedSubGraph> capability
   return nullptr;
 }
 
+namespace {
+
+// Chooses the capabilities to assign to minimize the estimated cost of the graph: the sum of the compute cost of
+// each node on its execution provider and the transfer cost of each edge between nodes on different providers.
+//
+// The search starts from the greedy assignment in preference order and then repeatedly applies the change that
+// lowers the cost the most, until no change does. A change either assigns the nodes of one capability to its provider,
+// or moves the nodes of a fused capability back to their fallback provider, the last provider that can run each
+// node by itself. Fused capabilities are all-or-nothing and are never split.
+// Edges from one producer to several consumers on the same other provider are each counted, so the transfer cost is
+// an upper bound of the copies that are inserted.
+class CostBasedCapabilitySelector {
+ public:
+  CostBasedCapabilitySelector(const GraphViewer& graph_viewer, const ExecutionProviders& providers,
+                              const CostBasedPartitioningOptions& options)
+      : graph_viewer_(graph_viewer), options_(options) {
+    const size_t num_providers = providers.NumProviders();
+    size_t provider_idx = 0;
+    for (const auto& provider : providers) {
+      double cost = 1.;
+      auto entry = options.provider_costs.find(provider->Type());
+      if (entry != options.provider_costs.cend()) {
+        cost = entry->second;
+      } else if (provider_idx + 1 < num_providers) {
+        cost = CostBasedPartitioningOptions::kDefaultAcceleratorCost;
+      }
+
+      provider_types_.push_back(provider->Type());
+      provider_costs_.push_back(cost);
+      ++provider_idx;
+    }
+
+    const auto num_node_indexes = static_cast<size_t>(graph_viewer.MaxNodeIndex());
+    node_costs_.resize(num_node_indexes, 0.);
+    assignment_.resize(num_node_indexes, Assignment{kUnassigned, kUnassigned});
+    fallback_units_.resize(num_node_indexes, -1);
+    for (const auto& node : graph_viewer.Nodes()) {
+      node_costs_[node.Index()] = NodeCostModel::EstimateNodeCost(node);
+
+      // nodes assigned in a previous pass keep their provider
+      auto entry = std::find(provider_types_.cbegin(), provider_types_.cend(), node.GetExecutionProviderType());
+      if (entry != provider_types_.cend()) {
+        assignment_[node.Index()] = Assignment{static_cast<int>(entry - provider_types_.cbegin()), kFixedUnit};
+      }
+    }
+  }
+
+  // Adds the capabilities of the provider at provider_idx in preference order.
+  void AddCapabilities(size_t provider_idx, std::vector<std::unique_ptr<ComputeCapability>>& capabilities) {
+    for (auto& capability : capabilities) {
+      const auto* sub_graph = capability->sub_graph.get();
+      if (sub_graph == nullptr || sub_graph->nodes.empty()) {
+        continue;
+      }
+
+      Unit unit;
+      unit.provider = static_cast<int>(provider_idx);
+      unit.fused = sub_graph->GetMetaDef() != nullptr;
+      unit.nodes = sub_graph->nodes;
+      unit.capability = std::move(capability);
+      units_.push_back(std::move(unit));
+
+      const int unit_idx = static_cast<int>(units_.size() - 1);
+      if (!units_.back().fused) {
+        // the last provider that can run the node by itself is the fallback
+        fallback_units_[units_.back().nodes[0]] = unit_idx;
+      }
+    }
+  }
+
+  // Selects the capabilities to assign and returns them by provider index.
+  std::vector<std::vector<std::unique_ptr<ComputeCapability>>> Select() {
+    // greedy assignment in preference order
+    for (size_t unit_idx = 0; unit_idx < units_.size(); ++unit_idx) {
+      const auto& unit = units_[unit_idx];
+      if (std::all_of(unit.nodes.cbegin(), unit.nodes.cend(),
+                      [this](NodeIndex node_index) { return assignment_[node_index].unit == kUnassigned; })) {
+        Activate(static_cast<int>(unit_idx));
+      }
+    }
+
+    greedy_cost_ = TotalCost();
+
+    // apply each change that lowers the cost until a pass over all capabilities finds none
+    constexpr int kMaxPasses = 16;
+    std::vector<std::pair<NodeIndex, int>> changes;
+    for (int pass = 0; pass < kMaxPasses; ++pass) {
+      bool improved = false;
+      for (size_t unit_idx = 0; unit_idx < units_.size(); ++unit_idx) {
+        const int idx = static_cast<int>(unit_idx);
+        const bool is_active = IsActive(idx);
+        changes.clear();
+        if (is_active ? !units_[idx].fused || !GetFallbackChanges(idx, changes)
+                      : !GetActivationChanges(idx, changes)) {
+          continue;
+        }
+
+        if (CostDelta(changes) < -kMinImprovement) {
+          if (is_active) {
+            Deactivate(idx);
+          } else {
+            Activate(idx);
+          }
+
+          improved = true;
+        }
+      }
+
+      if (!improved) {
+        break;
+      }
+    }
+
+    std::vector<std::vector<std::unique_ptr<ComputeCapability>>> selected(provider_types_.size());
+    for (size_t unit_idx = 0; unit_idx < units_.size(); ++unit_idx) {
+      if (IsActive(static_cast<int>(unit_idx))) {
+        auto& unit = units_[unit_idx];
+        selected[unit.provider].push_back(std::move(unit.capability));
+      }
+    }
+
+    return selected;
+  }
+
+  // Logs the chosen partition. The assignment of each node is logged at verbose level.
+  void Dump(const logging::Logger& logger) const {
+    std::vector<size_t> provider_node_counts(provider_types_.size(), 0);
+    size_t num_cut_edges = 0;
+    for (const auto& node : graph_viewer_.Nodes()) {
+      const int provider = assignment_[node.Index()].provider;
+      if (provider >= 0) {
+        ++provider_node_counts[provider];
+      }
+
+      for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+        if (assignment_[it->GetNode().Index()].provider != provider) {
+          ++num_cut_edges;
+        }
+      }
+
+      VLOGS(logger, 1) << "Partition of graph " << graph_viewer_.Name() << ": node " << node.Name() << " ("
+                       << node.OpType() << ") estimated cost " << node_costs_[node.Index()] << " assigned to "
+                       << (provider >= 0 ? provider_types_[provider] : std::string("<none>"));
+    }
+
+    std::ostringstream ss;
+    ss << "Cost based partition of graph " << graph_viewer_.Name() << ": estimated cost " << TotalCost()
+       << " (greedy partition " << greedy_cost_ << "), " << num_cut_edges << " edges between providers.";
+    for (size_t i = 0; i < provider_types_.size(); ++i) {
+      ss << " " << provider_types_[i] << ": " << provider_node_counts[i] << " nodes.";
+    }
+
+    LOGS(logger, INFO) << ss.str();
+  }
+
+ private:
+  static constexpr int kUnassigned = -1;
+  // assigned before partitioning started
+  static constexpr int kFixedUnit = -2;
+  static constexpr double kMinImprovement = 1e-6;
+
+  struct Assignment {
+    int provider;
+    int unit;
+  };
+
+  struct Unit {
+    int provider;
+    bool fused;
+    std::vector<NodeIndex> nodes;
+    std::unique_ptr<ComputeCapability> capability;
+  };
+
+  bool IsActive(int unit_idx) const {
+    return assignment_[units_[unit_idx].nodes[0]].unit == unit_idx;
+  }
+
+  // changes to assign the nodes of the unit to its provider. false if the unit can't be assigned.
+  bool GetActivationChanges(int unit_idx, std::vector<std::pair<NodeIndex, int>>& changes) const {
+    const auto& unit = units_[unit_idx];
+    for (auto node_index : unit.nodes) {
+      const auto& assignment = assignment_[node_index];
+      if (assignment.unit == kFixedUnit || (assignment.unit >= 0 && units_[assignment.unit].fused)) {
+        return false;
+      }
+
+      changes.emplace_back(node_index, unit.provider);
+    }
+
+    return true;
+  }
+
+  // changes to move the nodes of a fused unit to their fallback providers. false if a node has no fallback.
+  bool GetFallbackChanges(int unit_idx, std::vector<std::pair<NodeIndex, int>>& changes) const {
+    for (auto node_index : units_[unit_idx].nodes) {
+      const int fallback_unit = fallback_units_[node_index];
+      if (fallback_unit < 0) {
+        return false;
+      }
+
+      changes.emplace_back(node_index, units_[fallback_unit].provider);
+    }
+
+    return true;
+  }
+
+  void Activate(int unit_idx) {
+    const auto& unit = units_[unit_idx];
+    for (auto node_index : unit.nodes) {
+      assignment_[node_index] = Assignment{unit.provider, unit_idx};
+    }
+  }
+
+  void Deactivate(int unit_idx) {
+    for (auto node_index : units_[unit_idx].nodes) {
+      Activate(fallback_units_[node_index]);
+    }
+  }
+
+  double ComputeCost(NodeIndex node_index, int provider) const {
+    return provider >= 0 ? node_costs_[node_index] * provider_costs_[provider] : 0.;
+  }
+
+  // edge is an output edge end of the producer, or an input edge end of the consumer. both refer to the output of the
+  // producer with GetSrcArgIndex.
+  double TransferCost(const Node& producer, const Node::EdgeEnd& edge, int producer_provider,
+                      int consumer_provider) const {
+    if (producer_provider == consumer_provider || producer_provider < 0 || consumer_provider < 0) {
+      return 0.;
+    }
+
+    double num_elements = 1.;
+    const auto* shape = producer.OutputDefs()[edge.GetSrcArgIndex()]->Shape();
+    if (shape != nullptr) {
+      for (const auto& dim : shape->dim()) {
+        num_elements *= dim.has_dim_value() && dim.dim_value() > 0 ? static_cast<double>(dim.dim_value()) : 1.;
+      }
+    }
+
+    return num_elements * options_.transfer_cost;
+  }
+
+  double TotalCost() const {
+    double cost = 0.;
+    for (const auto& node : graph_viewer_.Nodes()) {
+      const int provider = assignment_[node.Index()].provider;
+      cost += ComputeCost(node.Index(), provider);
+      for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+        cost += TransferCost(node, *it, provider, assignment_[it->GetNode().Index()].provider);
+      }
+    }
+
+    return cost;
+  }
+
+  // change of the total cost if the nodes in changes are moved to the given providers
+  double CostDelta(const std::vector<std::pair<NodeIndex, int>>& changes) {
+    for (const auto& change : changes) {
+      new_providers_[change.first] = change.second;
+    }
+
+    const auto new_provider = [this](NodeIndex node_index) {
+      auto entry = new_providers_.find(node_index);
+      return entry != new_providers_.cend() ? entry->second : assignment_[node_index].provider;
+    };
+
+    double delta = 0.;
+    for (const auto& change : changes) {
+      const NodeIndex node_index = change.first;
+      const int old_provider = assignment_[node_index].provider;
+      delta += ComputeCost(node_index, change.second) - ComputeCost(node_index, old_provider);
+
+      const Node& node = *graph_viewer_.GetNode(node_index);
+      for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+        const NodeIndex consumer = it->GetNode().Index();
+        delta += TransferCost(node, *it, change.second, new_provider(consumer)) -
+                 TransferCost(node, *it, old_provider, assignment_[consumer].provider);
+      }
+
+      // input edge ends refer to the producer and its output index
+      for (auto it = node.InputEdgesBegin(), end = node.InputEdgesEnd(); it != end; ++it) {
+        const Node& producer = it->GetNode();
+        if (new_providers_.count(producer.Index()) != 0) {
+          continue;  // counted as an output edge of the producer
+        }
+
+        const int producer_provider = assignment_[producer.Index()].provider;
+        delta += TransferCost(producer, *it, producer_provider, change.second) -
+                 TransferCost(producer, *it, producer_provider, old_provider);
+      }
+    }
+
+    new_providers_.clear();
+    return delta;
+  }
+
+  const GraphViewer& graph_viewer_;
+  const CostBasedPartitioningOptions& options_;
+
+  std::vector<std::string> provider_types_;
+  std::vector<double> provider_costs_;
+
+  std::vector<Unit> units_;
+  // by node index
+  std::vector<double> node_costs_;
+  std::vector<Assignment> assignment_;
+  std::vector<int> fallback_units_;
+
+  double greedy_cost_ = 0.;
+  // scratch space of CostDelta
+  std::unordered_map<NodeIndex, int> new_providers_;
+};
+
+}  // namespace
+
 Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& func_mgr) const {
   // It is a greedy partitioning algorithm per provider preferences user provided when calling ONNX RUNTIME right now.
   // 1. Execution providers' capabilities are checked one by one.
@@ -148,11 +468,31 @@ Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& f
   // TODO: when the graph contain a function node, and user pass in the dll which could
   // run the function by SessionOption, we should create a function kernel for it and
   // delegate the compute to the functions inside the dlls.
+
+  // in cost based mode the capabilities of all providers are gathered up front from the unmodified graph, and only
+  // the chosen ones are placed below
+  std::vector<std::vector<std::unique_ptr<ComputeCapability>>> selected_capabilities;
+  if (cost_based_) {
+    CostBasedCapabilitySelector selector(graph_viewer, providers_, cost_options_);
+    size_t provider_idx = 0;
+    for (auto& provider : providers_) {
+      auto capabilities = provider->GetCapability(
+          graph_viewer, kernel_registry_mgr_.GetKernelRegistriesByProviderType(provider->Type()));
+      selector.AddCapabilities(provider_idx++, capabilities);
+    }
+
+    selected_capabilities = selector.Select();
+    selector.Dump(*logger_);
+  }
+
+  size_t provider_idx = 0;
   for (auto& provider : providers_) {
     int count = 0;
     std::vector<Node*> nodes_need_compile;
     std::vector<std::unique_ptr<ComputeCapability>> capabilities =
-        provider->GetCapability(graph_viewer, kernel_registry_mgr_.GetKernelRegistriesByProviderType(provider->Type()));
+        cost_based_ ? std::move(selected_capabilities[provider_idx++])
+                    : provider->GetCapability(graph_viewer,
+                                              kernel_registry_mgr_.GetKernelRegistriesByProviderType(provider->Type()));
     for (auto& capability : capabilities) {
       Node* n = PlaceNode(graph, std::move(capability->sub_graph), kernel_registry_mgr_, provider->Type(), count);
       if (n != nullptr) {
@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <string>
+#include <unordered_map>
+
 #include "core/common/common.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/op_kernel.h"
@@ -13,6 +16,23 @@ namespace onnxruntime {
 class ExecutionProviders;
 class KernelRegistryManager;
 
+namespace logging {
+class Logger;
+}
+
+// Options of the cost based partitioning mode, see kOrtSessionOptionsConfigGraphPartitioningMode.
+// Costs are in units of the estimated number of operations of a node on the CPU execution provider.
+struct CostBasedPartitioningOptions {
+  // Relative cost of an operation on each execution provider, by provider type. The last provider in preference
+  // order defaults to 1 and all others default to kDefaultAcceleratorCost.
+  std::unordered_map<std::string, double> provider_costs;
+
+  // Cost per element of a tensor produced by a node on one execution provider and consumed by a node on another.
+  double transfer_cost = 1.;
+
+  static constexpr double kDefaultAcceleratorCost = 0.5;
+};
+
 class GraphPartitioner {
  public:
   //The order of providers represents the user preference.
@@ -20,6 +40,16 @@ class GraphPartitioner {
       : kernel_registry_mgr_(kernel_registry_mgr),
         providers_(providers) {}
 
+  // Chooses the capabilities to assign by minimizing the estimated compute and transfer cost of the graph instead of
+  // assigning them greedily in preference order. The chosen partition is logged to logger.
+  GraphPartitioner(KernelRegistryManager& kernel_registry_mgr, const ExecutionProviders& providers,
+                   const CostBasedPartitioningOptions& cost_options, const logging::Logger& logger)
+      : kernel_registry_mgr_(kernel_registry_mgr),
+        providers_(providers),
+        cost_based_(true),
+        cost_options_(cost_options),
+        logger_(&logger) {}
+
   Status Partition(Graph& graph, bool export_dll, FuncManager& func_mgr) const;
 
  private:
@@ -27,5 +57,9 @@ class GraphPartitioner {
 
   KernelRegistryManager& kernel_registry_mgr_;
   const ExecutionProviders& providers_;
+
+  bool cost_based_ = false;
+  CostBasedPartitioningOptions cost_options_;
+  const logging::Logger* logger_ = nullptr;
 };
 }  // namespace onnxruntime
@@ -0,0 +1,124 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "core/common/parse_string.h"
+
+namespace onnxruntime {
+
+Status MemoryPatternCache::ParseDimBuckets(const std::string& str, std::vector<int64_t>& dim_buckets) {
+  dim_buckets.clear();
+  if (str.empty()) {
+    return Status::OK();
+  }
+
+  std::istringstream is{str};
+  std::string token;
+  while (std::getline(is, token, ',')) {
+    int64_t bucket = 0;
+    if (!TryParseStringWithClassicLocale(token, bucket) || bucket <= 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid memory pattern dimension bucket '", token,
+                             "' in '", str, "'. Buckets must be positive integers.");
+    }
+
+    if (!dim_buckets.empty() && bucket <= dim_buckets.back()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Memory pattern dimension buckets must be strictly ",
+                             "ascending. Got '", str, "'");
+    }
+
+    dim_buckets.push_back(bucket);
+  }
+
+  return Status::OK();
+}
+
+int64_t MemoryPatternCache::BucketDim(int64_t dim) const {
+  auto it = std::lower_bound(dim_buckets_.cbegin(), dim_buckets_.cend(), dim);
+  return it == dim_buckets_.cend() ? dim : *it;
+}
+
+void MemoryPatternCache::MakeKey(const InputShapes& input_shapes,
+                                 std::vector<int64_t>& key, std::vector<int64_t>& dims) const {
+  for (const auto& shape : input_shapes) {
+    const auto& shape_dims = shape.get().GetDims();
+    key.push_back(static_cast<int64_t>(shape_dims.size()));
+    for (auto dim : shape_dims) {
+      key.push_back(BucketDim(dim));
+      dims.push_back(dim);
+    }
+  }
+}
+
+std::shared_ptr<const MemoryPatternGroup> MemoryPatternCache::Find(
+    const InputShapes& input_shapes, std::unordered_map<int, TensorShape>& inferred_shapes) const {
+  std::vector<int64_t> key;
+  std::vector<int64_t> dims;
+  MakeKey(input_shapes, key, dims);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it == index_.cend()) {
+    return nullptr;
+  }
+
+  const Entry& entry = *it->second;
+  // same key so same number of dims
+  for (size_t i = 0, end = dims.size(); i < end; ++i) {
+    if (dims[i] > entry.traced_dims[i]) {
+      return nullptr;
+    }
+  }
+
+  entries_.splice(entries_.begin(), entries_, it->second);
+  inferred_shapes = entry.inferred_shapes;
+  return entry.patterns;
+}
+
+void MemoryPatternCache::Insert(const InputShapes& input_shapes, std::unique_ptr<MemoryPatternGroup> patterns,
+                                std::unordered_map<int, TensorShape> inferred_shapes) {
+  std::vector<int64_t> key;
+  std::vector<int64_t> dims;
+  MakeKey(input_shapes, key, dims);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    Entry& entry = *it->second;
+    bool covers_new_shapes = true;
+    for (size_t i = 0, end = dims.size(); i < end; ++i) {
+      if (dims[i] > entry.traced_dims[i]) {
+        covers_new_shapes = false;
+        break;
+      }
+    }
+
+    if (!covers_new_shapes) {
+      entry.traced_dims = std::move(dims);
+      entry.patterns = std::move(patterns);
+      entry.inferred_shapes = std::move(inferred_shapes);
+    }
+
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return;
+  }
+
+  entries_.push_front(Entry{key, std::move(dims), std::move(patterns), std::move(inferred_shapes)});
+  index_.emplace(std::move(key), entries_.begin());
+
+  // frames that are still using an evicted entry keep it alive through their shared_ptr
+  while (capacity_ != 0 && entries_.size() > capacity_) {
+    index_.erase(entries_.back().key);
+    entries_.pop_back();
+  }
+}
+
+size_t MemoryPatternCache::Size() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return entries_.size();
+}
+
+}  // namespace onnxruntime
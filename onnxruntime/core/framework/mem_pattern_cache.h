@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/tensor_shape.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// Thread-safe, bounded LRU cache of MemoryPatternGroup instances keyed by the shapes of the graph inputs.
+//
+// Optionally dimensions are rounded up to a configured set of bucket sizes before they are used as the key, so that
+// e.g. all sequence lengths between 100 and 128 share a single entry. A pattern is only handed out for input shapes
+// that are no larger (dimension-wise) than the shapes it was traced with. The blocks of such a pattern are at least
+// as large as the tensors they will hold, assuming tensor sizes grow monotonically with the input dimensions, which
+// holds for the typical batch/sequence length dimensions. Larger shapes in the same bucket get a cache miss, and the
+// pattern traced for them replaces the cached one, so each bucket converges to the largest shape seen for it.
+class MemoryPatternCache {
+ public:
+  using InputShapes = std::vector<std::reference_wrapper<const TensorShape>>;
+
+  static constexpr size_t kDefaultCapacity = 128;
+
+  MemoryPatternCache() = default;
+
+  // Maximum number of entries. 0 means unbounded. Not thread-safe, call before the cache is used.
+  void SetCapacity(size_t capacity) { capacity_ = capacity; }
+
+  // Ascending bucket sizes dimensions are rounded up to. Dimensions larger than the last bucket are used as is.
+  // An empty list disables bucketing. Not thread-safe, call before the cache is used.
+  void SetDimBuckets(std::vector<int64_t> dim_buckets) { dim_buckets_ = std::move(dim_buckets); }
+
+  // Parses a comma separated list of strictly ascending, positive bucket sizes, e.g. "32,64,128,256".
+  static common::Status ParseDimBuckets(const std::string& str, std::vector<int64_t>& dim_buckets);
+
+  // Returns the patterns usable for input_shapes, or nullptr if there are none.
+  // On success inferred_shapes is set to the shapes stored with the patterns.
+  std::shared_ptr<const MemoryPatternGroup> Find(const InputShapes& input_shapes,
+                                                 std::unordered_map<int, TensorShape>& inferred_shapes) const;
+
+  // Adds the patterns traced for input_shapes. An existing entry for the same key is only replaced if it was
+  // traced with a smaller dimension somewhere, as it would not be usable for input_shapes otherwise.
+  void Insert(const InputShapes& input_shapes, std::unique_ptr<MemoryPatternGroup> patterns,
+              std::unordered_map<int, TensorShape> inferred_shapes = {});
+
+  size_t Size() const;
+
+ private:
+  struct Entry {
+    std::vector<int64_t> key;
+    // dims of all inputs the patterns were traced with, in the same layout as the key
+    std::vector<int64_t> traced_dims;
+    std::shared_ptr<const MemoryPatternGroup> patterns;
+    std::unordered_map<int, TensorShape> inferred_shapes;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  int64_t BucketDim(int64_t dim) const;
+
+  // The rank of each input is part of the key so that e.g. {2, 3} + {4} and {2} + {3, 4} don't collide.
+  void MakeKey(const InputShapes& input_shapes, std::vector<int64_t>& key, std::vector<int64_t>& dims) const;
+
+  size_t capacity_ = kDefaultCapacity;
+  std::vector<int64_t> dim_buckets_;
+
+  mutable OrtMutex mutex_;
+  // most recently used entry first
+  mutable EntryList entries_;
+  std::map<std::vector<int64_t>, EntryList::iterator> index_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryPatternCache);
+};
+
+}  // namespace onnxruntime
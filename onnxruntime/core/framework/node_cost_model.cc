@@ -0,0 +1,166 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/node_cost_model.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+// dimensions of a NodeArg with unknown dimensions as 1. empty if the shape is unknown.
+static std::vector<double> GetDims(const NodeArg* node_arg) {
+  std::vector<double> dims;
+  if (node_arg == nullptr || !node_arg->Exists()) {
+    return dims;
+  }
+
+  const auto* shape = node_arg->Shape();
+  if (shape == nullptr) {
+    return dims;
+  }
+
+  dims.reserve(shape->dim_size());
+  for (const auto& dim : shape->dim()) {
+    dims.push_back(dim.has_dim_value() && dim.dim_value() > 0 ? static_cast<double>(dim.dim_value()) : 1.);
+  }
+
+  return dims;
+}
+
+static double NumElements(const std::vector<double>& dims, size_t first_dim = 0) {
+  double num_elements = 1.;
+  for (size_t i = first_dim; i < dims.size(); ++i) {
+    num_elements *= dims[i];
+  }
+
+  return num_elements;
+}
+
+static double NumElements(ConstPointerContainer<std::vector<NodeArg*>> node_args) {
+  double num_elements = 0.;
+  for (const auto* node_arg : node_args) {
+    if (node_arg->Exists() && node_arg->Shape() != nullptr) {
+      num_elements += NumElements(GetDims(node_arg));
+    }
+  }
+
+  return num_elements;
+}
+
+static int64_t GetIntAttribute(const Node& node, const std::string& name, int64_t default_value) {
+  const auto& attributes = node.GetAttributes();
+  auto entry = attributes.find(name);
+  return entry != attributes.cend() ? entry->second.i() : default_value;
+}
+
+double NodeCostModel::EstimateNodeCost(const Node& node) {
+  const auto& op_type = node.OpType();
+  const auto input_defs = node.InputDefs();
+  const double output_elements = NumElements(node.OutputDefs());
+  double cost = std::max(NumElements(input_defs), output_elements);
+
+  if (op_type == "Conv" || op_type == "FusedConv" || op_type == "NhwcConv" || op_type == "ConvInteger" ||
+      op_type == "QLinearConv" || op_type == "ConvTranspose") {
+    // every output element (input element for ConvTranspose) is multiplied with C/group * kernel size weights
+    const size_t weight_idx = op_type == "QLinearConv" ? 3 : 1;
+    if (input_defs.size() > weight_idx) {
+      const auto weight_dims = GetDims(input_defs[weight_idx]);
+      if (weight_dims.size() > 1) {
+        const double elements = op_type == "ConvTranspose" ? NumElements(GetDims(input_defs[0])) : output_elements;
+        cost = elements * NumElements(weight_dims, 1);
+      }
+    }
+  } else if (op_type == "MatMul" || op_type == "MatMulInteger" || op_type == "QLinearMatMul" ||
+             op_type == "FusedMatMul" || op_type == "Gemm" || op_type == "FusedGemm") {
+    // every output element is the dot product of K elements of A and B
+    const auto a_dims = GetDims(input_defs[0]);
+    if (!a_dims.empty()) {
+      const bool trans_a = (op_type == "Gemm" || op_type == "FusedGemm") &&
+                           GetIntAttribute(node, "transA", 0) != 0 && a_dims.size() == 2;
+      cost = output_elements * (trans_a ? a_dims[0] : a_dims.back());
+    }
+  } else if (op_type == "LSTM" || op_type == "GRU" || op_type == "RNN") {
+    // every step multiplies the input with W and the hidden state with R for each batch entry
+    const auto x_dims = GetDims(input_defs[0]);
+    if (x_dims.size() == 3 && input_defs.size() > 2) {
+      cost = x_dims[0] * x_dims[1] *
+             (NumElements(GetDims(input_defs[1])) + NumElements(GetDims(input_defs[2])));
+    }
+  }
+
+  return std::max(cost, 1.);
+}
+
+NodeCostModel::NodeCostModel(const GraphViewer& graph_viewer) {
+  const auto num_node_indexes = static_cast<size_t>(graph_viewer.MaxNodeIndex());
+  successors_.resize(num_node_indexes);
+  estimated_costs_.resize(num_node_indexes, 0.);
+  measured_costs_.resize(num_node_indexes, -1.);
+  num_measurements_.resize(num_node_indexes, 0);
+
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+  reverse_order_.assign(order.crbegin(), order.crend());
+  for (auto node_index : order) {
+    const auto& node = *graph_viewer.GetNode(node_index);
+    estimated_costs_[node_index] = EstimateNodeCost(node);
+    for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+      successors_[node_index].push_back(it->GetNode().Index());
+    }
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  UpdatePriorities();
+}
+
+std::shared_ptr<const std::vector<double>> NodeCostModel::GetPriorities() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return priorities_;
+}
+
+void NodeCostModel::UpdateMeasuredCosts(const std::vector<double>& kernel_times) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  const size_t num_nodes = std::min(kernel_times.size(), measured_costs_.size());
+  for (size_t i = 0; i < num_nodes; ++i) {
+    if (kernel_times[i] < 0) {
+      continue;
+    }
+
+    // running average over all profiled runs
+    const auto n = ++num_measurements_[i];
+    measured_costs_[i] = n == 1 ? kernel_times[i] : measured_costs_[i] + (kernel_times[i] - measured_costs_[i]) / n;
+  }
+
+  UpdatePriorities();
+}
+
+void NodeCostModel::UpdatePriorities() {
+  // time per estimated operation of the measured nodes, used to convert the estimates of the other nodes
+  double measured_sum = 0.;
+  double estimated_sum = 0.;
+  for (size_t i = 0; i < measured_costs_.size(); ++i) {
+    if (measured_costs_[i] >= 0) {
+      measured_sum += measured_costs_[i];
+      estimated_sum += estimated_costs_[i];
+    }
+  }
+
+  const double scale = measured_sum > 0 && estimated_sum > 0 ? measured_sum / estimated_sum : 1.;
+
+  auto priorities = std::make_shared<std::vector<double>>(estimated_costs_.size(), 0.);
+  for (auto node_index : reverse_order_) {
+    double longest_successor_path = 0.;
+    for (auto successor : successors_[node_index]) {
+      longest_successor_path = std::max(longest_successor_path, (*priorities)[successor]);
+    }
+
+    const double cost = measured_costs_[node_index] >= 0 ? measured_costs_[node_index]
+                                                          : estimated_costs_[node_index] * scale;
+    (*priorities)[node_index] = cost + longest_successor_path;
+  }
+
+  priorities_ = std::move(priorities);
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/graph/basic_types.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class GraphViewer;
+class Node;
+
+// Thread-safe cost estimates for the nodes of a graph, used by the ParallelExecutor to run the nodes on the critical
+// path first.
+//
+// The initial costs are static estimates of the number of operations of each node, computed from the op type and the
+// inferred shapes of its inputs and outputs. Kernel times measured in profiled runs replace the estimates of the
+// measured nodes, and the estimates of the remaining nodes are scaled by the measured time per estimated operation so
+// that all costs share the same unit.
+class NodeCostModel {
+ public:
+  explicit NodeCostModel(const GraphViewer& graph_viewer);
+
+  // Static estimate of the number of operations of a node. Unknown dimensions count as 1.
+  static double EstimateNodeCost(const Node& node);
+
+  // Returns the priority of each node, indexed by node index: the cost of the most expensive path from the node to
+  // the end of the graph, including the node itself. Entries of removed nodes are 0.
+  std::shared_ptr<const std::vector<double>> GetPriorities() const;
+
+  // Refines the costs with kernel times indexed by node index. Negative entries are nodes that weren't measured.
+  void UpdateMeasuredCosts(const std::vector<double>& kernel_times);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NodeCostModel);
+
+  // requires mutex_ to be held
+  void UpdatePriorities();
+
+  // node indexes in reverse topological order
+  std::vector<NodeIndex> reverse_order_;
+  // successors of each node, indexed by node index
+  std::vector<std::vector<NodeIndex>> successors_;
+  std::vector<double> estimated_costs_;
+
+  mutable OrtMutex mutex_;
+  // average measured kernel time of each node. negative if the node wasn't measured yet.
+  std::vector<double> measured_costs_;
+  std::vector<size_t> num_measurements_;
+  std::shared_ptr<const std::vector<double>> priorities_;
+};
+
+}  // namespace onnxruntime
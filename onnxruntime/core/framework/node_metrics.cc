@@ -0,0 +1,159 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/node_metrics.h"
+
+#include <algorithm>
+#include <locale>
+#include <map>
+#include <sstream>
+
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+NodeMetrics::NodeMetrics(const GraphViewer& graph_viewer) {
+  const auto num_node_indexes = static_cast<size_t>(graph_viewer.MaxNodeIndex());
+  node_names_.resize(num_node_indexes);
+  op_types_.resize(num_node_indexes);
+  counters_ = onnxruntime::make_unique<Counters[]>(num_node_indexes);
+
+  for (const auto& node : graph_viewer.Nodes()) {
+    node_names_[node.Index()] = node.Name().empty() ? std::to_string(node.Index()) : node.Name();
+    op_types_[node.Index()] = node.OpType();
+  }
+}
+
+void NodeMetrics::Record(NodeIndex node_index, uint64_t time_ns, uint64_t output_bytes) noexcept {
+  if (node_index >= node_names_.size()) {
+    return;
+  }
+
+  auto& counters = counters_[node_index];
+  counters.call_count.fetch_add(1, std::memory_order_relaxed);
+  counters.total_time_ns.fetch_add(time_ns, std::memory_order_relaxed);
+  counters.output_bytes.fetch_add(output_bytes, std::memory_order_relaxed);
+
+  auto min_time_ns = counters.min_time_ns.load(std::memory_order_relaxed);
+  while (time_ns < min_time_ns &&
+         !counters.min_time_ns.compare_exchange_weak(min_time_ns, time_ns, std::memory_order_relaxed)) {
+  }
+
+  auto max_time_ns = counters.max_time_ns.load(std::memory_order_relaxed);
+  while (time_ns > max_time_ns &&
+         !counters.max_time_ns.compare_exchange_weak(max_time_ns, time_ns, std::memory_order_relaxed)) {
+  }
+}
+
+void NodeMetrics::GetSnapshot(const std::string& graph_prefix, std::vector<Entry>& entries) const {
+  for (size_t i = 0; i < node_names_.size(); ++i) {
+    const auto& counters = counters_[i];
+    Entry entry;
+    entry.call_count = counters.call_count.load(std::memory_order_relaxed);
+    if (entry.call_count == 0) {
+      continue;
+    }
+
+    entry.node_name = graph_prefix + node_names_[i];
+    entry.op_type = op_types_[i];
+    entry.total_time_ns = counters.total_time_ns.load(std::memory_order_relaxed);
+    entry.min_time_ns = counters.min_time_ns.load(std::memory_order_relaxed);
+    entry.max_time_ns = counters.max_time_ns.load(std::memory_order_relaxed);
+    entry.output_bytes = counters.output_bytes.load(std::memory_order_relaxed);
+    entries.push_back(std::move(entry));
+  }
+}
+
+std::vector<NodeMetrics::Entry> NodeMetrics::AggregateByOpType(const std::vector<Entry>& node_entries) {
+  // ordered so that the output is stable
+  std::map<std::string, Entry> op_type_entries;
+  for (const auto& entry : node_entries) {
+    auto insert_result = op_type_entries.emplace(entry.op_type, Entry{});
+    auto& op_type_entry = insert_result.first->second;
+    if (insert_result.second) {
+      op_type_entry.op_type = entry.op_type;
+      op_type_entry.min_time_ns = entry.min_time_ns;
+    }
+
+    op_type_entry.call_count += entry.call_count;
+    op_type_entry.total_time_ns += entry.total_time_ns;
+    op_type_entry.min_time_ns = std::min(op_type_entry.min_time_ns, entry.min_time_ns);
+    op_type_entry.max_time_ns = std::max(op_type_entry.max_time_ns, entry.max_time_ns);
+    op_type_entry.output_bytes += entry.output_bytes;
+  }
+
+  std::vector<Entry> entries;
+  entries.reserve(op_type_entries.size());
+  for (auto& op_type_entry : op_type_entries) {
+    entries.push_back(std::move(op_type_entry.second));
+  }
+
+  return entries;
+}
+
+// escapes a label value as required by the Prometheus text format
+static std::string EscapeLabelValue(const std::string& value) {
+  std::string escaped;
+  escaped.reserve(value.size());
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      escaped += '\\';
+      escaped += c;
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else {
+      escaped += c;
+    }
+  }
+
+  return escaped;
+}
+
+std::string NodeMetrics::ToPrometheusText(const std::vector<Entry>& node_entries) {
+  struct Metric {
+    const char* name;
+    const char* type;
+    const char* help;
+    double (*get_value)(const Entry&);
+  };
+
+  static const Metric metrics[] = {
+      {"calls_total", "counter", "Number of kernel calls.",
+       [](const Entry& e) { return static_cast<double>(e.call_count); }},
+      {"time_seconds_total", "counter", "Total kernel time.",
+       [](const Entry& e) { return static_cast<double>(e.total_time_ns) / 1e9; }},
+      {"min_time_seconds", "gauge", "Shortest kernel time.",
+       [](const Entry& e) { return static_cast<double>(e.min_time_ns) / 1e9; }},
+      {"max_time_seconds", "gauge", "Longest kernel time.",
+       [](const Entry& e) { return static_cast<double>(e.max_time_ns) / 1e9; }},
+      {"output_bytes_total", "counter", "Total size of the output tensors.",
+       [](const Entry& e) { return static_cast<double>(e.output_bytes); }},
+  };
+
+  std::ostringstream ss;
+  ss.imbue(std::locale::classic());
+  ss.precision(17);
+
+  const auto op_type_entries = AggregateByOpType(node_entries);
+
+  for (const bool per_node : {true, false}) {
+    const char* prefix = per_node ? "onnxruntime_node_" : "onnxruntime_op_";
+    const auto& entries = per_node ? node_entries : op_type_entries;
+    for (const auto& metric : metrics) {
+      ss << "# HELP " << prefix << metric.name << " " << metric.help << "\n"
+         << "# TYPE " << prefix << metric.name << " " << metric.type << "\n";
+      for (const auto& entry : entries) {
+        ss << prefix << metric.name << "{";
+        if (per_node) {
+          ss << "node=\"" << EscapeLabelValue(entry.node_name) << "\",";
+        }
+
+        ss << "op_type=\"" << EscapeLabelValue(entry.op_type) << "\"} " << metric.get_value(entry) << "\n";
+      }
+    }
+  }
+
+  return ss.str();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+
+class GraphViewer;
+
+// Aggregated execution counters of the kernels of a graph that are cheap enough to be left enabled in production.
+//
+// Each node has a fixed set of counters that are updated with relaxed atomics after its kernel ran, so concurrent
+// Run calls never contend on a lock. Per op type values are aggregated from the per node counters when a snapshot is
+// taken.
+class NodeMetrics {
+ public:
+  explicit NodeMetrics(const GraphViewer& graph_viewer);
+
+  // Values of the counters of a node, or of all nodes with the same op type.
+  struct Entry {
+    std::string node_name;
+    std::string op_type;
+    uint64_t call_count = 0;
+    uint64_t total_time_ns = 0;
+    uint64_t min_time_ns = 0;
+    uint64_t max_time_ns = 0;
+    // sum of the sizes of the output tensors of all calls
+    uint64_t output_bytes = 0;
+  };
+
+  // Records a successful kernel call of the node with the given index. Thread-safe.
+  void Record(NodeIndex node_index, uint64_t time_ns, uint64_t output_bytes) noexcept;
+
+  // Appends an entry for each node that ran at least once.
+  // graph_prefix is prepended to the node names to distinguish the nodes of subgraphs.
+  void GetSnapshot(const std::string& graph_prefix, std::vector<Entry>& entries) const;
+
+  // Combines the entries of the nodes with the same op type. The node names of the returned entries are empty.
+  static std::vector<Entry> AggregateByOpType(const std::vector<Entry>& node_entries);
+
+  // Formats the entries of the nodes and of their op types in the Prometheus text exposition format.
+  static std::string ToPrometheusText(const std::vector<Entry>& node_entries);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NodeMetrics);
+
+  struct Counters {
+    std::atomic<uint64_t> call_count{0};
+    std::atomic<uint64_t> total_time_ns{0};
+    std::atomic<uint64_t> min_time_ns{UINT64_MAX};
+    std::atomic<uint64_t> max_time_ns{0};
+    std::atomic<uint64_t> output_bytes{0};
+  };
+
+  // names and op types indexed by node index. empty for removed nodes.
+  std::vector<std::string> node_names_;
+  std::vector<std::string> op_types_;
+  std::unique_ptr<Counters[]> counters_;
+};
+
+}  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "core/framework/parallel_executor.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <thread>
@@ -19,12 +20,20 @@
 namespace onnxruntime {
 
 ParallelExecutor::ParallelExecutor(const SessionState& session_state, const bool& terminate_flag)
-    : out_standings_(0), terminate_flag_(terminate_flag), executor_pool_(session_state.GetInterOpThreadPool()) {
+    : intra_op_parallelism_(concurrency::ThreadPool::DegreeOfParallelism(session_state.GetThreadPool())),
+      out_standings_(0),
+      terminate_flag_(terminate_flag),
+      executor_pool_(session_state.GetInterOpThreadPool()) {
   const auto& graph_viewer = session_state.GetGraphViewer();
   node_refs_.resize(graph_viewer.MaxNodeIndex());
   for (auto& node : graph_viewer.Nodes()) {
     node_refs_[node.Index()] = node.GetInputEdgesCount();
   }
+
+  const auto* node_cost_model = session_state.GetNodeCostModel();
+  if (node_cost_model) {
+    priorities_ = node_cost_model->GetPriorities();
+  }
 }
 
 Status ParallelExecutor::Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
@@ -38,16 +47,28 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
     tp = session_state.Profiler().StartTime();
   }
 
+  profiling_run_ = profiling::Profiler::CurrentRun();
   root_frame_ = onnxruntime::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
                                                          fetch_allocators, session_state);
-  //std::cout << "start nodes:" << std::endl;
-  for (auto node_index : session_state.GetGraphViewer().GetRootNodes()) {
-    auto p_op_kernel = session_state.GetKernel(node_index);
-    if (!p_op_kernel)
-      continue;
-
-    //std::cout << "\t" << p_op_kernel->Node().Name() << std::endl;
-    EnqueueNode(node_index, session_state, logger);
+  if (is_profiler_enabled) {
+    kernel_times_.assign(node_refs_.size(), -1.);
+  }
+
+  size_t num_root_nodes = 0;
+  {
+    std::lock_guard<OrtMutex> lock(ref_mutex_);
+    for (auto node_index : session_state.GetGraphViewer().GetRootNodes()) {
+      auto p_op_kernel = session_state.GetKernel(node_index);
+      if (!p_op_kernel)
+        continue;
+
+      PushReadyNode(node_index);
+      ++num_root_nodes;
+    }
+  }
+
+  for (size_t i = 0; i < num_root_nodes; ++i) {
+    ScheduleReadyNode(session_state, logger);
   }
 
   // Wait for finish.
@@ -101,6 +122,11 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
   }
 
   if (is_profiler_enabled) {
+    auto* node_cost_model = session_state.GetNodeCostModel();
+    if (node_cost_model) {
+      node_cost_model->UpdateMeasuredCosts(kernel_times_);
+    }
+
     session_state.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "ParallelExecutor::Execute", tp);
   }
 
@@ -120,6 +146,7 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
   TimePoint sync_time_begin;
   TimePoint kernel_begin_time;
   const bool f_profiler_enabled = session_state.Profiler().IsEnabled();
+  NodeMetrics* const node_metrics = session_state.GetNodeMetrics();
   const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
 
   // Avoid context switching if possible.
@@ -189,14 +216,28 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
     // call compute on the kernel
     VLOGS(logger, 1) << "Computing kernel: " << node.Name();
 
-    // Execute the kernel.
-    ORT_TRY {
-      status = p_op_kernel->Compute(&op_kernel_context);
+    TimePoint metrics_begin_time;
+    if (node_metrics) {
+      metrics_begin_time = std::chrono::high_resolution_clock::now();
     }
-    ORT_CATCH(const std::exception& ex) {
-      ORT_HANDLE_EXCEPTION([&]() {
-        status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
-      });
+
+    // Execute the kernel. The intra-op threads are split evenly between the nodes running at the same time, as
+    // loops that are split across more threads than are available only add overhead.
+    {
+      const int num_running_nodes = ++num_running_nodes_;
+      concurrency::ThreadPool::ScopedParallelismLimit parallelism_limit(
+          num_running_nodes > 1 ? std::max(1, intra_op_parallelism_ / num_running_nodes) : 0);
+
+      ORT_TRY {
+        status = p_op_kernel->Compute(&op_kernel_context);
+      }
+      ORT_CATCH(const std::exception& ex) {
+        ORT_HANDLE_EXCEPTION([&]() {
+          status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+        });
+      }
+
+      --num_running_nodes_;
     }
 
     if (!status.IsOK()) {
@@ -209,7 +250,30 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
       break;
     }
 
+    if (node_metrics) {
+      const auto kernel_time = std::chrono::high_resolution_clock::now() - metrics_begin_time;
+      uint64_t output_bytes = 0;
+      for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
+        const OrtValue* p_output = op_kernel_context.GetOutputMLValue(output_index);
+        if (p_output != nullptr && p_output->IsTensor()) {
+          output_bytes += p_output->Get<Tensor>().SizeInBytes();
+        }
+      }
+
+      node_metrics->Record(
+          node_index,
+          static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(kernel_time).count()),
+          output_bytes);
+    }
+
     if (f_profiler_enabled) {
+      // profiling may have been enabled after the run started
+      if (!kernel_times_.empty()) {
+        kernel_times_[node_index] =
+            std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - kernel_begin_time)
+                .count();
+      }
+
       session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
                                                      node.Name() + "_kernel_time",
                                                      kernel_begin_time,
@@ -251,34 +315,59 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
 
     keep_running = false;
 
-    // Checking which output nodes ready for running.
+    // Queue the output nodes that are ready for running and continue with the ready node with the highest priority,
+    // which may be a node that became ready earlier. Every other node that became ready gets a thread of the pool.
+    size_t num_ready_nodes = 0;
     {
-      auto begin = node.OutputEdgesBegin();
-      auto end = node.OutputEdgesEnd();
-
       std::lock_guard<OrtMutex> lock(ref_mutex_);
-      for (auto it = begin; it != end; it++) {
+      for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
         auto idx = (*it).GetNode().Index();
         if ((--node_refs_[idx]) == 0) {
-          if (!keep_running) {
-            node_index = idx;
-            keep_running = true;
-          } else {
-            EnqueueNode(idx, session_state, logger);
-          }
+          PushReadyNode(idx);
+          ++num_ready_nodes;
         }
+      }
 
-        // std::cout << "handle output, current name: " << node.Name() << ", current index: "
-        // << p_node_index << ", output name: " << (*it)->GetNode().Name() << ", output index: "
-        // << (*it)->GetNode().Index() << ", after -- output ref: " << node_refs_[idx] << std::endl;
+      if (num_ready_nodes > 0) {
+        node_index = PopReadyNode();
+        keep_running = true;
       }
     }
+
+    for (size_t i = 1; i < num_ready_nodes; ++i) {
+      ScheduleReadyNode(session_state, logger);
+    }
   }
 
   return status;
 }
 
-void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger) {
+void ParallelExecutor::PushReadyNode(size_t node_index) {
+  ready_nodes_.push_back(node_index);
+  if (priorities_) {
+    const auto& priorities = *priorities_;
+    std::push_heap(ready_nodes_.begin(), ready_nodes_.end(), [&priorities](size_t a, size_t b) {
+      return priorities[a] < priorities[b];
+    });
+  }
+}
+
+size_t ParallelExecutor::PopReadyNode() {
+  // every scheduled task and every thread continuing with another node pops exactly one node pushed before
+  ORT_ENFORCE(!ready_nodes_.empty());
+  if (priorities_) {
+    const auto& priorities = *priorities_;
+    std::pop_heap(ready_nodes_.begin(), ready_nodes_.end(), [&priorities](size_t a, size_t b) {
+      return priorities[a] < priorities[b];
+    });
+  }
+
+  size_t node_index = ready_nodes_.back();
+  ready_nodes_.pop_back();
+  return node_index;
+}
+
+void ParallelExecutor::ScheduleReadyNode(const SessionState& session_state, const logging::Logger& logger) {
   {
     std::unique_lock<OrtMutex> lock(complete_mutex_);
     // if there are errors there's no point queuing more work
@@ -288,7 +377,16 @@ void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& sess
     out_standings_++;
   }
 
-  executor_pool_->Schedule([this, p_node_index, &session_state, &logger]() {
+  executor_pool_->Schedule([this, &session_state, &logger]() {
+    // continue the run on this thread so that the profiler samples its nodes like the rest of the run
+    profiling::Profiler::RunScope profiling_run(profiling_run_);
+
+    size_t p_node_index;
+    {
+      std::lock_guard<OrtMutex> lock(ref_mutex_);
+      p_node_index = PopReadyNode();
+    }
+
     auto create_exception_message = [p_node_index, &session_state](const std::exception* ex) {
       const auto* node = session_state.GetGraphViewer().GetNode(p_node_index);
 
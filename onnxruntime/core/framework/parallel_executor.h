@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <vector>
 #include "core/common/common.h"
 #include "core/common/status.h"
@@ -33,7 +35,12 @@ class ParallelExecutor : public IExecutor {
 
   Status RunNodeAsync(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
 
-  void EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
+  // Schedules a task on the inter-op thread pool that runs the ready node with the highest priority.
+  void ScheduleReadyNode(const SessionState& session_state, const logging::Logger& logger);
+
+  // Adds a node to/removes the node with the highest priority from ready_nodes_. Require ref_mutex_ to be held.
+  void PushReadyNode(size_t node_index);
+  size_t PopReadyNode();
 
   void FinishNodeRun(const Status& status) {
     bool finished = false;
@@ -54,6 +61,20 @@ class ParallelExecutor : public IExecutor {
   std::unique_ptr<ExecutionFrame> root_frame_;
   std::vector<size_t> node_refs_;
   OrtMutex ref_mutex_;
+
+  // Nodes are run in order of the cost of the longest path from them to the end of the graph, so the nodes on the
+  // critical path start as soon as they are ready. nullptr if the session state has no cost model.
+  std::shared_ptr<const std::vector<double>> priorities_;
+  std::vector<size_t> ready_nodes_;  // heap ordered by priority. protected by ref_mutex_
+
+  // intra-op threads available to a node running on its own. shared between the nodes running concurrently.
+  int intra_op_parallelism_;
+  std::atomic<int> num_running_nodes_{0};
+
+  // kernel times in microseconds indexed by node index, measured when profiling to refine the cost model.
+  std::vector<double> kernel_times_;
+  // run of the profiler that Execute was called in
+  profiling::Profiler::RunContext* profiling_run_ = nullptr;
   int out_standings_;  //protected by complete_mutex_
   OrtMutex complete_mutex_;
   OrtCondVar complete_cv_;
@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepacked_weights_container.h"
+
+namespace onnxruntime {
+
+const PrePackedWeights* PrepackedWeightsContainer::Find(const std::string& key) const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = prepacked_weights_map_.find(key);
+  return it != prepacked_weights_map_.end() ? &it->second : nullptr;
+}
+
+const PrePackedWeights& PrepackedWeightsContainer::Insert(const std::string& key, PrePackedWeights&& weights) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return prepacked_weights_map_.emplace(key, std::move(weights)).first->second;
+}
+
+size_t PrepackedWeightsContainer::NumberOfEntries() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return prepacked_weights_map_.size();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/prepacked_weights.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// Thread-safe store of pre-packed weights that can be shared by the kernels of several sessions, e.g. replicas of
+// the same model loaded for different NUMA nodes or tenants, so that each weight is packed and kept in memory once.
+//
+// Entries are keyed by a string that identifies both the packing kernel (op, attributes, execution provider) and
+// the content of the initialized tensor, see SessionState::PrepackInitializedConstantTensors.
+// The packed buffers are allocated with the container's CPU allocator and live as long as the container, which
+// must outlive all sessions using it.
+class PrepackedWeightsContainer final {
+ public:
+  PrepackedWeightsContainer() : allocator_(std::make_shared<CPUAllocator>()) {}
+
+  // The allocator kernels pack the shared weights with.
+  AllocatorPtr GetAllocator() const { return allocator_; }
+
+  // Returns the weights stored for key, or nullptr if there are none.
+  const PrePackedWeights* Find(const std::string& key) const;
+
+  // Stores the weights for key and returns the stored entry. If another session added weights for the same key in
+  // the meantime, those are kept and returned and the passed in weights are freed.
+  const PrePackedWeights& Insert(const std::string& key, PrePackedWeights&& weights);
+
+  size_t NumberOfEntries() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrepackedWeightsContainer);
+
+  AllocatorPtr allocator_;
+
+  mutable OrtMutex mutex_;
+  // node based map so that references to the entries stay valid
+  std::unordered_map<std::string, PrePackedWeights> prepacked_weights_map_;  // GUARDED_BY(mutex_)
+};
+
+}  // namespace onnxruntime
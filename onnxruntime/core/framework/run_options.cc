@@ -53,3 +53,20 @@ ORT_API_STATUS_IMPL(OrtApis::RunOptionsUnsetTerminate, _Inout_ OrtRunOptions* op
   options->terminate = false;
   return nullptr;
 }
+
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsGetTerminate, _In_ const OrtRunOptions* options, _Out_ int* out) {
+  *out = options->terminate ? 1 : 0;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsSetShrinkArenas, _Inout_ OrtRunOptions* options, int shrink_arenas) {
+  options->shrink_memory_arenas = shrink_arenas != 0;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsSetProfiling, _Inout_ OrtRunOptions* options, int start_profiling,
+                    int end_profiling) {
+  options->start_profiling = start_profiling != 0;
+  options->end_profiling = end_profiling != 0;
+  return nullptr;
+}
@@ -127,6 +127,7 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
                                    const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
                                    const logging::Logger& logger) {
   const bool is_profiler_enabled = session_state.Profiler().IsEnabled();
+  NodeMetrics* const node_metrics = session_state.GetNodeMetrics();
   TimePoint tp;
   TimePoint sync_time_begin;
   TimePoint kernel_begin_time;
@@ -295,6 +296,11 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
                                input_activation_sizes, input_parameter_sizes, node_name_for_profiling);
     }
 
+    TimePoint metrics_begin_time;
+    if (node_metrics) {
+      metrics_begin_time = std::chrono::high_resolution_clock::now();
+    }
+
     Status compute_status;
     {
 #ifdef CONCURRENCY_VISUALIZER
@@ -328,6 +334,15 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
       return Status(compute_status.Category(), compute_status.Code(), msg_string);
     }
 
+    if (node_metrics) {
+      const auto kernel_time = std::chrono::high_resolution_clock::now() - metrics_begin_time;
+      CalculateTotalOutputSizes(&op_kernel_context, total_output_sizes, node_name_for_profiling);
+      node_metrics->Record(
+          node_index,
+          static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(kernel_time).count()),
+          static_cast<uint64_t>(total_output_sizes));
+    }
+
     if (is_profiler_enabled) {
       // Calculate total output sizes for this operation.
       CalculateTotalOutputSizes(&op_kernel_context, total_output_sizes, node_name_for_profiling);
@@ -3,18 +3,24 @@
 
 #include "core/framework/session_state.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "core/common/logging/logging.h"
+#include "core/common/parse_string.h"
 #include "core/common/safeint.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/framework/allocator.h"
+#include "core/framework/murmurhash3.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/ort_value_pattern_planner.h"
 #include "core/framework/session_state_utils.h"
 #include "core/framework/utils.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/controlflow/utils.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 using namespace ::onnxruntime::common;
 using namespace ::onnxruntime::experimental;
@@ -234,6 +240,71 @@ void SessionState::CleanInitializedTensorsFromGraph() {
   graph_.CleanAllInitializedTensors();
 }
 
+// Creates the key of the weights a kernel packs from an initialized constant tensor in a
+// PrepackedWeightsContainer. Returns an empty string if the packed weights can't be shared.
+//
+// The packed weights depend on the kernel (op, version, attributes, execution provider and its packing related
+// configuration) and the tensor. Tensors are identified by their type, shape and a hash of their content, so
+// identical weights in separate models, or in models loaded by separate sessions, share the packed weights
+// regardless of whether the initializers themselves are shared via SessionOptions::initializers_to_share_map.
+static std::string GetPrePackedWeightsKey(const Node& node, const OpKernel& kernel, const Tensor& tensor,
+                                          int input_idx) {
+  if (tensor.IsDataTypeString()) {
+    return {};
+  }
+
+  // use the configuration of the provider the kernel was created for. it may differ from the session options
+  // when the provider was registered explicitly.
+  const auto* provider = kernel.Info().GetExecutionProvider();
+  std::ostringstream key;
+  key << node.Domain() << ':' << node.OpType() << ':' << node.SinceVersion() << ':' << provider->Type() << ':';
+  if (provider->Type() == kCpuExecutionProvider) {
+    key << static_cast<int>(static_cast<const CPUExecutionProvider*>(provider)->GetGemmPackedBFormat()) << ':';
+  }
+  key << input_idx << ':';
+
+  // order the attributes by name so that the key doesn't depend on the iteration order of the map
+  const auto& attributes = node.GetAttributes();
+  std::map<std::string, std::string> serialized_attributes;
+  for (const auto& attribute : attributes) {
+    serialized_attributes[attribute.first] = attribute.second.SerializeAsString();
+  }
+  for (const auto& attribute : serialized_attributes) {
+    key << attribute.first.size() << ':' << attribute.first << ':'
+        << attribute.second.size() << ':' << attribute.second << ';';
+  }
+
+  key << tensor.GetElementType() << ':' << tensor.Shape() << ':';
+
+  // MurmurHash3 takes an int length, so hash large tensors in chunks seeding each chunk with the previous hash
+  uint32_t hash[4] = {0, 0, 0, 0};
+  const auto* data = static_cast<const uint8_t*>(tensor.DataRaw());
+  size_t remaining = tensor.SizeInBytes();
+  constexpr size_t kMaxChunkSize = size_t{1} << 30;
+  do {
+    const size_t chunk_size = std::min(remaining, kMaxChunkSize);
+    MurmurHash3::x86_128(data, static_cast<int>(chunk_size), hash[0] ^ hash[1] ^ hash[2] ^ hash[3], hash);
+    data += chunk_size;
+    remaining -= chunk_size;
+  } while (remaining > 0);
+  key << hash[0] << '-' << hash[1] << '-' << hash[2] << '-' << hash[3];
+
+  return key.str();
+}
+
+// Hands the buffers in the container to the kernel. The container keeps ownership of them.
+static Status UseSharedPrePackedBuffers(OpKernel& kernel, const PrePackedWeights& prepacked_weights,
+                                        const Tensor& tensor, int input_idx, bool& used_shared_buffers) {
+  std::vector<BufferUniquePtr> shared_buffers;
+  shared_buffers.reserve(prepacked_weights.buffers_.size());
+  for (const auto& buffer : prepacked_weights.buffers_) {
+    shared_buffers.emplace_back(buffer.get(), BufferDeleter(nullptr));
+  }
+
+  return kernel.UseSharedPrePackedBuffers(shared_buffers, prepacked_weights.buffer_sizes_, tensor, input_idx,
+                                          used_shared_buffers);
+}
+
 Status SessionState::PrepackInitializedConstantTensors() {
   // calculate the use count of each value
   std::unordered_map<std::string, size_t> node_arg_use_count;
@@ -245,39 +316,134 @@ Status SessionState::PrepackInitializedConstantTensors() {
     });
   }
 
+  // the constant initialized tensors each kernel may pack. all inputs of a kernel are packed by one thread as
+  // PrePack changes the state of the kernel, but separate kernels are packed in parallel.
+  struct InputToPack {
+    int input_idx;
+    int ort_value_idx;
+    const Tensor* tensor;
+    bool is_packed = false;
+    bool uses_shared_weights = false;
+  };
+
+  struct KernelToPack {
+    const Node* node;
+    OpKernel* kernel;
+    std::vector<InputToPack> inputs;
+    Status status;
+  };
+
+  std::vector<KernelToPack> kernels_to_pack;
   for (auto& node : GetGraphViewer().Nodes()) {
-    auto kernel = GetMutableKernel(node.Index());
+    KernelToPack kernel_to_pack{&node, GetMutableKernel(node.Index()), {}, Status::OK()};
     int input_idx = 0;
     for (auto& input_def : node.InputDefs()) {
       if (input_def->Exists()) {
-        const std::string& input_name = input_def->Name();
         int ort_value_idx;
-        ORT_RETURN_IF_ERROR(ort_value_name_idx_map_.GetIdx(input_name, ort_value_idx));
-        if (constant_initialized_tensors_.count(ort_value_idx) &&
-            constant_initialized_tensors_[ort_value_idx].IsTensor()) {
-          bool is_packed = false;
-          const Tensor& const_initialized_tensor = constant_initialized_tensors_[ort_value_idx].Get<Tensor>();
-          ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, is_packed));
-          if (is_packed && node_arg_use_count.count(input_name) && --node_arg_use_count[input_name] == 0) {
-            // release the constant intialized tensor
-            initialized_tensors_.erase(ort_value_idx);
-            constant_initialized_tensors_.erase(ort_value_idx);
-          }
+        ORT_RETURN_IF_ERROR(ort_value_name_idx_map_.GetIdx(input_def->Name(), ort_value_idx));
+        auto entry = constant_initialized_tensors_.find(ort_value_idx);
+        if (entry != constant_initialized_tensors_.cend() && entry->second.IsTensor()) {
+          kernel_to_pack.inputs.push_back({input_idx, ort_value_idx, &entry->second.Get<Tensor>()});
         }
       }
       input_idx++;
     }
+
+    if (!kernel_to_pack.inputs.empty()) {
+      kernels_to_pack.push_back(std::move(kernel_to_pack));
+    }
   }
 
-  return Status::OK();
-}
+  const auto prepack_kernel = [this](KernelToPack& kernel_to_pack) -> Status {
+    const Node& node = *kernel_to_pack.node;
+    OpKernel* kernel = kernel_to_pack.kernel;
+    AllocatorPtr kernel_alloc = kernel->Info().GetAllocator(0, OrtMemTypeDefault);
 
-static int64_t CalculateMemoryPatternsKey(const std::vector<std::reference_wrapper<const TensorShape>>& shapes) {
-  int64_t key = 0;
-  for (auto shape : shapes) {
-    for (auto dim : shape.get().GetDims()) key ^= dim;
+    for (auto& input : kernel_to_pack.inputs) {
+      bool is_packed = false;
+      const Tensor& const_initialized_tensor = *input.tensor;
+      const int input_idx = input.input_idx;
+
+      // the container only holds CPU memory
+      std::string key;
+      if (prepacked_weights_container_ != nullptr && kernel_alloc->Info().device.Type() == OrtDevice::CPU) {
+        key = GetPrePackedWeightsKey(node, *kernel, const_initialized_tensor, input_idx);
+      }
+
+      if (key.empty()) {
+        ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, kernel_alloc, is_packed,
+                                            nullptr));
+      } else {
+        const PrePackedWeights* prepacked_weights = prepacked_weights_container_->Find(key);
+        if (prepacked_weights != nullptr) {
+          ORT_RETURN_IF_ERROR(UseSharedPrePackedBuffers(*kernel, *prepacked_weights, const_initialized_tensor,
+                                                        input_idx, is_packed));
+          input.uses_shared_weights = is_packed;
+
+          // the kernel can't use the weights stored under the key. keep the ones it packs to itself as the
+          // container won't replace the stored weights.
+          if (!is_packed) {
+            ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, kernel_alloc, is_packed,
+                                                nullptr));
+          }
+        } else {
+          PrePackedWeights weights_to_be_filled_in;
+          ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
+                                              prepacked_weights_container_->GetAllocator(), is_packed,
+                                              &weights_to_be_filled_in));
+
+          // kernels that don't support sharing keep the packed weights themselves
+          if (is_packed && !weights_to_be_filled_in.buffers_.empty()) {
+            const auto& stored_weights = prepacked_weights_container_->Insert(key,
+                                                                              std::move(weights_to_be_filled_in));
+            bool used_shared_buffers = false;
+            ORT_RETURN_IF_ERROR(UseSharedPrePackedBuffers(*kernel, stored_weights, const_initialized_tensor,
+                                                          input_idx, used_shared_buffers));
+            ORT_RETURN_IF_NOT(used_shared_buffers, "Kernel for ", node.OpType(),
+                              " filled in pre-packed weights but did not use the shared buffers.");
+          }
+        }
+      }
+
+      input.is_packed = is_packed;
+    }
+
+    return Status::OK();
+  };
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool_, static_cast<std::ptrdiff_t>(kernels_to_pack.size()),
+      [&kernels_to_pack, &prepack_kernel](std::ptrdiff_t i) {
+        auto& kernel_to_pack = kernels_to_pack[i];
+        ORT_TRY {
+          kernel_to_pack.status = prepack_kernel(kernel_to_pack);
+        }
+        ORT_CATCH(const std::exception& ex) {
+          ORT_HANDLE_EXCEPTION([&]() {
+            kernel_to_pack.status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "PrePack failed for node ",
+                                                    kernel_to_pack.node->Name(), ": ", ex.what());
+          });
+        }
+      });
+
+  for (const auto& kernel_to_pack : kernels_to_pack) {
+    ORT_RETURN_IF_ERROR(kernel_to_pack.status);
+
+    for (const auto& input : kernel_to_pack.inputs) {
+      if (input.uses_shared_weights) {
+        ++number_of_shared_prepacked_weights_;
+      }
+
+      const std::string& input_name = kernel_to_pack.node->InputDefs()[input.input_idx]->Name();
+      if (input.is_packed && node_arg_use_count.count(input_name) && --node_arg_use_count[input_name] == 0) {
+        // release the constant intialized tensor
+        initialized_tensors_.erase(input.ort_value_idx);
+        constant_initialized_tensors_.erase(input.ort_value_idx);
+      }
+    }
   }
-  return key;
+
+  return Status::OK();
 }
 
 #ifdef ENABLE_TRAINING
@@ -425,22 +591,18 @@ Status SessionState::GeneratePatternGroupCache(const std::vector<std::reference_
 }
 #endif
 
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
-                                                              const std::vector<int>& feed_mlvalue_idxs,
-                                                              std::unordered_map<int, TensorShape>& inferred_shapes) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
-
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
+    const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
+    const std::vector<int>& feed_mlvalue_idxs,
+    std::unordered_map<int, TensorShape>& inferred_shapes) const {
+  auto patterns = mem_patterns_.Find(input_shapes, inferred_shapes);
+  if (patterns == nullptr) {
 #ifdef ENABLE_TRAINING
     auto mem_patterns = onnxruntime::make_unique<MemoryPatternGroup>();
     if (GeneratePatternGroupCache(input_shapes, feed_mlvalue_idxs, mem_patterns.get(), inferred_shapes).IsOK()) {
-      key = CalculateMemoryPatternsKey(input_shapes);
-      auto ptr = mem_patterns.get();
-      mem_patterns_[key] = std::move(mem_patterns);
-      shape_patterns_[key] = inferred_shapes;
-      return ptr;
+      mem_patterns_.Insert(input_shapes, std::move(mem_patterns), inferred_shapes);
+      // the insert may have been a no-op if a concurrent Run added patterns for the same shapes
+      return mem_patterns_.Find(input_shapes, inferred_shapes);
     }
     return nullptr;
 #else
@@ -449,8 +611,7 @@ const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(const std::vector<
 #endif
   }
 
-  inferred_shapes = shape_patterns_[key];
-  return it->second.get();
+  return patterns;
 }
 
 void SessionState::ResolveMemoryPatternFlag() {
@@ -466,14 +627,7 @@ void SessionState::ResolveMemoryPatternFlag() {
 
 Status SessionState::UpdateMemoryPatternGroupCache(const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
                                                    std::unique_ptr<MemoryPatternGroup> mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
-
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
-    mem_patterns_[key] = std::move(mem_patterns);
-  }
-
+  mem_patterns_.Insert(input_shapes, std::move(mem_patterns));
   return Status::OK();
 }
 
@@ -596,6 +750,22 @@ const SessionState* SessionState::GetSubgraphSessionState(onnxruntime::NodeIndex
   return const_cast<SessionState*>(this)->GetMutableSubgraphSessionState(index, attribute_name);
 }
 
+void SessionState::GetNodeMetricsSnapshot(const std::string& graph_prefix,
+                                          std::vector<NodeMetrics::Entry>& entries) const {
+  if (node_metrics_) {
+    node_metrics_->GetSnapshot(graph_prefix, entries);
+  }
+
+  for (const auto& node_to_subgraph_session_states : subgraph_session_states_) {
+    const auto* node = graph_viewer_->GetNode(node_to_subgraph_session_states.first);
+    const auto node_name = node->Name().empty() ? std::to_string(node->Index()) : node->Name();
+    for (const auto& attr_to_session_state : node_to_subgraph_session_states.second) {
+      attr_to_session_state.second->GetNodeMetricsSnapshot(
+          graph_prefix + node_name + "/" + attr_to_session_state.first + "/", entries);
+    }
+  }
+}
+
 const NodeIndexInfo& SessionState::GetNodeIndexInfo() const {
   ORT_ENFORCE(node_index_info_, "SetGraphAndCreateKernels must be called prior to GetExecutionInfo.");
   return *node_index_info_;
@@ -704,7 +874,8 @@ Status SessionState::CreateSubgraphSessionState() {
       auto subgraph_session_state =
           onnxruntime::make_unique<SessionState>(*subgraph, execution_providers_, enable_mem_pattern_,
                                                  thread_pool_, inter_op_thread_pool_, data_transfer_mgr_,
-                                                 logger_, profiler_);
+                                                 logger_, profiler_, use_deterministic_compute_,
+                                                 prepacked_weights_container_);
 
       // Pass fused function manager to subgraph
       subgraph_session_state->fused_funcs_mgr_.SetFusedFuncs(fused_funcs_mgr_);
@@ -811,6 +982,21 @@ Status SessionState::FinalizeSessionState(const std::basic_string<PATH_CHAR_TYPE
                                   remove_initializers);
 }
 
+// Returns whether the nodes of graph and of all its subgraphs are assigned to the CPU execution provider.
+static bool AllNodesAssignedToCpu(const Graph& graph) {
+  for (const auto& node : graph.Nodes()) {
+    if (node.GetExecutionProviderType() != kCpuExecutionProvider) {
+      return false;
+    }
+    for (const auto* subgraph : node.GetSubgraphs()) {
+      if (!AllNodesAssignedToCpu(*subgraph)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_TYPE>& graph_location,
                                               KernelRegistryManager& kernel_registry_manager,
                                               _In_opt_ const Node* parent_node,
@@ -853,7 +1039,7 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
           [this](int idx, const OrtValue& value, const OrtCallback& d, bool constant) -> Status {
             return AddInitializedTensor(idx, value, &d, constant);
           },
-          logger_, data_transfer_mgr_, *p_seq_exec_plan_.get(), session_options));
+          logger_, data_transfer_mgr_, *p_seq_exec_plan_.get(), session_options, thread_pool_));
 
   // remove weights from the graph now to save memory but in many cases it won't save memory, if the tensor was
   // preallocated with the some other tensors in a single 'allocate' call, which is very common.
@@ -864,6 +1050,32 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
 
   ORT_RETURN_IF_ERROR(CreateKernels(kernel_registry_manager));
 
+  if (enable_mem_pattern_) {
+    size_t cache_capacity = MemoryPatternCache::kDefaultCapacity;
+    std::string cache_capacity_str;
+    if (session_options.TryGetConfigEntry(kOrtSessionOptionsConfigMemoryPatternCacheCapacity, cache_capacity_str)) {
+      ORT_RETURN_IF_ERROR(ParseStringWithClassicLocale(cache_capacity_str, cache_capacity));
+    }
+    mem_patterns_.SetCapacity(cache_capacity);
+
+#ifdef ENABLE_TRAINING
+    // patterns and inferred shapes are generated up front from the exact input shapes, so bucketing doesn't apply
+#else
+    std::vector<int64_t> dim_buckets;
+    ORT_RETURN_IF_ERROR(MemoryPatternCache::ParseDimBuckets(
+        session_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternDimBuckets, ""), dim_buckets));
+    mem_patterns_.SetDimBuckets(std::move(dim_buckets));
+#endif
+  }
+
+  if (session_options.execution_mode == ExecutionMode::ORT_PARALLEL) {
+    node_cost_model_ = onnxruntime::make_unique<NodeCostModel>(*graph_viewer_);
+  }
+
+  if (session_options.GetConfigOrDefault(kOrtSessionOptionsConfigEnableNodeMetrics, "0") == "1") {
+    node_metrics_ = onnxruntime::make_unique<NodeMetrics>(*graph_viewer_);
+  }
+
   const auto disable_prepacking =
       session_options.GetConfigOrDefault(kOrtSessionOptionsConfigDisablePrepacking, "0");
 
@@ -881,6 +1093,14 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   SessionOptions subgraph_session_options(session_options);
   subgraph_session_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
 
+  struct SubgraphToFinalize {
+    Node* node;
+    const std::string* attr_name;
+    SessionState* session_state;
+    Status status;
+  };
+
+  std::vector<SubgraphToFinalize> subgraphs_to_finalize;
   for (const auto& node_to_subgraph_ss : subgraph_session_states_) {
     Node& node = *graph_.GetNode(node_to_subgraph_ss.first);
 
@@ -892,21 +1112,48 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
                   "Missing session state for subgraph. Node:'", node.Name(),
                   "' OpType:", node.OpType(), " Index:", node.Index(), " Attribute:", attr_name);
 
-      SessionState& subgraph_session_state = *entry->second;
+      subgraphs_to_finalize.push_back({&node, &attr_name, entry->second.get(), Status::OK()});
+    }
+  }
 
-      // recurse
-      ORT_RETURN_IF_ERROR(subgraph_session_state.FinalizeSessionStateImpl(
-          graph_location, kernel_registry_manager, &node, subgraph_session_options, remove_initializers));
+  // recurse. the subgraphs of If/Loop/Scan nodes have separate session states, so they can be finalized in parallel,
+  // but the kernel constructors and PrePack of some execution providers aren't safe to run concurrently, so that's
+  // limited to subgraphs whose nodes are all assigned to the CPU execution provider.
+  const bool finalize_in_parallel =
+      std::all_of(subgraphs_to_finalize.cbegin(), subgraphs_to_finalize.cend(),
+                  [](const SubgraphToFinalize& subgraph) {
+                    return AllNodesAssignedToCpu(subgraph.session_state->graph_);
+                  });
 
-      // setup all the info for handling the feeds and fetches used in subgraph execution
-      auto* p_op_kernel = GetMutableKernel(node.Index());
-      ORT_ENFORCE(p_op_kernel);
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      finalize_in_parallel ? thread_pool_ : nullptr, static_cast<std::ptrdiff_t>(subgraphs_to_finalize.size()),
+      [&](std::ptrdiff_t i) {
+        auto& subgraph = subgraphs_to_finalize[i];
+        ORT_TRY {
+          subgraph.status = subgraph.session_state->FinalizeSessionStateImpl(
+              graph_location, kernel_registry_manager, subgraph.node, subgraph_session_options, remove_initializers);
+        }
+        ORT_CATCH(const std::exception& ex) {
+          ORT_HANDLE_EXCEPTION([&]() {
+            subgraph.status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to finalize the session state of subgraph ",
+                                              *subgraph.attr_name, " of node ", subgraph.node->Name(), ": ",
+                                              ex.what());
+          });
+        }
+      });
 
-      // Downcast is safe, since only control flow nodes have subgraphs
-      // (node.GetAttributeNameToMutableSubgraphMap() is non-empty)
-      auto& control_flow_kernel = static_cast<controlflow::IControlFlowKernel&>(*p_op_kernel);
-      ORT_RETURN_IF_ERROR(control_flow_kernel.SetupSubgraphExecutionInfo(*this, attr_name, subgraph_session_state));
-    }
+  for (const auto& subgraph : subgraphs_to_finalize) {
+    ORT_RETURN_IF_ERROR(subgraph.status);
+
+    // setup all the info for handling the feeds and fetches used in subgraph execution
+    auto* p_op_kernel = GetMutableKernel(subgraph.node->Index());
+    ORT_ENFORCE(p_op_kernel);
+
+    // Downcast is safe, since only control flow nodes have subgraphs
+    // (node.GetAttributeNameToMutableSubgraphMap() is non-empty)
+    auto& control_flow_kernel = static_cast<controlflow::IControlFlowKernel&>(*p_op_kernel);
+    ORT_RETURN_IF_ERROR(control_flow_kernel.SetupSubgraphExecutionInfo(*this, *subgraph.attr_name,
+                                                                       *subgraph.session_state));
   }
 
   return Status::OK();
@@ -22,10 +22,14 @@
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/mem_pattern_cache.h"
 #include "core/framework/ml_value.h"
+#include "core/framework/node_cost_model.h"
 #include "core/framework/node_index_info.h"
+#include "core/framework/node_metrics.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/prepacked_weights_container.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/onnx_protobuf.h"
 #include "core/platform/ort_mutex.h"
@@ -80,7 +84,8 @@ class SessionState {
                const DataTransferManager& data_transfer_mgr,
                const logging::Logger& logger,
                profiling::Profiler& profiler,
-               bool use_deterministic_compute = false)
+               bool use_deterministic_compute = false,
+               PrepackedWeightsContainer* prepacked_weights_container = nullptr)
       : graph_(graph),
         execution_providers_(execution_providers),
         logger_(logger),
@@ -89,7 +94,8 @@ class SessionState {
         thread_pool_(thread_pool),
         inter_op_thread_pool_(inter_op_thread_pool),
         data_transfer_mgr_(data_transfer_mgr),
-        use_deterministic_compute_(use_deterministic_compute) {
+        use_deterministic_compute_(use_deterministic_compute),
+        prepacked_weights_container_(prepacked_weights_container) {
     SetupAllocators();
   }
 
@@ -185,9 +191,10 @@ class SessionState {
   profiling::Profiler& Profiler() const noexcept { return profiler_; }
 
   /**
-  Get cached memory pattern based on input shapes
+  Get cached memory pattern based on input shapes.
+  The returned patterns stay valid for as long as the caller holds on to them, even if they are evicted from the cache.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(
       const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
       const std::vector<int>& feed_mlvalue_idxs,
       std::unordered_map<int, TensorShape>& inferred_shapes) const;
@@ -249,6 +256,28 @@ class SessionState {
   concurrency::ThreadPool* GetThreadPool() const noexcept { return thread_pool_; }
   concurrency::ThreadPool* GetInterOpThreadPool() const noexcept { return inter_op_thread_pool_; }
 
+  // Number of constant initialized tensors whose packed weights were taken from the PrepackedWeightsContainer
+  // as another session had packed them already.
+  size_t GetNumberOfSharedPrePackedWeights() const noexcept { return number_of_shared_prepacked_weights_; }
+
+  /**
+  Get the node cost estimates used by the ParallelExecutor to prioritize nodes.
+  nullptr unless the session uses the parallel execution mode. Valid after FinalizeSessionState is called.
+  */
+  NodeCostModel* GetNodeCostModel() const noexcept { return node_cost_model_.get(); }
+
+  /**
+  Get the execution counters of the nodes of this graph.
+  nullptr unless enabled in the session options. Valid after FinalizeSessionState is called.
+  */
+  NodeMetrics* GetNodeMetrics() const noexcept { return node_metrics_.get(); }
+
+  /**
+  Append the execution counters of the nodes of this graph and of all its subgraphs to entries.
+  The names of the nodes in subgraphs are prefixed with '<node name>/<attribute name>/' of the node containing them.
+  */
+  void GetNodeMetricsSnapshot(const std::string& graph_prefix, std::vector<NodeMetrics::Entry>& entries) const;
+
   bool ExportDll() const noexcept { return export_fused_dll_; }
   void SetExportDllFlag(bool flag) noexcept { export_fused_dll_ = flag; }
 
@@ -297,6 +326,7 @@ class SessionState {
   /**
   * Prepack the constant initialized tensors for better performance.
   * The original constant initialized tensors will be removed to save memory.
+  * If a PrepackedWeightsContainer was provided, the packed weights are shared with other sessions using it.
   */
   Status PrepackInitializedConstantTensors();
 
@@ -388,12 +418,9 @@ class SessionState {
   // switch for enable memory pattern optimization or not.
   bool enable_mem_pattern_;
 
-  // lock for the mem_patterns_
-  mutable OrtMutex mem_patterns_lock_;
-
   // cache for the generated mem_patterns. key is calculated based on input shapes.
-  mutable std::map<int64_t, std::unique_ptr<MemoryPatternGroup>> mem_patterns_;
-  mutable std::map<int64_t, std::unordered_map<int, TensorShape>> shape_patterns_;
+  // capacity and dimension buckets are configured from the session options in FinalizeSessionState.
+  mutable MemoryPatternCache mem_patterns_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -414,7 +441,16 @@ class SessionState {
 
   bool use_deterministic_compute_;
 
+  // store of pre-packed weights shared with other sessions. may be nullptr.
+  PrepackedWeightsContainer* const prepacked_weights_container_{};
+  size_t number_of_shared_prepacked_weights_ = 0;
+
   std::unique_ptr<NodeIndexInfo> node_index_info_;
+
+  // node costs and priorities for the ParallelExecutor
+  std::unique_ptr<NodeCostModel> node_cost_model_;
+  // execution counters of each node. nullptr if disabled.
+  std::unique_ptr<NodeMetrics> node_metrics_;
   std::multimap<int, std::unique_ptr<FeedsFetchesManager>> cached_feeds_fetches_managers_;
 
 #if !defined(ORT_MINIMAL_BUILD)
@@ -23,17 +23,21 @@
 #include "core/framework/utils.h"
 #include "core/framework/mem_buffer.h"
 #include "core/framework/tensor_allocator.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 namespace session_state_utils {
 
+static bool IsCpuLocation(const OrtMemoryInfo& location) {
+  return strcmp(location.name, CPU) == 0 || location.mem_type == OrtMemTypeCPUOutput;
+}
+
 static common::Status DeserializeTensorProto(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
                                              const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer& m,
                                              const OrtMemoryInfo& default_cpu_memory_info, OrtValue& ort_value,
                                              OrtCallback& deleter,
                                              const DataTransferManager& data_transfer_mgr) {
-  const OrtMemoryInfo& alloc_info = m.GetAllocInfo();
-  if (strcmp(alloc_info.name, CPU) == 0 || alloc_info.mem_type == OrtMemTypeCPUOutput) {
+  if (IsCpuLocation(m.GetAllocInfo())) {
     // deserialize directly to CPU tensor
     return utils::TensorProtoToMLValue(env, proto_path.c_str(), tensor_proto, m, ort_value, deleter);
   }
@@ -87,6 +91,12 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
   return common::Status::OK();
 }
 
+// Initializers deserialized to CPU from data that can be used in place don't need a buffer from the planner.
+static bool CanUseInitializerDataInPlace(const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                         const OrtMemoryInfo& location) {
+  return IsCpuLocation(location) && utils::CanUseTensorProtoDataInPlace(tensor_proto);
+}
+
 common::Status SaveInitializedTensors(
     const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
     const GraphViewer& graph, const OrtMemoryInfo& default_cpu_memory_info,
@@ -94,7 +104,8 @@ common::Status SaveInitializedTensors(
     const std::function<Status(int idx, const OrtValue& value, const OrtCallback& d, bool constant)>& save_tensor_func,
     const logging::Logger& logger, const DataTransferManager& data_transfer_mgr,
     const ExecutionPlanBase& exec_plan,
-    const SessionOptions& session_options) {
+    const SessionOptions& session_options,
+    concurrency::ThreadPool* thread_pool) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > -1, "OrtValue indexes should have been populated.");
 
@@ -131,18 +142,23 @@ common::Status SaveInitializedTensors(
   const onnxruntime::InitializedTensorSet& initialized_tensor_set = graph.GetAllInitializedTensors();
   std::unordered_map<int, const ONNX_NAMESPACE::TensorProto*> id_to_initialized_tensor;
   std::set<int> user_supplied_initializer_ids;  // set containing the ort value ids of all user supplied initializers
+  std::set<int> in_place_initializer_ids;       // set containing the ort value ids of initializers used in place
   for (const auto& entry : initialized_tensor_set) {
     int ort_value_index;
     ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(entry.first, ort_value_index));
     if (use_user_supplied_initializer(entry.first)) {
       user_supplied_initializer_ids.insert(ort_value_index);
+    } else if (CanUseInitializerDataInPlace(*entry.second, exec_plan.GetLocation(ort_value_index))) {
+      in_place_initializer_ids.insert(ort_value_index);
     }
     id_to_initialized_tensor[ort_value_index] = entry.second;
   }
 
   for (const auto& entry : id_to_initialized_tensor) {
-    // We don't want to trace shared initializers since their memory is provided by the user
-    if (user_supplied_initializer_ids.find(entry.first) != user_supplied_initializer_ids.end()) {
+    // We don't want to trace shared initializers since their memory is provided by the user,
+    // or initializers that use their data in place
+    if (user_supplied_initializer_ids.find(entry.first) != user_supplied_initializer_ids.end() ||
+        in_place_initializer_ids.find(entry.first) != in_place_initializer_ids.end()) {
       continue;
     }
     ORT_RETURN_IF_ERROR(planner.Trace(entry.first, entry.second));
@@ -160,29 +176,76 @@ common::Status SaveInitializedTensors(
                        << i.second << " bytes for " << i.first << std::endl;
   }
 
-  OrtCallback deleter{nullptr, nullptr};
-
   //3. create weight tensors based on weights buffer
+  struct InitializerToSave {
+    int ort_value_index;
+    const ONNX_NAMESPACE::TensorProto* tensor_proto;
+    std::unique_ptr<MemBuffer> buffer;  // nullptr for user supplied initializers
+    OrtValue ort_value;
+    OrtCallback deleter{nullptr, nullptr};
+    Status status;
+  };
+
+  // the planner isn't thread-safe, so get the buffers first
+  std::vector<InitializerToSave> initializers_to_save(id_to_initialized_tensor.size());
+  std::vector<size_t> cpu_initializer_indices;
+  size_t i = 0;
   for (const auto& entry : id_to_initialized_tensor) {
-    int ort_value_index = entry.first;
+    auto& initializer = initializers_to_save[i];
+    initializer.ort_value_index = entry.first;
+    initializer.tensor_proto = entry.second;
     const char* name = (entry.second->name().empty()) ? "" : entry.second->name().c_str();
-    OrtValue ort_value;
 
-    if (user_supplied_initializer_ids.find(entry.first) != user_supplied_initializer_ids.end()) {
-      ort_value = *(session_options.initializers_to_share_map.at(name));
+    if (user_supplied_initializer_ids.find(entry.first) == user_supplied_initializer_ids.end()) {
+      if (in_place_initializer_ids.find(entry.first) != in_place_initializer_ids.end()) {
+        initializer.buffer = onnxruntime::make_unique<MemBuffer>(nullptr, 0, exec_plan.GetLocation(entry.first));
+      } else {
+        // TODO: if the tensor need be copied, does it have enough room?
+        ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(entry.first, name, initializer.buffer));
+      }
+#ifndef NDEBUG
+      ORT_ENFORCE(initializer.buffer != nullptr);
+      ORT_ENFORCE(initializer.buffer->GetBuffer() != nullptr || initializer.buffer->GetLen() == 0);
+#endif
+      if (IsCpuLocation(initializer.buffer->GetAllocInfo())) {
+        cpu_initializer_indices.push_back(i);
+      }
+    }
+
+    ++i;
+  }
+
+  const auto deserialize = [&](InitializerToSave& initializer) {
+    ORT_TRY {
+      initializer.status = DeserializeTensorProto(env, graph_loc, *initializer.tensor_proto, *initializer.buffer,
+                                                  default_cpu_memory_info, initializer.ort_value,
+                                                  initializer.deleter, data_transfer_mgr);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        initializer.status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+      });
+    }
+  };
+
+  // reading external data and unpacking the raw data of initializers in CPU memory is independent for each
+  // initializer, so do it in parallel. copies to other devices stay on this thread.
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(cpu_initializer_indices.size()),
+      [&](std::ptrdiff_t idx) { deserialize(initializers_to_save[cpu_initializer_indices[idx]]); });
+
+  for (auto& initializer : initializers_to_save) {
+    const char* name = (initializer.tensor_proto->name().empty()) ? "" : initializer.tensor_proto->name().c_str();
+
+    if (initializer.buffer == nullptr) {
+      initializer.ort_value = *(session_options.initializers_to_share_map.at(name));
       LOGS(logger, INFO) << "Using user supplied initializer with name (" << name << ").";
     } else {
-      const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
+      if (!IsCpuLocation(initializer.buffer->GetAllocInfo())) {
+        deserialize(initializer);
+      }
 
-      std::unique_ptr<MemBuffer> m;
-      // TODO: if the tensor need be copied, does it have enough room?
-      ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, m));
-#ifndef NDEBUG
-      ORT_ENFORCE(m != nullptr);
-      ORT_ENFORCE(m->GetBuffer() != nullptr || m->GetLen() == 0);
-#endif
-      Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, *m, default_cpu_memory_info, ort_value, deleter,
-                                         data_transfer_mgr);
+      const Status& st = initializer.status;
       if (!st.IsOK()) {
         std::ostringstream oss;
         oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
@@ -193,9 +256,10 @@ common::Status SaveInitializedTensors(
     // any outer scope value is shadowed by a local value and can't override it.
     // due to that check_outer_scope is false
     bool constant = graph.IsConstantInitializer(name, /* check_outer_scope */ false);
-    ORT_RETURN_IF_ERROR(save_tensor_func(ort_value_index, ort_value, deleter, constant));
+    ORT_RETURN_IF_ERROR(save_tensor_func(initializer.ort_value_index, initializer.ort_value, initializer.deleter,
+                                         constant));
 
-    VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << ort_value_index;
+    VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << initializer.ort_value_index;
   }
 
   LOGS(logger, INFO) << "Done saving initialized tensors";
@@ -385,6 +385,79 @@ static void DeleteCharArray(void* param) noexcept {
   delete[] arr;
 }
 
+void SetExternalDataInMemory(ONNX_NAMESPACE::TensorProto& tensor_proto, const void* data, size_t data_length) {
+  tensor_proto.clear_raw_data();
+  tensor_proto.clear_external_data();
+  tensor_proto.set_data_location(TensorProto_DataLocation_EXTERNAL);
+
+  auto* location = tensor_proto.add_external_data();
+  location->set_key("location");
+  location->set_value(kTensorProtoMemoryAddressTag);
+  auto* offset = tensor_proto.add_external_data();
+  offset->set_key("offset");
+  offset->set_value(std::to_string(reinterpret_cast<uintptr_t>(data)));
+  auto* length = tensor_proto.add_external_data();
+  length->set_key("length");
+  length->set_value(std::to_string(data_length));
+}
+
+bool HasExternalDataInMemory(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  if (tensor_proto.data_location() != TensorProto_DataLocation_EXTERNAL) {
+    return false;
+  }
+
+  for (const auto& entry : tensor_proto.external_data()) {
+    if (entry.key() == "location") {
+      return entry.value() == kTensorProtoMemoryAddressTag;
+    }
+  }
+
+  return false;
+}
+
+Status GetExternalDataInMemory(const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                               const void*& data, size_t& data_length) {
+  ORT_RETURN_IF_NOT(HasExternalDataInMemory(tensor_proto), "Tensor ", tensor_proto.name(),
+                    " doesn't have external data in memory.");
+
+  std::unique_ptr<ExternalDataInfo> external_data_info;
+  ORT_RETURN_IF_ERROR(ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info));
+  data = reinterpret_cast<const void*>(static_cast<uintptr_t>(external_data_info->GetOffset()));
+  data_length = external_data_info->GetLength();
+  return Status::OK();
+}
+
+// kernels may rely on the natural alignment of the elements
+static bool IsAlignedForElementType(const void* data, const DataTypeImpl& element_type) {
+  return reinterpret_cast<uintptr_t>(data) % element_type.Size() == 0;
+}
+
+bool CanUseTensorProtoDataInPlace(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  if (endian::native != endian::little ||
+      tensor_proto.data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING ||
+      tensor_proto.data_location() != TensorProto_DataLocation_EXTERNAL) {
+    return false;
+  }
+
+  const auto* type = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType();
+
+  if (HasExternalDataInMemory(tensor_proto)) {
+    const void* data = nullptr;
+    size_t data_length = 0;
+    size_t expected_length = 0;
+    return GetExternalDataInMemory(tensor_proto, data, data_length).IsOK() &&
+           GetSizeInBytesFromTensorProto<0>(tensor_proto, &expected_length).IsOK() &&
+           data_length == expected_length &&
+           IsAlignedForElementType(data, *type);
+  }
+
+  // external data in a file is memory mapped, or read into a new buffer if mapping fails. a mapping starts at a page
+  // boundary, so the data is aligned if its offset in the file is.
+  std::unique_ptr<ExternalDataInfo> external_data_info;
+  return ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info).IsOK() &&
+         external_data_info->GetOffset() % static_cast<int64_t>(type->Size()) == 0;
+}
+
 static Status GetFileContent(
     const Env& env, const ORTCHAR_T* file_path, FileOffsetType offset, size_t length,
     void*& raw_buffer, OrtCallback& deleter) {
@@ -437,7 +510,15 @@ Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
   AutoDelete deleter_for_file_data;
   void* tensor_data;
   {
-    if (tensor_proto.data_location() == TensorProto_DataLocation_EXTERNAL) {
+    if (HasExternalDataInMemory(tensor_proto)) {
+      if (ele_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING)
+        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "string tensor can not have raw data");
+
+      const void* external_data = nullptr;
+      ORT_RETURN_IF_ERROR(GetExternalDataInMemory(tensor_proto, external_data, raw_data_len));
+      // the data is only read from, unless it has to be copied into the preallocated buffer below
+      raw_data = const_cast<void*>(external_data);
+    } else if (tensor_proto.data_location() == TensorProto_DataLocation_EXTERNAL) {
       if (ele_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING)
         return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "string tensor can not have raw data");
 
@@ -467,7 +548,11 @@ Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
       //raw_data = buffer.release();
       raw_data_len = tensor_proto.raw_data().size();
     }
-    if (endian::native == endian::little && raw_data != nullptr && deleter_for_file_data.d.f != nullptr) {
+    // use the mapped or loaded file data, or the data in memory, in place unless it is misaligned. a misaligned
+    // mapping is copied into the preallocated buffer and unmapped.
+    if (endian::native == endian::little && raw_data != nullptr &&
+        (deleter_for_file_data.d.f != nullptr || CanUseTensorProtoDataInPlace(tensor_proto)) &&
+        IsAlignedForElementType(raw_data, *type)) {
       tensor_data = raw_data;
       MoveOrtCallback(deleter_for_file_data.d, deleter);
     } else {
@@ -842,8 +927,8 @@ template common::Status GetSizeInBytesFromTensorProto<0>(const ONNX_NAMESPACE::T
 #define CASE_UNPACK(TYPE, ELEMENT_TYPE, DATA_SIZE)                              \
   case ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_##TYPE: {     \
     size_t element_count = 0;                                                   \
-    if (initializer.has_raw_data()) {                                           \
-      tensor_byte_size = initializer.raw_data().size();                         \
+    if (raw_data != nullptr) {                                                  \
+      tensor_byte_size = raw_data_len;                                          \
       element_count = tensor_byte_size / sizeof(ELEMENT_TYPE);                  \
     } else {                                                                    \
       element_count = initializer.DATA_SIZE();                                  \
@@ -851,9 +936,7 @@ template common::Status GetSizeInBytesFromTensorProto<0>(const ONNX_NAMESPACE::T
     }                                                                           \
     unpacked_tensor.reset(new uint8_t[tensor_byte_size]);                       \
     return onnxruntime::utils::UnpackTensor(                                    \
-        initializer,                                                            \
-        initializer.has_raw_data() ? initializer.raw_data().data() : nullptr,   \
-        initializer.has_raw_data() ? initializer.raw_data().size() : 0,         \
+        initializer, raw_data, raw_data_len,                                    \
         reinterpret_cast<ELEMENT_TYPE*>(unpacked_tensor.get()), element_count); \
     break;                                                                      \
   }
@@ -861,6 +944,15 @@ template common::Status GetSizeInBytesFromTensorProto<0>(const ONNX_NAMESPACE::T
 Status UnpackInitializerData(const onnx::TensorProto& initializer,
                              std::unique_ptr<uint8_t[]>& unpacked_tensor,
                              size_t& tensor_byte_size) {
+  const void* raw_data = nullptr;
+  size_t raw_data_len = 0;
+  if (HasExternalDataInMemory(initializer)) {
+    ORT_RETURN_IF_ERROR(GetExternalDataInMemory(initializer, raw_data, raw_data_len));
+  } else if (initializer.has_raw_data()) {
+    raw_data = initializer.raw_data().data();
+    raw_data_len = initializer.raw_data().size();
+  }
+
   switch (initializer.data_type()) {
     CASE_UNPACK(FLOAT, float, float_data_size);
     CASE_UNPACK(DOUBLE, double, double_data_size);
@@ -40,6 +40,23 @@ common::Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_prot
                                     const ONNX_NAMESPACE::TensorProto& input, const MemBuffer& m, OrtValue& value,
                                     OrtCallback& deleter);
 
+// Value of the 'location' of external data that is already in memory. The 'offset' is the address of the data.
+// Used by initializers of ORT format models that reference the model bytes instead of a copy of them.
+constexpr const char* kTensorProtoMemoryAddressTag = "*/_ORT_MEM_ADDR_/*";
+
+// Sets the external data of tensor_proto to the data_length bytes at data, which must outlive tensor_proto.
+void SetExternalDataInMemory(ONNX_NAMESPACE::TensorProto& tensor_proto, const void* data, size_t data_length);
+
+bool HasExternalDataInMemory(const ONNX_NAMESPACE::TensorProto& tensor_proto);
+
+common::Status GetExternalDataInMemory(const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                       const void*& data, size_t& data_length);
+
+// Returns true if TensorProtoToMLValue creates the tensor from the data of tensor_proto in place when deserializing
+// to CPU, so it doesn't need a preallocated buffer. This is the case for little-endian external data that is in
+// memory or in a file, which is memory mapped, if the data is aligned for the element type.
+bool CanUseTensorProtoDataInPlace(const ONNX_NAMESPACE::TensorProto& tensor_proto);
+
 /** Creates a TensorProto from a Tensor.
     @param[in] tensor the Tensor whose data and shape will be used to create the TensorProto.
     @param[in] tensor_proto_name the name of the TensorProto.
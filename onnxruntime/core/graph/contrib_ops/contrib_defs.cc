@@ -407,6 +407,10 @@ where value of each element is the end position, or valid length of actual seque
 left-side padding, mask_index has shape (2 * batch_size), where the values are the exclusive end positions followed by
 the inclusive start positions. When unidirectional is 1, and each token only attend to previous tokens. For GPT-2, both past
 and present state are optional. Present state could appear in output even when past state is not in input.
+When past_present_share_buffer is 1, past and present have shape (2, batch_size, num_heads, max_sequence_length, head_size)
+and the past_sequence_length input gives the number of positions in past that hold state. The key and value of the new
+tokens are written to present after them, and the other positions keep the values from past. Binding the same buffer
+to past and present (e.g. with IOBinding) updates the state in place, so each step only writes the new tokens.
 )DOC";
 
   ONNX_CONTRIB_OPERATOR_SCHEMA(Attention)
@@ -418,11 +422,17 @@ and present state are optional. Present state could appear in output even when p
             "Whether every token can only attend to previous tokens. Default value is 0.",
             AttributeProto::INT,
             static_cast<int64_t>(0))
+      .Attr("past_present_share_buffer",
+            "Whether past and present have the same shape with max_sequence_length positions, so they can share a buffer. "
+            "Requires the past and past_sequence_length inputs. Default value is 0.",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
       .Input(0, "input", "3D input tensor with shape (batch_size, sequence_length, hidden_size), hidden_size = num_heads * head_size", "T")
       .Input(1, "weight", "2D input tensor with shape (hidden_size, 3 * hidden_size)", "T")
       .Input(2, "bias", "1D input tensor with shape (3 * hidden_size)", "T")
       .Input(3, "mask_index", "Attention mask with shape (batch_size, past_sequence_length + sequence_length), or index with shape (batch_size) or (2 * batch_size).", "M", OpSchema::Optional)
-      .Input(4, "past", "past state for key and value with shape (2, batch_size, num_heads, past_sequence_length, head_size).", "T", OpSchema::Optional)
+      .Input(4, "past", "past state for key and value with shape (2, batch_size, num_heads, past_sequence_length, head_size), or (2, batch_size, num_heads, max_sequence_length, head_size) when past_present_share_buffer is 1.", "T", OpSchema::Optional)
+      .Input(5, "past_sequence_length", "Number of positions in past that hold state, with shape (1). Only used when past_present_share_buffer is 1.", "M", OpSchema::Optional)
       .Output(0, "output", "3D output tensor with shape (batch_size, append_length, hidden_size)", "T")
       .Output(1, "present", "present state for key and value with shape (2, batch_size, num_heads, past_sequence_length + sequence_length, head_size)", "T", OpSchema::Optional)
       .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float tensors.")
@@ -450,7 +460,9 @@ and present state are optional. Present state could appear in output even when p
                 fail_shape_inference("Inputs 4 shall be 5 dimensions");
               }
 
-              if (past_dims[3].has_dim_value() && input_dims[1].has_dim_value()) {
+              if (getAttribute(ctx, "past_present_share_buffer", 0) == 1) {
+                propagateShapeFromInputToOutput(ctx, 4, 1);
+              } else if (past_dims[3].has_dim_value() && input_dims[1].has_dim_value()) {
                 auto all_sequence_length = past_shape.dim(3).dim_value() + input_shape.dim(1).dim_value();
 
                 ONNX_NAMESPACE::TensorShapeProto present_shape;
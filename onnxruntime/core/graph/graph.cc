@@ -3439,9 +3439,11 @@ Status Graph::LoadFromOrtFormat(
     const onnxruntime::experimental::fbs::Graph& fbs_graph,
     const Model& owning_model,
     const std::unordered_map<std::string, int>& domain_to_version,
-    const logging::Logger& logger, std::unique_ptr<Graph>& graph) {
+    const logging::Logger& logger, bool can_use_flatbuffer_for_initializers,
+    std::unique_ptr<Graph>& graph) {
   // can't use make_unique as we're calling a private ctor
   graph.reset(new Graph(owning_model, domain_to_version, nullptr, nullptr, logger));
+  graph->can_use_flatbuffer_for_initializers_ = can_use_flatbuffer_for_initializers;
 
   ORT_RETURN_IF_ERROR(graph->LoadFromOrtFormat(fbs_graph));
 
@@ -3465,6 +3467,7 @@ Status Graph::LoadFromOrtFormat(const onnxruntime::experimental::fbs::Graph& fbs
   graph.reset(new Graph(parent_graph.owning_model_,
                         parent_graph.domain_to_version_, &parent_graph, &parent_node,
                         logger));
+  graph->can_use_flatbuffer_for_initializers_ = parent_graph.can_use_flatbuffer_for_initializers_;
 
   return graph->LoadFromOrtFormat(fbs_graph);
 }
@@ -3503,7 +3506,8 @@ common::Status Graph::LoadFromOrtFormat(const onnxruntime::experimental::fbs::Gr
     for (const auto* fbs_tensor : *fbs_initializers) {
       ORT_RETURN_IF(nullptr == fbs_tensor, "Initializer tensor is missing. Invalid ORT format model.");
       TensorProto* initializer = deserialized_proto_data_.add_initializer();
-      ORT_RETURN_IF_ERROR(experimental::utils::LoadInitializerOrtFormat(*fbs_tensor, *initializer));
+      ORT_RETURN_IF_ERROR(experimental::utils::LoadInitializerOrtFormat(*fbs_tensor, *initializer,
+                                                                        can_use_flatbuffer_for_initializers_));
       name_to_initial_tensor_[initializer->name()] = initializer;
     }
   }
@@ -18,6 +18,10 @@ namespace utils {
 
 #if !defined(ORT_MINIMAL_BUILD)
 
+// Alignment of the raw data of initializers, so a loaded model can use the data in place.
+// See LoadInitializerOrtFormat.
+static constexpr size_t kInitializerRawDataAlignment = 64;
+
 Status SaveInitializerOrtFormat(flatbuffers::FlatBufferBuilder& builder,
                                 const TensorProto& initializer,
                                 flatbuffers::Offset<fbs::Tensor>& fbs_tensor) {
@@ -40,6 +44,7 @@ Status SaveInitializerOrtFormat(flatbuffers::FlatBufferBuilder& builder,
     size_t tensor_byte_size = 0;
     ORT_RETURN_IF_ERROR(
         onnxruntime::utils::UnpackInitializerData(initializer, unpacked_tensor, tensor_byte_size));
+    builder.ForceVectorAlignment(tensor_byte_size, sizeof(uint8_t), kInitializerRawDataAlignment);
     raw_data = builder.CreateVector(unpacked_tensor.get(), tensor_byte_size);
   }
 
@@ -142,7 +147,8 @@ Status SaveAttributeOrtFormat(flatbuffers::FlatBufferBuilder& builder,
 #if defined(ENABLE_ORT_FORMAT_LOAD)
 
 Status LoadInitializerOrtFormat(const fbs::Tensor& fbs_tensor,
-                                TensorProto& initializer) {
+                                TensorProto& initializer,
+                                bool can_use_flatbuffer_for_initializers) {
   initializer.Clear();
 
   LOAD_STR_FROM_ORT_FORMAT(initializer, name, fbs_tensor.name());
@@ -167,7 +173,12 @@ Status LoadInitializerOrtFormat(const fbs::Tensor& fbs_tensor,
     ORT_RETURN_IF(nullptr == fbs_raw_data, "Missing raw data for initializer. Invalid ORT format model.");
 
     // fbs_raw_data is uint8_t vector, so the size is byte size
-    initializer.set_raw_data(fbs_raw_data->Data(), fbs_raw_data->size());
+    if (can_use_flatbuffer_for_initializers) {
+      // reference the data in the flatbuffer, which the session creates tensors from in place if it is aligned
+      onnxruntime::utils::SetExternalDataInMemory(initializer, fbs_raw_data->Data(), fbs_raw_data->size());
+    } else {
+      initializer.set_raw_data(fbs_raw_data->Data(), fbs_raw_data->size());
+    }
   }
 
   return Status::OK();
@@ -47,8 +47,12 @@ onnxruntime::common::Status SaveAttributeOrtFormat(
 
 #if defined(ENABLE_ORT_FORMAT_LOAD)
 
+// Load a given fbs::Tensor into TensorProto
+// Note, if can_use_flatbuffer_for_initializers is true, the raw data of the initializer is not copied and
+//       initializer references it as external data in memory. fbs_tensor must outlive initializer in that case.
 onnxruntime::common::Status LoadInitializerOrtFormat(
-    const fbs::Tensor& fbs_tensor, ONNX_NAMESPACE::TensorProto& initializer);
+    const fbs::Tensor& fbs_tensor, ONNX_NAMESPACE::TensorProto& initializer,
+    bool can_use_flatbuffer_for_initializers = false);
 
 // Load a give fbs::Attribute into AttributeProto
 // Note, If the attribute type is a graph, we will leave an empty graph in attr_proto,
@@ -39,6 +39,57 @@ namespace onnxruntime {
 
 static constexpr int DEFAULT_PROTOBUF_BLOCK_SIZE = 4 * 1024 * 1024;
 
+// Only the ORT format loader marks tensors as having external data in memory, for bytes it keeps mapped for the
+// lifetime of the session. In a ModelProto the offset would be an arbitrary address in the process, so the marker
+// is rejected wherever a tensor can appear.
+static Status ValidateNoExternalDataInMemory(const TensorProto& tensor_proto) {
+  if (utils::HasExternalDataInMemory(tensor_proto)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Tensor ", tensor_proto.name(),
+                           " has external data with the reserved location ", utils::kTensorProtoMemoryAddressTag,
+                           ". The location is only valid within ONNX Runtime.");
+  }
+  return Status::OK();
+}
+
+static Status ValidateNoExternalDataInMemory(const SparseTensorProto& sparse_tensor_proto) {
+  ORT_RETURN_IF_ERROR(ValidateNoExternalDataInMemory(sparse_tensor_proto.values()));
+  return ValidateNoExternalDataInMemory(sparse_tensor_proto.indices());
+}
+
+static Status ValidateNoExternalDataInMemory(const GraphProto& graph_proto) {
+  for (const auto& initializer : graph_proto.initializer()) {
+    ORT_RETURN_IF_ERROR(ValidateNoExternalDataInMemory(initializer));
+  }
+  for (const auto& sparse_initializer : graph_proto.sparse_initializer()) {
+    ORT_RETURN_IF_ERROR(ValidateNoExternalDataInMemory(sparse_initializer));
+  }
+
+  for (const auto& node : graph_proto.node()) {
+    for (const auto& attr : node.attribute()) {
+      if (attr.has_t()) {
+        ORT_RETURN_IF_ERROR(ValidateNoExternalDataInMemory(attr.t()));
+      }
+      for (const auto& tensor : attr.tensors()) {
+        ORT_RETURN_IF_ERROR(ValidateNoExternalDataInMemory(tensor));
+      }
+      if (attr.has_sparse_tensor()) {
+        ORT_RETURN_IF_ERROR(ValidateNoExternalDataInMemory(attr.sparse_tensor()));
+      }
+      for (const auto& sparse_tensor : attr.sparse_tensors()) {
+        ORT_RETURN_IF_ERROR(ValidateNoExternalDataInMemory(sparse_tensor));
+      }
+      if (attr.has_g()) {
+        ORT_RETURN_IF_ERROR(ValidateNoExternalDataInMemory(attr.g()));
+      }
+      for (const auto& subgraph : attr.graphs()) {
+        ORT_RETURN_IF_ERROR(ValidateNoExternalDataInMemory(subgraph));
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
 Model::Model(const std::string& graph_name,
              bool is_onnx_domain_only,
              const ModelMetaData& model_metadata,
@@ -110,6 +161,8 @@ Model::Model(ModelProto&& model_proto, const PathString& model_path, const IOnnx
     ORT_THROW("Unknown model file format version.");
   }
 
+  ORT_THROW_IF_ERROR(ValidateNoExternalDataInMemory(model_proto.graph()));
+
   model_proto_ = std::move(model_proto);
   for (auto& prop : model_proto_.metadata_props()) {
     model_metadata_[prop.key()] = prop.value();
@@ -459,13 +512,8 @@ Status Model::LoadFromBytes(int count, void* p_bytes, const PathString& model_pa
     return status;
   }
 
-  p_model = std::make_shared<Model>(std::move(model_proto), model_path, local_registries, logger);
-
-  Graph::ResolveOptions options;
-  options.no_proto_sync_required = true;
-  ORT_RETURN_IF_ERROR(p_model->MainGraph().Resolve(options));
-
-  return Status::OK();
+  // errors in the model are returned rather than thrown
+  return Load(std::move(model_proto), model_path, p_model, local_registries, logger);
 }
 
 using ::google::protobuf::io::CodedInputStream;
@@ -517,13 +565,8 @@ Status Model::Load(int fd, const PathString& model_path, std::shared_ptr<Model>&
 
   ORT_RETURN_IF_ERROR(Load(fd, model_proto));
 
-  p_model = std::make_shared<Model>(std::move(model_proto), model_path, local_registries, logger);
-
-  Graph::ResolveOptions options;
-  options.no_proto_sync_required = true;
-  ORT_RETURN_IF_ERROR(p_model->MainGraph().Resolve(options));
-
-  return Status::OK();
+  // errors in the model are returned rather than thrown
+  return Load(std::move(model_proto), model_path, p_model, local_registries, logger);
 }
 
 Status Model::Save(Model& model, int p_fd) {
@@ -590,6 +633,7 @@ Model::Model() : model_path_{} {
 #if defined(ENABLE_ORT_FORMAT_LOAD)
 common::Status Model::LoadFromOrtFormat(const fbs::Model& fbs_model,
                                         const logging::Logger& logger,
+                                        bool can_use_flatbuffer_for_initializers,
                                         std::unique_ptr<Model>& model) {
   model.reset(new Model());
 
@@ -615,7 +659,8 @@ common::Status Model::LoadFromOrtFormat(const fbs::Model& fbs_model,
   auto fbs_graph = fbs_model.graph();
   ORT_RETURN_IF(nullptr == fbs_graph, "Graph is null. Invalid ORT format model.");
 
-  ORT_RETURN_IF_ERROR(Graph::LoadFromOrtFormat(*fbs_graph, *model, domain_to_version, logger, model->graph_));
+  ORT_RETURN_IF_ERROR(Graph::LoadFromOrtFormat(*fbs_graph, *model, domain_to_version, logger,
+                                               can_use_flatbuffer_for_initializers, model->graph_));
 
   return Status::OK();
 }
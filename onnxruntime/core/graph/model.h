@@ -229,8 +229,11 @@ class Model {
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 #if defined(ENABLE_ORT_FORMAT_LOAD)
+  // If can_use_flatbuffer_for_initializers is true, initializers reference the data in fbs_model instead of copying
+  // it, so the flatbuffer must outlive the Model.
   static common::Status LoadFromOrtFormat(const onnxruntime::experimental::fbs::Model& fbs_model,
                                           const logging::Logger& logger,
+                                          bool can_use_flatbuffer_for_initializers,
                                           std::unique_ptr<Model>& model);
 #endif
 
@@ -281,6 +281,36 @@ MlasGemm(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Single precision matrix/matrix multiply routines where the packed matrix B
+// holds half precision or bfloat16 elements. The elements are converted back
+// to single precision as each panel of matrix B is used, so the packed buffer
+// needs half the memory of a single precision packed buffer.
+//
+
+enum MLAS_HALF_FORMAT {
+    MlasHalfFormatFloat16,
+    MlasHalfFormatBFloat16,
+};
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    MLAS_HALF_FORMAT PackedBFormat,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Buffer packing routines.
 //
@@ -322,6 +352,26 @@ MlasGemmPackB(
     void* PackedB
     );
 
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K,
+    MLAS_HALF_FORMAT PackedBFormat
+    );
+
+void
+MLASCALL
+MlasGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    MLAS_HALF_FORMAT PackedBFormat,
+    void* PackedB
+    );
+
 //
 // Convolution routines.
 //
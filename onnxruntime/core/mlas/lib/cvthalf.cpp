@@ -0,0 +1,132 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    cvthalf.cpp
+
+Abstract:
+
+    This module implements the portable routines to convert half precision
+    (IEEE 754 binary16) and bfloat16 values to single precision.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasConvertFloat16ToFloatKernel(
+    const uint16_t* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of half precision values to the
+    destination buffer of single precision values.
+
+Arguments:
+
+    Source - Supplies the source buffer of half precision values.
+
+    Destination - Supplies the destination buffer of single precision values.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Count > 0) {
+
+        const uint32_t Half = *Source++;
+        const uint32_t Sign = (Half & 0x8000) << 16;
+        uint32_t Exponent = (Half >> 10) & 0x1F;
+        uint32_t Mantissa = Half & 0x3FF;
+        uint32_t Bits;
+
+        if (Exponent == 0x1F) {
+
+            //
+            // Infinity or NaN.
+            //
+
+            Bits = Sign | 0x7F800000 | (Mantissa << 13);
+
+        } else if (Exponent != 0) {
+
+            Bits = Sign | ((Exponent + (127 - 15)) << 23) | (Mantissa << 13);
+
+        } else if (Mantissa != 0) {
+
+            //
+            // Denormal values are normalized in single precision.
+            //
+
+            Exponent = 127 - 15 + 1;
+
+            do {
+                Mantissa <<= 1;
+                Exponent--;
+            } while ((Mantissa & 0x400) == 0);
+
+            Bits = Sign | (Exponent << 23) | ((Mantissa & 0x3FF) << 13);
+
+        } else {
+
+            Bits = Sign;
+        }
+
+        memcpy(Destination++, &Bits, sizeof(float));
+        Count--;
+    }
+}
+
+void
+MLASCALL
+MlasConvertBFloat16ToFloatKernel(
+    const uint16_t* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of bfloat16 values to the
+    destination buffer of single precision values.
+
+Arguments:
+
+    Source - Supplies the source buffer of bfloat16 values.
+
+    Destination - Supplies the destination buffer of single precision values.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Count > 0) {
+
+        //
+        // A bfloat16 value is the upper half of a single precision value.
+        //
+
+        const uint32_t Bits = uint32_t(*Source++) << 16;
+
+        memcpy(Destination++, &Bits, sizeof(float));
+        Count--;
+    }
+}
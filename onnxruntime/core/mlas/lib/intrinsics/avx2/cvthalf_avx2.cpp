@@ -0,0 +1,120 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    cvthalf_avx2.cpp
+
+Abstract:
+
+    This module implements the routines to convert half precision (IEEE 754
+    binary16) and bfloat16 values to single precision using F16C and AVX2
+    intrinsics.
+
+--*/
+
+#include "../../mlasi.h"
+
+void
+MLASCALL
+MlasConvertFloat16ToFloatKernelF16C(
+    const uint16_t* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of half precision values to the
+    destination buffer of single precision values.
+
+Arguments:
+
+    Source - Supplies the source buffer of half precision values.
+
+    Destination - Supplies the destination buffer of single precision values.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Count >= 16) {
+
+        __m256 v0 = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)Source));
+        __m256 v1 = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(Source + 8)));
+
+        _mm256_storeu_ps(Destination, v0);
+        _mm256_storeu_ps(Destination + 8, v1);
+
+        Source += 16;
+        Destination += 16;
+        Count -= 16;
+    }
+
+    if (Count >= 8) {
+
+        _mm256_storeu_ps(Destination, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)Source)));
+
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    if (Count > 0) {
+        MlasConvertFloat16ToFloatKernel(Source, Destination, Count);
+    }
+}
+
+void
+MLASCALL
+MlasConvertBFloat16ToFloatKernelAvx2(
+    const uint16_t* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of bfloat16 values to the
+    destination buffer of single precision values.
+
+Arguments:
+
+    Source - Supplies the source buffer of bfloat16 values.
+
+    Destination - Supplies the destination buffer of single precision values.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Count >= 16) {
+
+        __m256i v0 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)Source));
+        __m256i v1 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(Source + 8)));
+
+        _mm256_storeu_ps(Destination, _mm256_castsi256_ps(_mm256_slli_epi32(v0, 16)));
+        _mm256_storeu_ps(Destination + 8, _mm256_castsi256_ps(_mm256_slli_epi32(v1, 16)));
+
+        Source += 16;
+        Destination += 16;
+        Count -= 16;
+    }
+
+    if (Count > 0) {
+        MlasConvertBFloat16ToFloatKernel(Source, Destination, Count);
+    }
+}
@@ -119,6 +119,7 @@ Abstract:
 #define MLAS_SGEMM_STRIDEK                          128
 #define MLAS_SGEMM_PACKED_STRIDEN                   128
 #define MLAS_SGEMM_PACKED_STRIDEK                   256
+#define MLAS_SGEMM_HALF_PACKED_STRIDEN              64
 #define MLAS_DGEMM_STRIDEN                          64
 #define MLAS_DGEMM_STRIDEK                          128
 
@@ -489,6 +490,16 @@ void
 
 typedef MLAS_QLINEAR_BINARY_OP_U8_KERNEL* PMLAS_QLINEAR_BINARY_OP_U8_KERNEL;
 
+typedef
+void
+(MLASCALL MLAS_CONVERT_HALF_TO_FLOAT_KERNEL)(
+    const uint16_t* Source,
+    float* Destination,
+    size_t Count
+    );
+
+typedef MLAS_CONVERT_HALF_TO_FLOAT_KERNEL* PMLAS_CONVERT_HALF_TO_FLOAT_KERNEL;
+
 extern "C" {
 
 #if defined(MLAS_TARGET_AMD64_IX86)
@@ -593,6 +604,13 @@ extern "C" {
     MLAS_QLINEAR_BINARY_OP_U8_KERNEL MlasQLinearAddU8KernelAvx2;
 #endif
 
+    MLAS_CONVERT_HALF_TO_FLOAT_KERNEL MlasConvertFloat16ToFloatKernel;
+    MLAS_CONVERT_HALF_TO_FLOAT_KERNEL MlasConvertBFloat16ToFloatKernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_CONVERT_HALF_TO_FLOAT_KERNEL MlasConvertFloat16ToFloatKernelF16C;
+    MLAS_CONVERT_HALF_TO_FLOAT_KERNEL MlasConvertBFloat16ToFloatKernelAvx2;
+#endif
+
     MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL MlasReduceMaximumF32Kernel;
     MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL MlasReduceMinimumMaximumF32Kernel;
 #if defined(MLAS_TARGET_AMD64)
@@ -703,6 +721,8 @@ struct MLAS_PLATFORM {
     PMLAS_COMPUTE_UNARY_FLOAT_KERNEL ErfKernelRoutine;
     PMLAS_QLINEAR_BINARY_OP_S8_KERNEL QLinearAddS8Kernel;
     PMLAS_QLINEAR_BINARY_OP_U8_KERNEL QLinearAddU8Kernel;
+    PMLAS_CONVERT_HALF_TO_FLOAT_KERNEL ConvertFloat16ToFloatKernel;
+    PMLAS_CONVERT_HALF_TO_FLOAT_KERNEL ConvertBFloat16ToFloatKernel;
     PMLAS_COMPUTE_UNARY_FLOAT_KERNEL ComputeExpF32Kernel;
     PMLAS_COMPUTE_UNARY_FLOAT_KERNEL LogisticKernelRoutine;
     PMLAS_COMPUTE_UNARY_FLOAT_KERNEL TanhKernelRoutine;
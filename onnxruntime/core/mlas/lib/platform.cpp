@@ -140,6 +140,8 @@ Return Value:
     this->ReduceMinimumMaximumF32Kernel = MlasReduceMinimumMaximumF32Kernel;
     this->QLinearAddS8Kernel = MlasQLinearAddS8Kernel;
     this->QLinearAddU8Kernel = MlasQLinearAddU8Kernel;
+    this->ConvertFloat16ToFloatKernel = MlasConvertFloat16ToFloatKernel;
+    this->ConvertBFloat16ToFloatKernel = MlasConvertBFloat16ToFloatKernel;
 
     this->NchwcBlockSize = 8;
     this->PreferredBufferAlignment = MLAS_DEFAULT_PREFERRED_BUFFER_ALIGNMENT;
@@ -221,6 +223,15 @@ Return Value:
                 this->QLinearAddS8Kernel = MlasQLinearAddS8KernelAvx2;
                 this->QLinearAddU8Kernel = MlasQLinearAddU8KernelAvx2;
                 this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelFma3;
+                this->ConvertBFloat16ToFloatKernel = MlasConvertBFloat16ToFloatKernelAvx2;
+
+                //
+                // Check if the processor supports the F16C feature.
+                //
+
+                if ((Cpuid1[2] & 0x20000000) != 0) {
+                    this->ConvertFloat16ToFloatKernel = MlasConvertFloat16ToFloatKernelF16C;
+                }
 
 #if !defined(MLAS_AVX512F_UNSUPPORTED)
 
@@ -48,6 +48,8 @@ struct MLAS_SGEMM_WORK_BLOCK {
     size_t ldc;
     float alpha;
     float beta;
+    bool PackedBIsHalf;
+    MLAS_HALF_FORMAT PackedBFormat;
 };
 
 void
@@ -1198,6 +1200,177 @@ Return Value:
     }
 }
 
+MLAS_FORCEINLINE
+void
+MlasSgemmConvertHalfToFloat(
+    MLAS_HALF_FORMAT Format,
+    const uint16_t* Source,
+    float* Destination,
+    size_t Count
+    )
+{
+#if defined(MLAS_TARGET_AMD64)
+    PMLAS_CONVERT_HALF_TO_FLOAT_KERNEL ConvertKernel = (Format == MlasHalfFormatFloat16) ?
+        MlasPlatform.ConvertFloat16ToFloatKernel : MlasPlatform.ConvertBFloat16ToFloatKernel;
+#else
+    PMLAS_CONVERT_HALF_TO_FLOAT_KERNEL ConvertKernel = (Format == MlasHalfFormatFloat16) ?
+        MlasConvertFloat16ToFloatKernel : MlasConvertBFloat16ToFloatKernel;
+#endif
+
+    ConvertKernel(Source, Destination, Count);
+}
+
+void
+MlasSgemmHalfPackedOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    MLAS_HALF_FORMAT PackedBFormat,
+    size_t AlignedN,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) with a half precision or bfloat16 packed matrix B.
+
+    Each panel of packed matrix B is converted to single precision in a local
+    buffer, which is then used for all rows of matrix A.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    RangeStartN - Supplies the starting column from packed matrix B.
+
+    RangeCountN - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of packed matrix B.
+
+    PackedBFormat - Supplies the format of the elements of packed matrix B.
+
+    AlignedN - Supplies the total number of aligned columns for packed matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_PACKED_STRIDEK];
+    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_HALF_PACKED_STRIDEN * MLAS_SGEMM_PACKED_STRIDEK], 16 * sizeof(float));
+
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
+
+    size_t CountN;
+
+    for (size_t n = 0; n < RangeCountN; n += CountN) {
+
+        const size_t SliceStartN = RangeStartN + n;
+
+        CountN = std::min(RangeCountN - n, size_t(MLAS_SGEMM_HALF_PACKED_STRIDEN));
+
+        //
+        // Multiply the output matrix by beta as needed.
+        //
+
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
+        }
+
+        //
+        // Step through each slice of matrix B along the K dimension.
+        //
+
+        size_t CountK;
+        bool ZeroMode = (beta == 0.0f);
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = std::min(K - k, size_t(MLAS_SGEMM_PACKED_STRIDEK));
+
+            //
+            // Convert the panel of packed matrix B to single precision. The
+            // packed columns are padded to a multiple of 16 columns.
+            //
+
+            const size_t AlignedCountN = (CountN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) &
+                ~(size_t(MLAS_SGEMM_STRIDEN_THREAD_ALIGN) - 1);
+
+            MlasSgemmConvertHalfToFloat(PackedBFormat,
+                (const uint16_t*)PackedB + AlignedN * k + CountK * SliceStartN, PanelB, AlignedCountN * CountK);
+
+            //
+            // Step through each slice of matrix A along the M dimension.
+            //
+
+            float* c = C + n;
+
+            if (TransA == CblasNoTrans) {
+
+                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+
+            } else {
+
+                const float* a = A + k * lda;
+                size_t RowsRemaining = M;
+
+                do {
+
+                    //
+                    // Transpose elements from matrix A into a local buffer.
+                    //
+
+                    size_t RowsTransposed = std::min(RowsRemaining, size_t(MLAS_SGEMM_TRANSA_ROWS));
+
+                    MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+
+                    RowsRemaining -= RowsTransposed;
+                    a += RowsTransposed;
+
+                    //
+                    // Step through the rows of the local buffer.
+                    //
+
+                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+
+                } while (RowsRemaining > 0);
+            }
+
+            ZeroMode = false;
+        }
+    }
+}
+
 void
 MlasSgemmThreaded(
     void* Context,
@@ -1282,6 +1455,12 @@ Return Value:
         MlasSgemmOperation(TransA, TransB, RangeCountM, RangeCountN, WorkBlock->K,
             WorkBlock->alpha, A, lda, B, ldb, WorkBlock->beta, C, ldc);
 
+    } else if (WorkBlock->PackedBIsHalf) {
+
+        MlasSgemmHalfPackedOperation(TransA, RangeCountM, RangeStartN, RangeCountN,
+            WorkBlock->K, WorkBlock->alpha, A, lda, WorkBlock->PackedB, WorkBlock->PackedBFormat,
+            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, WorkBlock->beta, C, ldc);
+
     } else {
 
         MlasSgemmPackedOperation(TransA, RangeCountM, RangeStartN, RangeCountN,
@@ -1548,6 +1727,96 @@ Return Value:
     MlasSgemmSchedule(&WorkBlock, ThreadPool);
 }
 
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    MLAS_HALF_FORMAT PackedBFormat,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) with a half precision or bfloat16 packed matrix B.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of packed matrix B. The buffer was packed
+        by MlasGemmPackB with the same PackedBFormat.
+
+    PackedBFormat - Supplies the format of the elements of packed matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SGEMM_WORK_BLOCK WorkBlock;
+
+    //
+    // Capture the GEMM parameters to the work block.
+    //
+
+    memset(&WorkBlock, 0, sizeof(MLAS_SGEMM_WORK_BLOCK));
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.PackedB = PackedB;
+    WorkBlock.PackedBIsHalf = true;
+    WorkBlock.PackedBFormat = PackedBFormat;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.alpha = alpha;
+    WorkBlock.beta = beta;
+
+    //
+    // Schedule the operation across a set of worker threads.
+    //
+
+    MlasSgemmSchedule(&WorkBlock, ThreadPool);
+}
+
 size_t
 MLASCALL
 MlasGemmPackBSize(
@@ -1648,3 +1917,215 @@ Return Value:
         PackedB = (float*)PackedB + AlignedN * CountK;
     }
 }
+
+MLAS_FORCEINLINE
+uint16_t
+MlasSgemmConvertFloatToHalf(
+    MLAS_HALF_FORMAT Format,
+    float Value
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a single precision value to half precision or
+    bfloat16, rounding to the nearest even value.
+
+Arguments:
+
+    Format - Supplies the format to convert to.
+
+    Value - Supplies the value to convert.
+
+Return Value:
+
+    Returns the converted value.
+
+--*/
+{
+    uint32_t Bits;
+    memcpy(&Bits, &Value, sizeof(float));
+
+    if (Format == MlasHalfFormatBFloat16) {
+
+        if ((Bits & 0x7FFFFFFF) > 0x7F800000) {
+            return uint16_t((Bits >> 16) | 0x40);
+        }
+
+        return uint16_t((Bits + 0x7FFF + ((Bits >> 16) & 1)) >> 16);
+    }
+
+    const uint32_t Sign = (Bits >> 16) & 0x8000;
+    Bits &= 0x7FFFFFFF;
+
+    if (Bits >= 0x7F800000) {
+
+        //
+        // Infinity or NaN.
+        //
+
+        return uint16_t(Sign | 0x7C00 | ((Bits > 0x7F800000) ? 0x200 : 0));
+    }
+
+    if (Bits >= 0x477FF000) {
+
+        //
+        // The value rounds to a magnitude larger than the largest half
+        // precision value.
+        //
+
+        return uint16_t(Sign | 0x7C00);
+    }
+
+    if (Bits < 0x38800000) {
+
+        //
+        // The value is a half precision denormal or zero. The mantissa is the
+        // value in units of 2^-24, which is exact in single precision before
+        // rounding.
+        //
+
+        float Magnitude;
+        memcpy(&Magnitude, &Bits, sizeof(float));
+
+        return uint16_t(Sign | uint32_t(std::nearbyint(Magnitude * 16777216.0f)));
+    }
+
+    //
+    // Round the mantissa to 10 bits and rebias the exponent.
+    //
+
+    Bits += 0xFFF + ((Bits >> 13) & 1);
+
+    return uint16_t(Sign | ((Bits - 0x38000000) >> 13));
+}
+
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K,
+    MLAS_HALF_FORMAT PackedBFormat
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the length in bytes for the half precision or
+    bfloat16 packed matrix B buffer.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    PackedBFormat - Supplies the format of the elements of packed matrix B.
+
+Return Value:
+
+    Returns the size in bytes for the packed matrix B buffer.
+
+--*/
+{
+    MLAS_UNREFERENCED_PARAMETER(PackedBFormat);
+
+    //
+    // Compute the number of bytes required to hold the packed buffer.
+    //
+
+    const size_t AlignedN =
+        (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+    const size_t BytesRequired = AlignedN * K * sizeof(uint16_t);
+    const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
+    const size_t AlignedBytesRequired = (BytesRequired + BufferAlignment - 1) &
+        ~(BufferAlignment - 1);
+
+    return AlignedBytesRequired;
+}
+
+void
+MLASCALL
+MlasGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    MLAS_HALF_FORMAT PackedBFormat,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the contents of matrix B to the destination buffer,
+    converting the elements to half precision or bfloat16. The destination
+    buffer should be sized based on MlasGemmPackBSize() with the same format.
+
+    The packed buffer has the same layout as the buffer from the single
+    precision MlasGemmPackB, so that each panel of it can be converted back to
+    the layout used by the SGEMM kernels with a plain buffer conversion.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedBFormat - Supplies the format of the elements of packed matrix B.
+
+    PackedB - Supplies the address of packed matrix B.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t AlignedN =
+        (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+    uint16_t* D = (uint16_t*)PackedB;
+
+    //
+    // Step through each slice of matrix B along the K dimension.
+    //
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = std::min(K - k, size_t(MLAS_SGEMM_PACKED_STRIDEK));
+
+        //
+        // Unroll columns of 16 elements to be physically contiguous. Any
+        // remaining columns less than 16 elements wide are zero-padded.
+        //
+
+        for (size_t n = 0; n < AlignedN; n += 16) {
+
+            for (size_t y = 0; y < CountK; y++) {
+
+                for (size_t x = 0; x < 16; x++) {
+
+                    float Value = 0.0f;
+
+                    if (n + x < N) {
+                        Value = (TransB == CblasNoTrans) ? B[(k + y) * ldb + n + x] :
+                            B[(n + x) * ldb + k + y];
+                    }
+
+                    *D++ = MlasSgemmConvertFloatToHalf(PackedBFormat, Value);
+                }
+            }
+        }
+    }
+}
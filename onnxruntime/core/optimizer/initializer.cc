@@ -18,6 +18,15 @@ Status Initializer::ReadExternalRawData(
           tensor_proto.data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING,
       "External data type must not be UNDEFINED or STRING.");
 
+  if (utils::HasExternalDataInMemory(tensor_proto)) {
+    const void* data = nullptr;
+    size_t data_length = 0;
+    ORT_RETURN_IF_ERROR(utils::GetExternalDataInMemory(tensor_proto, data, data_length));
+    const char* data_bytes = static_cast<const char*>(data);
+    raw_data.assign(data_bytes, data_bytes + data_length);
+    return Status::OK();
+  }
+
   ORT_RETURN_IF(
       model_path.IsEmpty(),
       "model_path must not be empty. Ensure that a path is provided when the model is created or loaded.");
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/zipmap_output_transformer.h"
+
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+Status ZipMapOutputTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                          const logging::Logger& logger) const {
+  // only the outputs of the main graph are returned to the caller
+  if (graph_level > 0) {
+    return Status::OK();
+  }
+
+  // the scores are copied to the output by an Identity node
+  const auto& domain_to_version = graph.DomainToVersionMap();
+  if (domain_to_version.find(kOnnxDomain) == domain_to_version.end()) {
+    return Status::OK();
+  }
+
+  std::vector<NodeIndex> zipmap_nodes;
+  for (const auto& node : graph.Nodes()) {
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "ZipMap", {1}, kMLDomain) &&
+        node.GetOutputEdgesCount() == 0 && graph.IsOutput(node.OutputDefs()[0]) &&
+        node.InputDefs()[0]->TypeAsProto() != nullptr) {
+      zipmap_nodes.push_back(node.Index());
+    }
+  }
+  if (zipmap_nodes.empty()) {
+    return Status::OK();
+  }
+
+  // labels output of each replaced output
+  std::unordered_map<const NodeArg*, const NodeArg*> labels_outputs;
+  for (NodeIndex index : zipmap_nodes) {
+    Node& node = *graph.GetNode(index);
+    NodeArg* scores = node.MutableInputDefs()[0];
+    NodeArg* output = node.MutableOutputDefs()[0];
+
+    TensorProto labels;
+    labels.set_name(graph.GenerateNodeArgName(output->Name() + "_labels"));
+    const auto* strings = graph_utils::GetNodeAttribute(node, "classlabels_strings");
+    if (strings != nullptr && strings->strings_size() > 0) {
+      labels.set_data_type(TensorProto_DataType_STRING);
+      *labels.mutable_string_data() = strings->strings();
+      labels.add_dims(strings->strings_size());
+    } else {
+      const auto* ints = graph_utils::GetNodeAttribute(node, "classlabels_int64s");
+      labels.set_data_type(TensorProto_DataType_INT64);
+      if (ints != nullptr) {
+        *labels.mutable_int64_data() = ints->ints();
+      }
+      labels.add_dims(labels.int64_data_size());
+    }
+
+    TypeProto labels_type;
+    labels_type.mutable_tensor_type()->set_elem_type(labels.data_type());
+    labels_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(labels.dims(0));
+    labels_outputs[output] = &graph.GetOrCreateNodeArg(labels.name(), &labels_type);
+    graph.AddInitializedTensor(labels);
+
+    const std::string name = node.Name();
+    graph.RemoveNode(index);
+    graph.SetNodeArgType(*output, *scores->TypeAsProto());
+    graph.AddNode(graph.GenerateNodeName(name + "_scores"), "Identity", "Scores of the removed ZipMap node",
+                  {scores}, {output});
+
+    LOGS(logger, INFO) << "Output " << output->Name() << " of ZipMap node " << name
+                       << " replaced with the scores tensor and " << labels.name();
+  }
+
+  std::vector<const NodeArg*> outputs;
+  for (const NodeArg* output : graph.GetOutputs()) {
+    outputs.push_back(output);
+    auto labels = labels_outputs.find(output);
+    if (labels != labels_outputs.end()) {
+      outputs.push_back(labels->second);
+    }
+  }
+  graph.SetOutputs(outputs);
+
+  modified = true;
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ZipMapOutputTransformer
+
+Transformer that removes the ZipMap nodes producing outputs of the main graph. Each such output becomes the tensor of
+scores the ZipMap node took as input, under the same name, and the labels of the columns of the scores are added as
+an initializer output named after it with a "_labels" suffix, right after it.
+ZipMap creates a map per row with a node per label, so reading the scores from a tensor saves one or two allocations
+per row and label. See kOrtSessionOptionsConfigZipMapOutputAsTensors.
+*/
+class ZipMapOutputTransformer : public GraphTransformer {
+ public:
+  ZipMapOutputTransformer() noexcept : GraphTransformer("ZipMapOutputTransformer") {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -64,10 +64,17 @@ struct ThreadOptions {
   // to the logical processor with id of affinity[0]. If the vector is empty, the thread can run on all the processors
   // its process can run on. NOTE: When hyperthreading is enabled, for example, on a 4 cores 8 physical threads CPU,
   // processor group [0,1,2,3] may only contain half of the physical cores.
+  // If the pool has more threads than the vector has entries the threads wrap around to the start of the vector.
   std::vector<size_t> affinity;
 
   // Set or unset denormal as zero.
   bool set_denormal_as_zero = false;
+
+  // If greater than 0, TryBatchParallelFor splits a loop into about num_batches * dynamic_block_base blocks of
+  // iterations which the threads claim dynamically, rather than giving each batch one fixed range of iterations.
+  // This evens out the load if some iterations or threads are slower than others, e.g. threads running on another
+  // socket, at the cost of claiming more blocks.
+  int dynamic_block_base = 0;
 };
 /// \brief An interface used by the onnxruntime implementation to
 /// access operating system functionality like the filesystem etc.
@@ -119,6 +126,14 @@ class Env {
   // This function doesn't support systems with more than 64 logical processors
   virtual std::vector<size_t> GetThreadAffinityMasks() const = 0;
 
+  // Returns the logical processors this process may run on grouped by physical core, e.g. {{0, 4}, {1, 5}} for two
+  // cores with two hyperthreads each. Cores are ordered by the id of their first processor.
+  // If numa_node is not negative only the cores on that NUMA node are returned.
+  // Returns an empty vector if the processor topology is unknown on this platform or the NUMA node doesn't exist.
+  virtual std::vector<std::vector<size_t>> GetPhysicalCoreProcessors(int /*numa_node*/) const {
+    return {};
+  }
+
   /// \brief Returns the number of micro-seconds since the Unix epoch.
   virtual uint64_t NowMicros() const {
     return env_time_->NowMicros();
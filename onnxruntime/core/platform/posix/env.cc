@@ -27,6 +27,11 @@ limitations under the License.
 #include <dlfcn.h>
 #include <ftw.h>
 #include <string.h>
+#include <sched.h>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
 #include <thread>
 #include <utility>  // for std::forward
 #include <vector>
@@ -105,6 +110,38 @@ struct Freer {
 
 using MallocdStringPtr = std::unique_ptr<char, Freer<char> >;
 
+#if defined(__linux__)
+// Reads the first line of a sysfs file such as /sys/devices/system/cpu/cpu0/topology/core_id.
+bool ReadSysfsLine(const std::string& path, std::string& line) {
+  std::ifstream file(path);
+  return static_cast<bool>(std::getline(file, line));
+}
+
+// Parses a list of processors in the kernel's format, e.g. "0-3,8-11".
+bool ParseCpuList(const std::string& list, cpu_set_t& cpus) {
+  std::istringstream stream(list);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    char* end = nullptr;
+    unsigned long first = strtoul(range.c_str(), &end, 10);
+    unsigned long last = first;
+    if (*end == '-') {
+      last = strtoul(end + 1, &end, 10);
+    }
+    if (*end != '\0' || last < first) {
+      return false;
+    }
+    for (unsigned long cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu) {
+      CPU_SET(cpu, &cpus);
+    }
+  }
+  return true;
+}
+#endif
+
 class PosixThread : public EnvThread {
  private:
   struct Param {
@@ -134,12 +171,15 @@ class PosixThread : public EnvThread {
       ORT_THROW("pthread_create failed");
 #if !defined(__APPLE__) && !defined(__ANDROID__)
     if (!thread_options.affinity.empty()) {
+      const size_t processor = thread_options.affinity[index % thread_options.affinity.size()];
+      if (processor >= CPU_SETSIZE)
+        ORT_THROW("Invalid processor id for thread affinity: ", processor);
       cpu_set_t cpuset;
       CPU_ZERO(&cpuset);
-      CPU_SET(thread_options.affinity[index], &cpuset);
+      CPU_SET(processor, &cpuset);
       s = pthread_setaffinity_np(hThread, sizeof(cpu_set_t), &cpuset);
       if (s != 0)
-        ORT_THROW("pthread_setaffinity_np failed");
+        ORT_THROW("pthread_setaffinity_np failed for processor ", processor, " with error code ", s);
     }
 #endif
   }
@@ -206,6 +246,54 @@ class PosixEnv : public Env {
     return ret;
   }
 
+#if defined(__linux__)
+  std::vector<std::vector<size_t>> GetPhysicalCoreProcessors(int numa_node) const override {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+      return {};
+    }
+
+    if (numa_node >= 0) {
+      std::string node_cpus;
+      cpu_set_t node_set;
+      CPU_ZERO(&node_set);
+      if (!ReadSysfsLine("/sys/devices/system/node/node" + std::to_string(numa_node) + "/cpulist", node_cpus) ||
+          !ParseCpuList(node_cpus, node_set)) {
+        return {};
+      }
+      CPU_AND(&allowed, &allowed, &node_set);
+    }
+
+    // processors with the same package and core id are hyperthreads of one physical core
+    std::map<std::pair<std::string, std::string>, std::vector<size_t>> cores;
+    for (size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (!CPU_ISSET(cpu, &allowed)) {
+        continue;
+      }
+      const std::string topology = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+      std::string package_id;
+      std::string core_id;
+      if (!ReadSysfsLine(topology + "physical_package_id", package_id) ||
+          !ReadSysfsLine(topology + "core_id", core_id)) {
+        // unknown topology, treat the processor as a core of its own
+        package_id = "cpu";
+        core_id = std::to_string(cpu);
+      }
+      cores[{package_id, core_id}].push_back(cpu);
+    }
+
+    std::vector<std::vector<size_t>> result;
+    result.reserve(cores.size());
+    for (auto& core : cores) {
+      result.push_back(std::move(core.second));
+    }
+    std::sort(result.begin(), result.end(),
+              [](const std::vector<size_t>& a, const std::vector<size_t>& b) { return a.front() < b.front(); });
+    return result;
+  }
+#endif
+
   void SleepForMicroseconds(int64_t micros) const override {
     while (micros > 0) {
       timespec sleep_time;
@@ -9,9 +9,29 @@
 
 namespace onnxruntime {
 
+// Element type of the weights CPU kernels pre-pack for the MLAS SGEMM routines.
+// See kOrtSessionOptionsConfigCpuGemmPackedBFormat.
+enum class GemmPackedBFormat {
+  kFloat,
+  kFloat16,
+  kBFloat16,
+};
+
+// Algorithm the tree ensemble kernels evaluate the trees with. See kOrtSessionOptionsConfigCpuTreeEnsembleEvaluation.
+enum class TreeEnsembleEvaluation {
+  kTraversal,
+  kQuickScorer,
+};
+
 // Information needed to construct CPU execution providers.
 struct CPUExecutionProviderInfo {
   bool create_arena{true};
+  // See kOrtSessionOptionsConfigArenaThreadCacheMaxBytes. 0 disables the arena thread cache.
+  size_t arena_thread_cache_max_bytes{0};
+  // See kOrtSessionOptionsConfigArenaMaxIdleBytes. 0 disables automatic release of free arena regions.
+  size_t arena_max_idle_bytes{0};
+  GemmPackedBFormat gemm_packed_b_format{GemmPackedBFormat::kFloat};
+  TreeEnsembleEvaluation tree_ensemble_evaluation{TreeEnsembleEvaluation::kTraversal};
 
   explicit CPUExecutionProviderInfo(bool use_arena)
       : create_arena(use_arena) {}
@@ -26,7 +46,9 @@ using FuseRuleFn = std::function<void(const onnxruntime::GraphViewer&,
 class CPUExecutionProvider : public IExecutionProvider {
  public:
   explicit CPUExecutionProvider(const CPUExecutionProviderInfo& info)
-      : IExecutionProvider{onnxruntime::kCpuExecutionProvider} {
+      : IExecutionProvider{onnxruntime::kCpuExecutionProvider},
+        gemm_packed_b_format_(info.gemm_packed_b_format),
+        tree_ensemble_evaluation_(info.tree_ensemble_evaluation) {
     bool create_arena = info.create_arena;
 
 #ifdef USE_JEMALLOC
@@ -41,7 +63,8 @@ class CPUExecutionProvider : public IExecutionProvider {
 #endif
 
     AllocatorCreationInfo device_info{[](int) { return onnxruntime::make_unique<TAllocator>(); },
-                                      0, create_arena};
+                                      0, create_arena, {0, -1, -1, -1}, info.arena_thread_cache_max_bytes,
+                                      info.arena_max_idle_bytes};
 
     InsertAllocator(CreateAllocator(device_info));
   }
@@ -49,7 +72,12 @@ class CPUExecutionProvider : public IExecutionProvider {
   std::shared_ptr<KernelRegistry> GetKernelRegistry() const override;
   std::unique_ptr<IDataTransfer> GetDataTransfer() const override;
 
+  GemmPackedBFormat GetGemmPackedBFormat() const { return gemm_packed_b_format_; }
+  TreeEnsembleEvaluation GetTreeEnsembleEvaluation() const { return tree_ensemble_evaluation_; }
+
  private:
   std::vector<FuseRuleFn> fuse_rules_;
+  const GemmPackedBFormat gemm_packed_b_format_;
+  const TreeEnsembleEvaluation tree_ensemble_evaluation_;
 };
 }  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/gemm.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
@@ -34,4 +35,144 @@ ONNX_CPU_OPERATOR_KERNEL(
     13,
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Gemm<float>);
+
+#if !defined(USE_MKLML_FOR_BLAS)
+static MLAS_HALF_FORMAT ToMlasHalfFormat(GemmPackedBFormat format) {
+  return format == GemmPackedBFormat::kBFloat16 ? MlasHalfFormatBFloat16 : MlasHalfFormatFloat16;
+}
+
+static size_t GemmPackBSize(GemmPackedBFormat format, size_t N, size_t K) {
+  return format == GemmPackedBFormat::kFloat ? MlasGemmPackBSize(N, K)
+                                             : MlasGemmPackBSize(N, K, ToMlasHalfFormat(format));
+}
+
+template <>
+Status Gemm<float>::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                            /*out*/ bool& is_packed,
+                            /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  // only pack Matrix B. Kernels of other execution providers derived from this one read B from the inputs.
+  if (input_idx != 1 || Info().GetExecutionProvider()->Type() != kCpuExecutionProvider) {
+    return Status::OK();
+  }
+
+  b_shape_ = tensor.Shape();
+  if (b_shape_.NumDimensions() != 2) {
+    return Status::OK();
+  }
+
+  const size_t K = trans_B_ == CblasTrans ? static_cast<size_t>(b_shape_[1]) : static_cast<size_t>(b_shape_[0]);
+  const size_t N = trans_B_ == CblasTrans ? static_cast<size_t>(b_shape_[0]) : static_cast<size_t>(b_shape_[1]);
+
+  // The CPU execution provider may be configured to keep the packed weights in a half precision format.
+  packed_b_format_ = static_cast<const CPUExecutionProvider*>(Info().GetExecutionProvider())->GetGemmPackedBFormat();
+
+  const size_t packed_b_size = GemmPackBSize(packed_b_format_, N, K);
+  if (packed_b_size == 0) {
+    return Status::OK();
+  }
+
+  auto* packed_b_data = alloc->Alloc(packed_b_size);
+  packed_b_ = BufferUniquePtr(packed_b_data, BufferDeleter(alloc));
+  if (packed_b_format_ == GemmPackedBFormat::kFloat) {
+    MlasGemmPackB(trans_B_,
+                  N,
+                  K,
+                  tensor.Data<float>(),
+                  trans_B_ == CblasTrans ? K : N,
+                  packed_b_data);
+  } else {
+    MlasGemmPackB(trans_B_,
+                  N,
+                  K,
+                  tensor.Data<float>(),
+                  trans_B_ == CblasTrans ? K : N,
+                  ToMlasHalfFormat(packed_b_format_),
+                  packed_b_data);
+  }
+  is_packed = true;
+
+  if (prepacked_weights != nullptr) {
+    prepacked_weights->buffers_.push_back(std::move(packed_b_));
+    prepacked_weights->buffer_sizes_.push_back(packed_b_size);
+  }
+  return Status::OK();
+}
+
+template <>
+Status Gemm<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                              const std::vector<size_t>& prepacked_buffer_sizes,
+                                              const Tensor& tensor, int input_idx,
+                                              /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx != 1 || Info().GetExecutionProvider()->Type() != kCpuExecutionProvider ||
+      tensor.Shape().NumDimensions() != 2) {
+    return Status::OK();
+  }
+
+  // The buffers may have been packed by a kernel of another session. Only use them if they were packed in the
+  // format this kernel computes with, which the size of the buffer tells apart.
+  const auto format = static_cast<const CPUExecutionProvider*>(Info().GetExecutionProvider())->GetGemmPackedBFormat();
+  const auto& shape = tensor.Shape();
+  const size_t K = trans_B_ == CblasTrans ? static_cast<size_t>(shape[1]) : static_cast<size_t>(shape[0]);
+  const size_t N = trans_B_ == CblasTrans ? static_cast<size_t>(shape[0]) : static_cast<size_t>(shape[1]);
+  if (prepacked_buffers.size() != 1 || prepacked_buffer_sizes.size() != 1 ||
+      prepacked_buffer_sizes[0] != GemmPackBSize(format, N, K)) {
+    return Status::OK();
+  }
+
+  b_shape_ = shape;
+  packed_b_format_ = format;
+  packed_b_ = std::move(prepacked_buffers[0]);
+  used_shared_buffers = true;
+
+  return Status::OK();
+}
+#endif
+
+template <>
+void Gemm<float>::ComputeGemmWithPackedB(int64_t M, int64_t N, int64_t K,
+                                         const float* a_data,
+                                         const float* c_data, const TensorShape* c_shape,
+                                         float* y_data,
+                                         concurrency::ThreadPool* thread_pool) const {
+  ComputeBias(M, N, beta_, c_data, c_shape, y_data);
+
+#if !defined(USE_MKLML_FOR_BLAS)
+  if (packed_b_format_ != GemmPackedBFormat::kFloat) {
+    MlasGemm(trans_A_,
+             static_cast<size_t>(M),
+             static_cast<size_t>(N),
+             static_cast<size_t>(K),
+             alpha_,
+             a_data,
+             static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
+             packed_b_.get(),
+             ToMlasHalfFormat(packed_b_format_),
+             c_data != nullptr ? beta_ : 0.0f,
+             y_data,
+             static_cast<size_t>(N),
+             thread_pool);
+    return;
+  }
+#endif
+
+  MlasGemm(trans_A_,
+           static_cast<size_t>(M),
+           static_cast<size_t>(N),
+           static_cast<size_t>(K),
+           alpha_,
+           a_data,
+           static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
+           packed_b_.get(),
+           // ideally we need to set the output buffer contents to 0 if bias is missing,
+           // but passing 0 for beta is cheaper and it will ignore any junk in the output buffer
+           c_data != nullptr ? beta_ : 0.0f,
+           y_data,
+           static_cast<size_t>(N),
+           thread_pool);
+}
+
 }  // namespace onnxruntime
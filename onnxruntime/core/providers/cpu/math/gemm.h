@@ -7,6 +7,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "gemm_helper.h"
 #include "core/providers/cpu/activation/activations.h"
 
@@ -39,19 +40,21 @@ private:
     ORT_ENFORCE(info.GetAttr<float>("beta", &beta_).IsOK());
   }
 
-  static void ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
-                          int64_t M, int64_t N, int64_t K,
-                          float alpha,
-                          const T* a_data, const T* b_data,
-                          float beta,
-                          const T* c_data, const TensorShape* c_shape,
-                          T* y_data,
-                          concurrency::ThreadPool* thread_pool) {
-    // if input is empty tensor, return directly as nothing need to be calculated.
-    if (M == 0 || N == 0)
-      return;
+#if !defined(USE_MKLML_FOR_BLAS)
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   const std::vector<size_t>& prepacked_buffer_sizes,
+                                   const Tensor& tensor, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+#endif
 
-    // Broadcast the bias as needed if bias is given
+  // Broadcast the bias to the output as needed if bias is given
+  static void ComputeBias(int64_t M, int64_t N, float beta,
+                          const T* c_data, const TensorShape* c_shape,
+                          T* y_data) {
     if (beta != 0 && c_data != nullptr) {
       ORT_ENFORCE(c_shape != nullptr, "c_shape is required if c_data is provided");
       auto output_mat = EigenMatrixMapRowMajor<T>(y_data, M, N);
@@ -69,6 +72,21 @@ private:
         output_mat = ConstEigenMatrixMapRowMajor<T>(c_data, M, N);
       }
     }
+  }
+
+  static void ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
+                          int64_t M, int64_t N, int64_t K,
+                          float alpha,
+                          const T* a_data, const T* b_data,
+                          float beta,
+                          const T* c_data, const TensorShape* c_shape,
+                          T* y_data,
+                          concurrency::ThreadPool* thread_pool) {
+    // if input is empty tensor, return directly as nothing need to be calculated.
+    if (M == 0 || N == 0)
+      return;
+
+    ComputeBias(M, N, beta, c_data, c_shape, y_data);
 
     math::Gemm<T>(trans_a, trans_b,
                   M, N, K,
@@ -86,11 +104,11 @@ private:
     concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
 
     const auto* X = context->Input<Tensor>(0);
-    const auto* W = context->Input<Tensor>(1);
+    const auto* W = packed_b_ ? nullptr : context->Input<Tensor>(1);
     const auto* B = context->Input<Tensor>(2);
     // Bias could be missing. Treat as scalar 0 if that is the case.
-    GemmHelper helper(X->Shape(), trans_A_ != CblasNoTrans, W->Shape(), trans_B_ != CblasNoTrans,
-                      B != nullptr ? B->Shape() : TensorShape({}));
+    GemmHelper helper(X->Shape(), trans_A_ != CblasNoTrans, W != nullptr ? W->Shape() : b_shape_,
+                      trans_B_ != CblasNoTrans, B != nullptr ? B->Shape() : TensorShape({}));
 
     if (!helper.State().IsOK())
       return helper.State();
@@ -110,10 +128,14 @@ private:
 
     T* y_data = Y->MutableData<T>();
 
-    ComputeGemm(trans_A_, trans_B_, M, N, K, alpha_, X->Data<T>(), W->Data<T>(), beta_,
-                b_data, b_shape,
-                y_data,
-                thread_pool);
+    if (packed_b_) {
+      ComputeGemmWithPackedB(M, N, K, X->Data<T>(), b_data, b_shape, y_data, thread_pool);
+    } else {
+      ComputeGemm(trans_A_, trans_B_, M, N, K, alpha_, X->Data<T>(), W->Data<T>(), beta_,
+                  b_data, b_shape,
+                  y_data,
+                  thread_pool);
+    }
 
     if(activation_){
       std::unique_ptr<functors::ElementWiseRangedTransform<T>> f(activation_->Copy());
@@ -128,14 +150,72 @@ private:
   }
 
  private:
+  // Only used with the B matrix pre-packed by PrePack
+  void ComputeGemmWithPackedB(int64_t M, int64_t N, int64_t K,
+                              const T* a_data,
+                              const T* c_data, const TensorShape* c_shape,
+                              T* y_data,
+                              concurrency::ThreadPool* thread_pool) const;
+
   CBLAS_TRANSPOSE trans_A_;
   CBLAS_TRANSPOSE trans_B_;
   float alpha_;
   float beta_;
 
+  TensorShape b_shape_;
+  BufferUniquePtr packed_b_;
+  GemmPackedBFormat packed_b_format_{GemmPackedBFormat::kFloat};
+
  protected:
   // For fused gemm + activation  
   std::unique_ptr<functors::ElementWiseRangedTransform<T>> activation_;
 };
 
+// B is only pre-packed for float, where MLAS provides the packed SGEMM routines.
+#if !defined(USE_MKLML_FOR_BLAS)
+template <typename T>
+Status Gemm<T>::PrePack(const Tensor& /*tensor*/, int /*input_idx*/, AllocatorPtr /*alloc*/,
+                        /*out*/ bool& is_packed,
+                        /*out*/ PrePackedWeights* /*prepacked_weights*/) {
+  is_packed = false;
+  return Status::OK();
+}
+
+template <typename T>
+Status Gemm<T>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                          const std::vector<size_t>& /*prepacked_buffer_sizes*/,
+                                          const Tensor& /*tensor*/, int /*input_idx*/,
+                                          /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+  return Status::OK();
+}
+
+template <>
+Status Gemm<float>::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                            /*out*/ bool& is_packed,
+                            /*out*/ PrePackedWeights* prepacked_weights);
+
+template <>
+Status Gemm<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                              const std::vector<size_t>& prepacked_buffer_sizes,
+                                              const Tensor& tensor, int input_idx,
+                                              /*out*/ bool& used_shared_buffers);
+#endif
+
+template <typename T>
+void Gemm<T>::ComputeGemmWithPackedB(int64_t /*M*/, int64_t /*N*/, int64_t /*K*/,
+                                     const T* /*a_data*/,
+                                     const T* /*c_data*/, const TensorShape* /*c_shape*/,
+                                     T* /*y_data*/,
+                                     concurrency::ThreadPool* /*thread_pool*/) const {
+  ORT_THROW("Gemm with a pre-packed B matrix is only supported for float.");
+}
+
+template <>
+void Gemm<float>::ComputeGemmWithPackedB(int64_t M, int64_t N, int64_t K,
+                                         const float* a_data,
+                                         const float* c_data, const TensorShape* c_shape,
+                                         float* y_data,
+                                         concurrency::ThreadPool* thread_pool) const;
+
 }  // namespace onnxruntime
@@ -126,7 +126,18 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
 }
 
 #if !defined(USE_MKLML_FOR_BLAS)
-Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+static MLAS_HALF_FORMAT ToMlasHalfFormat(GemmPackedBFormat format) {
+  return format == GemmPackedBFormat::kBFloat16 ? MlasHalfFormatBFloat16 : MlasHalfFormatFloat16;
+}
+
+static size_t GemmPackBSize(GemmPackedBFormat format, size_t N, size_t K) {
+  return format == GemmPackedBFormat::kFloat ? MlasGemmPackBSize(N, K)
+                                             : MlasGemmPackBSize(N, K, ToMlasHalfFormat(format));
+}
+
+Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                              /*out*/ bool& is_packed,
+                              /*out*/ PrePackedWeights* prepacked_weights) {
   is_packed = false;
 
   // only pack Matrix B
@@ -144,24 +155,78 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, bool& is_pack
     const size_t N = trans_b ? static_cast<size_t>(b_shape_[0])
                              : static_cast<size_t>(b_shape_[1]);
 
-    const size_t packed_b_size = MlasGemmPackBSize(N, K);
+    // The CPU execution provider may be configured to keep the packed weights in a half precision format.
+    const auto* provider = Info().GetExecutionProvider();
+    if (provider->Type() == kCpuExecutionProvider) {
+      packed_b_format_ = static_cast<const CPUExecutionProvider*>(provider)->GetGemmPackedBFormat();
+    }
+
+    const size_t packed_b_size = GemmPackBSize(packed_b_format_, N, K);
     if (packed_b_size == 0) {
       return Status::OK();
     }
 
-    auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
     auto* packed_b_data = alloc->Alloc(packed_b_size);
     packed_b_ = BufferUniquePtr(packed_b_data, BufferDeleter(alloc));
-    MlasGemmPackB(trans_b ? CblasTrans : CblasNoTrans,
-                  N,
-                  K,
-                  tensor.Data<float>(),
-                  static_cast<int>(trans_b ? K : N),
-                  packed_b_data);
+    if (packed_b_format_ == GemmPackedBFormat::kFloat) {
+      MlasGemmPackB(trans_b ? CblasTrans : CblasNoTrans,
+                    N,
+                    K,
+                    tensor.Data<float>(),
+                    static_cast<int>(trans_b ? K : N),
+                    packed_b_data);
+    } else {
+      MlasGemmPackB(trans_b ? CblasTrans : CblasNoTrans,
+                    N,
+                    K,
+                    tensor.Data<float>(),
+                    static_cast<size_t>(trans_b ? K : N),
+                    ToMlasHalfFormat(packed_b_format_),
+                    packed_b_data);
+    }
     is_packed = true;
+
+    if (prepacked_weights != nullptr) {
+      prepacked_weights->buffers_.push_back(std::move(packed_b_));
+      prepacked_weights->buffer_sizes_.push_back(packed_b_size);
+    }
   }
   return Status::OK();
 }
+
+Status MatMul<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                const std::vector<size_t>& prepacked_buffer_sizes,
+                                                const Tensor& tensor, int input_idx,
+                                                /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx != 1 || tensor.Shape().NumDimensions() != 2) {
+    return Status::OK();
+  }
+
+  // The buffers may have been packed by a kernel of another session. Only use them if they were packed in the
+  // format this kernel computes with, which the size of the buffer tells apart.
+  auto format = GemmPackedBFormat::kFloat;
+  const auto* provider = Info().GetExecutionProvider();
+  if (provider->Type() == kCpuExecutionProvider) {
+    format = static_cast<const CPUExecutionProvider*>(provider)->GetGemmPackedBFormat();
+  }
+
+  const auto& shape = tensor.Shape();
+  const size_t K = trans_b_attr_ ? static_cast<size_t>(shape[1]) : static_cast<size_t>(shape[0]);
+  const size_t N = trans_b_attr_ ? static_cast<size_t>(shape[0]) : static_cast<size_t>(shape[1]);
+  if (prepacked_buffers.size() != 1 || prepacked_buffer_sizes.size() != 1 ||
+      prepacked_buffer_sizes[0] != GemmPackBSize(format, N, K)) {
+    return Status::OK();
+  }
+
+  b_shape_ = shape;
+  packed_b_format_ = format;
+  packed_b_ = std::move(prepacked_buffers[0]);
+  used_shared_buffers = true;
+
+  return Status::OK();
+}
 #endif
 
 Status MatMul<float>::Compute(OpKernelContext* ctx) const {
@@ -191,6 +256,23 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   size_t max_len = helper.OutputOffsets().size();
   for (size_t i = 0; i < max_len; i++) {
 #if !defined(USE_MKLML_FOR_BLAS)
+    if (packed_b_ && packed_b_format_ != GemmPackedBFormat::kFloat) {
+      MlasGemm(
+          trans_a ? CblasTrans : CblasNoTrans,
+          static_cast<size_t>(helper.M()),
+          static_cast<size_t>(helper.N()),
+          static_cast<size_t>(helper.K()),
+          alpha_attr_,
+          a_data + helper.LeftOffsets()[i],
+          static_cast<size_t>(trans_a ? helper.M() : helper.K()),
+          packed_b_.get(),
+          ToMlasHalfFormat(packed_b_format_),
+          0.0f,
+          y_data + helper.OutputOffsets()[i],
+          static_cast<size_t>(helper.N()),
+          thread_pool);
+      continue;
+    }
     if (packed_b_) {
       MlasGemm(
           trans_a ? CblasTrans : CblasNoTrans,
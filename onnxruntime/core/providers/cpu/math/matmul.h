@@ -4,6 +4,7 @@
 #pragma once
 
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 
 namespace onnxruntime {
 
@@ -25,7 +26,14 @@ class MatMul<float> final : public OpKernel {
   }
 
 #if !defined(USE_MKLML_FOR_BLAS)
-  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   const std::vector<size_t>& prepacked_buffer_sizes,
+                                   const Tensor& tensor, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
 #endif
 
   Status Compute(OpKernelContext* context) const override;
@@ -33,6 +41,7 @@ class MatMul<float> final : public OpKernel {
  private:
   TensorShape b_shape_;
   BufferUniquePtr packed_b_;
+  GemmPackedBFormat packed_b_format_{GemmPackedBFormat::kFloat};
 
   // For FusedMatMul and TransposeMatMul contrib ops
   float alpha_attr_;
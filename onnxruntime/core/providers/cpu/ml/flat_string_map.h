@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+namespace ml {
+
+// Read only hash map from strings to values, for the vocabularies of the ML operators, which are fixed once the
+// kernel is created. The keys are stored back to back in one buffer and the table is open addressed with linear
+// probing and a load factor of at most 1/2. Each slot keeps a 32 bit tag of the hash of its key, so a lookup
+// usually compares a single key, and finding a key touches one or two cache lines instead of a bucket list.
+template <typename TValue>
+class FlatStringMap {
+ public:
+  FlatStringMap() : FlatStringMap({}, {}) {}
+
+  // Like assigning the pairs to a std::unordered_map in order, the last value of a duplicated key is kept.
+  FlatStringMap(const std::vector<std::string>& keys, const std::vector<TValue>& values) {
+    ORT_ENFORCE(keys.size() == values.size());
+    ORT_ENFORCE(keys.size() < std::numeric_limits<uint32_t>::max() / 2, "Too many keys: ", keys.size());
+
+    size_t capacity = 1;
+    while (capacity < 2 * keys.size()) {
+      capacity *= 2;
+    }
+    mask_ = capacity - 1;
+    slots_.resize(capacity);
+    values_.reserve(keys.size());
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+      const std::string& key = keys[i];
+      const size_t hash = std::hash<std::string>{}(key);
+      Slot* slot = &slots_[FindSlot(key, hash)];
+      if (slot->value != kEmpty) {
+        values_[slot->value] = values[i];
+        continue;
+      }
+
+      ORT_ENFORCE(chars_.size() + key.size() <= std::numeric_limits<uint32_t>::max(), "Keys are too long.");
+      slot->tag = Tag(hash);
+      slot->length = static_cast<uint32_t>(key.size());
+      slot->offset = static_cast<uint32_t>(chars_.size());
+      slot->value = static_cast<uint32_t>(values_.size());
+      chars_.append(key);
+      values_.push_back(values[i]);
+    }
+  }
+
+  // Returns the value of the key, or nullptr if the key isn't in the map.
+  const TValue* Find(const std::string& key) const {
+    const Slot& slot = slots_[FindSlot(key, std::hash<std::string>{}(key))];
+    return slot.value == kEmpty ? nullptr : &values_[slot.value];
+  }
+
+  size_t Size() const { return values_.size(); }
+
+ private:
+  static constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+
+  struct Slot {
+    uint32_t tag = 0;
+    uint32_t length = 0;
+    uint32_t offset = 0;
+    uint32_t value = kEmpty;
+  };
+
+  // The low bits of the hash select the slot, so the tag is taken from the high bits.
+  static uint32_t Tag(size_t hash) {
+    return static_cast<uint32_t>(static_cast<uint64_t>(hash) >> 32) ^ static_cast<uint32_t>(hash);
+  }
+
+  // Returns the index of the slot of the key, or of the empty slot the key would be inserted in.
+  size_t FindSlot(const std::string& key, size_t hash) const {
+    const uint32_t tag = Tag(hash);
+    for (size_t index = hash & mask_;; index = (index + 1) & mask_) {
+      const Slot& slot = slots_[index];
+      if (slot.value == kEmpty ||
+          (slot.tag == tag && slot.length == key.size() &&
+           std::memcmp(chars_.data() + slot.offset, key.data(), key.size()) == 0)) {
+        return index;
+      }
+    }
+  }
+
+  size_t mask_;
+  std::vector<Slot> slots_;
+  std::string chars_;
+  std::vector<TValue> values_;
+};
+
+}  // namespace ml
+}  // namespace onnxruntime
@@ -3,8 +3,12 @@
 
 #pragma once
 
+#include <numeric>
+#include <type_traits>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/ml/flat_string_map.h"
 #include "core/providers/cpu/ml/ml_common.h"
 
 namespace onnxruntime {
@@ -20,24 +24,18 @@ class LabelEncoder final : public OpKernel {
     ORT_ENFORCE(info.GetAttr<std::string>("default_string", &default_string_).IsOK());
     ORT_ENFORCE(info.GetAttr<int64_t>("default_int64", &default_int_).IsOK());
 
-    auto num_entries = string_classes.size();
-
-    string_to_int_map_.reserve(num_entries);
-    int_to_string_map_.reserve(num_entries);
-
-    for (size_t i = 0; i < num_entries; ++i) {
-      const std::string& str = string_classes[i];
-
-      string_to_int_map_[str] = i;
-      int_to_string_map_[i] = str;
-    }
+    std::vector<int64_t> indices(string_classes.size());
+    std::iota(indices.begin(), indices.end(), int64_t{0});
+    string_to_int_map_ = FlatStringMap<int64_t>(string_classes, indices);
+    string_classes_ = std::move(string_classes);
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  std::unordered_map<std::string, int64_t> string_to_int_map_;
-  std::unordered_map<int64_t, std::string> int_to_string_map_;
+  FlatStringMap<int64_t> string_to_int_map_;
+  // The class of index i is string_classes_[i].
+  std::vector<std::string> string_classes_;
 
   std::string default_string_;
   int64_t default_int_;
@@ -64,8 +62,7 @@ class LabelEncoder_2 final : public OpKernel {
                 "However, the number of key is ", num_keys, " and the number of ",
                 "values is ", num_values, ".");
 
-    for (size_t i = 0; i < num_keys; ++i)
-      _map[keys[i]] = values[i];
+    BuildMap(keys, values, _map);
   }
 
   Status Compute(OpKernelContext* context) const override {
@@ -78,18 +75,43 @@ class LabelEncoder_2 final : public OpKernel {
     auto input = X.template DataAsSpan<TKey>();
     auto output = Y.template MutableDataAsSpan<TValue>();
 
-    for (int64_t i = 0; i < shape.Size(); ++i) {
-      const auto found = _map.find(input[i]);
-      if (found == _map.end())
-        output[i] = _default_value;
-      else
-        output[i] = found->second;
-    }
+    concurrency::ThreadPool::TryParallelFor(
+        context->GetOperatorThreadPool(), shape.Size(), kStringLookupCost,
+        [this, &input, &output](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t i = first; i < last; ++i) {
+            const TValue* found = Find(_map, input[i]);
+            output[i] = found == nullptr ? _default_value : *found;
+          }
+        });
 
     return Status::OK();
   }
 
  private:
+  // String keys are looked up in a FlatStringMap, the others in a std::unordered_map.
+  using Map = typename std::conditional<std::is_same<TKey, std::string>::value, FlatStringMap<TValue>,
+                                        std::unordered_map<TKey, TValue>>::type;
+
+  static void BuildMap(const std::vector<TKey>& keys, const std::vector<TValue>& values,
+                       std::unordered_map<TKey, TValue>& map) {
+    for (size_t i = 0; i < keys.size(); ++i)
+      map[keys[i]] = values[i];
+  }
+
+  static void BuildMap(const std::vector<std::string>& keys, const std::vector<TValue>& values,
+                       FlatStringMap<TValue>& map) {
+    map = FlatStringMap<TValue>(keys, values);
+  }
+
+  static const TValue* Find(const std::unordered_map<TKey, TValue>& map, const TKey& key) {
+    const auto found = map.find(key);
+    return found == map.end() ? nullptr : &found->second;
+  }
+
+  static const TValue* Find(const FlatStringMap<TValue>& map, const std::string& key) {
+    return map.Find(key);
+  }
+
   // Specialize this method to set attribute names. For example, if keys' type
   // is 64-bit integer, _key_field_name should be "keys_int64s". Field names
   // for other types can be found in ONNX spec.
@@ -98,7 +120,7 @@ class LabelEncoder_2 final : public OpKernel {
   // A collection of key-value pairs. Each (a_key, a_value) pair
   // means that the "a_key" in the input would be mapped to "a_value".
   // If _map doesn't contain "a_key", we use _default_value as its output.
-  std::unordered_map<TKey, TValue> _map;
+  Map _map;
   TValue _default_value;
   // ONNX attribute name to load keys.
   std::string _key_field_name;
@@ -29,6 +29,10 @@ enum class NODE_MODE {
   LEAF
 };
 
+// Cost per element of the operators looking strings up or copying the strings they map values to, to split their
+// inputs with ThreadPool::TryParallelFor.
+constexpr TensorOpCost kStringLookupCost{sizeof(std::string) + 32.0, sizeof(std::string), 64.0};
+
 static inline NODE_MODE MakeTreeNodeMode(const std::string& input) {
   if (input == "BRANCH_LEQ") {
     return NODE_MODE::BRANCH_LEQ;
@@ -63,6 +63,7 @@ SVMClassifier::SVMClassifier(const OpKernelInfo& info)
     mode_ = SVM_TYPE::SVM_LINEAR;
     set_kernel_type(KERNEL::LINEAR);
   }
+  set_support_vectors(support_vectors_, vector_count_);
 
   ORT_ENFORCE(classlabels_strings_.size() > 0 || classlabels_ints_.size() > 0);
   ORT_ENFORCE(proba_.size() == probb_.size());
@@ -235,68 +236,73 @@ Status SVMClassifier::ComputeImpl(OpKernelContext& ctx,
     votes_data.resize(num_batches * class_count_, 0);
 
     auto kernels_span = gsl::make_span<float>(kernels_data.data(), kernels_data.size());
-    auto votes_span = gsl::make_span<int64_t>(votes_data.data(), votes_data.size());
 
     // combine the input data with the support vectors and apply the kernel type
     // output is {num_batches, vector_count_}
     batched_kernel_dot<float>(x_data, support_vectors_, num_batches, vector_count_, feature_count_, 0.f, kernels_span,
                               threadpool);
 
+    // reduce scores from kernels using coefficients, taking into account the varying number of support vectors
+    // per class.
+    // coefficients: [num_classes - 1, vector_count_]
+    //
+    // e.g. say you have 3 classes, with 3 x 3 coefficients
+    //
+    // AA AB AC
+    // BA BB BC
+    // CA CB CC
+    //
+    // you can remove the diagonal line of items comparing a class with itself leaving one less row.
+    //
+    // BA AB AC
+    // CA CB BC
+    //
+    // for each class there is a coefficient per support vector, and a class has one or more support vectors.
+    //
+    // Combine the scores for the two combinations for two classes with their coefficient.
+    // e.g. AB combines with BA.
+    // If A has 3 support vectors and B has 2, there's a 3x2 block for AB and a 2x3 block for BA to combine
+    //
+    // The products of the kernels of the support vectors of each class with all the rows of coefficients come from
+    // one matrix product per class, for all the batches at once:
+    // class_products: [num_batches, class_count_, num_classes - 1]
+    // and the score of the classifier of classes i and j is class_products[i][j - 1] + class_products[j][i] + rho.
+    // The products and the scores are accumulated in double so that a score close to 0 votes for the same class as
+    // the scalar evaluation.
+    using StridedMatrix = Eigen::Map<const Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>,
+                                     0, Eigen::OuterStride<>>;
+    using StridedProducts = Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>,
+                                       0, Eigen::OuterStride<>>;
+    const int64_t num_coefficient_rows = class_count_ - 1;
+    const int64_t products_per_batch = class_count_ * num_coefficient_rows;
+    std::vector<double> class_products_data(num_batches * products_per_batch, 0.);
+    for (int64_t c = 0; c < class_count_ && num_coefficient_rows > 0; ++c) {
+      if (vectors_per_class_[c] == 0) {
+        continue;
+      }
+
+      StridedMatrix class_kernels(kernels_data.data() + starting_vector_[c], num_batches, vectors_per_class_[c],
+                                  Eigen::OuterStride<>(vector_count_));
+      StridedMatrix class_coefficients(coefficients_.data() + starting_vector_[c], num_coefficient_rows,
+                                       vectors_per_class_[c], Eigen::OuterStride<>(vector_count_));
+      StridedProducts class_products(class_products_data.data() + c * num_coefficient_rows, num_batches,
+                                     num_coefficient_rows, Eigen::OuterStride<>(products_per_batch));
+      class_products.noalias() = class_kernels.cast<double>() * class_coefficients.cast<double>().transpose();
+    }
+
     for (int64_t n = 0; n < num_batches; n++) {
-      // reduce scores from kernels using coefficients, taking into account the varying number of support vectors
-      // per class.
-      // coefficients: [num_classes - 1, vector_count_]
-      //
-      // e.g. say you have 3 classes, with 3 x 3 coefficients
-      //
-      // AA AB AC
-      // BA BB BC
-      // CA CB CC
-      //
-      // you can remove the diagonal line of items comparing a class with itself leaving one less row.
-      //
-      // BA AB AC
-      // CA CB BC
-      //
-      // for each class there is a coefficient per support vector, and a class has one or more support vectors.
-      //
-      // Combine the scores for the two combinations for two classes with their coefficient.
-      // e.g. AB combines with BA.
-      // If A has 3 support vectors and B has 2, there's a 3x2 block for AB and a 2x3 block for BA to combine
-
-      auto cur_kernels = kernels_span.subspan(n * vector_count_, vector_count_);
+      const double* class_products = class_products_data.data() + n * products_per_batch;
       auto cur_scores = classifier_scores.subspan(n * num_slots_per_iteration, num_classifiers);
-      auto cur_votes = votes_span.subspan(n * class_count_, class_count_);
-      auto scores_iter = cur_scores.begin();
+      int64_t* cur_votes = votes_data.data() + n * class_count_;
 
       int64_t classifier_idx = 0;
       for (int64_t i = 0; i < class_count_ - 1; i++) {
-        int64_t start_index_i = starting_vector_[i];  // start of support vectors for class i
-        int64_t class_i_support_count = vectors_per_class_[i];
-        int64_t i_coeff_row_offset = vector_count_ * i;
-
-        for (int64_t j = i + 1; j < class_count_; j++) {
-          int64_t start_index_j = starting_vector_[j];  // start of support vectors for class j
-          int64_t class_j_support_count = vectors_per_class_[j];
-          int64_t j_coeff_row_offset = vector_count_ * (j - 1);
-
-          double sum = 0;
-
-          const float* val1 = &(coefficients_[j_coeff_row_offset + start_index_i]);
-          const float* val2 = &(cur_kernels[start_index_i]);
-          for (int64_t m = 0; m < class_i_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          val1 = &(coefficients_[i_coeff_row_offset + start_index_j]);
-          val2 = &(cur_kernels[start_index_j]);
-
-          for (int64_t m = 0; m < class_j_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          sum += rho_[classifier_idx++];
-
-          *scores_iter++ = static_cast<float>(sum);
-          ++(cur_votes[sum > 0 ? i : j]);
+        // class_products[i][j - 1] for all the j > i are contiguous
+        const double* i_products = class_products + i * num_coefficient_rows;
+        for (int64_t j = i + 1; j < class_count_; j++, classifier_idx++) {
+          const double sum = i_products[j - 1] + class_products[j * num_coefficient_rows + i] + rho_[classifier_idx];
+          cur_scores[classifier_idx] = static_cast<float>(sum);
+          ++cur_votes[sum > 0 ? i : j];
         }
       }
     }
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <limits>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/util/math_cpuonly.h"
@@ -30,6 +32,25 @@ class SVMCommon {
   void set_kernel_type(KERNEL new_kernel_type) { kernel_type_ = new_kernel_type; }
   KERNEL get_kernel_type() const { return kernel_type_; }
 
+  // Computes the squared norms of the support vectors the RBF kernel needs. Must be called once the kernel type and
+  // the support vectors are known.
+  void set_support_vectors(const std::vector<float>& support_vectors, int64_t vector_count) {
+    support_vector_norms_.clear();
+    if (kernel_type_ != KERNEL::RBF || vector_count == 0) {
+      return;
+    }
+
+    const int64_t feature_count = static_cast<int64_t>(support_vectors.size()) / vector_count;
+    support_vector_norms_.resize(vector_count);
+    for (int64_t i = 0; i < vector_count; ++i) {
+      support_vector_norms_[i] = ConstEigenVectorArrayMap<float>(support_vectors.data() + i * feature_count,
+                                                                 feature_count)
+                                     .cast<double>()
+                                     .square()
+                                     .sum();
+    }
+  }
+
   template <typename T>
   void batched_kernel_dot(const gsl::span<const T> a, const gsl::span<const T> b,
                           int64_t m, int64_t n, int64_t k,
@@ -39,28 +60,42 @@ class SVMCommon {
     assert(a.size() == size_t(m * k) && b.size() == size_t(k * n) && out.size() == size_t(m * n));
 
     if (kernel_type_ == KERNEL::RBF) {
+      // |a - b|^2 = |a|^2 + |b|^2 - 2 a.b so the dot products of all the batches with all the support vectors come
+      // from one GEMM, and the squared norms of the support vectors are computed once by set_support_vectors.
+      assert(support_vector_norms_.size() == size_t(n));
+      onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
+                                        m, n, k,
+                                        -2.f, a.data(), b.data(), 0.f,
+                                        nullptr, nullptr,
+                                        out.data(),
+                                        threadpool);
+
+      // the rounding error of the dot product grows with the norms, so when the distance is small compared to them,
+      // e.g. for a batch close to a support vector with large values, it's computed directly from the difference.
+      const double cancellation_ratio = static_cast<double>(k) * 16 * std::numeric_limits<T>::epsilon();
+
       T* cur_out = out.data();
       const T* cur_batch = a.data();
-
-      // each batch has 'k' features
+      const double* support_vector_norms = support_vector_norms_.data();
       for (int64_t batch = 0; batch < m; ++batch) {
-        const T* cur_support_vector = b.data();
-
-        // broadcast the support vectors against the k features in each batch. output is one value per support vector
+        const double batch_norm = ConstEigenVectorArrayMap<T>(cur_batch, k).template cast<double>().square().sum();
         for (int64_t support_vector = 0; support_vector < n; ++support_vector) {
-          T sum = 0.f;
-          const T* cur_input = cur_batch;
-
-          for (int64_t feature = 0; feature < k; ++feature) {
-            T val = *cur_input++ - *cur_support_vector++;
-            sum += val * val;
+          const double norms = batch_norm + support_vector_norms[support_vector];
+          double distance = static_cast<double>(cur_out[support_vector]) + norms;
+          if (distance <= cancellation_ratio * norms) {
+            distance = (ConstEigenVectorArrayMap<T>(cur_batch, k).template cast<double>() -
+                        ConstEigenVectorArrayMap<T>(b.data() + support_vector * k, k).template cast<double>())
+                           .square()
+                           .sum();
           }
-
-          *cur_out++ = std::exp(-gamma_ * sum);
+          cur_out[support_vector] = static_cast<T>(-gamma_ * distance);
         }
 
         cur_batch += k;  // move to start of next batch
+        cur_out += n;
       }
+
+      MlasComputeExp(out.data(), out.data(), out.size());
     } else {
       float alpha = 1.f;
       float beta = 1.f;
@@ -100,12 +135,14 @@ class SVMCommon {
   float gamma_{0.f};
   float coef0_{0.f};
   float degree_{0.f};
+  std::vector<double> support_vector_norms_;
 };
 
 class SVMClassifier final : public OpKernel, private SVMCommon {
   using SVMCommon::batched_kernel_dot;
   using SVMCommon::set_kernel_type;
   using SVMCommon::get_kernel_type;
+  using SVMCommon::set_support_vectors;
 
  public:
   SVMClassifier(const OpKernelInfo& info);
@@ -34,6 +34,7 @@ SVMRegressor<T>::SVMRegressor(const OpKernelInfo& info)
     mode_ = SVM_TYPE::SVM_LINEAR;
     set_kernel_type(KERNEL::LINEAR);
   }
+  set_support_vectors(support_vectors_, vector_count_);
 }
 
 template <typename T>
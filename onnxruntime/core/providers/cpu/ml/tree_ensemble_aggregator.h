@@ -40,26 +40,27 @@ struct ScoreValue {
   }
 };
 
-enum MissingTrack {
-  kNone,
-  kTrue,
-  kFalse
+enum TreeNodeFlags : uint8_t {
+  kNodeModeMask = 0x7,  // NODE_MODE of the node
+  kMissingTrackTrue = 0x8,
 };
 
+// A node of a tree. The nodes of a tree are stored in depth first order with the false child of a node right after
+// it, so only the index of the true child is needed and a node with float thresholds fits in 16 bytes. The weights of
+// the leaves are stored apart from the nodes, as they are only read once a leaf is reached.
 template <typename T>
 struct TreeNodeElement {
-  TreeNodeElementId id;
+  // feature compared to the threshold, or for a leaf the number of its weights
   int feature_id;
   T value;
-  T hitrates;
-  NODE_MODE mode;
-  TreeNodeElement<T>* truenode;
-  TreeNodeElement<T>* falsenode;
-  MissingTrack missing_tracks;
-  std::vector<SparseValue<T>> weights;
-
-  bool is_not_leaf;
-  bool is_missing_track_true;
+  // index of the true child, or for a leaf the index of its first weight
+  uint32_t truenode_or_weight;
+  uint8_t flags;
+
+  NODE_MODE mode() const { return static_cast<NODE_MODE>(flags & kNodeModeMask); }
+  bool is_not_leaf() const { return mode() != NODE_MODE::LEAF; }
+  bool is_missing_track_true() const { return (flags & kMissingTrackTrue) != 0; }
+  int64_t n_weights() const { return feature_id; }
 };
 
 template <typename ITYPE, typename OTYPE>
@@ -83,7 +84,8 @@ class TreeAggregator {
 
   // 1 output
 
-  void ProcessTreeNodePrediction1(ScoreValue<OTYPE>& /*prediction*/, const TreeNodeElement<OTYPE>& /*root*/) const {}
+  void ProcessTreeNodePrediction1(ScoreValue<OTYPE>& /*prediction*/, const TreeNodeElement<OTYPE>& /*root*/,
+                                  const std::vector<SparseValue<OTYPE>>& /*weights*/) const {}
 
   void MergePrediction1(ScoreValue<OTYPE>& /*prediction*/, ScoreValue<OTYPE>& /*prediction2*/) const {}
 
@@ -94,7 +96,8 @@ class TreeAggregator {
 
   // N outputs
 
-  void ProcessTreeNodePrediction(std::vector<ScoreValue<OTYPE>>& /*predictions*/, const TreeNodeElement<OTYPE>& /*root*/) const {}
+  void ProcessTreeNodePrediction(std::vector<ScoreValue<OTYPE>>& /*predictions*/, const TreeNodeElement<OTYPE>& /*root*/,
+                                 const std::vector<SparseValue<OTYPE>>& /*weights*/) const {}
 
   void MergePrediction(std::vector<ScoreValue<OTYPE>>& /*predictions*/, const std::vector<ScoreValue<OTYPE>>& /*predictions2*/) const {}
 
@@ -126,8 +129,9 @@ class TreeAggregatorSum : public TreeAggregator<ITYPE, OTYPE> {
 
   // 1 output
 
-  void ProcessTreeNodePrediction1(ScoreValue<OTYPE>& prediction, const TreeNodeElement<OTYPE>& root) const {
-    prediction.score += root.weights[0].value;
+  void ProcessTreeNodePrediction1(ScoreValue<OTYPE>& prediction, const TreeNodeElement<OTYPE>& root,
+                                  const std::vector<SparseValue<OTYPE>>& weights) const {
+    prediction.score += weights[root.truenode_or_weight].value;
   }
 
   void MergePrediction1(ScoreValue<OTYPE>& prediction, const ScoreValue<OTYPE>& prediction2) const {
@@ -141,8 +145,10 @@ class TreeAggregatorSum : public TreeAggregator<ITYPE, OTYPE> {
 
   // N outputs
 
-  void ProcessTreeNodePrediction(std::vector<ScoreValue<OTYPE>>& predictions, const TreeNodeElement<OTYPE>& root) const {
-    for (auto it = root.weights.cbegin(); it != root.weights.cend(); ++it) {
+  void ProcessTreeNodePrediction(std::vector<ScoreValue<OTYPE>>& predictions, const TreeNodeElement<OTYPE>& root,
+                                 const std::vector<SparseValue<OTYPE>>& weights) const {
+    auto it = weights.cbegin() + root.truenode_or_weight;
+    for (auto end = it + root.n_weights(); it != end; ++it) {
       ORT_ENFORCE(it->i < (int64_t)predictions.size());
       predictions[it->i].score += it->value;
       predictions[it->i].has_score = 1;
@@ -212,9 +218,11 @@ class TreeAggregatorMin : public TreeAggregator<ITYPE, OTYPE> {
 
   // 1 output
 
-  void ProcessTreeNodePrediction1(ScoreValue<OTYPE>& prediction, const TreeNodeElement<OTYPE>& root) const {
-    prediction.score = (!(prediction.has_score) || root.weights[0].value < prediction.score)
-                           ? root.weights[0].value
+  void ProcessTreeNodePrediction1(ScoreValue<OTYPE>& prediction, const TreeNodeElement<OTYPE>& root,
+                                  const std::vector<SparseValue<OTYPE>>& weights) const {
+    const OTYPE weight = weights[root.truenode_or_weight].value;
+    prediction.score = (!(prediction.has_score) || weight < prediction.score)
+                           ? weight
                            : prediction.score;
     prediction.has_score = 1;
   }
@@ -230,8 +238,10 @@ class TreeAggregatorMin : public TreeAggregator<ITYPE, OTYPE> {
 
   // N outputs
 
-  void ProcessTreeNodePrediction(std::vector<ScoreValue<OTYPE>>& predictions, const TreeNodeElement<OTYPE>& root) const {
-    for (auto it = root.weights.begin(); it != root.weights.end(); ++it) {
+  void ProcessTreeNodePrediction(std::vector<ScoreValue<OTYPE>>& predictions, const TreeNodeElement<OTYPE>& root,
+                                 const std::vector<SparseValue<OTYPE>>& weights) const {
+    auto it = weights.cbegin() + root.truenode_or_weight;
+    for (auto end = it + root.n_weights(); it != end; ++it) {
       predictions[it->i].score = (!predictions[it->i].has_score || it->value < predictions[it->i].score)
                                      ? it->value
                                      : predictions[it->i].score;
@@ -263,9 +273,11 @@ class TreeAggregatorMax : public TreeAggregator<ITYPE, OTYPE> {
 
   // 1 output
 
-  void ProcessTreeNodePrediction1(ScoreValue<OTYPE>& prediction, const TreeNodeElement<OTYPE>& root) const {
-    prediction.score = (!(prediction.has_score) || root.weights[0].value > prediction.score)
-                           ? root.weights[0].value
+  void ProcessTreeNodePrediction1(ScoreValue<OTYPE>& prediction, const TreeNodeElement<OTYPE>& root,
+                                  const std::vector<SparseValue<OTYPE>>& weights) const {
+    const OTYPE weight = weights[root.truenode_or_weight].value;
+    prediction.score = (!(prediction.has_score) || weight > prediction.score)
+                           ? weight
                            : prediction.score;
     prediction.has_score = 1;
   }
@@ -281,8 +293,10 @@ class TreeAggregatorMax : public TreeAggregator<ITYPE, OTYPE> {
 
   // N outputs
 
-  void ProcessTreeNodePrediction(std::vector<ScoreValue<OTYPE>>& predictions, const TreeNodeElement<OTYPE>& root) const {
-    for (auto it = root.weights.begin(); it != root.weights.end(); ++it) {
+  void ProcessTreeNodePrediction(std::vector<ScoreValue<OTYPE>>& predictions, const TreeNodeElement<OTYPE>& root,
+                                 const std::vector<SparseValue<OTYPE>>& weights) const {
+    auto it = weights.cbegin() + root.truenode_or_weight;
+    for (auto end = it + root.n_weights(); it != end; ++it) {
       predictions[it->i].score = (!predictions[it->i].has_score || it->value > predictions[it->i].score)
                                      ? it->value
                                      : predictions[it->i].score;
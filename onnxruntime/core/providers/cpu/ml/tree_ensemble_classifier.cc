@@ -158,7 +158,8 @@ TreeEnsembleClassifier<T>::TreeEnsembleClassifier(const OpKernelInfo& info)
           info.GetAttrsOrDefault<int64_t>("class_treeids"),
           info.GetAttrsOrDefault<float>("class_weights"),
           info.GetAttrsOrDefault<std::string>("classlabels_strings"),
-          info.GetAttrsOrDefault<int64_t>("classlabels_int64s")) {
+          info.GetAttrsOrDefault<int64_t>("classlabels_int64s"),
+          detail::UseQuickScorer(info)) {
 }  // namespace ml
 
 template <typename T>
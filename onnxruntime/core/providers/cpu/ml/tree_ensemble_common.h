@@ -3,26 +3,62 @@
 
 #pragma once
 
+#include <algorithm>
+#include <limits>
 #include "tree_ensemble_aggregator.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 
 namespace onnxruntime {
 namespace ml {
 namespace detail {
 
+// Returns true if the execution provider of the kernel asks for the trees to be evaluated with QuickScorer.
+inline bool UseQuickScorer(const OpKernelInfo& info) {
+  const auto* provider = info.GetExecutionProvider();
+  return provider->Type() == kCpuExecutionProvider &&
+         static_cast<const CPUExecutionProvider*>(provider)->GetTreeEnsembleEvaluation() ==
+             TreeEnsembleEvaluation::kQuickScorer;
+}
+
+// Returns the index of the lowest bit set in a non zero value.
+inline uint32_t LowestBitIndex(uint64_t value) {
+  static const uint8_t kDeBruijnIndex[64] = {
+      0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+      62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+      63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+      46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6};
+  return kDeBruijnIndex[((value & (~value + 1)) * 0x03f79d71b4cb0a89ULL) >> 58];
+}
+
 template <typename ITYPE, typename OTYPE>
 class TreeEnsembleCommon {
  public:
   int64_t n_targets_or_classes_;
 
  protected:
+  // number of rows going through a tree before moving to the next tree when there are several rows, so the nodes of a
+  // tree are read from the cache for all of them but the first
+  static constexpr int64_t kRowBlockSize = 16;
+  // maximum number of leaves of a tree evaluated with QuickScorer, the size of the bitvectors
+  static constexpr uint32_t kQuickScorerMaxLeaves = 64;
+
+  struct QuickScorerNode {
+    int feature_id;
+    OTYPE threshold;
+    uint32_t tree;
+    uint64_t mask;
+  };
+
   std::vector<OTYPE> base_values_;
   POST_EVAL_TRANSFORM post_transform_;
   AGGREGATE_FUNCTION aggregate_function_;
   int64_t n_nodes_;
   std::vector<TreeNodeElement<OTYPE>> nodes_;
-  std::vector<TreeNodeElement<OTYPE>*> roots_;
+  std::vector<const TreeNodeElement<OTYPE>*> roots_;
+  // weights of the leaves, the ones of a leaf are contiguous
+  std::vector<SparseValue<OTYPE>> weights_;
 
   int64_t max_tree_depth_;
   int64_t n_trees_;
@@ -31,6 +67,16 @@ class TreeEnsembleCommon {
   int parallel_tree_;  // starts parallelizing the computing if n_tree >= parallel_tree_ and n_rows == 1
   int parallel_N_;     // starts parallelizing the computing if n_rows >= parallel_N_
 
+  // QuickScorer tables, see InitQuickScorer, only filled if use_quickscorer_ is true
+  bool use_quickscorer_;
+  std::vector<int> qs_features_;        // features the nodes test
+  std::vector<size_t> qs_feature_begin_;  // index of the first node of each feature in the arrays below, and the end
+  std::vector<OTYPE> qs_thresholds_;    // thresholds of the nodes, sorted by feature then threshold
+  std::vector<uint32_t> qs_trees_;      // tree of each node
+  std::vector<uint64_t> qs_masks_;      // leaves of its tree a node leaves reachable when its condition is false
+  std::vector<size_t> qs_leaf_begin_;   // index of the first leaf of each tree in qs_leaves_
+  std::vector<const TreeNodeElement<OTYPE>*> qs_leaves_;  // leaves of each tree from the true side to the false side
+
  public:
   TreeEnsembleCommon(int parallel_tree,
                      int parallel_N,
@@ -50,16 +96,40 @@ class TreeEnsembleCommon {
                      const std::vector<int64_t>& target_class_ids,
                      const std::vector<int64_t>& target_class_nodeids,
                      const std::vector<int64_t>& target_class_treeids,
-                     const std::vector<OTYPE>& target_class_weights);
+                     const std::vector<OTYPE>& target_class_weights,
+                     bool use_quickscorer);
 
   void compute(OpKernelContext* ctx, const Tensor* X, Tensor* Z, Tensor* label) const;
 
  protected:
-  TreeNodeElement<OTYPE>* ProcessTreeNodeLeave(
-      TreeNodeElement<OTYPE>* root, const ITYPE* x_data) const;
+  const TreeNodeElement<OTYPE>* ProcessTreeNodeLeave(
+      const TreeNodeElement<OTYPE>* root, const ITYPE* x_data) const;
 
   template <typename AGG>
   void ComputeAgg(concurrency::ThreadPool* ttp, const Tensor* X, Tensor* Z, Tensor* label, const AGG& agg) const;
+
+  // Computes the rows [begin, end) with one target, kRowBlockSize rows at a time.
+  template <typename AGG>
+  void ComputeRows1(const AGG& agg, const ITYPE* x_data, OTYPE* z_data, int64_t* label_data, int64_t stride,
+                    int64_t begin, int64_t end) const;
+
+  // Computes the rows [begin, end) with several targets or classes, kRowBlockSize rows at a time.
+  template <typename AGG>
+  void ComputeRows(const AGG& agg, const ITYPE* x_data, OTYPE* z_data, int64_t* label_data, int64_t stride,
+                   int64_t begin, int64_t end) const;
+
+  // Builds the QuickScorer tables. Returns false if the ensemble can't be evaluated with QuickScorer.
+  bool InitQuickScorer();
+
+  // Adds the nodes of the subtree to qs_nodes and its leaves to qs_leaves_, returns the number of leaves.
+  uint32_t AddQuickScorerNodes(const TreeNodeElement<OTYPE>* node, uint32_t tree, uint32_t first_leaf,
+                               std::vector<QuickScorerNode>& qs_nodes);
+
+  // Computes the bitvectors of the leaves the n_rows rows of a block can reach in every tree, kRowBlockSize per tree,
+  // the lowest bit set of each one is the leaf the row ends in. features is a buffer of
+  // qs_features_.size() * kRowBlockSize values.
+  void ComputeQuickScorerBitvectors(const ITYPE* x_block, int64_t stride, int64_t n_rows,
+                                    ITYPE* features, uint64_t* bitvectors) const;
 };
 
 template <typename ITYPE, typename OTYPE>
@@ -80,7 +150,9 @@ TreeEnsembleCommon<ITYPE, OTYPE>::TreeEnsembleCommon(int parallel_tree, int para
                                                      const std::vector<int64_t>& target_class_ids,
                                                      const std::vector<int64_t>& target_class_nodeids,
                                                      const std::vector<int64_t>& target_class_treeids,
-                                                     const std::vector<OTYPE>& target_class_weights) {
+                                                     const std::vector<OTYPE>& target_class_weights,
+                                                     bool use_quickscorer) {
+  ORT_UNUSED_PARAMETER(nodes_hitrates);
   parallel_tree_ = parallel_tree;
   parallel_N_ = parallel_N;
 
@@ -117,91 +189,118 @@ TreeEnsembleCommon<ITYPE, OTYPE>::TreeEnsembleCommon(int parallel_tree, int para
       same_mode_ = false;
   }
 
-  // filling nodes
+  // index of the attributes of each node
 
-  n_nodes_ = nodes_treeids.size();
-  nodes_.resize(n_nodes_);
-  roots_.clear();
-  std::map<TreeNodeElementId, TreeNodeElement<OTYPE>*> idi;
+  const size_t n_input_nodes = nodes_treeids.size();
+  std::map<TreeNodeElementId, size_t> idi;
+  TreeNodeElementId coor;
   size_t i;
-
-  for (i = 0; i < nodes_treeids.size(); ++i) {
-    TreeNodeElement<OTYPE>& node = nodes_[i];
-    node.id.tree_id = static_cast<int>(nodes_treeids[i]);
-    node.id.node_id = static_cast<int>(nodes_nodeids[i]);
-    node.feature_id = static_cast<int>(nodes_featureids[i]);
-    node.value = nodes_values[i];
-    node.hitrates = i < nodes_hitrates.size() ? nodes_hitrates[i] : -1;
-    node.mode = cmodes[i];
-    node.is_not_leaf = node.mode != NODE_MODE::LEAF;
-    node.truenode = nullptr;   // nodes_truenodeids[i];
-    node.falsenode = nullptr;  // nodes_falsenodeids[i];
-    node.missing_tracks = i < static_cast<size_t>(nodes_missing_value_tracks_true.size())
-                              ? (nodes_missing_value_tracks_true[i] == 1
-                                     ? MissingTrack::kTrue
-                                     : MissingTrack::kFalse)
-                              : MissingTrack::kNone;
-    node.is_missing_track_true = node.missing_tracks == MissingTrack::kTrue;
-    if (idi.find(node.id) != idi.end()) {
-      ORT_THROW("Node ", node.id.node_id, " in tree ", node.id.tree_id, " is already there.");
+  for (i = 0; i < n_input_nodes; ++i) {
+    coor.tree_id = static_cast<int>(nodes_treeids[i]);
+    coor.node_id = static_cast<int>(nodes_nodeids[i]);
+    if (!idi.insert(std::pair<TreeNodeElementId, size_t>(coor, i)).second) {
+      ORT_THROW("Node ", coor.node_id, " in tree ", coor.tree_id, " is already there.");
     }
-    idi.insert(std::pair<TreeNodeElementId, TreeNodeElement<OTYPE>*>(node.id, &node));
   }
 
-  TreeNodeElementId coor;
-  for (auto it = nodes_.begin(); it != nodes_.end(); ++it, ++i) {
-    if (!it->is_not_leaf)
-      continue;
-    i = std::distance(nodes_.begin(), it);
-    coor.tree_id = it->id.tree_id;
-    coor.node_id = static_cast<int>(nodes_truenodeids[i]);
-
+  std::vector<std::vector<SparseValue<OTYPE>>> leaf_weights(n_input_nodes);
+  SparseValue<OTYPE> w;
+  for (i = 0; i < target_class_nodeids.size(); i++) {
+    coor.tree_id = static_cast<int>(target_class_treeids[i]);
+    coor.node_id = static_cast<int>(target_class_nodeids[i]);
     auto found = idi.find(coor);
     if (found == idi.end()) {
-      ORT_THROW("Unable to find node ", coor.tree_id, "-", coor.node_id, " (truenode).");
+      ORT_THROW("Unable to find node ", coor.tree_id, "-", coor.node_id, " (weights).");
     }
-    if (coor.node_id >= 0 && coor.node_id < n_nodes_) {
-      it->truenode = found->second;
-      if ((it->truenode->id.tree_id != it->id.tree_id) ||
-          (it->truenode->id.node_id == it->id.node_id)) {
-        ORT_THROW("One falsenode is pointing either to itself, either to another tree.");
+    w.i = target_class_ids[i];
+    w.value = target_class_weights[i];
+    leaf_weights[found->second].push_back(w);
+  }
+
+  // filling nodes, tree by tree in depth first order with the false child of a node right after it.
+  // every node must be reached once: a node shared by several parents would be copied and a cycle never ends.
+
+  struct PendingNode {
+    size_t index;        // index of the node in the attributes
+    size_t true_parent;  // index in nodes_ of the node this one is the true child of, n_input_nodes if none
+  };
+  std::vector<PendingNode> pending;
+  std::vector<bool> visited(n_input_nodes, false);
+  std::vector<size_t> root_indices;
+  nodes_.reserve(n_input_nodes);
+  int64_t previous = -1;
+  for (size_t root = 0; root < n_input_nodes; ++root) {
+    if ((previous != -1) && (previous == nodes_treeids[root]))
+      continue;
+    previous = nodes_treeids[root];
+    root_indices.push_back(nodes_.size());
+
+    pending.push_back({root, n_input_nodes});
+    while (!pending.empty()) {
+      PendingNode p = pending.back();
+      pending.pop_back();
+      if (visited[p.index]) {
+        ORT_THROW("Node ", nodes_nodeids[p.index], " in tree ", nodes_treeids[p.index],
+                  " is reached more than once, the tree contains a cycle or a node with several parents.");
       }
-    } else
-      it->truenode = nullptr;
+      visited[p.index] = true;
 
-    coor.node_id = static_cast<int>(nodes_falsenodeids[i]);
-    found = idi.find(coor);
-    if (found == idi.end()) {
-      ORT_THROW("Unable to find node ", coor.tree_id, "-", coor.node_id, " (falsenode).");
-    }
-    if (coor.node_id >= 0 && coor.node_id < n_nodes_) {
-      it->falsenode = found->second;
-      if ((it->falsenode->id.tree_id != it->id.tree_id) ||
-          (it->falsenode->id.node_id == it->id.node_id)) {
+      const size_t index = nodes_.size();
+      ORT_ENFORCE(index < std::numeric_limits<uint32_t>::max(), "Too many nodes in TreeEnsemble.");
+      if (p.true_parent != n_input_nodes) {
+        nodes_[p.true_parent].truenode_or_weight = static_cast<uint32_t>(index);
+      }
+
+      i = p.index;
+      TreeNodeElement<OTYPE> node;
+      node.value = nodes_values[i];
+      node.flags = static_cast<uint8_t>(cmodes[i]);
+      if (i < nodes_missing_value_tracks_true.size() && nodes_missing_value_tracks_true[i] == 1) {
+        node.flags |= kMissingTrackTrue;
+      }
+
+      if (cmodes[i] == NODE_MODE::LEAF) {
+        auto& weights = leaf_weights[i];
+        // the aggregators with one target read the first weight of every leaf
+        if (weights.empty() && n_targets_or_classes_ == 1) {
+          weights.push_back({0, 0});
+        }
+        node.feature_id = static_cast<int>(weights.size());
+        node.truenode_or_weight = static_cast<uint32_t>(weights_.size());
+        weights_.insert(weights_.end(), weights.begin(), weights.end());
+        nodes_.push_back(node);
+        continue;
+      }
+
+      node.feature_id = static_cast<int>(nodes_featureids[i]);
+      node.truenode_or_weight = 0;
+      nodes_.push_back(node);
+
+      coor.tree_id = static_cast<int>(nodes_treeids[i]);
+      coor.node_id = static_cast<int>(nodes_truenodeids[i]);
+      auto found_true = idi.find(coor);
+      if (found_true == idi.end()) {
+        ORT_THROW("Unable to find node ", coor.tree_id, "-", coor.node_id, " (truenode).");
+      }
+      coor.node_id = static_cast<int>(nodes_falsenodeids[i]);
+      auto found_false = idi.find(coor);
+      if (found_false == idi.end()) {
+        ORT_THROW("Unable to find node ", coor.tree_id, "-", coor.node_id, " (falsenode).");
+      }
+      if (found_true->second == i || found_false->second == i) {
         ORT_THROW("One falsenode is pointing either to itself, either to another tree.");
       }
-    } else
-      it->falsenode = nullptr;
-  }
 
-  int64_t previous = -1;
-  for (i = 0; i < static_cast<size_t>(n_nodes_); ++i) {
-    if ((previous == -1) || (previous != nodes_[i].id.tree_id))
-      roots_.push_back(&(nodes_[i]));
-    previous = nodes_[i].id.tree_id;
+      // the false child is popped first so it's stored right after its parent
+      pending.push_back({found_true->second, index});
+      pending.push_back({found_false->second, n_input_nodes});
+    }
   }
 
-  TreeNodeElementId ind;
-  SparseValue<OTYPE> w;
-  for (i = 0; i < target_class_nodeids.size(); i++) {
-    ind.tree_id = static_cast<int>(target_class_treeids[i]);
-    ind.node_id = static_cast<int>(target_class_nodeids[i]);
-    if (idi.find(ind) == idi.end()) {
-      ORT_THROW("Unable to find node ", coor.tree_id, "-", coor.node_id, " (weights).");
-    }
-    w.i = target_class_ids[i];
-    w.value = target_class_weights[i];
-    idi[ind]->weights.push_back(w);
+  n_nodes_ = nodes_.size();
+  roots_.clear();
+  for (auto root_index : root_indices) {
+    roots_.push_back(&nodes_[root_index]);
   }
 
   n_trees_ = roots_.size();
@@ -213,6 +312,8 @@ TreeEnsembleCommon<ITYPE, OTYPE>::TreeEnsembleCommon(int parallel_tree, int para
       break;
     }
   }
+
+  use_quickscorer_ = use_quickscorer && InitQuickScorer();
 }
 
 template <typename ITYPE, typename OTYPE>
@@ -268,7 +369,7 @@ void TreeEnsembleCommon<ITYPE, OTYPE>::ComputeAgg(concurrency::ThreadPool* ttp,
       ScoreValue<OTYPE> score = {0, 0};
       if (n_trees_ <= parallel_tree_) {
         for (int64_t j = 0; j < n_trees_; ++j) {
-          agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(roots_[j], x_data));
+          agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(roots_[j], x_data), weights_);
         }
       } else {
         std::vector<ScoreValue<OTYPE>> scores_t(n_trees_, {0, 0});
@@ -276,7 +377,7 @@ void TreeEnsembleCommon<ITYPE, OTYPE>::ComputeAgg(concurrency::ThreadPool* ttp,
             ttp,
             SafeInt<int32_t>(n_trees_),
             [this, &scores_t, &agg, x_data](ptrdiff_t j) {
-              agg.ProcessTreeNodePrediction1(scores_t[j], *ProcessTreeNodeLeave(roots_[j], x_data));
+              agg.ProcessTreeNodePrediction1(scores_t[j], *ProcessTreeNodeLeave(roots_[j], x_data), weights_);
             },
             0);
 
@@ -288,32 +389,17 @@ void TreeEnsembleCommon<ITYPE, OTYPE>::ComputeAgg(concurrency::ThreadPool* ttp,
       agg.FinalizeScores1(z_data, score, label_data);
     } else {
       if (N <= parallel_N_) {
-        ScoreValue<OTYPE> score;
-        size_t j;
-
-        for (int64_t i = 0; i < N; ++i) {
-          score = {0, 0};
-          for (j = 0; j < static_cast<size_t>(n_trees_); ++j) {
-            agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
-          }
-
-          agg.FinalizeScores1(z_data + i * n_targets_or_classes_, score,
-                              label_data == nullptr ? nullptr : (label_data + i));
-        }
+        ComputeRows1(agg, x_data, z_data, label_data, stride, 0, N);
       } else {
-        concurrency::ThreadPool::TryBatchParallelFor(
+        // TODO: Refine the number of threads used
+        auto num_threads = std::min<int32_t>(concurrency::ThreadPool::DegreeOfParallelism(ttp), SafeInt<int32_t>(N));
+        concurrency::ThreadPool::TrySimpleParallelFor(
             ttp,
-            SafeInt<int32_t>(N),
-            [this, &agg, x_data, z_data, stride, label_data](ptrdiff_t i) {
-              ScoreValue<OTYPE> score = {0, 0};
-              for (size_t j = 0; j < static_cast<size_t>(n_trees_); ++j) {
-                agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
-              }
-
-              agg.FinalizeScores1(z_data + i * n_targets_or_classes_, score,
-                                  label_data == nullptr ? nullptr : (label_data + i));
-            },
-            0);
+            num_threads,
+            [this, &agg, num_threads, x_data, z_data, label_data, N, stride](ptrdiff_t batch_num) {
+              auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, N);
+              ComputeRows1(agg, x_data, z_data, label_data, stride, work.start, work.end);
+            });
       }
     }
   } else {
@@ -321,7 +407,7 @@ void TreeEnsembleCommon<ITYPE, OTYPE>::ComputeAgg(concurrency::ThreadPool* ttp,
       std::vector<ScoreValue<OTYPE>> scores(n_targets_or_classes_, {0, 0});
       if (n_trees_ <= parallel_tree_) {
         for (int64_t j = 0; j < n_trees_; ++j) {
-          agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(roots_[j], x_data));
+          agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(roots_[j], x_data), weights_);
         }
       } else {
         // split the work into one block per thread so we can re-use the 'private_scores' vector as much as possible
@@ -335,7 +421,7 @@ void TreeEnsembleCommon<ITYPE, OTYPE>::ComputeAgg(concurrency::ThreadPool* ttp,
               std::vector<ScoreValue<OTYPE>> private_scores(n_targets_or_classes_, {0, 0});
               auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, n_trees_);
               for (auto j = work.start; j < work.end; ++j) {
-                agg.ProcessTreeNodePrediction(private_scores, *ProcessTreeNodeLeave(roots_[j], x_data));
+                agg.ProcessTreeNodePrediction(private_scores, *ProcessTreeNodeLeave(roots_[j], x_data), weights_);
               }
 
               std::lock_guard<OrtMutex> lock(merge_mutex);
@@ -346,60 +432,120 @@ void TreeEnsembleCommon<ITYPE, OTYPE>::ComputeAgg(concurrency::ThreadPool* ttp,
       agg.FinalizeScores(scores, z_data, -1, label_data);
     } else {
       if (N <= parallel_N_) {
-        std::vector<ScoreValue<OTYPE>> scores(n_targets_or_classes_);
-        size_t j;
-
-        for (int64_t i = 0; i < N; ++i) {
-          std::fill(scores.begin(), scores.end(), ScoreValue<OTYPE>({0, 0}));
-          for (j = 0; j < roots_.size(); ++j) {
-            agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
-          }
-
-          agg.FinalizeScores(scores, z_data + i * n_targets_or_classes_, -1,
-                             label_data == nullptr ? nullptr : (label_data + i));
-        }
+        ComputeRows(agg, x_data, z_data, label_data, stride, 0, N);
       } else {
-        // split the work into one block per thread so we can re-use the 'scores' vector as much as possible
+        // split the work into one block per thread so we can re-use the 'scores' vectors as much as possible
         // TODO: Refine the number of threads used.
         auto num_threads = std::min<int32_t>(concurrency::ThreadPool::DegreeOfParallelism(ttp), SafeInt<int32_t>(N));
         concurrency::ThreadPool::TrySimpleParallelFor(
             ttp,
             num_threads,
             [this, &agg, num_threads, x_data, z_data, label_data, N, stride](ptrdiff_t batch_num) {
-              size_t j;
-              std::vector<ScoreValue<OTYPE>> scores(n_targets_or_classes_);
               auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, N);
+              ComputeRows(agg, x_data, z_data, label_data, stride, work.start, work.end);
+            });
+      }
+    }
+  }
+}
+
+template <typename ITYPE, typename OTYPE>
+template <typename AGG>
+void TreeEnsembleCommon<ITYPE, OTYPE>::ComputeRows1(const AGG& agg, const ITYPE* x_data, OTYPE* z_data,
+                                                    int64_t* label_data, int64_t stride,
+                                                    int64_t begin, int64_t end) const {
+  ScoreValue<OTYPE> scores[kRowBlockSize];
+  std::vector<ITYPE> features(use_quickscorer_ ? qs_features_.size() * kRowBlockSize : 0);
+  std::vector<uint64_t> bitvectors(use_quickscorer_ ? static_cast<size_t>(n_trees_ * kRowBlockSize) : 0);
+  for (int64_t block = begin; block < end; block += kRowBlockSize) {
+    const int64_t n_rows = end - block < kRowBlockSize ? end - block : kRowBlockSize;
+    const ITYPE* x_block = x_data + block * stride;
+    std::fill(scores, scores + n_rows, ScoreValue<OTYPE>({0, 0}));
+
+    if (use_quickscorer_) {
+      ComputeQuickScorerBitvectors(x_block, stride, n_rows, features.data(), bitvectors.data());
+      for (size_t j = 0; j < static_cast<size_t>(n_trees_); ++j) {
+        const uint64_t* tree_bitvectors = bitvectors.data() + j * kRowBlockSize;
+        const TreeNodeElement<OTYPE>* const* leaves = qs_leaves_.data() + qs_leaf_begin_[j];
+        for (int64_t r = 0; r < n_rows; ++r) {
+          agg.ProcessTreeNodePrediction1(scores[r], *leaves[LowestBitIndex(tree_bitvectors[r])], weights_);
+        }
+      }
+    } else {
+      // The rows of the block go through the same tree one after the other. Their paths don't depend on each other so
+      // the loads of several rows are in flight at the same time.
+      for (size_t j = 0; j < static_cast<size_t>(n_trees_); ++j) {
+        const TreeNodeElement<OTYPE>* root = roots_[j];
+        for (int64_t r = 0; r < n_rows; ++r) {
+          agg.ProcessTreeNodePrediction1(scores[r], *ProcessTreeNodeLeave(root, x_block + r * stride), weights_);
+        }
+      }
+    }
 
-              for (auto i = work.start; i < work.end; ++i) {
-                std::fill(scores.begin(), scores.end(), ScoreValue<OTYPE>({0, 0}));
-                for (j = 0; j < roots_.size(); ++j) {
-                  agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
-                }
+    for (int64_t r = 0; r < n_rows; ++r) {
+      agg.FinalizeScores1(z_data + (block + r) * n_targets_or_classes_, scores[r],
+                          label_data == nullptr ? nullptr : (label_data + block + r));
+    }
+  }
+}
 
-                agg.FinalizeScores(scores,
-                                   z_data + i * n_targets_or_classes_, -1,
-                                   label_data == nullptr ? nullptr : (label_data + i));
-              }
-            });
+template <typename ITYPE, typename OTYPE>
+template <typename AGG>
+void TreeEnsembleCommon<ITYPE, OTYPE>::ComputeRows(const AGG& agg, const ITYPE* x_data, OTYPE* z_data,
+                                                   int64_t* label_data, int64_t stride,
+                                                   int64_t begin, int64_t end) const {
+  std::vector<std::vector<ScoreValue<OTYPE>>> scores(
+      static_cast<size_t>(end - begin < kRowBlockSize ? end - begin : kRowBlockSize),
+      std::vector<ScoreValue<OTYPE>>(n_targets_or_classes_));
+  std::vector<ITYPE> features(use_quickscorer_ ? qs_features_.size() * kRowBlockSize : 0);
+  std::vector<uint64_t> bitvectors(use_quickscorer_ ? static_cast<size_t>(n_trees_ * kRowBlockSize) : 0);
+  for (int64_t block = begin; block < end; block += kRowBlockSize) {
+    const int64_t n_rows = end - block < kRowBlockSize ? end - block : kRowBlockSize;
+    const ITYPE* x_block = x_data + block * stride;
+    for (int64_t r = 0; r < n_rows; ++r) {
+      std::fill(scores[r].begin(), scores[r].end(), ScoreValue<OTYPE>({0, 0}));
+    }
+
+    if (use_quickscorer_) {
+      ComputeQuickScorerBitvectors(x_block, stride, n_rows, features.data(), bitvectors.data());
+      for (size_t j = 0; j < static_cast<size_t>(n_trees_); ++j) {
+        const uint64_t* tree_bitvectors = bitvectors.data() + j * kRowBlockSize;
+        const TreeNodeElement<OTYPE>* const* leaves = qs_leaves_.data() + qs_leaf_begin_[j];
+        for (int64_t r = 0; r < n_rows; ++r) {
+          agg.ProcessTreeNodePrediction(scores[r], *leaves[LowestBitIndex(tree_bitvectors[r])], weights_);
+        }
+      }
+    } else {
+      for (size_t j = 0; j < static_cast<size_t>(n_trees_); ++j) {
+        const TreeNodeElement<OTYPE>* root = roots_[j];
+        for (int64_t r = 0; r < n_rows; ++r) {
+          agg.ProcessTreeNodePrediction(scores[r], *ProcessTreeNodeLeave(root, x_block + r * stride), weights_);
+        }
       }
     }
+
+    for (int64_t r = 0; r < n_rows; ++r) {
+      agg.FinalizeScores(scores[r], z_data + (block + r) * n_targets_or_classes_, -1,
+                         label_data == nullptr ? nullptr : (label_data + block + r));
+    }
   }
-}  // namespace detail
+}
 
-#define TREE_FIND_VALUE(CMP)                                         \
-  if (has_missing_tracks_) {                                         \
-    while (root->is_not_leaf) {                                      \
-      val = x_data[root->feature_id];                                \
-      root = (val CMP root->value ||                                 \
-              (root->is_missing_track_true && _isnan_(val)))         \
-                 ? root->truenode                                    \
-                 : root->falsenode;                                  \
-    }                                                                \
-  } else {                                                           \
-    while (root->is_not_leaf) {                                      \
-      val = x_data[root->feature_id];                                \
-      root = val CMP root->value ? root->truenode : root->falsenode; \
-    }                                                                \
+#define TREE_FIND_VALUE(CMP)                                            \
+  if (has_missing_tracks_) {                                            \
+    while (root->is_not_leaf()) {                                       \
+      val = x_data[root->feature_id];                                   \
+      root = (val CMP root->value ||                                    \
+              (root->is_missing_track_true() && _isnan_(val)))          \
+                 ? nodes + root->truenode_or_weight                     \
+                 : root + 1;                                            \
+    }                                                                   \
+  } else {                                                              \
+    while (root->is_not_leaf()) {                                       \
+      val = x_data[root->feature_id];                                   \
+      root = val CMP root->value ? nodes + root->truenode_or_weight     \
+                                 : root + 1;                            \
+    }                                                                   \
   }
 
 inline bool _isnan_(float x) { return std::isnan(x); }
@@ -408,25 +554,27 @@ inline bool _isnan_(int64_t) { return false; }
 inline bool _isnan_(int32_t) { return false; }
 
 template <typename ITYPE, typename OTYPE>
-TreeNodeElement<OTYPE>*
+const TreeNodeElement<OTYPE>*
 TreeEnsembleCommon<ITYPE, OTYPE>::ProcessTreeNodeLeave(
-    TreeNodeElement<OTYPE>* root, const ITYPE* x_data) const {
+    const TreeNodeElement<OTYPE>* root, const ITYPE* x_data) const {
+  // the false child of a node is the next node
+  const TreeNodeElement<OTYPE>* nodes = nodes_.data();
   ITYPE val;
   if (same_mode_) {
-    switch (root->mode) {
+    switch (root->mode()) {
       case NODE_MODE::BRANCH_LEQ:
         if (has_missing_tracks_) {
-          while (root->is_not_leaf) {
+          while (root->is_not_leaf()) {
             val = x_data[root->feature_id];
             root = (val <= root->value ||
-                    (root->is_missing_track_true && _isnan_(val)))
-                       ? root->truenode
-                       : root->falsenode;
+                    (root->is_missing_track_true() && _isnan_(val)))
+                       ? nodes + root->truenode_or_weight
+                       : root + 1;
           }
         } else {
-          while (root->is_not_leaf) {
+          while (root->is_not_leaf()) {
             val = x_data[root->feature_id];
-            root = val <= root->value ? root->truenode : root->falsenode;
+            root = val <= root->value ? nodes + root->truenode_or_weight : root + 1;
           }
         }
         break;
@@ -450,48 +598,155 @@ TreeEnsembleCommon<ITYPE, OTYPE>::ProcessTreeNodeLeave(
     }
   } else {  // Different rules to compare to node thresholds.
     OTYPE threshold;
-    while (root->is_not_leaf) {
+    bool condition;
+    while (root->is_not_leaf()) {
       val = x_data[root->feature_id];
       threshold = root->value;
-      switch (root->mode) {
+      switch (root->mode()) {
         case NODE_MODE::BRANCH_LEQ:
-          root = val <= threshold || (root->is_missing_track_true && _isnan_(val))
-                     ? root->truenode
-                     : root->falsenode;
+          condition = val <= threshold;
           break;
         case NODE_MODE::BRANCH_LT:
-          root = val < threshold || (root->is_missing_track_true && _isnan_(val))
-                     ? root->truenode
-                     : root->falsenode;
+          condition = val < threshold;
           break;
         case NODE_MODE::BRANCH_GTE:
-          root = val >= threshold || (root->is_missing_track_true && _isnan_(val))
-                     ? root->truenode
-                     : root->falsenode;
+          condition = val >= threshold;
           break;
         case NODE_MODE::BRANCH_GT:
-          root = val > threshold || (root->is_missing_track_true && _isnan_(val))
-                     ? root->truenode
-                     : root->falsenode;
+          condition = val > threshold;
           break;
         case NODE_MODE::BRANCH_EQ:
-          root = val == threshold || (root->is_missing_track_true && _isnan_(val))
-                     ? root->truenode
-                     : root->falsenode;
+          condition = val == threshold;
           break;
         case NODE_MODE::BRANCH_NEQ:
-          root = val != threshold || (root->is_missing_track_true && _isnan_(val))
-                     ? root->truenode
-                     : root->falsenode;
+          condition = val != threshold;
           break;
-        case NODE_MODE::LEAF:
+        default:
+          condition = false;
           break;
       }
+      root = condition || (root->is_missing_track_true() && _isnan_(val))
+                 ? nodes + root->truenode_or_weight
+                 : root + 1;
     }
   }
   return root;
 }
 
+// QuickScorer (Lucchese et al., 2015) numbers the leaves of every tree from the true side to the false side. A node
+// whose condition is false for a row removes the leaves of its true subtree from the ones the row can reach, and the
+// row ends in the first leaf no node removed. The nodes are grouped by feature and sorted by threshold, so the nodes
+// whose condition is false for a row are the ones of each feature with a threshold below the value of the feature.
+template <typename ITYPE, typename OTYPE>
+bool TreeEnsembleCommon<ITYPE, OTYPE>::InitQuickScorer() {
+  if (has_missing_tracks_) {
+    return false;
+  }
+  for (const auto& node : nodes_) {
+    if (node.is_not_leaf() && node.mode() != NODE_MODE::BRANCH_LEQ) {
+      return false;
+    }
+  }
+  // the nodes of a tree are stored from its root to the root of the next tree
+  for (size_t j = 0; j < roots_.size(); ++j) {
+    const TreeNodeElement<OTYPE>* tree_end = j + 1 < roots_.size() ? roots_[j + 1] : nodes_.data() + nodes_.size();
+    uint32_t n_leaves = 0;
+    for (const TreeNodeElement<OTYPE>* node = roots_[j]; node != tree_end; ++node) {
+      n_leaves += node->is_not_leaf() ? 0 : 1;
+    }
+    if (n_leaves > kQuickScorerMaxLeaves) {
+      return false;
+    }
+  }
+
+  std::vector<QuickScorerNode> qs_nodes;
+  qs_leaf_begin_.reserve(roots_.size());
+  for (size_t j = 0; j < roots_.size(); ++j) {
+    qs_leaf_begin_.push_back(qs_leaves_.size());
+    AddQuickScorerNodes(roots_[j], static_cast<uint32_t>(j), 0, qs_nodes);
+  }
+  std::sort(qs_nodes.begin(), qs_nodes.end(), [](const QuickScorerNode& a, const QuickScorerNode& b) {
+    return a.feature_id < b.feature_id || (a.feature_id == b.feature_id && a.threshold < b.threshold);
+  });
+
+  qs_thresholds_.reserve(qs_nodes.size());
+  qs_trees_.reserve(qs_nodes.size());
+  qs_masks_.reserve(qs_nodes.size());
+  for (size_t k = 0; k < qs_nodes.size(); ++k) {
+    if (k == 0 || qs_nodes[k].feature_id != qs_nodes[k - 1].feature_id) {
+      qs_features_.push_back(qs_nodes[k].feature_id);
+      qs_feature_begin_.push_back(k);
+    }
+    qs_thresholds_.push_back(qs_nodes[k].threshold);
+    qs_trees_.push_back(qs_nodes[k].tree);
+    qs_masks_.push_back(qs_nodes[k].mask);
+  }
+  qs_feature_begin_.push_back(qs_nodes.size());
+  return true;
+}
+
+template <typename ITYPE, typename OTYPE>
+uint32_t TreeEnsembleCommon<ITYPE, OTYPE>::AddQuickScorerNodes(const TreeNodeElement<OTYPE>* node, uint32_t tree,
+                                                               uint32_t first_leaf,
+                                                               std::vector<QuickScorerNode>& qs_nodes) {
+  if (!node->is_not_leaf()) {
+    qs_leaves_.push_back(node);
+    return 1;
+  }
+
+  const uint32_t n_true_leaves = AddQuickScorerNodes(nodes_.data() + node->truenode_or_weight, tree, first_leaf,
+                                                     qs_nodes);
+  // the false subtree has at least one leaf so the shift is below 64
+  const uint64_t true_leaves = ((uint64_t{1} << n_true_leaves) - 1) << first_leaf;
+  qs_nodes.push_back({node->feature_id, node->value, tree, ~true_leaves});
+  return n_true_leaves + AddQuickScorerNodes(node + 1, tree, first_leaf + n_true_leaves, qs_nodes);
+}
+
+template <typename ITYPE, typename OTYPE>
+void TreeEnsembleCommon<ITYPE, OTYPE>::ComputeQuickScorerBitvectors(const ITYPE* x_block, int64_t stride,
+                                                                    int64_t n_rows, ITYPE* features,
+                                                                    uint64_t* bitvectors) const {
+  // The values of the block are transposed so the rows of a feature are contiguous. The rows past the end of the
+  // block take the lowest value, the conditions are true for them and they don't change any bitvector.
+  for (size_t f = 0; f < qs_features_.size(); ++f) {
+    ITYPE* feature = features + f * kRowBlockSize;
+    const ITYPE* x_feature = x_block + qs_features_[f];
+    for (int64_t r = 0; r < n_rows; ++r) {
+      feature[r] = x_feature[r * stride];
+    }
+    for (int64_t r = n_rows; r < kRowBlockSize; ++r) {
+      feature[r] = std::numeric_limits<ITYPE>::lowest();
+    }
+  }
+  std::fill(bitvectors, bitvectors + n_trees_ * kRowBlockSize, ~uint64_t{0});
+
+  for (size_t f = 0; f < qs_features_.size(); ++f) {
+    const ITYPE* feature = features + f * kRowBlockSize;
+    // The nodes whose threshold is above the largest value of the block are true for all the rows. A missing value
+    // is false for every condition.
+    ITYPE max_value = std::numeric_limits<ITYPE>::lowest();
+    bool has_nan = false;
+    for (int64_t r = 0; r < kRowBlockSize; ++r) {
+      if (_isnan_(feature[r])) {
+        has_nan = true;
+      } else if (max_value < feature[r]) {
+        max_value = feature[r];
+      }
+    }
+
+    const size_t feature_end = qs_feature_begin_[f + 1];
+    for (size_t k = qs_feature_begin_[f]; k < feature_end && (has_nan || qs_thresholds_[k] < max_value); ++k) {
+      const OTYPE threshold = qs_thresholds_[k];
+      const uint64_t mask = qs_masks_[k];
+      uint64_t* tree_bitvectors = bitvectors + qs_trees_[k] * kRowBlockSize;
+      // a fixed number of rows without any branch, the compiler vectorizes it
+      for (int64_t r = 0; r < kRowBlockSize; ++r) {
+        tree_bitvectors[r] &= mask | (uint64_t{0} - static_cast<uint64_t>(feature[r] <= threshold));
+      }
+    }
+  }
+}
+
 template <typename ITYPE, typename OTYPE>
 class TreeEnsembleCommonClassifier : TreeEnsembleCommon<ITYPE, OTYPE> {
  private:
@@ -521,7 +776,8 @@ class TreeEnsembleCommonClassifier : TreeEnsembleCommon<ITYPE, OTYPE> {
                                const std::vector<int64_t>& class_treeids,
                                const std::vector<OTYPE>& class_weights,
                                const std::vector<std::string>& classlabels_strings,
-                               const std::vector<int64_t>& classlabels_int64s);
+                               const std::vector<int64_t>& classlabels_int64s,
+                               bool use_quickscorer);
 
   int64_t get_class_count() const { return this->n_targets_or_classes_; }
 
@@ -549,7 +805,8 @@ TreeEnsembleCommonClassifier<ITYPE, OTYPE>::TreeEnsembleCommonClassifier(
     const std::vector<int64_t>& class_treeids,
     const std::vector<OTYPE>& class_weights,
     const std::vector<std::string>& classlabels_strings,
-    const std::vector<int64_t>& classlabels_int64s)
+    const std::vector<int64_t>& classlabels_int64s,
+    bool use_quickscorer)
     : TreeEnsembleCommon<ITYPE, OTYPE>(parallel_tree,
                                        parallel_N,
                                        aggregate_function,
@@ -569,7 +826,8 @@ TreeEnsembleCommonClassifier<ITYPE, OTYPE>::TreeEnsembleCommonClassifier(
                                        class_ids,
                                        class_nodeids,
                                        class_treeids,
-                                       class_weights) {
+                                       class_weights,
+                                       use_quickscorer) {
   classlabels_strings_ = classlabels_strings;
   classlabels_int64s_ = classlabels_int64s;
 
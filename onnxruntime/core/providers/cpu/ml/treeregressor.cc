@@ -42,7 +42,8 @@ TreeEnsembleRegressor<T>::TreeEnsembleRegressor(const OpKernelInfo& info)
           info.GetAttrsOrDefault<int64_t>("target_ids"),
           info.GetAttrsOrDefault<int64_t>("target_nodeids"),
           info.GetAttrsOrDefault<int64_t>("target_treeids"),
-          info.GetAttrsOrDefault<float>("target_weights")) {
+          info.GetAttrsOrDefault<float>("target_weights"),
+          detail::UseQuickScorer(info)) {
 }  // namespace ml
 
 template <typename T>
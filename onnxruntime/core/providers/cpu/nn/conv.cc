@@ -64,7 +64,7 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   const int64_t kernel_size = TensorShape(kernel_shape).Size();
   const int64_t X_offset = C / conv_attrs_.group * input_image_size;
   const int64_t Y_offset = Y->Shape().Size() / Y->Shape()[0] / conv_attrs_.group;
-  const int64_t W_offset = W->Shape().Size() / conv_attrs_.group;
+  const int64_t W_offset = W_shape.Size() / conv_attrs_.group;
   const int64_t kernel_dim = C / conv_attrs_.group * kernel_size;
   const int64_t col_buffer_size = kernel_dim * output_image_size;
 
@@ -160,18 +160,65 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+Status Conv<float>::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                            /*out*/ bool& is_packed,
+                            /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  // MlasConv consumes the filter as is, so there is no layout change to apply. A copy of a constant filter is only
+  // worth holding when sessions share it through a container, otherwise it doubles the memory of the filter and
+  // replaces the memory mapped initializer. Kernels of other execution providers derived from this one read W from
+  // the inputs.
+  if (input_idx != 1 || prepacked_weights == nullptr ||
+      Info().GetExecutionProvider()->Type() != kCpuExecutionProvider) {
+    return Status::OK();
+  }
+
+  const size_t W_size = tensor.SizeInBytes();
+  if (W_size == 0) {
+    return Status::OK();
+  }
+
+  auto* W_data = alloc->Alloc(W_size);
+  packed_W_buffer_ = BufferUniquePtr(W_data, BufferDeleter(alloc));
+  memcpy(W_data, tensor.DataRaw(), W_size);
+  W_shape_ = tensor.Shape();
+  is_packed = true;
+
+  prepacked_weights->buffers_.push_back(std::move(packed_W_buffer_));
+  prepacked_weights->buffer_sizes_.push_back(W_size);
+  return Status::OK();
+}
+
+Status Conv<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                              const std::vector<size_t>& /*prepacked_buffer_sizes*/,
+                                              const Tensor& tensor, int input_idx,
+                                              /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    W_shape_ = tensor.Shape();
+    packed_W_buffer_ = std::move(prepacked_buffers[0]);
+    used_shared_buffers = true;
+  }
+
+  return Status::OK();
+}
+
 Status Conv<float>::Compute(OpKernelContext* context) const {
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const auto* X = context->Input<Tensor>(0);
-  const auto* W = context->Input<Tensor>(1);
+  const Tensor* W = packed_W_buffer_ ? nullptr : context->Input<Tensor>(1);
+  const TensorShape& W_shape = W ? W->Shape() : W_shape_;
+  const auto* Wdata = W ? W->template Data<float>() : static_cast<const float*>(packed_W_buffer_.get());
   const Tensor* B = num_inputs == 3 ? context->Input<Tensor>(2) : nullptr;
   const int64_t N = X->Shape()[0];
   const int64_t C = X->Shape()[1];
-  const int64_t M = W->Shape()[0];
-  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X, W));
+  const int64_t M = W_shape[0];
+  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X->Shape(), W_shape));
 
   std::vector<int64_t> kernel_shape;
-  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W->Shape(), kernel_shape));
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W_shape, kernel_shape));
 
   std::vector<int64_t> pads(conv_attrs_.pads);
   if (pads.empty()) {
@@ -232,7 +279,7 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
 
     MlasConv(&Parameters,
              Xdata,
-             W->template Data<float>(),
+             Wdata,
              Bdata,
              static_cast<float*>(working_buffer.get()),
              Ydata,
@@ -243,7 +290,7 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
     const int64_t kernel_size = TensorShape(kernel_shape).Size();
     const int64_t X_offset = C / conv_attrs_.group * input_image_size;
     const int64_t Y_offset = Y->Shape().Size() / Y->Shape()[0] / conv_attrs_.group;
-    const int64_t W_offset = W->Shape().Size() / conv_attrs_.group;
+    const int64_t W_offset = W_shape.Size() / conv_attrs_.group;
     const int64_t kernel_dim = C / conv_attrs_.group * kernel_size;
     const int64_t col_buffer_size = kernel_dim * output_image_size;
 
@@ -278,7 +325,7 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
             output_image_size,
             kernel_dim,
             1,
-            W->template Data<float>() + group_id * W_offset,
+            Wdata + group_id * W_offset,
             col_buffer_data,
             0,
             Ydata + group_id * Y_offset,
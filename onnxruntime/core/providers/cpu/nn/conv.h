@@ -28,12 +28,26 @@ class Conv<float> : public OpKernel {
     activation_.ActivationKind = MlasIdentityActivation;
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   const std::vector<size_t>& prepacked_buffer_sizes,
+                                   const Tensor& tensor, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
   Status Compute(OpKernelContext* context) const override;
 
  protected:
   MLAS_ACTIVATION activation_;
 
   ConvAttributes conv_attrs_;
+
+ private:
+  // copy of a constant filter, which can be shared with other sessions
+  TensorShape W_shape_;
+  BufferUniquePtr packed_W_buffer_;
 };
 
 }  // namespace onnxruntime
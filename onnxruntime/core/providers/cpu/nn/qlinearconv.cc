@@ -255,7 +255,15 @@ class QLinearConv<int8_t> : public OpKernel {
   explicit QLinearConv<int8_t>(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info), is_W_packed_(false) {}
 
   Status Compute(OpKernelContext* context) const override;
-  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   const std::vector<size_t>& prepacked_buffer_sizes,
+                                   const Tensor& tensor, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
 
  private:
   static void ReorderFilter(const uint8_t* input,
@@ -300,7 +308,9 @@ void QLinearConv<int8_t>::ReorderFilter(const uint8_t* input,
   }
 }
 
-Status QLinearConv<int8_t>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+Status QLinearConv<int8_t>::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                                    /*out*/ bool& is_packed,
+                                    /*out*/ PrePackedWeights* prepacked_weights) {
   is_packed = false;
 
   // Support packing the weight matrix.
@@ -331,8 +341,6 @@ Status QLinearConv<int8_t>::PrePack(const Tensor& tensor, int input_idx, bool& i
   const auto* Wdata = static_cast<const uint8_t*>(tensor.DataRaw());
   W_shape_ = shape;
 
-  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
-
 #ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
   packed_W_size_ = MlasGemmPackBSize(group_output_channels, kernel_dim, true);
 
@@ -359,6 +367,11 @@ Status QLinearConv<int8_t>::PrePack(const Tensor& tensor, int input_idx, bool& i
 
     is_W_packed_ = true;
     is_packed = true;
+
+    if (prepacked_weights != nullptr) {
+      prepacked_weights->buffers_.push_back(std::move(packed_W_buffer_));
+      prepacked_weights->buffer_sizes_.push_back(group_count * packed_W_size_);
+    }
     return Status::OK();
   }
 #endif
@@ -370,6 +383,43 @@ Status QLinearConv<int8_t>::PrePack(const Tensor& tensor, int input_idx, bool& i
 
   is_W_packed_ = true;
   is_packed = true;
+
+  if (prepacked_weights != nullptr) {
+    prepacked_weights->buffers_.push_back(std::move(reordered_W_buffer_));
+    prepacked_weights->buffer_sizes_.push_back(static_cast<size_t>(shape.Size()));
+  }
+  return Status::OK();
+}
+
+Status QLinearConv<int8_t>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                      const std::vector<size_t>& /*prepacked_buffer_sizes*/,
+                                                      const Tensor& tensor, int input_idx,
+                                                      /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx != 3) {
+    return Status::OK();
+  }
+
+  // PrePack only shares the weights it packed, so the shape has been validated there.
+  W_shape_ = tensor.Shape();
+
+#ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
+  const size_t group_output_channels = static_cast<size_t>(W_shape_[0] / conv_attrs_.group);
+  const size_t kernel_dim = static_cast<size_t>(W_shape_[1] * W_shape_[2] * W_shape_[3]);
+  packed_W_size_ = MlasGemmPackBSize(group_output_channels, kernel_dim, true);
+
+  if (packed_W_size_ != 0) {
+    packed_W_buffer_ = std::move(prepacked_buffers[0]);
+    is_W_packed_ = true;
+    used_shared_buffers = true;
+    return Status::OK();
+  }
+#endif
+
+  reordered_W_buffer_ = std::move(prepacked_buffers[0]);
+  is_W_packed_ = true;
+  used_shared_buffers = true;
   return Status::OK();
 }
 
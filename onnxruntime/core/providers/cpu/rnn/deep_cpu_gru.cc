@@ -161,8 +161,8 @@ class UniDirectionalGru {
                     onnxruntime::concurrency::ThreadPool* ttp);
 
   void Compute(const gsl::span<const T>& inputs, const gsl::span<const int>& sequence_lengths, int num_directions,
-               const gsl::span<const T>& input_weights, const gsl::span<const T>& recurrent_weights,
-               gsl::span<T>& outputs, gsl::span<T>& final_hidden_state);
+               const GemmWeights<T>& input_weights, const GemmWeights<T>& recurrent_weightsZR,
+               const GemmWeights<T>& recurrent_weightsH, gsl::span<T>& outputs, gsl::span<T>& final_hidden_state);
 
   ~UniDirectionalGru() = default;
 
@@ -236,6 +236,77 @@ class UniDirectionalGru {
 #define DumpMatrix(...) ((void)0)
 #endif
 
+#if !defined(USE_MKLML_FOR_BLAS)
+Status DeepCpuGruOp::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                             /*out*/ bool& is_packed,
+                             /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  if (!tensor.IsDataType<float>() || (input_idx != 1 && input_idx != 2)) {
+    return Status::OK();
+  }
+
+  // weights: [num_directions, 3*hidden_size, input_size]
+  // recurrence weights: [num_directions, 3*hidden_size, hidden_size]
+  const auto& shape = tensor.Shape();
+  if (shape.NumDimensions() != 3 || shape[0] != num_directions_ || shape[1] != 3 * hidden_size_) {
+    return Status::OK();
+  }
+
+  const size_t hidden_size = static_cast<size_t>(hidden_size_);
+  if (input_idx == 1) {
+    if (!PackWeights(tensor, 0, 3 * hidden_size, alloc, packed_W_)) {
+      return Status::OK();
+    }
+
+    if (prepacked_weights != nullptr) {
+      prepacked_weights->buffers_.push_back(std::move(packed_W_.buffer_));
+      prepacked_weights->buffer_sizes_.push_back(packed_W_.weights_size_ * num_directions_);
+    }
+  } else {
+    if (shape[2] != hidden_size_) {
+      return Status::OK();
+    }
+
+    if (!PackWeights(tensor, 0, 2 * hidden_size, alloc, packed_R_zr_) ||
+        !PackWeights(tensor, 2 * hidden_size, hidden_size, alloc, packed_R_h_)) {
+      packed_R_zr_.buffer_.reset();
+      packed_R_h_.buffer_.reset();
+      return Status::OK();
+    }
+
+    if (prepacked_weights != nullptr) {
+      prepacked_weights->buffers_.push_back(std::move(packed_R_zr_.buffer_));
+      prepacked_weights->buffer_sizes_.push_back(packed_R_zr_.weights_size_ * num_directions_);
+      prepacked_weights->buffers_.push_back(std::move(packed_R_h_.buffer_));
+      prepacked_weights->buffer_sizes_.push_back(packed_R_h_.weights_size_ * num_directions_);
+    }
+  }
+
+  is_packed = true;
+  return Status::OK();
+}
+
+Status DeepCpuGruOp::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                               const std::vector<size_t>& /*prepacked_buffer_sizes*/,
+                                               const Tensor& tensor, int input_idx,
+                                               /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  const size_t hidden_size = static_cast<size_t>(hidden_size_);
+  if (input_idx == 1) {
+    UseSharedPackedWeights(prepacked_buffers[0], tensor.Shape(), 3 * hidden_size, packed_W_);
+    used_shared_buffers = true;
+  } else if (input_idx == 2) {
+    UseSharedPackedWeights(prepacked_buffers[0], tensor.Shape(), 2 * hidden_size, packed_R_zr_);
+    UseSharedPackedWeights(prepacked_buffers[1], tensor.Shape(), hidden_size, packed_R_h_);
+    used_shared_buffers = true;
+  }
+
+  return Status::OK();
+}
+#endif
+
 Status DeepCpuGruOp::Compute(OpKernelContext* context) const {
   const Tensor& X = *context->Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
 
@@ -258,8 +329,10 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   concurrency::ThreadPool* thread_pool = context.GetOperatorThreadPool();
 
   const Tensor& X = *context.Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
-  const Tensor& W = *context.Input<Tensor>(1);  // weights. [num_directions, 3*hidden_size, input_size]
-  const Tensor& R = *context.Input<Tensor>(2);  // recurrence weights. [num_directions, 3*hidden_size, hidden_size]
+  const Tensor* W = packed_W_.buffer_ ? nullptr : context.Input<Tensor>(1);
+                                               // weights. [num_directions, 3*hidden_size, input_size]
+  const Tensor* R = packed_R_zr_.buffer_ ? nullptr : context.Input<Tensor>(2);
+                                               // recurrence weights. [num_directions, 3*hidden_size, hidden_size]
 
   // optional
   const auto* B = context.Input<Tensor>(3);              // bias. [num_directions, 6*hidden_size]
@@ -272,7 +345,10 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   int batch_size = gsl::narrow<int>(X_shape[1]);
   int input_size = gsl::narrow<int>(X_shape[2]);
 
-  auto status = ValidateCommonRnnInputs(X, W.Shape(), R.Shape(), B, 3, sequence_lens, initial_h, num_directions_, hidden_size_);
+  const auto& W_shape = (W != nullptr) ? W->Shape() : packed_W_.shape_;
+  const auto& R_shape = (R != nullptr) ? R->Shape() : packed_R_zr_.shape_;
+
+  auto status = ValidateCommonRnnInputs(X, W_shape, R_shape, B, 3, sequence_lens, initial_h, num_directions_, hidden_size_);
   ORT_RETURN_IF_ERROR(status);
 
   // GRU outputs are optional but must be in the same order
@@ -295,8 +371,8 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   AllocatorPtr alloc;
   status = context.GetTempSpaceAllocator(&alloc);
   ORT_RETURN_IF_ERROR(status);
-  gsl::span<const T> input_weights = W.DataAsSpan<T>();
-  gsl::span<const T> recurrent_weights = R.DataAsSpan<T>();
+  const T* input_weights = W != nullptr ? W->Data<T>() : nullptr;
+  const T* recurrent_weights = R != nullptr ? R->Data<T>() : nullptr;
   gsl::span<const T> bias = B != nullptr ? B->DataAsSpan<T>() : gsl::span<const T>();
 
   // spans for first direction
@@ -304,8 +380,13 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   const size_t recurrent_weights_size_per_direction = 3 * hidden_size_ * hidden_size_;
   const size_t bias_size_per_direction = 6 * hidden_size_;
 
-  gsl::span<const T> input_weights_1 = input_weights.subspan(0, input_weights_size_per_direction);
-  gsl::span<const T> recurrent_weights_1 = recurrent_weights.subspan(0, recurrent_weights_size_per_direction);
+  // R[h] follows R[zr] in the recurrence weights of each direction
+  const T* recurrent_weights_h = recurrent_weights != nullptr ? recurrent_weights + 2 * hidden_size_ * hidden_size_
+                                                              : nullptr;
+
+  GemmWeights<T> input_weights_1(0, input_weights, input_weights_size_per_direction, packed_W_);
+  GemmWeights<T> recurrent_weights_zr_1(0, recurrent_weights, recurrent_weights_size_per_direction, packed_R_zr_);
+  GemmWeights<T> recurrent_weights_h_1(0, recurrent_weights_h, recurrent_weights_size_per_direction, packed_R_h_);
   gsl::span<const T> bias_1 = bias.empty() ? bias : bias.subspan(0, bias_size_per_direction);
 
   gsl::span<const T> input = X.DataAsSpan<T>();
@@ -340,10 +421,9 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
 
   if (direction_ == Direction::kBidirectional) {
     // spans for second direction
-    gsl::span<const T> input_weights_2 = input_weights.subspan(input_weights_size_per_direction,
-                                                               input_weights_size_per_direction);
-    gsl::span<const T> recurrent_weights_2 = recurrent_weights.subspan(recurrent_weights_size_per_direction,
-                                                                       recurrent_weights_size_per_direction);
+    GemmWeights<T> input_weights_2(1, input_weights, input_weights_size_per_direction, packed_W_);
+    GemmWeights<T> recurrent_weights_zr_2(1, recurrent_weights, recurrent_weights_size_per_direction, packed_R_zr_);
+    GemmWeights<T> recurrent_weights_h_2(1, recurrent_weights_h, recurrent_weights_size_per_direction, packed_R_h_);
     gsl::span<const T> bias_2 = bias.empty() ? bias : bias.subspan(bias_size_per_direction, bias_size_per_direction);
 
     gsl::span<const T> initial_hidden_2 = initial_hidden.empty()
@@ -362,24 +442,24 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
                                     activation_funcs_.Entries()[0],
                                     activation_funcs_.Entries()[1],
                                     clip_, thread_pool);
-    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
-               output_1, hidden_output_1);
+    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_zr_1,
+               recurrent_weights_h_1, output_1, hidden_output_1);
 
     detail::UniDirectionalGru<T> bw(alloc, seq_length, batch_size, input_size, hidden_size_,
                                     linear_before_reset_, Direction::kReverse, bias_2, initial_hidden_2,
                                     activation_funcs_.Entries()[2],
                                     activation_funcs_.Entries()[3],
                                     clip_, thread_pool);
-    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_2,
-               output_2, hidden_output_2);
+    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_zr_2,
+               recurrent_weights_h_2, output_2, hidden_output_2);
   } else {
     detail::UniDirectionalGru<T> gru_p(alloc, seq_length, batch_size, input_size, hidden_size_,
                                        linear_before_reset_, direction_, bias_1, initial_hidden_1,
                                        activation_funcs_.Entries()[0],
                                        activation_funcs_.Entries()[1],
                                        clip_, thread_pool);
-    gru_p.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
-                  output_1, hidden_output_1);
+    gru_p.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_zr_1,
+                  recurrent_weights_h_1, output_1, hidden_output_1);
   }
 
   if (!output.empty())
@@ -478,8 +558,9 @@ template <typename T>
 void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
                                    const gsl::span<const int>& sequence_lengths_arg,
                                    const int num_directions,
-                                   const gsl::span<const T>& input_weights,
-                                   const gsl::span<const T>& recurrent_weights,
+                                   const GemmWeights<T>& input_weights,
+                                   const GemmWeights<T>& recurrent_weightsZR,
+                                   const GemmWeights<T>& recurrent_weightsH,
                                    gsl::span<T>& outputs,
                                    gsl::span<T>& final_hidden_state) {
   using span_T_const_iter = typename gsl::span<T>::const_iterator;
@@ -496,11 +577,13 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
   }
 
   DumpMatrix("Inputs", inputs.data(), seq_length_ * batch_size_, input_size_);
-  DumpMatrix("input_weights", input_weights.data(), 3 * hidden_size_, input_size_);
-  DumpMatrix("recurrent_weights", recurrent_weights.data(), 3 * hidden_size_, hidden_size_);
-
-  gsl::span<const T> recurrent_weightsZR = recurrent_weights.subspan(0, 2 * hidden_size_ * hidden_size_);
-  gsl::span<const T> recurrent_weightsH = recurrent_weights.subspan(2 * hidden_size_ * hidden_size_, hidden_size_ * hidden_size_);
+  if (!input_weights.is_prepacked_) {
+    DumpMatrix("input_weights", static_cast<const T*>(input_weights.buffer_), 3 * hidden_size_, input_size_);
+  }
+  if (!recurrent_weightsZR.is_prepacked_) {
+    DumpMatrix("recurrent_weights", static_cast<const T*>(recurrent_weightsZR.buffer_), 3 * hidden_size_,
+               hidden_size_);
+  }
 
   gsl::span<T> original_outputs = outputs;
   const bool output_sequence = !outputs.empty();
@@ -530,9 +613,7 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
   // apply weights to all the inputs
   ComputeGemm(total_rows, hidden_size_x3, input_size_, alpha,
               inputs.cbegin(), inputs.cend(),
-              input_size_,
-              input_weights.cbegin(), input_weights.cend(),
-              input_size_, 0.f,
+              input_weights, 0.f,
               outputZRH_.begin(), outputZRH_.end(),
               hidden_size_x3, ttp_);
 
@@ -593,9 +674,7 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
     // Ht-1 * R[zr] + Xt*(W[zr]^T)
     ComputeGemm(batch_size_, hidden_size_x2, hidden_size_, alpha,
                 prev_Ht, prev_Ht_end,
-                hidden_size_,
-                recurrent_weightsZR.cbegin(), recurrent_weightsZR.cend(),
-                hidden_size_, 1.f,  // beta == 1 so we add existing values in outputZRH_
+                recurrent_weightsZR, 1.f,  // beta == 1 so we add existing values in outputZRH_
                 outputZRH_.begin() + out_added_offset, outputZRH_.end(),
                 hidden_size_x3, ttp_);
 
@@ -613,9 +692,7 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
       // compute Ht-1 * (Rh^T) + Rbh
       ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
                   prev_Ht, prev_Ht_end,  // Ht-1
-                  hidden_size_,
-                  recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
-                  hidden_size_,
+                  recurrent_weightsH,    // Rh^T
                   use_bias_ ? 1.f : 0.f,  // don't add values in linear_output_ if no bias input
                   linear_output_.begin(),
                   linear_output_.end(),  // pre: Rbh if use_bias_, post:output
@@ -686,9 +763,7 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
       // Calculate Xt*(Wh^T) + rt (.) Ht-1 * Rh
       ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
                   cur_h_local, cur_h_local_end,  // rt (.) Ht-1
-                  hidden_size_,
-                  recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
-                  hidden_size_, 1.f,                                       // beta == 1 to add Xt*(Wh^T) from out_H
+                  recurrent_weightsH, 1.f,       // Rh^T. beta == 1 to add Xt*(Wh^T) from out_H
                   out_H, outputZRH_.end(),
                   hidden_size_x3, ttp_);
     }
@@ -51,6 +51,16 @@ class DeepCpuGruOp final : public OpKernel {
                                                      activation_func_betas);
   }
 
+#if !defined(USE_MKLML_FOR_BLAS)
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   const std::vector<size_t>& prepacked_buffer_sizes,
+                                   const Tensor& tensor, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+#endif
   Status Compute(OpKernelContext* context) const override;
 
   ~DeepCpuGruOp() override = default;
@@ -65,6 +75,11 @@ class DeepCpuGruOp final : public OpKernel {
 
   rnn::detail::ActivationFuncs activation_funcs_;
 
+  // W is packed as a whole. R is used as two separate matrices, R[zr] and R[h], so each of them is packed.
+  rnn::detail::PackedWeights packed_W_;
+  rnn::detail::PackedWeights packed_R_zr_;
+  rnn::detail::PackedWeights packed_R_h_;
+
   template <typename T>
   Status ComputeImpl(OpKernelContext& context) const;
 };
@@ -290,7 +290,8 @@ class UniDirectionalLstm {
 
 }  // namespace detail
 
-Status DeepCpuLstmOp::TryPackWeights(const Tensor& weights, PackedWeights& packed_weights, bool& is_packed) {
+Status DeepCpuLstmOp::TryPackWeights(const Tensor& weights, const AllocatorPtr& alloc,
+                                     PackedWeights& packed_weights, bool& is_packed) {
   const auto& shape = weights.Shape();
   if (shape.NumDimensions() != 3) {
     return Status::OK();
@@ -299,48 +300,49 @@ Status DeepCpuLstmOp::TryPackWeights(const Tensor& weights, PackedWeights& packe
   // weights: [num_directions, 4*hidden_size, input_size]
   // recurrence weights: [num_directions, 4*hidden_size, hidden_size]
   const size_t N = static_cast<size_t>(shape[1]);
-  const size_t K = static_cast<size_t>(shape[2]);
 
   if ((shape[0] != num_directions_) || (N != static_cast<size_t>(hidden_size_ * 4))) {
     return Status::OK();
   }
 
-  const size_t packed_weights_size = MlasGemmPackBSize(N, K);
-  if (packed_weights_size == 0) {
-    return Status::OK();
-  }
-
-  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
-  auto* packed_weights_data = alloc->Alloc(SafeInt<size_t>(packed_weights_size) * num_directions_);
-  packed_weights.buffer_ = BufferUniquePtr(packed_weights_data, BufferDeleter(alloc));
-  packed_weights.weights_size_ = packed_weights_size;
-  packed_weights.shape_ = shape;
-
-  const auto* weights_data = weights.Data<float>();
-  for (int i = 0; i < num_directions_; i++) {
-    MlasGemmPackB(CblasTrans, N, K, weights_data, K, packed_weights_data);
-    packed_weights_data = static_cast<uint8_t*>(packed_weights_data) + packed_weights_size;
-    weights_data += N * K;
-  }
-
-  is_packed = true;
+  is_packed = PackWeights(weights, 0, N, alloc, packed_weights);
   return Status::OK();
 }
 
 #if !defined(USE_MKLML_FOR_BLAS)
-Status DeepCpuLstmOp::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+Status DeepCpuLstmOp::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                              /*out*/ bool& is_packed,
+                              /*out*/ PrePackedWeights* prepacked_weights) {
   is_packed = false;
 
-  if (tensor.IsDataType<float>()) {
-    if (input_idx == 1) {
-      return TryPackWeights(tensor, packed_W_, is_packed);
-    } else if (input_idx == 2) {
-      return TryPackWeights(tensor, packed_R_, is_packed);
+  if (tensor.IsDataType<float>() && (input_idx == 1 || input_idx == 2)) {
+    PackedWeights& packed_weights = input_idx == 1 ? packed_W_ : packed_R_;
+    ORT_RETURN_IF_ERROR(TryPackWeights(tensor, alloc, packed_weights, is_packed));
+
+    if (is_packed && prepacked_weights != nullptr) {
+      prepacked_weights->buffers_.push_back(std::move(packed_weights.buffer_));
+      prepacked_weights->buffer_sizes_.push_back(packed_weights.weights_size_ * num_directions_);
     }
   }
 
   return Status::OK();
 }
+
+Status DeepCpuLstmOp::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                const std::vector<size_t>& /*prepacked_buffer_sizes*/,
+                                                const Tensor& tensor, int input_idx,
+                                                /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1 || input_idx == 2) {
+    PackedWeights& packed_weights = input_idx == 1 ? packed_W_ : packed_R_;
+    UseSharedPackedWeights(prepacked_buffers[0], tensor.Shape(), static_cast<size_t>(hidden_size_ * 4),
+                           packed_weights);
+    used_shared_buffers = true;
+  }
+
+  return Status::OK();
+}
 #endif
 
 Status DeepCpuLstmOp::Compute(OpKernelContext* context) const {
@@ -51,14 +51,22 @@ class DeepCpuLstmOp final : public OpKernel {
   }
 
 #if !defined(USE_MKLML_FOR_BLAS)
-  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   const std::vector<size_t>& prepacked_buffer_sizes,
+                                   const Tensor& tensor, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
 #endif
   Status Compute(OpKernelContext* context) const override;
 
   ~DeepCpuLstmOp() override = default;
 
  private:
-  Status TryPackWeights(const Tensor& weights, rnn::detail::PackedWeights& packed_weights, bool& is_packed);
+  Status TryPackWeights(const Tensor& weights, const AllocatorPtr& alloc,
+                        rnn::detail::PackedWeights& packed_weights, bool& is_packed);
 
   template <typename T>
   Status ComputeImpl(OpKernelContext& context) const;
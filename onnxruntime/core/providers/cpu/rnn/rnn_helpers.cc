@@ -186,6 +186,40 @@ ActivationFuncs::ActivationFuncs(const std::vector<std::string>& funcs,
   }
 }
 
+bool PackWeights(const Tensor& weights, size_t row_offset, size_t N, const AllocatorPtr& alloc,
+                 PackedWeights& packed_weights) {
+  const auto& shape = weights.Shape();
+  const size_t num_directions = static_cast<size_t>(shape[0]);
+  const size_t rows = static_cast<size_t>(shape[1]);
+  const size_t K = static_cast<size_t>(shape[2]);
+
+  const size_t packed_weights_size = MlasGemmPackBSize(N, K);
+  if (packed_weights_size == 0) {
+    return false;
+  }
+
+  auto* packed_weights_data = alloc->Alloc(SafeInt<size_t>(packed_weights_size) * num_directions);
+  packed_weights.buffer_ = BufferUniquePtr(packed_weights_data, BufferDeleter(alloc));
+  packed_weights.weights_size_ = packed_weights_size;
+  packed_weights.shape_ = shape;
+
+  const auto* weights_data = weights.Data<float>() + row_offset * K;
+  for (size_t i = 0; i < num_directions; i++) {
+    MlasGemmPackB(CblasTrans, N, K, weights_data, K, packed_weights_data);
+    packed_weights_data = static_cast<uint8_t*>(packed_weights_data) + packed_weights_size;
+    weights_data += rows * K;
+  }
+
+  return true;
+}
+
+void UseSharedPackedWeights(BufferUniquePtr& buffer, const TensorShape& shape, size_t N,
+                            PackedWeights& packed_weights) {
+  packed_weights.buffer_ = std::move(buffer);
+  packed_weights.weights_size_ = MlasGemmPackBSize(N, static_cast<size_t>(shape[2]));
+  packed_weights.shape_ = shape;
+}
+
 void DumpMatrixImpl(const std::string& name, const float* src, int row, int col, int offset, int col_width) {
   std::cout << "Dump matrix: " << name << std::endl;
 
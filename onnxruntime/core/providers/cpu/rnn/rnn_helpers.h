@@ -169,6 +169,15 @@ struct PackedWeights {
   TensorShape shape_;
 };
 
+// Packs rows [row_offset, row_offset + N) of each direction of weights with shape [num_directions, rows, K]
+// for MlasGemm, using the weights as the transposed B matrix. Returns false if the packing isn't supported.
+bool PackWeights(const Tensor& weights, size_t row_offset, size_t N, const AllocatorPtr& alloc,
+                 PackedWeights& packed_weights);
+
+// Sets up packed_weights to use a buffer that PackWeights filled for the same weights in another kernel instance.
+void UseSharedPackedWeights(BufferUniquePtr& buffer, const TensorShape& shape, size_t N,
+                            PackedWeights& packed_weights);
+
 template <typename T>
 struct GemmWeights {
   GemmWeights(int idx, const T* weights_data, size_t weights_size, const PackedWeights& packed_weights) {
@@ -13,6 +13,7 @@
 
 #include "core/common/denormal.h"
 #include "core/common/logging/logging.h"
+#include "core/common/parse_string.h"
 #include "core/framework/allocatormgr.h"
 #include "core/framework/error_code_helper.h"
 #include "core/framework/execution_frame.h"
@@ -34,6 +35,7 @@
 #include "core/optimizer/insert_cast_transformer.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/graph_transformer_utils.h"
+#include "core/optimizer/zipmap_output_transformer.h"
 #include "core/platform/Barrier.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
@@ -46,6 +48,7 @@
 #include "core/session/environment.h"
 #include "core/session/IOBinding.h"
 #include "core/session/inference_session_utils.h"
+#include "core/session/optimized_model_cache.h"
 #include "core/util/protobuf_parsing_utils.h"
 #include "core/util/thread_utils.h"
 
@@ -233,7 +236,15 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
       // we set affinity of each thread to each processor.
       to.auto_set_affinity = to.thread_pool_size == 0 &&
                              session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL &&
-                             to.affinity_vec_len == 0;
+                             to.affinity.empty();
+      ORT_THROW_IF_ERROR(concurrency::SetThreadAffinity(
+          Env::Default(), session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpThreadAffinities, ""),
+          to));
+      const std::string dynamic_block_base =
+          session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpDynamicBlockBase, "0");
+      ORT_ENFORCE(ParseStringWithClassicLocale(dynamic_block_base, to.dynamic_block_base).IsOK() &&
+                      to.dynamic_block_base >= 0,
+                  "Invalid value for ", kOrtSessionOptionsConfigIntraOpDynamicBlockBase, ": ", dynamic_block_base);
       thread_pool_ =
           concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
     }
@@ -246,6 +257,9 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
       if (to.name == nullptr)
         to.name = ORT_TSTR("intra-op");
       to.set_denormal_as_zero = set_denormal_as_zero;
+      ORT_THROW_IF_ERROR(concurrency::SetThreadAffinity(
+          Env::Default(), session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigInterOpThreadAffinities, ""),
+          to));
       inter_op_thread_pool_ =
           concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTER_OP);
       if (inter_op_thread_pool_ == nullptr) {
@@ -263,6 +277,28 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
   }
 
   session_profiler_.Initialize(session_logger_);
+
+  profiling::ProfilingSamplingOptions sampling_options;
+  const std::string sampling_rate =
+      session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigProfilingSamplingRate, "1");
+  ORT_ENFORCE(ParseStringWithClassicLocale(sampling_rate, sampling_options.sampling_rate).IsOK() &&
+                  sampling_options.sampling_rate > 0,
+              "Invalid value for ", kOrtSessionOptionsConfigProfilingSamplingRate, ": ", sampling_rate);
+  const std::string latency_threshold =
+      session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigProfilingLatencyThresholdUs, "0");
+  ORT_ENFORCE(ParseStringWithClassicLocale(latency_threshold, sampling_options.latency_threshold_us).IsOK() &&
+                  sampling_options.latency_threshold_us >= 0,
+              "Invalid value for ", kOrtSessionOptionsConfigProfilingLatencyThresholdUs, ": ", latency_threshold);
+  session_profiler_.SetSamplingOptions(sampling_options);
+
+  std::string max_profiling_events;
+  if (session_options_.TryGetConfigEntry(kOrtSessionOptionsConfigProfilingMaxEvents, max_profiling_events)) {
+    size_t max_num_events = 0;
+    ORT_ENFORCE(ParseStringWithClassicLocale(max_profiling_events, max_num_events).IsOK() && max_num_events > 0,
+                "Invalid value for ", kOrtSessionOptionsConfigProfilingMaxEvents, ": ", max_profiling_events);
+    session_profiler_.UseRingBuffer(max_num_events);
+  }
+
   if (session_options_.enable_profiling) {
     StartProfiling(session_options_.profile_file_prefix);
   }
@@ -347,7 +383,14 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 InferenceSession::~InferenceSession() {
-  if (session_options_.enable_profiling) {
+  {
+    // runs scheduled by RunAsync use the session state and possibly the session's thread pools
+    std::unique_lock<OrtMutex> lock(async_runs_mutex_);
+    async_runs_completed_.wait(lock, [this]() { return num_async_runs_in_flight_ == 0; });
+  }
+
+  // profiling may also have been started by StartProfiling or the RunOptions of a Run call
+  if (session_profiler_.IsEnabled()) {
     ORT_TRY {
       EndProfiling();
     }
@@ -433,6 +476,27 @@ common::Status InferenceSession::RegisterExecutionProvider(std::unique_ptr<IExec
   return execution_providers_.Add(provider_type, std::move(p_exec_provider));
 }
 
+common::Status InferenceSession::AddPrePackedWeightsContainer(PrepackedWeightsContainer* prepacked_weights_container) {
+  if (prepacked_weights_container == nullptr) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Received nullptr for prepacked weights container");
+  }
+
+  std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+
+  if (is_inited_) {
+    return Status(common::ONNXRUNTIME, common::FAIL,
+                  "The prepacked weights container must be added before the session is initialized.");
+  }
+
+  if (prepacked_weights_container_ != nullptr) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "The session already has a prepacked weights container.");
+  }
+
+  prepacked_weights_container_ = prepacked_weights_container;
+  return Status::OK();
+}
+
 #if !defined(ORT_MINIMAL_BUILD)
 
 common::Status InferenceSession::RegisterGraphTransformer(
@@ -450,6 +514,7 @@ common::Status InferenceSession::RegisterGraphTransformer(
                           "Graph transformers must be registered before the session is initialized.");
   }
 
+  has_custom_graph_transformers_ = true;
   return graph_transformation_mgr_.Register(std::move(p_graph_transformer), level);
 }
 
@@ -515,6 +580,7 @@ common::Status InferenceSession::SaveToOrtFormat(const std::basic_string<ORTCHAR
     int size = builder.GetSize();
     file.write(reinterpret_cast<const char*>(buf), size);
     file.close();
+    ORT_RETURN_IF_NOT(file, "Failed to write the ORT format model to ", ToMBString(filepath));
   }
 
   return Status::OK();
@@ -783,6 +849,34 @@ common::Status InferenceSession::Load() {
   return Load(loader, "model_loading_from_saved_proto");
 }
 
+// Reads the options of the cost based partitioning mode from the session configuration.
+static Status GetCostBasedPartitioningOptions(const SessionOptions& session_options,
+                                              CostBasedPartitioningOptions& options) {
+  std::istringstream provider_costs(
+      session_options.GetConfigOrDefault(kOrtSessionOptionsConfigGraphPartitioningProviderCosts, ""));
+  std::string entry;
+  while (std::getline(provider_costs, entry, ';')) {
+    if (entry.empty()) {
+      continue;
+    }
+
+    const auto separator = entry.rfind(':');
+    ORT_RETURN_IF(separator == std::string::npos, "Invalid entry in ",
+                  kOrtSessionOptionsConfigGraphPartitioningProviderCosts, ": ", entry);
+    double cost = 0.;
+    ORT_RETURN_IF_ERROR(ParseStringWithClassicLocale(entry.substr(separator + 1), cost));
+    ORT_RETURN_IF(cost < 0., "Invalid entry in ", kOrtSessionOptionsConfigGraphPartitioningProviderCosts, ": ", entry);
+    options.provider_costs[entry.substr(0, separator)] = cost;
+  }
+
+  ORT_RETURN_IF_ERROR(ParseStringWithClassicLocale(
+      session_options.GetConfigOrDefault(kOrtSessionOptionsConfigGraphPartitioningTransferCost, "1"),
+      options.transfer_cost));
+  ORT_RETURN_IF(options.transfer_cost < 0., "Invalid value for ",
+                kOrtSessionOptionsConfigGraphPartitioningTransferCost);
+  return Status::OK();
+}
+
 common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
                                                 const onnxruntime::GraphTransformerManager& graph_transformer_mgr,
                                                 const ExecutionProviders& providers,
@@ -796,6 +890,13 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
   // 4. insert copy nodes
   // 5. insert cast nodes.
 
+  // ZipMap outputs are changed before any optimization as the caller opted in, independently of the optimization level
+  if (session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigZipMapOutputAsTensors, "0") == "1") {
+    ZipMapOutputTransformer zipmap_output_transformer;
+    bool modified = false;
+    ORT_RETURN_IF_ERROR_SESSIONID_(zipmap_output_transformer.Apply(graph, modified, *session_logger_));
+  }
+
   // first apply global(execution provider independent),  level 1(default/system/basic) graph to graph optimizations
   ORT_RETURN_IF_ERROR_SESSIONID_(
       graph_transformer_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *session_logger_));
@@ -818,9 +919,24 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
 #endif
 
   // Do partitioning based on execution providers' capability.
-  GraphPartitioner partitioner(kernel_registry_manager, providers);
-  ORT_RETURN_IF_ERROR_SESSIONID_(partitioner.Partition(graph, session_state.ExportDll(),
-                                                       session_state.GetMutableFuncMgr()));
+  const std::string partitioning_mode =
+      session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigGraphPartitioningMode, "greedy");
+  std::unique_ptr<GraphPartitioner> partitioner;
+  if (partitioning_mode == "cost") {
+    CostBasedPartitioningOptions cost_options;
+    ORT_RETURN_IF_ERROR_SESSIONID_(GetCostBasedPartitioningOptions(session_options_, cost_options));
+    partitioner = onnxruntime::make_unique<GraphPartitioner>(kernel_registry_manager, providers, cost_options,
+                                                             *session_logger_);
+  } else if (partitioning_mode == "greedy") {
+    partitioner = onnxruntime::make_unique<GraphPartitioner>(kernel_registry_manager, providers);
+  } else {
+    ORT_RETURN_IF_ERROR_SESSIONID_(ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid value for ",
+                                                   kOrtSessionOptionsConfigGraphPartitioningMode, ": ",
+                                                   partitioning_mode));
+  }
+
+  ORT_RETURN_IF_ERROR_SESSIONID_(partitioner->Partition(graph, session_state.ExportDll(),
+                                                        session_state.GetMutableFuncMgr()));
 
   // apply transformers except default transformers
   // Default transformers are required for correctness and they are owned and run by inference session
@@ -890,15 +1006,16 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
 template <typename T>
 static Status LoadOrtModelBytes(const std::basic_string<T>& model_uri,
                                 std::basic_string<ORTCHAR_T>& model_location,
-                                std::vector<uint8_t>& bytes) {
+                                gsl::span<const uint8_t>& bytes,
+                                std::vector<uint8_t>& bytes_data_holder) {
   size_t num_bytes = 0;
   model_location = ToWideString(model_uri);
   ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(model_location.c_str(), num_bytes));
 
-  bytes.resize(num_bytes);
+  bytes_data_holder.resize(num_bytes);
 
   std::ifstream bytes_stream(model_uri, std::ifstream::in | std::ifstream::binary);
-  bytes_stream.read(reinterpret_cast<char*>(bytes.data()), num_bytes);
+  bytes_stream.read(reinterpret_cast<char*>(bytes_data_holder.data()), num_bytes);
 
   if (!bytes_stream) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
@@ -906,24 +1023,52 @@ static Status LoadOrtModelBytes(const std::basic_string<T>& model_uri,
                            bytes_stream.gcount(), "/", num_bytes, " bytes were able to be read.");
   }
 
+  bytes = gsl::make_span(bytes_data_holder.data(), num_bytes);
   return Status::OK();
 }
 
-Status InferenceSession::LoadOrtModel(const std::string& model_uri) {
+template <typename T>
+static Status MapOrtModelBytes(const std::basic_string<T>& model_uri,
+                               std::basic_string<ORTCHAR_T>& model_location,
+                               gsl::span<const uint8_t>& bytes,
+                               Env::MappedMemoryPtr& mapped_bytes) {
+  size_t num_bytes = 0;
+  model_location = ToWideString(model_uri);
+  ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(model_location.c_str(), num_bytes));
+  ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(model_location.c_str(), 0, num_bytes, mapped_bytes));
+
+  bytes = gsl::make_span(reinterpret_cast<const uint8_t*>(mapped_bytes.get()), num_bytes);
+  return Status::OK();
+}
+
+template <typename T>
+Status InferenceSession::LoadOrtModelFromFile(const std::basic_string<T>& model_uri) {
   return LoadOrtModel(
       [&]() {
-        ORT_RETURN_IF_ERROR(LoadOrtModelBytes(model_uri, model_location_, ort_format_model_bytes_));
+        if (session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigUseMappedOrtModel, "0") == "1") {
+          auto status = MapOrtModelBytes(model_uri, model_location_, ort_format_model_bytes_,
+                                         ort_format_model_mapped_bytes_);
+          if (status.IsOK()) {
+            return Status::OK();
+          }
+
+          LOGS(*session_logger_, WARNING) << "Failed to memory map the ORT format model, reading it instead. "
+                                          << status.ErrorMessage();
+        }
+
+        ORT_RETURN_IF_ERROR(LoadOrtModelBytes(model_uri, model_location_, ort_format_model_bytes_,
+                                              ort_format_model_bytes_data_holder_));
         return Status::OK();
       });
 }
 
+Status InferenceSession::LoadOrtModel(const std::string& model_uri) {
+  return LoadOrtModelFromFile(model_uri);
+}
+
 #ifdef WIN32
 Status InferenceSession::LoadOrtModel(const std::wstring& model_uri) {
-  return LoadOrtModel(
-      [&]() {
-        ORT_RETURN_IF_ERROR(LoadOrtModelBytes(model_uri, model_location_, ort_format_model_bytes_));
-        return Status::OK();
-      });
+  return LoadOrtModelFromFile(model_uri);
 }
 #endif
 
@@ -933,8 +1078,10 @@ Status InferenceSession::LoadOrtModel(const void* model_data, int model_data_len
     //
     // TODO: Provide Load API where we can take ownership of memory to avoid the copy,
     // and/or a combined Load+Initialize where we don't need this temporary copy.
-    ort_format_model_bytes_.resize(model_data_len);
-    std::copy_n(reinterpret_cast<const uint8_t*>(model_data), model_data_len, ort_format_model_bytes_.data());
+    ort_format_model_bytes_data_holder_.resize(model_data_len);
+    std::copy_n(reinterpret_cast<const uint8_t*>(model_data), model_data_len,
+                ort_format_model_bytes_data_holder_.data());
+    ort_format_model_bytes_ = gsl::make_span(ort_format_model_bytes_data_holder_.data(), model_data_len);
 
     return Status::OK();
   });
@@ -958,7 +1105,14 @@ Status InferenceSession::LoadOrtModel(std::function<Status()> load_ort_format_mo
   }
 
   ORT_RETURN_IF_ERROR(load_ort_format_model_bytes());
+  ORT_RETURN_IF_ERROR(LoadOrtModelFromBytes());
+
+  is_model_loaded_ = true;
+
+  return Status::OK();
+}
 
+Status InferenceSession::LoadOrtModelFromBytes() {
   // Verify the ort_format_model_bytes_ is a valid InferenceSessionBuffer before we access the data
   flatbuffers::Verifier verifier(ort_format_model_bytes_.data(), ort_format_model_bytes_.size());
   ORT_RETURN_IF_NOT(fbs::VerifyInferenceSessionBuffer(verifier));
@@ -976,9 +1130,15 @@ Status InferenceSession::LoadOrtModel(std::function<Status()> load_ort_format_mo
   const auto* fbs_model = fbs_session->model();
   ORT_RETURN_IF(nullptr == fbs_model, "Missing Model. Invalid ORT format model.");
 
+  // initializers can use the bytes in place if they stay valid for the lifetime of the session. they are converted
+  // back to TensorProto raw data when saving an optimized model, so don't reference the bytes in that case.
+  const bool can_use_flatbuffer_for_initializers = ort_format_model_mapped_bytes_ != nullptr &&
+                                                   session_options_.optimized_model_filepath.empty();
+
   // need to go from unique_ptr to shared_ptr when moving into model_
   std::unique_ptr<Model> tmp_model;
-  ORT_RETURN_IF_ERROR(Model::LoadFromOrtFormat(*fbs_model, *session_logger_, tmp_model));
+  ORT_RETURN_IF_ERROR(Model::LoadFromOrtFormat(*fbs_model, *session_logger_, can_use_flatbuffer_for_initializers,
+                                               tmp_model));
   ORT_RETURN_IF_ERROR(SaveModelMetadata(*tmp_model));
   model_ = std::move(tmp_model);
 
@@ -986,10 +1146,92 @@ Status InferenceSession::LoadOrtModel(std::function<Status()> load_ort_format_mo
   const auto* fbs_sess_state = fbs_session->session_state();
   ORT_RETURN_IF(nullptr == fbs_sess_state, "SessionState is null. Invalid ORT format model.");
 
-  is_model_loaded_ = true;
-
   return Status::OK();
 }
+
+#if !defined(ORT_MINIMAL_BUILD)
+bool InferenceSession::LoadFromOptimizedModelCache(std::basic_string<ORTCHAR_T>& cache_file_path) {
+  cache_file_path.clear();
+
+  std::string cache_dir;
+  if (!session_options_.TryGetConfigEntry(kOrtSessionOptionsConfigOptimizedModelCacheDir, cache_dir) ||
+      cache_dir.empty() || !ort_format_model_bytes_.empty()) {
+    return false;
+  }
+
+  // the kernels of other execution providers, custom ops and custom transformers aren't part of the cache key.
+  // an optimized model is saved as well if optimized_model_filepath is set, so there's nothing to gain.
+  const auto& provider_types = execution_providers_.GetIds();
+  if (provider_types.size() != 1 || provider_types[0] != kCpuExecutionProvider || !custom_registries_.empty() ||
+      HasLocalSchema() || has_custom_graph_transformers_ || !session_options_.optimized_model_filepath.empty()) {
+    LOGS(*session_logger_, INFO) << "The optimized model cache is only used by sessions that only use the CPU "
+                                    "execution provider and have no custom ops, graph transformers or "
+                                    "optimized model file.";
+    return false;
+  }
+
+  auto status = optimized_model_cache::GetCacheFilePath(ToPathString(cache_dir), *model_, model_location_,
+                                                        session_options_, provider_types, transformers_to_enable_,
+                                                        cache_file_path);
+  if (!status.IsOK()) {
+    LOGS(*session_logger_, WARNING) << "Failed to look up the model in the optimized model cache. "
+                                    << status.ErrorMessage();
+    cache_file_path.clear();
+    return false;
+  }
+
+  size_t num_bytes = 0;
+  if (!Env::Default().GetFileLength(cache_file_path.c_str(), num_bytes).IsOK()) {
+    LOGS(*session_logger_, INFO) << "Optimized model cache miss. Saving the optimized model to "
+                                 << ToMBString(cache_file_path);
+    return false;
+  }
+
+  std::basic_string<ORTCHAR_T> cached_model_location;
+  if (session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigUseMappedOrtModel, "0") == "1") {
+    status = MapOrtModelBytes(cache_file_path, cached_model_location, ort_format_model_bytes_,
+                              ort_format_model_mapped_bytes_);
+  }
+
+  if (ort_format_model_mapped_bytes_ == nullptr) {
+    status = LoadOrtModelBytes(cache_file_path, cached_model_location, ort_format_model_bytes_,
+                               ort_format_model_bytes_data_holder_);
+  }
+
+  if (status.IsOK()) {
+    status = LoadOrtModelFromBytes();
+  }
+
+  if (!status.IsOK()) {
+    // another process may be writing the file, so leave it alone and optimize the model instead
+    LOGS(*session_logger_, WARNING) << "Failed to load the optimized model from " << ToMBString(cache_file_path)
+                                    << ". Optimizing the model instead. " << status.ErrorMessage();
+    ort_format_model_bytes_ = gsl::span<const uint8_t>();
+    std::vector<uint8_t>().swap(ort_format_model_bytes_data_holder_);
+    ort_format_model_mapped_bytes_.reset();
+    cache_file_path.clear();
+    return false;
+  }
+
+  LOGS(*session_logger_, INFO) << "Loaded the optimized model from " << ToMBString(cache_file_path);
+  return true;
+}
+
+void InferenceSession::SaveToOptimizedModelCache(const std::basic_string<ORTCHAR_T>& cache_file_path) const {
+  // write to a file of this session and move it into place so readers never see a partially written model
+  const auto temp_file_path = optimized_model_cache::GetTempCacheFilePath(cache_file_path);
+  auto status = SaveToOrtFormat(temp_file_path);
+  if (status.IsOK()) {
+    status = optimized_model_cache::CommitCacheFile(temp_file_path, cache_file_path);
+  } else {
+    optimized_model_cache::RemoveTempCacheFile(temp_file_path);
+  }
+
+  if (!status.IsOK()) {
+    LOGS(*session_logger_, WARNING) << "Failed to save the optimized model to the cache. " << status.ErrorMessage();
+  }
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
 #endif  // defined(ENABLE_ORT_FORMAT_LOAD)
 
 bool InferenceSession::IsInitialized() const {
@@ -1072,6 +1314,33 @@ common::Status InferenceSession::Initialize() {
     if (!have_cpu_ep) {
       LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
       CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+      const std::string thread_cache_max_bytes =
+          session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigArenaThreadCacheMaxBytes, "0");
+      ORT_RETURN_IF_ERROR_SESSIONID_(ParseStringWithClassicLocale(thread_cache_max_bytes,
+                                                                  epi.arena_thread_cache_max_bytes));
+      const std::string max_idle_bytes =
+          session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigArenaMaxIdleBytes, "0");
+      ORT_RETURN_IF_ERROR_SESSIONID_(ParseStringWithClassicLocale(max_idle_bytes, epi.arena_max_idle_bytes));
+      const std::string gemm_packed_b_format =
+          session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigCpuGemmPackedBFormat, "float");
+      if (gemm_packed_b_format == "float16") {
+        epi.gemm_packed_b_format = GemmPackedBFormat::kFloat16;
+      } else if (gemm_packed_b_format == "bfloat16") {
+        epi.gemm_packed_b_format = GemmPackedBFormat::kBFloat16;
+      } else if (gemm_packed_b_format != "float") {
+        ORT_RETURN_IF_ERROR_SESSIONID_(ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid value for ",
+                                                       kOrtSessionOptionsConfigCpuGemmPackedBFormat, ": ",
+                                                       gemm_packed_b_format));
+      }
+      const std::string tree_ensemble_evaluation =
+          session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigCpuTreeEnsembleEvaluation, "traversal");
+      if (tree_ensemble_evaluation == "quickscorer") {
+        epi.tree_ensemble_evaluation = TreeEnsembleEvaluation::kQuickScorer;
+      } else if (tree_ensemble_evaluation != "traversal") {
+        ORT_RETURN_IF_ERROR_SESSIONID_(ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid value for ",
+                                                       kOrtSessionOptionsConfigCpuTreeEnsembleEvaluation, ": ",
+                                                       tree_ensemble_evaluation));
+      }
       auto p_cpu_exec_provider = onnxruntime::make_unique<CPUExecutionProvider>(epi);
       ORT_RETURN_IF_ERROR_SESSIONID_(RegisterExecutionProvider(std::move(p_cpu_exec_provider)));
     }
@@ -1102,6 +1371,14 @@ common::Status InferenceSession::Initialize() {
     session_activity_started_ = true;
 #endif
 
+#if !defined(ORT_MINIMAL_BUILD) && defined(ENABLE_ORT_FORMAT_LOAD)
+    // replace the model with the optimized model from a previous session if it's in the cache
+    std::basic_string<ORTCHAR_T> optimized_model_cache_path;
+    const bool loaded_from_optimized_model_cache = LoadFromOptimizedModelCache(optimized_model_cache_path);
+#else
+    const bool loaded_from_optimized_model_cache = false;
+#endif
+
     // now that we have all the execution providers, create the session state
     session_state_ = onnxruntime::make_unique<SessionState>(
         model_->MainGraph(),
@@ -1112,7 +1389,8 @@ common::Status InferenceSession::Initialize() {
         data_transfer_mgr_,
         *session_logger_,
         session_profiler_,
-        session_options_.use_deterministic_compute);
+        session_options_.use_deterministic_compute,
+        prepacked_weights_container_);
 
     onnxruntime::Graph& graph = model_->MainGraph();
 
@@ -1127,25 +1405,35 @@ common::Status InferenceSession::Initialize() {
     ORT_RETURN_IF_ERROR_SESSIONID_(kernel_registry_manager_.RegisterKernels(execution_providers_));
 
 #if !defined(ORT_MINIMAL_BUILD)
-    // add predefined transformers
-    AddPredefinedTransformers(graph_transformation_mgr_, session_options_.graph_optimization_level,
-                              transformers_to_enable_);
-
-    // apply any transformations to the main graph and any subgraphs
-    ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, graph_transformation_mgr_,
-                                                  execution_providers_, kernel_registry_manager_,
-                                                  insert_cast_transformer_,
-                                                  *session_state_));
-
-    // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
-    ORT_RETURN_IF_ERROR_SESSIONID_(graph.Resolve());
-
-    // Update temporary copies of metadata, input- and output definitions to the same state as the resolved graph
-    ORT_RETURN_IF_ERROR_SESSIONID_(SaveModelMetadata(*model_));
+    // the cached model has already been optimized
+    if (!loaded_from_optimized_model_cache) {
+      // add predefined transformers
+      AddPredefinedTransformers(graph_transformation_mgr_, session_options_.graph_optimization_level,
+                                transformers_to_enable_);
+
+      // apply any transformations to the main graph and any subgraphs
+      ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, graph_transformation_mgr_,
+                                                    execution_providers_, kernel_registry_manager_,
+                                                    insert_cast_transformer_,
+                                                    *session_state_));
+
+      // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
+      ORT_RETURN_IF_ERROR_SESSIONID_(graph.Resolve());
+
+      // Update temporary copies of metadata, input- and output definitions to the same state as the resolved graph
+      ORT_RETURN_IF_ERROR_SESSIONID_(SaveModelMetadata(*model_));
+    }
+#else
+    ORT_UNUSED_PARAMETER(loaded_from_optimized_model_cache);
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
     // need to keep the initializers if we're going to save the optimized model
     bool keep_initializers = !session_options_.optimized_model_filepath.empty();
+#if !defined(ORT_MINIMAL_BUILD) && defined(ENABLE_ORT_FORMAT_LOAD)
+    const bool save_to_optimized_model_cache = !optimized_model_cache_path.empty() &&
+                                               !loaded_from_optimized_model_cache;
+    keep_initializers = keep_initializers || save_to_optimized_model_cache;
+#endif
 
     auto* serialized_session_state = !ort_format_model_bytes_.empty()
                                          ? fbs::GetInferenceSession(ort_format_model_bytes_.data())->session_state()
@@ -1178,11 +1466,25 @@ common::Status InferenceSession::Initialize() {
     }
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
+#if !defined(ORT_MINIMAL_BUILD) && defined(ENABLE_ORT_FORMAT_LOAD)
+    if (save_to_optimized_model_cache) {
+      SaveToOptimizedModelCache(optimized_model_cache_path);
+
+      // the initializers were only kept to save the model. optimized_model_filepath is empty if the cache is used.
+      graph.CleanAllInitializedTensors();
+    }
+#endif
+
     session_state_->ResolveMemoryPatternFlag();
     is_inited_ = true;
 
-    // we don't directly use the ORT format bytes currently, so free those now
-    std::vector<uint8_t>().swap(ort_format_model_bytes_);
+    // the ORT format bytes are only used in place by initializers if the model is memory mapped, so free the
+    // copy of them now
+    ort_format_model_bytes_ = gsl::span<const uint8_t>();
+    std::vector<uint8_t>().swap(ort_format_model_bytes_data_holder_);
+    if (!session_options_.optimized_model_filepath.empty()) {
+      ort_format_model_mapped_bytes_.reset();
+    }
 
     // and log telemetry
     bool model_has_fp16_inputs = ModelHasFP16Inputs(graph);
@@ -1403,6 +1705,20 @@ Status InferenceSession::Run(const RunOptions& run_options,
                              const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds,
                              const std::vector<std::string>& output_names, std::vector<OrtValue>* p_fetches,
                              const std::vector<OrtDevice>* p_fetches_device_info) {
+  if (run_options.start_profiling && !session_profiler_.IsEnabled()) {
+    StartProfiling(session_options_.profile_file_prefix);
+  }
+
+  // ends profiling after the events of this run were stored
+  auto end_profiling = gsl::finally([this, &run_options]() {
+    if (run_options.end_profiling) {
+      EndProfiling();
+    }
+  });
+
+  // decides whether this run is profiled
+  profiling::Profiler::RunScope profiling_run(session_profiler_);
+
   TimePoint tp;
   if (session_profiler_.IsEnabled()) {
     tp = session_profiler_.StartTime();
@@ -1498,6 +1814,10 @@ Status InferenceSession::Run(const RunOptions& run_options,
     ORT_CHECK_AND_SET_RETVAL(status);
   }
 
+  if (run_options.shrink_memory_arenas) {
+    ORT_CHECK_AND_SET_RETVAL(ShrinkMemoryArenas());
+  }
+
   --current_num_runs_;
 
   // keep track of telemetry
@@ -1626,6 +1946,68 @@ common::Status InferenceSession::Run(IOBinding& io_binding) {
   return Run(run_options, io_binding);
 }
 
+common::Status InferenceSession::RunAsync(const RunOptions* run_options, const std::vector<std::string>& feed_names,
+                                          const std::vector<OrtValue>& feeds,
+                                          const std::vector<std::string>& output_names,
+                                          RunAsyncCallback callback, const RunAsyncExecutor& executor) {
+  if (!callback) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "RunAsync requires a callback.");
+  }
+
+  concurrency::ThreadPool* thread_pool = nullptr;
+  if (!executor) {
+    // the parallel executor blocks while waiting for nodes it scheduled on the inter-op pool, so running it on a
+    // thread of that pool could exhaust the pool. the intra-op pool doesn't have that problem as parallel loops
+    // started from one of its threads run any work no other thread has picked up themselves.
+    thread_pool = session_options_.execution_mode == ExecutionMode::ORT_PARALLEL ? nullptr
+                                                                                 : GetInterOpThreadPoolToUse();
+    if (thread_pool == nullptr) {
+      thread_pool = GetIntraOpThreadPoolToUse();
+    }
+
+    if (thread_pool == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                             "RunAsync requires a thread pool to run on. Configure the session with more than one "
+                             "intra-op thread or provide an executor.");
+    }
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(async_runs_mutex_);
+    ++num_async_runs_in_flight_;
+  }
+
+  auto run = [this, run_options, feed_names, feeds, output_names, callback]() {
+    RunOptions default_run_options;
+    std::vector<OrtValue> fetches;
+    Status status = Run(run_options != nullptr ? *run_options : default_run_options, feed_names, feeds, output_names,
+                        &fetches);
+
+    // there's nobody to propagate an exception to on this thread
+    ORT_TRY {
+      callback(status, fetches);
+    }
+    ORT_CATCH(const std::exception& e) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        LOGS(*session_logger_, ERROR) << "RunAsync callback threw an exception: " << e.what();
+      });
+    }
+
+    std::lock_guard<OrtMutex> lock(async_runs_mutex_);
+    if (--num_async_runs_in_flight_ == 0) {
+      async_runs_completed_.notify_all();
+    }
+  };
+
+  if (executor) {
+    executor(std::move(run));
+  } else {
+    thread_pool->Schedule(std::move(run));
+  }
+
+  return Status::OK();
+}
+
 template <typename T>
 void InferenceSession::StartProfiling(const std::basic_string<T>& file_prefix) {
   std::basic_ostringstream<T> ss;
@@ -1664,6 +2046,32 @@ const profiling::Profiler& InferenceSession::GetProfiling() const {
   return session_profiler_;
 }
 
+common::Status InferenceSession::GetNodeMetrics(std::vector<NodeMetrics::Entry>& entries) const {
+  if (!IsInitialized()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Session was not initialized");
+  }
+
+  if (session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigEnableNodeMetrics, "0") != "1") {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Node metrics are not enabled. Set the ",
+                           kOrtSessionOptionsConfigEnableNodeMetrics, " config entry to \"1\" to enable them.");
+  }
+
+  session_state_->GetNodeMetricsSnapshot("", entries);
+  return Status::OK();
+}
+
+common::Status InferenceSession::ShrinkMemoryArenas() {
+  for (const auto& xp : execution_providers_) {
+    for (const auto& allocator : xp->GetAllocators()) {
+      if (allocator->Info().alloc_type == OrtArenaAllocator) {
+        ORT_RETURN_IF_ERROR_SESSIONID_(static_cast<IArenaAllocator*>(allocator.get())->Shrink());
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
 AllocatorPtr InferenceSession::GetAllocator(const OrtMemoryInfo& mem_info) const {
   return session_state_->GetAllocator(mem_info);
 }
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 
@@ -19,6 +20,8 @@
 #include "core/optimizer/graph_transformer_level.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/insert_cast_transformer.h"
+#include "core/platform/env.h"
+#include "core/platform/ort_mutex.h"
 #include "core/framework/session_options.h"
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
 #include "core/language_interop_ops/language_interop_ops.h"
@@ -165,6 +168,14 @@ class InferenceSession {
     */
   common::Status RegisterExecutionProvider(std::unique_ptr<IExecutionProvider> p_exec_provider) ORT_MUST_USE_RESULT;
 
+  /**
+    * Share the weights pre-packed by the kernels of this session with other sessions using the same container.
+    * Call this before invoking Initialize(). The container must outlive the session.
+    * @return OK if success.
+    */
+  common::Status AddPrePackedWeightsContainer(PrepackedWeightsContainer* prepacked_weights_container)
+      ORT_MUST_USE_RESULT;
+
 #if !defined(ORT_MINIMAL_BUILD)
   /**
     * Register a graph transformer. If you've one to register, call this before invoking Initialize().
@@ -295,6 +306,26 @@ class InferenceSession {
   virtual common::Status Run(const RunOptions& run_options, IOBinding& io_binding) ORT_MUST_USE_RESULT;
   common::Status Run(IOBinding& io_binding) ORT_MUST_USE_RESULT;
 
+  using RunAsyncCallback = std::function<void(const common::Status& status, std::vector<OrtValue>& fetches)>;
+  using RunAsyncExecutor = std::function<void(std::function<void()>)>;
+
+  /**
+    * Schedule a Run and return without waiting for it to complete.
+    * The Run executes on the given executor, or on the session's thread pools if executor is empty. The inter-op
+    * pool is used unless the session runs the parallel executor, which blocks on that pool, in which case the
+    * intra-op pool is used.
+    * callback is invoked on the thread that executed the Run with its status and the fetches in the order of
+    * output_names. Calls to callback may happen concurrently if multiple runs are in flight.
+    * The session waits for all scheduled runs to complete when it is destroyed, so it must not be destroyed from
+    * within callback.
+    * @param run_options if not null, must stay valid until callback was invoked. This allows a run to be cancelled
+    *        by setting terminate on it.
+    * @return OK if the run was scheduled. Errors of the run itself are reported through callback.
+    */
+  common::Status RunAsync(const RunOptions* run_options, const std::vector<std::string>& feed_names,
+                          const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                          RunAsyncCallback callback, const RunAsyncExecutor& executor = {}) ORT_MUST_USE_RESULT;
+
   /**
     * @return pair.first = OK; FAIL otherwise. pair.second is non-NULL when pair.first = OK.
     * @note lifetime of the returned pointer is valid as long as the Session object is live.
@@ -378,6 +409,20 @@ class InferenceSession {
     */
   const profiling::Profiler& GetProfiling() const;
 
+  /**
+    * Get the execution counters of the nodes of the model and its subgraphs.
+    * Requires the session.enable_node_metrics config entry to be set. Safe to call while Run() calls are in progress.
+    * @param entries Receives an entry for each node that ran at least once.
+    * @return OK if success.
+    */
+  common::Status GetNodeMetrics(std::vector<NodeMetrics::Entry>& entries) const;
+
+  /**
+    * Return memory that is not currently in use from the memory arenas of all execution providers
+    * to the devices. Safe to call while Run() calls are in progress.
+    */
+  common::Status ShrinkMemoryArenas();
+
   /**
     * Search registered execution providers for an allocator that has characteristics
     * specified within mem_info
@@ -432,6 +477,11 @@ class InferenceSession {
   /// convenience pointer to logger. should always be the same as session_state_.Logger();
   const logging::Logger* session_logger_;
 
+  // Memory mapped ORT format model, see kOrtSessionOptionsConfigUseMappedOrtModel.
+  // The initializers of model_ and session_state_ may use the mapped bytes in place, so this is declared before them
+  // to outlive them.
+  Env::MappedMemoryPtr ort_format_model_mapped_bytes_;
+
   // The model served by this inference session instance.
   // Currently this has to be a shared ptr because the Model::Load method
   // returns a shared_ptr only. Ideally factory functions should always return
@@ -468,6 +518,17 @@ class InferenceSession {
   }
 
   common::Status SaveToOrtFormat(const std::basic_string<ORTCHAR_T>& filepath) const;
+
+#if defined(ENABLE_ORT_FORMAT_LOAD)
+  // Gets the path of the optimized model in the cache configured by kOrtSessionOptionsConfigOptimizedModelCacheDir
+  // and replaces model_ with it if it exists. cache_file_path is empty if the session can't use the cache.
+  // Failures are logged and leave model_ unchanged, so that the session falls back to optimizing the model.
+  // Requires session_mutex_ to be held.
+  bool LoadFromOptimizedModelCache(std::basic_string<ORTCHAR_T>& cache_file_path);
+
+  // Saves the optimized model and session state to the cache. Requires session_mutex_ to be held.
+  void SaveToOptimizedModelCache(const std::basic_string<ORTCHAR_T>& cache_file_path) const;
+#endif
 #endif
 
 #if defined(ENABLE_ORT_FORMAT_LOAD)
@@ -493,6 +554,13 @@ class InferenceSession {
 
   common::Status LoadOrtModel(std::function<Status()> load_ort_format_model_bytes) ORT_MUST_USE_RESULT;
 
+  // Creates model_ from ort_format_model_bytes_. Requires session_mutex_ to be held.
+  common::Status LoadOrtModelFromBytes() ORT_MUST_USE_RESULT;
+
+  // Reads or memory maps the ORT format model file, see kOrtSessionOptionsConfigUseMappedOrtModel.
+  template <typename T>
+  common::Status LoadOrtModelFromFile(const std::basic_string<T>& model_uri) ORT_MUST_USE_RESULT;
+
 #endif  // defined(ENABLE_ORT_FORMAT_LOAD)
 
   // Create a Logger for a single execution if possible. Otherwise use the default logger.
@@ -581,6 +649,10 @@ class InferenceSession {
   //CustomRegistry objects own the corresponding KernelRegistry and OnnxRuntimeOpSchemaRegistry objects.
   //So its lifetime should be same as its constituents. This vector is to extend the lifetime of the owner.
   std::vector<std::shared_ptr<CustomRegistry>> custom_registries_;
+
+  // whether graph transformers were registered with RegisterGraphTransformer. they aren't part of the key of the
+  // optimized model cache, so the cache is disabled if there are any.
+  bool has_custom_graph_transformers_ = false;
 #endif
 
   ModelMetadata model_metadata_;
@@ -601,9 +673,17 @@ class InferenceSession {
   // Data transfer manager.
   DataTransferManager data_transfer_mgr_;
 
+  // Store of the pre-packed weights shared with other sessions. Not owned, may be nullptr.
+  PrepackedWeightsContainer* prepacked_weights_container_ = nullptr;
+
   // Number of concurrently running executors
   std::atomic<int> current_num_runs_;
 
+  // Number of runs scheduled by RunAsync that haven't completed yet. The destructor waits for this to reach 0.
+  int num_async_runs_in_flight_ = 0;  // GUARDED_BY(async_runs_mutex_)
+  onnxruntime::OrtMutex async_runs_mutex_;
+  onnxruntime::OrtCondVar async_runs_completed_;
+
   mutable onnxruntime::OrtMutex session_mutex_;  // to ensure only one thread can invoke Load/Initialize
   bool is_model_loaded_ = false;                 // GUARDED_BY(session_mutex_)
   bool is_inited_ = false;                       // GUARDED_BY(session_mutex_)
@@ -641,10 +721,10 @@ class InferenceSession {
   // Bytes from an ORT format model.
   // We store them currently to make the Load + Initialize behave the same way as for an ONNX model
   // as we need some of the bytes for the Load (create the Model) and some for the Initialize (create SessionState).
-  // Short term we free them after Initialize.
-  // Longer term we may want to directly refer to offsets in this buffer for initializers so we don't need to copy
-  // those into new OrtValue instances, at which point we won't free them until the InferenceSession goes away.
-  std::vector<uint8_t> ort_format_model_bytes_;
+  // They point to ort_format_model_bytes_data_holder_, which we free after Initialize, or to
+  // ort_format_model_mapped_bytes_, which initializers may refer to until the InferenceSession goes away.
+  gsl::span<const uint8_t> ort_format_model_bytes_;
+  std::vector<uint8_t> ort_format_model_bytes_data_holder_;
 };
 
 struct SessionIOBinding {
@@ -0,0 +1,242 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include "core/session/optimized_model_cache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+
+#include "onnxruntime_config.h"
+#include "core/common/cpuid_info.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/model.h"
+#include "core/platform/env.h"
+#include "core/platform/path_lib.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+
+namespace onnxruntime {
+namespace optimized_model_cache {
+
+namespace {
+
+// Incremental 128-bit hash. Each chunk is hashed with the hash of the previous chunks as seed so that the data can be
+// streamed without holding all of it in memory.
+class Hasher {
+ public:
+  void Update(const void* data, size_t size) {
+    // MurmurHash3 takes an int length, so large data is hashed in chunks.
+    constexpr size_t kMaxChunkSize = 1 << 30;
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    do {
+      const size_t chunk_size = std::min(size, kMaxChunkSize);
+      uint32_t chunk_hash[4];
+      MurmurHash3::x86_128(bytes, static_cast<int>(chunk_size), hash_[0] ^ hash_[1] ^ hash_[2] ^ hash_[3],
+                           chunk_hash);
+      for (int i = 0; i < 4; ++i) {
+        hash_[i] = hash_[i] * 31 + chunk_hash[i];
+      }
+
+      bytes += chunk_size;
+      size -= chunk_size;
+    } while (size > 0);
+  }
+
+  // strings are prefixed with their size so that adjacent strings can't be confused with each other
+  void Update(const std::string& s) {
+    Update(static_cast<uint64_t>(s.size()));
+    Update(s.data(), s.size());
+  }
+
+  template <typename T>
+  void Update(T value) {
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "Unsupported type.");
+    Update(&value, sizeof(value));
+  }
+
+  Status UpdateWithFile(const PathString& path) {
+    std::ifstream file(path, std::ios::binary);
+    ORT_RETURN_IF_NOT(file, "Failed to open ", ToMBString(path));
+
+    std::vector<char> buffer(1 << 20);
+    uint64_t file_size = 0;
+    while (file) {
+      file.read(buffer.data(), buffer.size());
+      const auto num_read = static_cast<size_t>(file.gcount());
+      if (num_read > 0) {
+        Update(buffer.data(), num_read);
+        file_size += num_read;
+      }
+    }
+
+    ORT_RETURN_IF_NOT(file.eof(), "Failed to read ", ToMBString(path));
+    Update(file_size);
+    return Status::OK();
+  }
+
+  std::string HexDigest() const {
+    std::ostringstream ss;
+    for (auto value : hash_) {
+      ss << std::hex << std::setw(8) << std::setfill('0') << value;
+    }
+
+    return ss.str();
+  }
+
+ private:
+  uint32_t hash_[4] = {0, 0, 0, 0};
+};
+
+void HashSessionOptions(const SessionOptions& session_options, Hasher& hasher) {
+  hasher.Update(session_options.graph_optimization_level);
+  hasher.Update(session_options.max_num_graph_transformation_steps);
+  hasher.Update(session_options.use_deterministic_compute);
+
+  hasher.Update(static_cast<uint64_t>(session_options.free_dimension_overrides.size()));
+  for (const auto& free_dim_override : session_options.free_dimension_overrides) {
+    hasher.Update(free_dim_override.dim_identifier);
+    hasher.Update(free_dim_override.dim_identifer_type);
+    hasher.Update(free_dim_override.dim_value);
+  }
+
+  // sort the config entries so that the order they were added in doesn't matter. the location of the cache doesn't
+  // affect the optimized model.
+  std::map<std::string, std::string> config_entries(session_options.session_configurations.cbegin(),
+                                                    session_options.session_configurations.cend());
+  config_entries.erase(kOrtSessionOptionsConfigOptimizedModelCacheDir);
+  hasher.Update(static_cast<uint64_t>(config_entries.size()));
+  for (const auto& entry : config_entries) {
+    hasher.Update(entry.first);
+    hasher.Update(entry.second);
+  }
+}
+
+// the kernels selected and the transformers that run depend on the instruction sets the CPU supports
+void HashCpuFeatures(Hasher& hasher) {
+  const auto& cpu_info = CPUIDInfo::GetCPUIDInfo();
+  hasher.Update(cpu_info.HasSSE3());
+  hasher.Update(cpu_info.HasAVX());
+  hasher.Update(cpu_info.HasAVX2());
+  hasher.Update(cpu_info.HasAVX512f());
+  hasher.Update(cpu_info.HasAVX512Skylake());
+  hasher.Update(cpu_info.HasF16C());
+}
+
+Status HashModel(const Model& model, const PathString& model_location, Hasher& hasher) {
+  if (model_location.empty()) {
+    hasher.Update(model.ToProto().SerializeAsString());
+  } else {
+    ORT_RETURN_IF_ERROR(hasher.UpdateWithFile(model_location));
+  }
+
+  // the model file only contains the location of external data, so the data has to be hashed separately
+  PathString model_dir;
+  if (!model_location.empty()) {
+    ORT_RETURN_IF_ERROR(GetDirNameFromFilePath(model_location, model_dir));
+  }
+
+  // InitializedTensorSet is unordered, so sort the initializers by name
+  const auto& initializers = model.MainGraph().GetAllInitializedTensors();
+  std::map<std::string, const ONNX_NAMESPACE::TensorProto*> sorted_initializers(initializers.cbegin(),
+                                                                                initializers.cend());
+  for (const auto& entry : sorted_initializers) {
+    const auto& tensor_proto = *entry.second;
+    if (tensor_proto.data_location() != ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL ||
+        utils::HasExternalDataInMemory(tensor_proto)) {
+      continue;
+    }
+
+    std::unique_ptr<ExternalDataInfo> external_data_info;
+    ORT_RETURN_IF_ERROR(ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info));
+    const auto& rel_path = external_data_info->GetRelPath();
+    const auto path = model_dir.empty() ? rel_path : ConcatPathComponent<ORTCHAR_T>(model_dir, rel_path);
+
+    hasher.Update(entry.first);
+    ORT_RETURN_IF_ERROR(hasher.UpdateWithFile(path));
+  }
+
+  return Status::OK();
+}
+
+}  // namespace
+
+Status GetCacheFilePath(const PathString& cache_dir, const Model& model, const PathString& model_location,
+                        const SessionOptions& session_options,
+                        const std::vector<std::string>& provider_types,
+                        const std::vector<std::string>& transformers_to_enable,
+                        PathString& cache_file_path) {
+  Hasher hasher;
+  hasher.Update(std::string(ORT_VERSION));
+  HashSessionOptions(session_options, hasher);
+
+  hasher.Update(static_cast<uint64_t>(provider_types.size()));
+  for (const auto& provider_type : provider_types) {
+    hasher.Update(provider_type);
+  }
+
+  hasher.Update(static_cast<uint64_t>(transformers_to_enable.size()));
+  for (const auto& transformer : transformers_to_enable) {
+    hasher.Update(transformer);
+  }
+
+  HashCpuFeatures(hasher);
+  ORT_RETURN_IF_ERROR(HashModel(model, model_location, hasher));
+
+  const auto& env = Env::Default();
+  if (!env.FolderExists(cache_dir)) {
+    // another session can create it at the same time
+    auto status = env.CreateFolder(cache_dir);
+    if (!status.IsOK() && !env.FolderExists(cache_dir)) {
+      return status;
+    }
+  }
+
+  cache_file_path = ConcatPathComponent<ORTCHAR_T>(cache_dir, ToPathString(hasher.HexDigest() + ".ort"));
+  return Status::OK();
+}
+
+PathString GetTempCacheFilePath(const PathString& cache_file_path) {
+  // the process id tells processes apart, the thread id and the counter the sessions of a process
+  static std::atomic<uint64_t> temp_file_count{0};
+  std::ostringstream suffix;
+  suffix << ".tmp." << Env::Default().GetSelfPid() << "." << std::this_thread::get_id() << "." << temp_file_count++;
+  return cache_file_path + ToPathString(suffix.str());
+}
+
+void RemoveTempCacheFile(const PathString& temp_file_path) {
+#ifdef _WIN32
+  _wremove(temp_file_path.c_str());
+#else
+  std::remove(temp_file_path.c_str());
+#endif
+}
+
+Status CommitCacheFile(const PathString& temp_file_path, const PathString& cache_file_path) {
+#ifdef _WIN32
+  const bool renamed = _wrename(temp_file_path.c_str(), cache_file_path.c_str()) == 0;
+#else
+  const bool renamed = std::rename(temp_file_path.c_str(), cache_file_path.c_str()) == 0;
+#endif
+
+  if (!renamed) {
+    RemoveTempCacheFile(temp_file_path);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to move ", ToMBString(temp_file_path), " to ",
+                           ToMBString(cache_file_path));
+  }
+
+  return Status::OK();
+}
+
+}  // namespace optimized_model_cache
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
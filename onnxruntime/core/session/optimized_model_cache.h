@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+#include "core/framework/session_options.h"
+
+namespace onnxruntime {
+
+class Model;
+
+namespace optimized_model_cache {
+
+// Gets the path of the file in cache_dir that the optimized ORT format model of model is cached in.
+//
+// The file name is a hash of everything the optimized model depends on: the model (the file at model_location, or
+// the serialized model if model_location is empty), the external data files of its initializers, the ORT version,
+// the session options, the execution providers and the features of the CPU. A model with the same name is therefore
+// only reused if it was created from the same model for the same configuration.
+// cache_dir is created if it doesn't exist.
+common::Status GetCacheFilePath(const PathString& cache_dir, const Model& model, const PathString& model_location,
+                                const SessionOptions& session_options,
+                                const std::vector<std::string>& provider_types,
+                                const std::vector<std::string>& transformers_to_enable,
+                                PathString& cache_file_path);
+
+// Gets the path of a temporary file to write the optimized model to before it is moved to cache_file_path, so that
+// sessions populating or reading the cache at the same time never see partially written models. Each call returns a
+// different path, so sessions of the same or different processes never write to the same file.
+PathString GetTempCacheFilePath(const PathString& cache_file_path);
+
+// Moves the model written to temp_file_path to cache_file_path. temp_file_path is removed if that fails, e.g. if
+// another session created cache_file_path first on a platform where existing files can't be replaced.
+common::Status CommitCacheFile(const PathString& temp_file_path, const PathString& cache_file_path);
+
+// Removes the temporary file of a model that couldn't be saved.
+void RemoveTempCacheFile(const PathString& temp_file_path);
+
+}  // namespace optimized_model_cache
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
@@ -247,4 +247,26 @@ ORT_API_STATUS_IMPL(AddInitializer, _Inout_ OrtSessionOptions* options, _In_ con
 ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_CUDA,
                     _In_ OrtSessionOptions* options, _In_ OrtCUDAProviderOptions* cuda_options);
 ORT_API_STATUS_IMPL(SetGlobalDenormalAsZero, _Inout_ OrtThreadingOptions* options);
+ORT_API_STATUS_IMPL(RunOptionsSetShrinkArenas, _Inout_ OrtRunOptions* options, int shrink_arenas);
+ORT_API_STATUS_IMPL(SessionShrinkArenas, _Inout_ OrtSession* sess);
+ORT_API_STATUS_IMPL(RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    _In_ RunAsyncCallbackFn run_async_callback, _In_opt_ void* user_data);
+ORT_API_STATUS_IMPL(SetGlobalIntraOpThreadAffinity, _Inout_ OrtThreadingOptions* tp_options, _In_ const char* affinity);
+ORT_API_STATUS_IMPL(SetGlobalInterOpThreadAffinity, _Inout_ OrtThreadingOptions* tp_options, _In_ const char* affinity);
+
+ORT_API_STATUS_IMPL(CreatePrepackedWeightsContainer, _Outptr_ OrtPrepackedWeightsContainer** out);
+ORT_API(void, ReleasePrepackedWeightsContainer, _Frees_ptr_opt_ OrtPrepackedWeightsContainer*);
+ORT_API_STATUS_IMPL(CreateSessionWithPrepackedWeightsContainer, _In_ const OrtEnv* env, _In_ const ORTCHAR_T* model_path,
+                    _In_ const OrtSessionOptions* options,
+                    _Inout_ OrtPrepackedWeightsContainer* prepacked_weights_container, _Outptr_ OrtSession** out);
+ORT_API_STATUS_IMPL(CreateSessionFromArrayWithPrepackedWeightsContainer, _In_ const OrtEnv* env,
+                    _In_ const void* model_data, size_t model_data_length, _In_ const OrtSessionOptions* options,
+                    _Inout_ OrtPrepackedWeightsContainer* prepacked_weights_container, _Outptr_ OrtSession** out);
+ORT_API_STATUS_IMPL(SessionGetNodeMetrics, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out);
+ORT_API_STATUS_IMPL(RunOptionsSetProfiling, _Inout_ OrtRunOptions* options, int start_profiling, int end_profiling);
+ORT_API_STATUS_IMPL(RunOptionsGetTerminate, _In_ const OrtRunOptions* options, _Out_ int* out);
 }  // namespace OrtApis
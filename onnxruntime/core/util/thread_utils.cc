@@ -5,20 +5,29 @@
 #ifdef _WIN32
 #include <Windows.h>
 #endif
+#include <sstream>
 #include <thread>
+#include "core/common/parse_string.h"
 #include "core/session/ort_apis.h"
+#include "core/framework/error_code_helper.h"
 
 namespace onnxruntime {
 namespace concurrency {
 static std::unique_ptr<ThreadPool>
 CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
-  if (options.thread_pool_size == 1)
-    return nullptr;
   std::vector<size_t> cpu_list;
   ThreadOptions to;
-  if (options.affinity_vec_len != 0) {
-    to.affinity.assign(options.affinity_vec, options.affinity_vec + options.affinity_vec_len);
+  if (!options.affinity.empty()) {
+    to.affinity = options.affinity;
+    if (options.thread_pool_size <= 0)
+      options.thread_pool_size = static_cast<int>(to.affinity.size());
+    // a pool of one thread runs all of its work on the caller's thread, which is never pinned
+    ORT_ENFORCE(options.thread_pool_size != 1,
+                "Thread affinity can't be applied to a thread pool of one thread, as its work runs on the calling "
+                "thread. Set at least two threads or list at least two processors.");
   }
+  if (options.thread_pool_size == 1)
+    return nullptr;
   if (options.thread_pool_size <= 0) {  // default
     cpu_list = Env::Default().GetThreadAffinityMasks();
     if (cpu_list.empty() || cpu_list.size() == 1)
@@ -28,6 +37,7 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
       to.affinity = cpu_list;
   }
   to.set_denormal_as_zero = options.set_denormal_as_zero;
+  to.dynamic_block_base = options.dynamic_block_base;
 
   return onnxruntime::make_unique<ThreadPool>(env, to, options.name, options.thread_pool_size,
                                               options.allow_spinning);
@@ -52,6 +62,110 @@ CreateThreadPool(Env* env, OrtThreadPoolParams options, ThreadPoolType tpool_typ
 #endif
 }
 
+// larger ids are most likely typos, and would make a range expand into a huge list
+static constexpr size_t kMaxProcessorId = 65535;
+
+static Status ParseProcessorList(const std::string& setting, std::vector<size_t>& processors) {
+  std::istringstream stream(setting);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    const auto dash = range.find('-');
+    size_t first = 0;
+    size_t last = 0;
+    if (!TryParseStringWithClassicLocale(range.substr(0, dash), first) ||
+        !TryParseStringWithClassicLocale(dash == std::string::npos ? range : range.substr(dash + 1), last) ||
+        last < first || last > kMaxProcessorId) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid processor range '", range,
+                             "' in thread affinity setting: ", setting);
+    }
+    for (size_t processor = first; processor <= last; ++processor) {
+      processors.push_back(processor);
+    }
+  }
+
+  if (processors.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid thread affinity setting: ", setting);
+  }
+  return Status::OK();
+}
+
+Status SetThreadAffinity(const Env& env, const std::string& setting, OrtThreadPoolParams& params) {
+  if (setting.empty()) {
+    return Status::OK();
+  }
+
+  if (setting == "none") {
+    params.affinity.clear();
+    params.auto_set_affinity = false;
+    return Status::OK();
+  }
+
+  std::vector<size_t> processors;
+  const std::string numa_prefix = "numa:";
+  const std::string physical_suffix = ":physical";
+  if (setting == "physical" || setting.compare(0, numa_prefix.size(), numa_prefix) == 0) {
+    int numa_node = -1;
+    bool physical_only = setting == "physical";
+    if (!physical_only) {
+      std::string node = setting.substr(numa_prefix.size());
+      if (node.size() > physical_suffix.size() &&
+          node.compare(node.size() - physical_suffix.size(), physical_suffix.size(), physical_suffix) == 0) {
+        physical_only = true;
+        node.resize(node.size() - physical_suffix.size());
+      }
+      if (!TryParseStringWithClassicLocale(node, numa_node) || numa_node < 0) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid NUMA node in thread affinity setting: ", setting);
+      }
+    }
+
+    const auto cores = env.GetPhysicalCoreProcessors(numa_node);
+    if (cores.empty()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Thread affinity setting '", setting,
+                             "' can't be applied. The processor topology is unknown on this platform or the NUMA "
+                             "node has no processors this process may run on.");
+    }
+    for (const auto& core : cores) {
+      if (physical_only) {
+        processors.push_back(core.front());
+      } else {
+        processors.insert(processors.end(), core.begin(), core.end());
+      }
+    }
+  } else {
+    ORT_RETURN_IF_ERROR(ParseProcessorList(setting, processors));
+
+    // if the topology is known, catch processors the process can't run on here rather than when creating the threads
+    const auto cores = env.GetPhysicalCoreProcessors(-1);
+    if (!cores.empty()) {
+      for (auto processor : processors) {
+        bool allowed = std::any_of(cores.cbegin(), cores.cend(), [processor](const std::vector<size_t>& core) {
+          return std::find(core.cbegin(), core.cend(), processor) != core.cend();
+        });
+        if (!allowed) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Thread affinity setting '", setting,
+                                 "' contains processor ", processor, " which this process may not run on.");
+        }
+      }
+    }
+  }
+
+#ifdef _WIN32
+  // ThreadOptions::affinity holds processor masks on Windows
+  for (auto& processor : processors) {
+    if (processor >= sizeof(size_t) * 8) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Thread affinity setting '", setting,
+                             "' contains processor ", processor, ". Only the first ", sizeof(size_t) * 8,
+                             " processors are supported.");
+    }
+    processor = size_t{1} << processor;
+  }
+#endif
+
+  params.affinity = std::move(processors);
+  params.auto_set_affinity = false;
+  return Status::OK();
+}
+
 }  // namespace concurrency
 }  // namespace onnxruntime
 namespace OrtApis {
@@ -91,6 +205,26 @@ ORT_API_STATUS_IMPL(SetGlobalSpinControl, _Inout_ OrtThreadingOptions* tp_option
   return nullptr;
 }
 
+ORT_API_STATUS_IMPL(SetGlobalIntraOpThreadAffinity, _Inout_ OrtThreadingOptions* tp_options,
+                    _In_ const char* affinity) {
+  if (!tp_options || !affinity) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "Received null OrtThreadingOptions or affinity");
+  }
+  auto status = onnxruntime::concurrency::SetThreadAffinity(onnxruntime::Env::Default(), affinity,
+                                                            tp_options->intra_op_thread_pool_params);
+  return onnxruntime::ToOrtStatus(status);
+}
+
+ORT_API_STATUS_IMPL(SetGlobalInterOpThreadAffinity, _Inout_ OrtThreadingOptions* tp_options,
+                    _In_ const char* affinity) {
+  if (!tp_options || !affinity) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "Received null OrtThreadingOptions or affinity");
+  }
+  auto status = onnxruntime::concurrency::SetThreadAffinity(onnxruntime::Env::Default(), affinity,
+                                                            tp_options->inter_op_thread_pool_params);
+  return onnxruntime::ToOrtStatus(status);
+}
+
 ORT_API_STATUS_IMPL(SetGlobalDenormalAsZero, _Inout_ OrtThreadingOptions* tp_options) {
   if (!tp_options) {
     return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "Received null OrtThreadingOptions");
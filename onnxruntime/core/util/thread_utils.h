@@ -6,6 +6,7 @@
 #include "core/session/onnxruntime_c_api.h"
 #include <memory>
 #include <string>
+#include <vector>
 
 struct OrtThreadPoolParams {
   //0: Use default setting. (All the physical cores or half of the logical cores)
@@ -20,14 +21,18 @@ struct OrtThreadPoolParams {
   bool allow_spinning = true;
 
   unsigned int stack_size = 0;
-  //Index is thread id, value is processor ID
+  //Index is thread id, value is processor ID. See ThreadOptions::affinity.
   //If the vector is empty, no explict affinity binding
-  size_t* affinity_vec = nullptr;
-  size_t affinity_vec_len = 0;
+  //If it is not empty and thread_pool_size = 0, the pool gets one thread per entry.
+  //CreateThreadPool throws if it is not empty and the pool would have one thread.
+  std::vector<size_t> affinity;
   const ORTCHAR_T* name = nullptr;
 
   // Set or unset denormal as zero
   bool set_denormal_as_zero = false;
+
+  // See ThreadOptions::dynamic_block_base. 0 disables dynamic blocks.
+  int dynamic_block_base = 0;
 };
 
 struct OrtThreadingOptions {
@@ -47,5 +52,15 @@ enum class ThreadPoolType : uint8_t {
 };
 std::unique_ptr<ThreadPool> CreateThreadPool(Env* env, OrtThreadPoolParams options,
                                              ThreadPoolType tpool_type);
+
+// Sets params.affinity from a thread affinity setting:
+//   ""                   leaves params unchanged
+//   "none"               doesn't pin the threads, and disables auto_set_affinity
+//   "physical"           one logical processor of each physical core the process may run on
+//   "numa:<n>"           all logical processors of NUMA node n
+//   "numa:<n>:physical"  one logical processor of each physical core of NUMA node n
+//   "<list>"             the listed logical processors, e.g. "0,2,4-7"
+// The topology based settings need Env::GetPhysicalCoreProcessors, which is only implemented on Linux.
+common::Status SetThreadAffinity(const Env& env, const std::string& setting, OrtThreadPoolParams& params);
 }  // namespace concurrency
 }  // namespace onnxruntime
@@ -1520,7 +1520,13 @@ RunOptions instance. The individual calls will exit gracefully and return an err
                      R"pbdoc(Choose to run in training or inferencing mode)pbdoc")
 #endif
       .def_readwrite("only_execute_path_to_fetches", &RunOptions::only_execute_path_to_fetches,
-                     R"pbdoc(Only execute the nodes needed by fetch list)pbdoc");
+                     R"pbdoc(Only execute the nodes needed by fetch list)pbdoc")
+      .def_readwrite("shrink_memory_arenas", &RunOptions::shrink_memory_arenas,
+                     R"pbdoc(Return memory that isn't in use from the session's memory arenas once the run completes)pbdoc")
+      .def_readwrite("start_profiling", &RunOptions::start_profiling,
+                     R"pbdoc(Start profiling the session before the run if it isn't being profiled)pbdoc")
+      .def_readwrite("end_profiling", &RunOptions::end_profiling,
+                     R"pbdoc(End profiling the session and write the profile file once the run completes)pbdoc");
 
   py::class_<ModelMetadata>(m, "ModelMetadata", R"pbdoc(Pre-defined and custom metadata about the model.
 It is usually used to identify the model used to run the prediction and
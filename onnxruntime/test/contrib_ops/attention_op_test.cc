@@ -3,9 +3,15 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "core/session/IOBinding.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
+#include "test/framework/test_utils.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
 
 namespace onnxruntime {
 namespace test {
@@ -16,6 +22,17 @@ enum MaskIndexType {
   kMaskDummy  // Dummy mask with shape [1, 1] or [batch_size, 1]
 };
 
+// Pads the sequence dimension of past or present state from sequence_length to max_sequence_length with zeros.
+static std::vector<float> PadStateSequence(const std::vector<float>& state, int batch_size, int number_of_heads,
+                                           int sequence_length, int max_sequence_length, int head_size) {
+  std::vector<float> padded(2 * batch_size * number_of_heads * max_sequence_length * head_size, 0.0f);
+  for (int i = 0; i < 2 * batch_size * number_of_heads; i++) {
+    std::copy_n(state.begin() + i * sequence_length * head_size, sequence_length * head_size,
+                padded.begin() + i * max_sequence_length * head_size);
+  }
+  return padded;
+}
+
 static void RunAttentionTest(
     const std::vector<float>& input_data,         // input:      [batch_size, sequence_length, hidden_size]
     const std::vector<float>& weights_data,       // weights:    [hidden_size, 3 * hidden_size]
@@ -33,10 +50,11 @@ static void RunAttentionTest(
     int past_sequence_length = 0,
     const std::vector<float>* past_data = nullptr,
     const std::vector<float>* present_data = nullptr,
-    MaskIndexType mask_index_type = kMaskIndexEnd) {
+    MaskIndexType mask_index_type = kMaskIndexEnd,
+    int max_sequence_length = 0) {  // past and present share a buffer with this many positions if > 0
   int min_cuda_architecture = use_float16 ? 530 : 0;
 
-  bool enable_cuda = HasCudaEnvironment(min_cuda_architecture) && !is_weights_constant;
+  bool enable_cuda = HasCudaEnvironment(min_cuda_architecture) && !is_weights_constant && max_sequence_length == 0;
   bool enable_cpu = (nullptr != DefaultCpuExecutionProvider().get()) && !use_float16;
   int head_size = hidden_size / number_of_heads;
   if (enable_cpu || enable_cuda) {
@@ -93,7 +111,17 @@ static void RunAttentionTest(
       tester.AddMissingOptionalInput<int32_t>();
     }
 
-    if (use_past_state) {
+    if (max_sequence_length > 0) {
+      tester.AddAttribute<int64_t>("past_present_share_buffer", 1);
+      std::vector<int64_t> buffer_dims = {2, batch_size, number_of_heads, max_sequence_length, head_size};
+      tester.AddInput<float>("past", buffer_dims,
+                             PadStateSequence(*past_data, batch_size, number_of_heads, past_sequence_length,
+                                              max_sequence_length, head_size));
+      tester.AddInput<int32_t>("past_sequence_length", {1}, {past_sequence_length});
+      tester.AddOutput<float>("present", buffer_dims,
+                              PadStateSequence(*present_data, batch_size, number_of_heads,
+                                               past_sequence_length + sequence_length, max_sequence_length, head_size));
+    } else if (use_past_state) {
       if (use_float16) {
         if (past_sequence_length > 0) {
           tester.AddInput<MLFloat16>("past", past_dims, ToFloat16(*past_data));
@@ -137,15 +165,16 @@ static void RunAttentionTest(
     int past_sequence_length = 0,
     const std::vector<float>* past_data = nullptr,
     const std::vector<float>* present_data = nullptr,
-    MaskIndexType mask_index_type = kMaskIndexEnd) {
+    MaskIndexType mask_index_type = kMaskIndexEnd,
+    int max_sequence_length = 0) {
   RunAttentionTest(input_data, weights_data, false, bias_data, mask_index_data, output_data,
                    batch_size, sequence_length, hidden_size, number_of_heads,
                    use_float16, is_unidirectional, use_past_state, past_sequence_length,
-                   past_data, present_data, mask_index_type);
+                   past_data, present_data, mask_index_type, max_sequence_length);
   RunAttentionTest(input_data, weights_data, true, bias_data, mask_index_data, output_data,
                    batch_size, sequence_length, hidden_size, number_of_heads,
                    use_float16, is_unidirectional, use_past_state, past_sequence_length,
-                   past_data, present_data, mask_index_type);
+                   past_data, present_data, mask_index_type, max_sequence_length);
 }
 
 TEST(AttentionTest, AttentionBatch1) {
@@ -512,6 +541,13 @@ TEST(AttentionTest, AttentionEmptyPastState) {
   RunAttentionTest(input_data, weight_data, bias_data, mask_index_data, output_data,
                    batch_size, sequence_length, hidden_size, number_of_heads, false, is_unidirectional,
                    use_past_state, past_sequence_length, &past_data, &present_data);
+
+  // first step with past and present in a buffer with room for more positions
+  int max_sequence_length = 5;
+  RunAttentionTest(input_data, weight_data, bias_data, mask_index_data, output_data,
+                   batch_size, sequence_length, hidden_size, number_of_heads, false, is_unidirectional,
+                   use_past_state, past_sequence_length, &past_data, &present_data, kMaskIndexEnd,
+                   max_sequence_length);
 }
 
 TEST(AttentionTest, AttentionPastStateBatch1) {
@@ -611,6 +647,13 @@ TEST(AttentionTest, AttentionPastStateBatch1) {
   RunAttentionTest(input_data, weight_data, bias_data, mask_index_data, output_data,
                    batch_size, sequence_length, hidden_size, number_of_heads, false, is_unidirectional,
                    use_past_state, past_sequence_length, &past_data, &present_data);
+
+  // past and present in a buffer with room for more positions
+  int max_sequence_length = 6;
+  RunAttentionTest(input_data, weight_data, bias_data, mask_index_data, output_data,
+                   batch_size, sequence_length, hidden_size, number_of_heads, false, is_unidirectional,
+                   use_past_state, past_sequence_length, &past_data, &present_data, kMaskIndexEnd,
+                   max_sequence_length);
 }
 
 TEST(AttentionTest, AttentionPastStateBatch2) {
@@ -816,6 +859,13 @@ TEST(AttentionTest, AttentionPastStateBatch2WithPadding) {
   RunAttentionTest(input_data, weight_data, bias_data, mask_index_data, output_data,
                    batch_size, sequence_length, hidden_size, number_of_heads, false, is_unidirectional,
                    use_past_state, past_sequence_length, &past_data, &present_data, kMaskIndexEndAndStart);
+
+  // past and present in a buffer with room for more positions
+  int max_sequence_length = 8;
+  RunAttentionTest(input_data, weight_data, bias_data, mask_index_data, output_data,
+                   batch_size, sequence_length, hidden_size, number_of_heads, false, is_unidirectional,
+                   use_past_state, past_sequence_length, &past_data, &present_data, kMaskIndexEndAndStart,
+                   max_sequence_length);
 }
 
 TEST(AttentionTest, AttentionBatch2MaskIndex2) {
@@ -1293,5 +1343,122 @@ TEST(AttentionTest, AttentionPastState_dynamic) {
   test.Run();
 }
 
+// Loads a model with a unidirectional Attention node with a past input into session. If share_buffer is true, the
+// node has the past_present_share_buffer attribute and a past_sequence_length input.
+static void LoadAttentionWithPastModel(InferenceSession& session, int number_of_heads, bool share_buffer) {
+  onnxruntime::Model model("attention_with_past", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  ONNX_NAMESPACE::TypeProto int32_type;
+  int32_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_INT32);
+
+  std::vector<NodeArg*> inputs{&graph.GetOrCreateNodeArg("input", &float_type),
+                               &graph.GetOrCreateNodeArg("weight", &float_type),
+                               &graph.GetOrCreateNodeArg("bias", &float_type),
+                               &graph.GetOrCreateNodeArg("", nullptr),
+                               &graph.GetOrCreateNodeArg("past", &float_type)};
+  if (share_buffer) {
+    inputs.push_back(&graph.GetOrCreateNodeArg("past_sequence_length", &int32_type));
+  }
+  std::vector<NodeArg*> outputs{&graph.GetOrCreateNodeArg("output", &float_type),
+                                &graph.GetOrCreateNodeArg("present", &float_type)};
+
+  auto& node = graph.AddNode("attention", "Attention", "", inputs, outputs, nullptr, onnxruntime::kMSDomain);
+  node.AddAttribute("num_heads", static_cast<int64_t>(number_of_heads));
+  node.AddAttribute("unidirectional", static_cast<int64_t>(1));
+  if (share_buffer) {
+    node.AddAttribute("past_present_share_buffer", static_cast<int64_t>(1));
+  }
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+}
+
+// Decodes several tokens with past and present bound to the same OrtValue, feeding present back as past, and compares
+// each step to an Attention node given the past of the previous step in a buffer of its own.
+TEST(AttentionTest, AttentionPastPresentShareBufferSteps) {
+  const int batch_size = 2;
+  const int hidden_size = 8;
+  const int number_of_heads = 2;
+  const int head_size = hidden_size / number_of_heads;
+  const int initial_past_sequence_length = 2;
+  const int max_sequence_length = 6;
+  const int steps = max_sequence_length - initial_past_sequence_length;
+
+  RandomValueGenerator random{};
+  std::vector<int64_t> weight_dims{hidden_size, 3 * hidden_size};
+  std::vector<float> weight_data = random.Gaussian<float>(weight_dims, 0.0f, 0.3f);
+  std::vector<int64_t> bias_dims{3 * hidden_size};
+  std::vector<float> bias_data = random.Gaussian<float>(bias_dims, 0.0f, 0.3f);
+  std::vector<int64_t> past_dims{2, batch_size, number_of_heads, initial_past_sequence_length, head_size};
+  std::vector<float> past_data = random.Gaussian<float>(past_dims, 0.0f, 0.3f);
+
+  SessionOptions so;
+  so.session_logid = "AttentionTest.AttentionPastPresentShareBufferSteps";
+  InferenceSession shared_session{so, GetEnvironment()};
+  LoadAttentionWithPastModel(shared_session, number_of_heads, true);
+  InferenceSession reference_session{so, GetEnvironment()};
+  LoadAttentionWithPastModel(reference_session, number_of_heads, false);
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue weight, bias, buffer;
+  CreateMLValue<float>(allocator, weight_dims, weight_data, &weight);
+  CreateMLValue<float>(allocator, bias_dims, bias_data, &bias);
+  CreateMLValue<float>(allocator, {2, batch_size, number_of_heads, max_sequence_length, head_size},
+                       PadStateSequence(past_data, batch_size, number_of_heads, initial_past_sequence_length,
+                                        max_sequence_length, head_size),
+                       &buffer);
+  const float* buffer_data = buffer.Get<Tensor>().Data<float>();
+
+  for (int step = 0; step < steps; step++) {
+    const int past_sequence_length = initial_past_sequence_length + step;
+    std::vector<int64_t> input_dims{batch_size, 1, hidden_size};
+    OrtValue input, past_seq_len, past;
+    CreateMLValue<float>(allocator, input_dims, random.Gaussian<float>(input_dims, 0.0f, 0.3f), &input);
+    CreateMLValue<int32_t>(allocator, {1}, {past_sequence_length}, &past_seq_len);
+    CreateMLValue<float>(allocator, {2, batch_size, number_of_heads, past_sequence_length, head_size}, past_data,
+                         &past);
+
+    std::unique_ptr<IOBinding> io_binding;
+    ASSERT_STATUS_OK(shared_session.NewIOBinding(&io_binding));
+    ASSERT_STATUS_OK(io_binding->BindInput("input", input));
+    ASSERT_STATUS_OK(io_binding->BindInput("weight", weight));
+    ASSERT_STATUS_OK(io_binding->BindInput("bias", bias));
+    ASSERT_STATUS_OK(io_binding->BindInput("past", buffer));
+    ASSERT_STATUS_OK(io_binding->BindInput("past_sequence_length", past_seq_len));
+    ASSERT_STATUS_OK(io_binding->BindOutput("output", OrtDevice()));
+    ASSERT_STATUS_OK(io_binding->BindOutput("present", buffer));
+    ASSERT_STATUS_OK(shared_session.Run(RunOptions(), *io_binding));
+
+    NameMLValMap feeds{{"input", input}, {"weight", weight}, {"bias", bias}, {"past", past}};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(reference_session.Run(RunOptions(), feeds, {"output", "present"}, &fetches));
+
+    const auto& outputs = io_binding->GetOutputs();
+    ASSERT_EQ(outputs.size(), 2u);
+    ASSERT_EQ(outputs[1].Get<Tensor>().Data<float>(), buffer_data);
+
+    auto output = outputs[0].Get<Tensor>().DataAsSpan<float>();
+    auto expected_output = fetches[0].Get<Tensor>().DataAsSpan<float>();
+    ASSERT_EQ(output.size(), expected_output.size());
+    for (size_t i = 0; i < static_cast<size_t>(output.size()); i++) {
+      EXPECT_NEAR(output[i], expected_output[i], 1e-5f) << "step " << step << " output " << i;
+    }
+
+    auto expected_present = fetches[1].Get<Tensor>().DataAsSpan<float>();
+    past_data.assign(expected_present.begin(), expected_present.end());
+    std::vector<float> expected_buffer = PadStateSequence(past_data, batch_size, number_of_heads,
+                                                          past_sequence_length + 1, max_sequence_length, head_size);
+    for (size_t i = 0; i < expected_buffer.size(); i++) {
+      EXPECT_NEAR(buffer_data[i], expected_buffer[i], 1e-5f) << "step " << step << " present " << i;
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -2,9 +2,11 @@
 // Licensed under the MIT License.
 
 #include "core/framework/bfc_arena.h"
+#include "test/util/include/asserts.h"
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include <cstdlib>
+#include <thread>
 
 namespace onnxruntime {
 namespace test {
@@ -284,5 +286,181 @@ TEST(BFCArenaTest, TestReserve) {
   a.GetStats(&stats);
   EXPECT_EQ(stats.total_allocated_bytes, 1048576);
 }
+
+TEST(BFCArenaTest, ThreadCacheReuse) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK, 1 << 20);
+
+  void* first_ptr = a.Alloc(1000);
+  a.Free(first_ptr);
+
+  // the freed chunk is held by the thread cache and is still in use from the bins' point of view
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_cache_misses, 1);
+  EXPECT_EQ(stats.num_thread_cache_hits, 0);
+  EXPECT_EQ(stats.bytes_in_thread_cache, 1024);
+  EXPECT_EQ(stats.bytes_in_use, 1024);
+
+  // same size class from the same thread is served from the cache
+  void* second_ptr = a.Alloc(900);
+  EXPECT_EQ(first_ptr, second_ptr);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_cache_hits, 1);
+  EXPECT_EQ(stats.bytes_in_thread_cache, 0);
+  EXPECT_EQ(stats.num_allocs, 1);
+
+  // allocations larger than the cacheable size bypass the cache
+  void* large_ptr = a.Alloc(4 << 20);
+  a.Free(large_ptr);
+  a.Free(second_ptr);
+
+  a.FlushThreadCaches();
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_thread_cache, 0);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.num_thread_cache_flushes, 1);
+}
+
+TEST(BFCArenaTest, ThreadCacheReturnsToBinsWhenFull) {
+  // 16 shards so each shard may hold 4096 bytes
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK, 16 * 4096);
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 8; ++i) {
+    ptrs.push_back(a.Alloc(1024));
+  }
+
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_GT(stats.num_thread_cache_flushes, 0);
+  EXPECT_LE(stats.bytes_in_thread_cache, 4096);
+  EXPECT_EQ(stats.bytes_in_use, stats.bytes_in_thread_cache);
+}
+
+TEST(BFCArenaTest, ThreadCacheConcurrentAllocFree) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK, 1 << 20);
+
+  constexpr int kNumThreads = 8;
+  std::vector<std::thread> threads;
+  std::vector<std::vector<void*>> allocated(kNumThreads);
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&a, &allocated, t]() {
+      for (int iter = 0; iter < 100; ++iter) {
+        std::vector<void*> ptrs;
+        for (int s = 1; s <= 16; ++s) {
+          void* p = a.Alloc(s * 64);
+          memset(p, t, s * 64);
+          ptrs.push_back(p);
+        }
+        for (void* p : ptrs) {
+          a.Free(p);
+        }
+      }
+      // keep a few alive and hand them to another thread to free
+      for (int s = 1; s <= 4; ++s) {
+        allocated[t].push_back(a.Alloc(s * 128));
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads[t] = std::thread([&a, &allocated, t]() {
+      for (void* p : allocated[(t + 1) % kNumThreads]) {
+        a.Free(p);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  a.FlushThreadCaches();
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.bytes_in_thread_cache, 0);
+  EXPECT_GT(stats.num_thread_cache_hits, 0);
+}
+
+TEST(BFCArenaTest, Shrink) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested);
+
+  void* small_ptr = a.Alloc(1 << 10);
+  void* large_ptr = a.Alloc(64 << 20);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  const int64_t allocated_before_free = stats.total_allocated_bytes;
+
+  // the region backing the large allocation is still in use so nothing can be released
+  ASSERT_STATUS_OK(a.Shrink());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, allocated_before_free);
+  EXPECT_EQ(stats.num_arena_shrinkages, 0);
+
+  a.Free(large_ptr);
+  ASSERT_STATUS_OK(a.Shrink());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, allocated_before_free - (64 << 20));
+  EXPECT_EQ(stats.num_arena_shrinkages, 1);
+
+  // the arena is still usable after shrinking
+  large_ptr = a.Alloc(64 << 20);
+  EXPECT_NE(large_ptr, nullptr);
+  a.Free(large_ptr);
+  a.Free(small_ptr);
+
+  ASSERT_STATUS_OK(a.Shrink());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(BFCArenaTest, ShrinkReleasesThreadCache) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK, 1 << 20);
+
+  a.Free(a.Alloc(1 << 10));
+  ASSERT_STATUS_OK(a.Shrink());
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_thread_cache, 0);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+}
+
+TEST(BFCArenaTest, ReleaseIdleRegions) {
+  // keep up to 1MB of idle memory around
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_THREAD_CACHE_MAX_BYTES, 1 << 20);
+
+  // below the idle limit, so the region is kept
+  void* p = a.Alloc(1 << 19);
+  a.Free(p);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 1 << 19);
+  EXPECT_EQ(stats.num_arena_shrinkages, 0);
+
+  // burst that needs a new region, which is released as soon as it is no longer in use
+  void* burst = a.Alloc(32 << 20);
+  a.Free(burst);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 1 << 19);
+  EXPECT_EQ(stats.num_arena_shrinkages, 1);
+}
 }  // namespace test
 }  // namespace onnxruntime
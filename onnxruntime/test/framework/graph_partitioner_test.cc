@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/execution_providers.h"
+#include "core/framework/graph_partitioner.h"
+#include "core/framework/kernel_registry_manager.h"
+#include "core/graph/model.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "asserts.h"
+#include "gtest/gtest.h"
+#include "test/test_environment.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+static const std::string kIslandExecutionProvider = "IslandExecutionProvider";
+
+// Compiles the node named "relu_1" on its own, leaving an island between the nodes on the CPU execution provider.
+class IslandExecutionProvider : public IExecutionProvider {
+ public:
+  IslandExecutionProvider() : IExecutionProvider{kIslandExecutionProvider} {
+    InsertAllocator(std::make_shared<CPUAllocator>());
+  }
+
+  std::vector<std::unique_ptr<ComputeCapability>>
+  GetCapability(const GraphViewer& graph, const std::vector<const KernelRegistry*>& /*kernel_registries*/)
+      const override {
+    std::vector<std::unique_ptr<ComputeCapability>> result;
+    for (const auto& node : graph.Nodes()) {
+      if (node.Name() == "relu_1") {
+        auto sub_graph = onnxruntime::make_unique<IndexedSubGraph>();
+        sub_graph->nodes.push_back(node.Index());
+        auto meta_def = onnxruntime::make_unique<IndexedSubGraph::MetaDef>();
+        meta_def->name = "IslandRelu";
+        meta_def->domain = "IslandTest";
+        meta_def->inputs = {node.InputDefs()[0]->Name()};
+        meta_def->outputs = {node.OutputDefs()[0]->Name()};
+        meta_def->since_version = 1;
+        meta_def->status = ONNX_NAMESPACE::EXPERIMENTAL;
+        sub_graph->SetMetaDef(std::move(meta_def));
+        result.push_back(onnxruntime::make_unique<ComputeCapability>(std::move(sub_graph)));
+      }
+    }
+
+    return result;
+  }
+
+  Status Compile(const std::vector<Node*>& fused_nodes, std::vector<NodeComputeInfo>& node_compute_funcs) override {
+    for (size_t i = 0; i < fused_nodes.size(); ++i) {
+      NodeComputeInfo info;
+      info.create_state_func = [](ComputeContext*, FunctionState*) { return 0; };
+      info.compute_func = [](FunctionState, const OrtApi*, OrtKernelContext*) { return Status::OK(); };
+      info.release_state_func = [](FunctionState) {};
+      node_compute_funcs.push_back(std::move(info));
+    }
+
+    return Status::OK();
+  }
+};
+
+// Partitions the graph X -> relu_0 -> relu_1 -> relu_2 -> Y with 1000 elements per tensor and returns the number of
+// nodes assigned to the island execution provider.
+static void PartitionReluChain(const std::string& mode, double transfer_cost, int& num_island_nodes) {
+  Model model("graph_partitioner_test", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1000);
+
+  NodeArg* input = &graph.GetOrCreateNodeArg("X", &type);
+  for (int i = 0; i < 3; ++i) {
+    NodeArg* output = &graph.GetOrCreateNodeArg(i == 2 ? "Y" : "T" + std::to_string(i), &type);
+    graph.AddNode("relu_" + std::to_string(i), "Relu", "", {input}, {output});
+    input = output;
+  }
+
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  ExecutionProviders execution_providers;
+  ASSERT_STATUS_OK(execution_providers.Add(kIslandExecutionProvider,
+                                           onnxruntime::make_unique<IslandExecutionProvider>()));
+  ASSERT_STATUS_OK(execution_providers.Add(kCpuExecutionProvider, onnxruntime::make_unique<CPUExecutionProvider>(
+                                                                      CPUExecutionProviderInfo(false))));
+
+  KernelRegistryManager kernel_registry_manager;
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+
+  FuncManager func_mgr;
+  if (mode == "cost") {
+    CostBasedPartitioningOptions options;
+    options.transfer_cost = transfer_cost;
+    GraphPartitioner partitioner(kernel_registry_manager, execution_providers, options,
+                                 DefaultLoggingManager().DefaultLogger());
+    ASSERT_STATUS_OK(partitioner.Partition(graph, false, func_mgr));
+  } else {
+    GraphPartitioner partitioner(kernel_registry_manager, execution_providers);
+    ASSERT_STATUS_OK(partitioner.Partition(graph, false, func_mgr));
+  }
+
+  num_island_nodes = 0;
+  for (const auto& node : graph.Nodes()) {
+    ASSERT_FALSE(node.GetExecutionProviderType().empty()) << node.Name();
+    if (node.GetExecutionProviderType() == kIslandExecutionProvider) {
+      ++num_island_nodes;
+    }
+  }
+}
+
+TEST(GraphPartitionerTest, GreedyPartitioningKeepsIsland) {
+  int num_island_nodes = 0;
+  PartitionReluChain("greedy", 1., num_island_nodes);
+  EXPECT_EQ(num_island_nodes, 1);
+}
+
+TEST(GraphPartitionerTest, CostBasedPartitioningRemovesExpensiveIsland) {
+  // running relu_1 on the island saves 500 operations, but copying its input and output costs 2000
+  int num_island_nodes = 0;
+  PartitionReluChain("cost", 1., num_island_nodes);
+  EXPECT_EQ(num_island_nodes, 0);
+}
+
+TEST(GraphPartitionerTest, CostBasedPartitioningKeepsCheapIsland) {
+  int num_island_nodes = 0;
+  PartitionReluChain("cost", 0.1, num_island_nodes);
+  EXPECT_EQ(num_island_nodes, 1);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <cfloat>
 #include <functional>
+#include <future>
 #include <iterator>
 #include <thread>
 #include <fstream>
@@ -27,12 +28,14 @@
 #include "core/graph/op.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/platform/env.h"
+#include "core/platform/path_lib.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
 #ifdef USE_CUDA
 #include "core/providers/cuda/gpu_data_transfer.h"
 #endif
 #include "core/session/environment.h"
+#include "core/session/optimized_model_cache.h"
 #include "core/session/IOBinding.h"
 #include "core/session/device_allocator.h"
 #include "core/session/allocator_impl.h"
@@ -44,6 +47,7 @@
 #include "test/optimizer/dummy_graph_transformer.h"
 #include "test/util/include/default_providers.h"
 #include "test/util/include/inference_session_wrapper.h"
+#include "test/util/include/temp_dir.h"
 
 #include "gtest/gtest.h"
 
@@ -391,6 +395,45 @@ TEST(InferenceSessionTests, DisableCPUArena) {
   RunModel(session_object, run_options);
 }
 
+TEST(InferenceSessionTests, NodeMetrics) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.NodeMetrics";
+
+  {
+    InferenceSession session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+    ASSERT_STATUS_OK(session_object.Initialize());
+
+    std::vector<NodeMetrics::Entry> entries;
+    ASSERT_FALSE(session_object.GetNodeMetrics(entries).IsOK());
+  }
+
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigEnableNodeMetrics, "1"));
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options);
+
+  std::vector<NodeMetrics::Entry> entries;
+  ASSERT_STATUS_OK(session_object.GetNodeMetrics(entries));
+  ASSERT_EQ(entries.size(), 1u);
+  const auto& entry = entries[0];
+  EXPECT_EQ(entry.op_type, "Mul");
+  EXPECT_EQ(entry.call_count, 2u);
+  EXPECT_LE(entry.min_time_ns, entry.max_time_ns);
+  EXPECT_LE(entry.max_time_ns, entry.total_time_ns);
+  // two runs with a 3x2 float output
+  EXPECT_EQ(entry.output_bytes, 2 * 6 * sizeof(float));
+
+  const auto text = NodeMetrics::ToPrometheusText(entries);
+  EXPECT_NE(text.find("# TYPE onnxruntime_node_calls_total counter\n"), std::string::npos) << text;
+  EXPECT_NE(text.find("onnxruntime_op_calls_total{op_type=\"Mul\"} 2\n"), std::string::npos) << text;
+  EXPECT_NE(text.find("onnxruntime_op_output_bytes_total{op_type=\"Mul\"} 48\n"), std::string::npos) << text;
+}
+
 TEST(InferenceSessionTests, TestModelSerialization) {
   // Load model with level 0 transform level
   // and assert that the model has Identity nodes.
@@ -453,6 +496,105 @@ TEST(InferenceSessionTests, TestModelSerialization) {
   ASSERT_TRUE(session_object_emptyValidation.Initialize().IsOK());
 }
 
+#if defined(ENABLE_ORT_FORMAT_LOAD)
+TEST(InferenceSessionTests, OptimizedModelCache) {
+  const string test_model = "testdata/transform/abs-id-max.onnx";
+  TemporaryDirectory cache_dir{ORT_TSTR("optimized_model_cache_test")};
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.OptimizedModelCache";
+  so.graph_optimization_level = TransformerLevel::Level1;
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigOptimizedModelCacheDir,
+                                     ToMBString(cache_dir.Path()).c_str()));
+
+  // the first session optimizes the model and saves it to the cache
+  InferenceSessionWrapper session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(test_model));
+  ASSERT_STATUS_OK(session_object.Initialize());
+  ASSERT_EQ(CountOpsInGraph(session_object.GetGraph())["Identity"], 0);
+
+  std::vector<PathString> cache_files;
+  LoopDir(cache_dir.Path(), [&cache_files](const ORTCHAR_T* filename, OrtFileType f_type) -> bool {
+    if (f_type == OrtFileType::TYPE_REG) {
+      cache_files.push_back(filename);
+    }
+    return true;
+  });
+  ASSERT_EQ(cache_files.size(), size_t{1});
+  const auto cache_file = ConcatPathComponent<ORTCHAR_T>(cache_dir.Path(), cache_files[0]);
+
+  // replace the cached model with an unoptimized one, so that the next session can only have Identity nodes if it
+  // loaded the cached model instead of optimizing the model again
+  SessionOptions so_noopt;
+  so_noopt.session_logid = "InferenceSessionTests.OptimizedModelCache";
+  so_noopt.graph_optimization_level = TransformerLevel::Default;
+  so_noopt.optimized_model_filepath = cache_file;
+  InferenceSession session_object_noopt{so_noopt, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object_noopt.Load(test_model));
+  ASSERT_STATUS_OK(session_object_noopt.Initialize());
+
+  InferenceSessionWrapper cached_session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(cached_session_object.Load(test_model));
+  ASSERT_STATUS_OK(cached_session_object.Initialize());
+  ASSERT_GT(CountOpsInGraph(cached_session_object.GetGraph())["Identity"], 0);
+
+  // a different configuration doesn't use the cached model
+  so.graph_optimization_level = TransformerLevel::Level2;
+  InferenceSessionWrapper level2_session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(level2_session_object.Load(test_model));
+  ASSERT_STATUS_OK(level2_session_object.Initialize());
+  ASSERT_EQ(CountOpsInGraph(level2_session_object.GetGraph())["Identity"], 0);
+}
+
+// sessions of a process initialized at the same time with the same model populate the cache with separate temporary
+// files, so each of them saves a complete model and the cache ends up with one model and no temporary files
+TEST(InferenceSessionTests, OptimizedModelCacheConcurrentSessions) {
+  const string test_model = "testdata/transform/abs-id-max.onnx";
+  TemporaryDirectory cache_dir{ORT_TSTR("optimized_model_cache_concurrent_test")};
+
+  const PathString cache_file_path = ConcatPathComponent<ORTCHAR_T>(cache_dir.Path(), ORT_TSTR("model.ort"));
+  ASSERT_NE(optimized_model_cache::GetTempCacheFilePath(cache_file_path),
+            optimized_model_cache::GetTempCacheFilePath(cache_file_path));
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.OptimizedModelCacheConcurrentSessions";
+  so.graph_optimization_level = TransformerLevel::Level1;
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigOptimizedModelCacheDir,
+                                     ToMBString(cache_dir.Path()).c_str()));
+
+  constexpr int num_sessions = 8;
+  std::vector<std::future<Status>> results;
+  for (int i = 0; i < num_sessions; ++i) {
+    results.push_back(std::async(std::launch::async, [&so, &test_model]() {
+      InferenceSessionWrapper session_object{so, GetEnvironment()};
+      ORT_RETURN_IF_ERROR(session_object.Load(test_model));
+      ORT_RETURN_IF_ERROR(session_object.Initialize());
+      ORT_RETURN_IF_NOT(CountOpsInGraph(session_object.GetGraph())["Identity"] == 0, "Model wasn't optimized.");
+      return Status::OK();
+    }));
+  }
+  for (auto& result : results) {
+    ASSERT_STATUS_OK(result.get());
+  }
+
+  std::vector<PathString> cache_files;
+  LoopDir(cache_dir.Path(), [&cache_files](const ORTCHAR_T* filename, OrtFileType f_type) -> bool {
+    if (f_type == OrtFileType::TYPE_REG) {
+      cache_files.push_back(filename);
+    }
+    return true;
+  });
+  ASSERT_EQ(cache_files.size(), size_t{1});
+  ASSERT_EQ(cache_files[0].find(ORT_TSTR(".tmp.")), PathString::npos);
+
+  // the model in the cache is complete
+  InferenceSessionWrapper cached_session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(cached_session_object.Load(test_model));
+  ASSERT_STATUS_OK(cached_session_object.Initialize());
+  ASSERT_EQ(CountOpsInGraph(cached_session_object.GetGraph())["Identity"], 0);
+}
+#endif  // defined(ENABLE_ORT_FORMAT_LOAD)
+
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
 static bool Compare(const InputDefList& f_arg, const InputDefList& s_arg) {
   if (f_arg.size() != s_arg.size()) {
@@ -619,6 +761,103 @@ TEST(InferenceSessionTests, CheckRunProfilerWithSessionOptions) {
   }
 }
 
+// Runs MODEL_URI num_runs times, starting profiling with the RunOptions of the first run, and counts the events in the
+// profile file and how many of them are events of the Run calls.
+static void RunWithSampledProfiling(SessionOptions& so, int num_runs, int& num_events, int& num_run_events) {
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+  ASSERT_FALSE(session_object.GetProfiling().IsEnabled());
+
+  for (int i = 0; i < num_runs; ++i) {
+    RunOptions run_options;
+    run_options.start_profiling = i == 0;
+    RunModel(session_object, run_options);
+    ASSERT_TRUE(session_object.GetProfiling().IsEnabled());
+  }
+
+  std::ifstream profile(session_object.EndProfiling());
+  ASSERT_TRUE(profile);
+
+  num_events = 0;
+  num_run_events = 0;
+  std::string line;
+  while (std::getline(profile, line)) {
+    if (line.find("\"name\" :") != std::string::npos) {
+      ++num_events;
+    }
+
+    if (line.find("model_run") != std::string::npos) {
+      ++num_run_events;
+    }
+  }
+}
+
+TEST(InferenceSessionTests, CheckRunProfilerWithSampling) {
+  SessionOptions so;
+  so.session_logid = "CheckRunProfilerWithSampling";
+  so.profile_file_prefix = ORT_TSTR("onnxruntime_sampled_profile_test");
+
+  int num_events = 0;
+  int num_run_events = 0;
+  RunWithSampledProfiling(so, 4, num_events, num_run_events);
+  ASSERT_EQ(num_run_events, 4);
+
+  // one in two runs
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigProfilingSamplingRate, "2"));
+  RunWithSampledProfiling(so, 4, num_events, num_run_events);
+  ASSERT_EQ(num_run_events, 2);
+}
+
+TEST(InferenceSessionTests, CheckRunProfilerWithLatencyThreshold) {
+  SessionOptions so;
+  so.session_logid = "CheckRunProfilerWithLatencyThreshold";
+  so.profile_file_prefix = ORT_TSTR("onnxruntime_latency_profile_test");
+
+  // no run takes an hour
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigProfilingLatencyThresholdUs, "3600000000"));
+  int num_events = 0;
+  int num_run_events = 0;
+  RunWithSampledProfiling(so, 2, num_events, num_run_events);
+  ASSERT_EQ(num_events, 0);
+}
+
+TEST(InferenceSessionTests, CheckRunProfilerWithRingBuffer) {
+  SessionOptions so;
+  so.session_logid = "CheckRunProfilerWithRingBuffer";
+  so.profile_file_prefix = ORT_TSTR("onnxruntime_ring_buffer_profile_test");
+
+  // the events of the last run are kept, its model_run event being the most recent one
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigProfilingMaxEvents, "3"));
+  int num_events = 0;
+  int num_run_events = 0;
+  RunWithSampledProfiling(so, 3, num_events, num_run_events);
+  ASSERT_EQ(num_events, 3);
+  ASSERT_EQ(num_run_events, 1);
+}
+
+TEST(InferenceSessionTests, CheckRunProfilerEndWithRunOptions) {
+  SessionOptions so;
+  so.session_logid = "CheckRunProfilerEndWithRunOptions";
+  so.profile_file_prefix = ORT_TSTR("onnxruntime_run_options_profile_test");
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  run_options.start_profiling = true;
+  run_options.end_profiling = true;
+  RunModel(session_object, run_options);
+  ASSERT_FALSE(session_object.GetProfiling().IsEnabled());
+
+  // profiling can be started again
+  run_options.end_profiling = false;
+  RunModel(session_object, run_options);
+  ASSERT_TRUE(session_object.GetProfiling().IsEnabled());
+  ASSERT_FALSE(session_object.EndProfiling().empty());
+}
+
 TEST(InferenceSessionTests, CheckRunProfilerWithStartProfile) {
   SessionOptions so;
 
@@ -707,6 +946,70 @@ TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   thread2.join();
 }
 
+TEST(InferenceSessionTests, RunAsync) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.RunAsync";
+  so.intra_op_param.thread_pool_size = 2;
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                       &ml_value);
+
+  std::vector<int64_t> expected_dims_mul_y = {3, 2};
+  std::vector<float> expected_values_mul_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+#ifndef _OPENMP
+  // run on the session's thread pool. there is none in an OpenMP build.
+  constexpr int num_runs = 8;
+  std::vector<std::promise<std::vector<OrtValue>>> results(num_runs);
+  for (auto& result : results) {
+    ASSERT_STATUS_OK(session_object.RunAsync(nullptr, {"X"}, {ml_value}, {"Y"},
+                                             [&result](const Status& status, std::vector<OrtValue>& fetches) {
+                                               EXPECT_STATUS_OK(status);
+                                               result.set_value(fetches);
+                                             }));
+  }
+
+  for (auto& result : results) {
+    VerifyOutputs(result.get_future().get(), expected_dims_mul_y, expected_values_mul_y);
+  }
+#endif
+
+  // run on a caller supplied executor. errors are reported through the callback.
+  std::vector<std::thread> threads;
+  auto executor = [&threads](std::function<void()> fn) { threads.emplace_back(std::move(fn)); };
+  std::promise<Status> error;
+  ASSERT_STATUS_OK(session_object.RunAsync(nullptr, {"X"}, {ml_value}, {"Z"},
+                                           [&error](const Status& status, std::vector<OrtValue>& fetches) {
+                                             EXPECT_TRUE(fetches.empty());
+                                             error.set_value(status);
+                                           },
+                                           executor));
+  ASSERT_EQ(threads.size(), 1u);
+  EXPECT_FALSE(error.get_future().get().IsOK());
+  threads.front().join();
+}
+
+TEST(InferenceSessionTests, RunAsyncRequiresThreadPool) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.RunAsyncRequiresThreadPool";
+  so.intra_op_param.thread_pool_size = 1;
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto status = session_object.RunAsync(nullptr, {}, {}, {"Y"},
+                                        [](const Status&, std::vector<OrtValue>&) { FAIL(); });
+  EXPECT_FALSE(status.IsOK());
+}
+
 TEST(InferenceSessionTests, PreAllocateOutputVector) {
   SessionOptions so;
 
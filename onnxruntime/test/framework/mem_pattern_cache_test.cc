@@ -0,0 +1,123 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+#include "test/util/include/asserts.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+static std::unique_ptr<MemoryPatternGroup> MakePatterns() {
+  return onnxruntime::make_unique<MemoryPatternGroup>();
+}
+
+TEST(MemoryPatternCacheTest, ExactShapes) {
+  MemoryPatternCache cache;
+  TensorShape shape_a({1, 128});
+  TensorShape shape_b({128, 1});
+  std::unordered_map<int, TensorShape> inferred_shapes;
+
+  EXPECT_EQ(cache.Find({std::cref(shape_a)}, inferred_shapes), nullptr);
+
+  auto patterns = MakePatterns();
+  const auto* expected = patterns.get();
+  cache.Insert({std::cref(shape_a)}, std::move(patterns));
+  EXPECT_EQ(cache.Find({std::cref(shape_a)}, inferred_shapes).get(), expected);
+
+  // dims that XOR to the same value must not collide
+  EXPECT_EQ(cache.Find({std::cref(shape_b)}, inferred_shapes), nullptr);
+
+  // same dims split differently across inputs must not collide
+  TensorShape shape_c({1});
+  TensorShape shape_d({128});
+  EXPECT_EQ(cache.Find({std::cref(shape_c), std::cref(shape_d)}, inferred_shapes), nullptr);
+
+  // without buckets smaller shapes don't match either
+  TensorShape smaller({1, 100});
+  EXPECT_EQ(cache.Find({std::cref(smaller)}, inferred_shapes), nullptr);
+}
+
+TEST(MemoryPatternCacheTest, LruEviction) {
+  MemoryPatternCache cache;
+  cache.SetCapacity(2);
+  TensorShape shape_1({1, 1});
+  TensorShape shape_2({1, 2});
+  TensorShape shape_3({1, 3});
+  std::unordered_map<int, TensorShape> inferred_shapes;
+
+  cache.Insert({std::cref(shape_1)}, MakePatterns());
+  cache.Insert({std::cref(shape_2)}, MakePatterns());
+
+  // touch shape_1 so shape_2 becomes the least recently used entry
+  auto held = cache.Find({std::cref(shape_1)}, inferred_shapes);
+  ASSERT_NE(held, nullptr);
+  auto evicted = cache.Find({std::cref(shape_2)}, inferred_shapes);
+  ASSERT_NE(evicted, nullptr);
+  ASSERT_NE(cache.Find({std::cref(shape_1)}, inferred_shapes), nullptr);
+
+  cache.Insert({std::cref(shape_3)}, MakePatterns());
+  EXPECT_EQ(cache.Size(), 2u);
+  EXPECT_NE(cache.Find({std::cref(shape_1)}, inferred_shapes), nullptr);
+  EXPECT_EQ(cache.Find({std::cref(shape_2)}, inferred_shapes), nullptr);
+  EXPECT_NE(cache.Find({std::cref(shape_3)}, inferred_shapes), nullptr);
+
+  // patterns handed out before eviction stay valid
+  EXPECT_TRUE(evicted->locations.empty());
+}
+
+TEST(MemoryPatternCacheTest, DimBuckets) {
+  MemoryPatternCache cache;
+  std::vector<int64_t> buckets;
+  ASSERT_STATUS_OK(MemoryPatternCache::ParseDimBuckets("64,128,256", buckets));
+  cache.SetDimBuckets(buckets);
+  std::unordered_map<int, TensorShape> inferred_shapes;
+
+  TensorShape traced({1, 100});
+  auto patterns = MakePatterns();
+  const auto* first = patterns.get();
+  cache.Insert({std::cref(traced)}, std::move(patterns));
+
+  // smaller shape in the same bucket reuses the patterns
+  TensorShape smaller({1, 65});
+  EXPECT_EQ(cache.Find({std::cref(smaller)}, inferred_shapes).get(), first);
+
+  // larger shape in the same bucket misses until patterns for it are added
+  TensorShape larger({1, 128});
+  EXPECT_EQ(cache.Find({std::cref(larger)}, inferred_shapes), nullptr);
+  patterns = MakePatterns();
+  const auto* second = patterns.get();
+  cache.Insert({std::cref(larger)}, std::move(patterns));
+  EXPECT_EQ(cache.Find({std::cref(larger)}, inferred_shapes).get(), second);
+  EXPECT_EQ(cache.Find({std::cref(traced)}, inferred_shapes).get(), second);
+  EXPECT_EQ(cache.Size(), 1u);
+
+  // patterns for a smaller shape don't replace the ones that cover it
+  cache.Insert({std::cref(smaller)}, MakePatterns());
+  EXPECT_EQ(cache.Find({std::cref(larger)}, inferred_shapes).get(), second);
+
+  // other buckets and dims beyond the last bucket are separate entries
+  TensorShape other_bucket({1, 200});
+  EXPECT_EQ(cache.Find({std::cref(other_bucket)}, inferred_shapes), nullptr);
+  TensorShape beyond({1, 300});
+  cache.Insert({std::cref(beyond)}, MakePatterns());
+  TensorShape beyond_smaller({1, 299});
+  EXPECT_EQ(cache.Find({std::cref(beyond_smaller)}, inferred_shapes), nullptr);
+}
+
+TEST(MemoryPatternCacheTest, ParseDimBuckets) {
+  std::vector<int64_t> buckets;
+  ASSERT_STATUS_OK(MemoryPatternCache::ParseDimBuckets("", buckets));
+  EXPECT_TRUE(buckets.empty());
+
+  ASSERT_STATUS_OK(MemoryPatternCache::ParseDimBuckets("8,16,32", buckets));
+  EXPECT_EQ(buckets, (std::vector<int64_t>{8, 16, 32}));
+
+  EXPECT_FALSE(MemoryPatternCache::ParseDimBuckets("16,8", buckets).IsOK());
+  EXPECT_FALSE(MemoryPatternCache::ParseDimBuckets("8,8", buckets).IsOK());
+  EXPECT_FALSE(MemoryPatternCache::ParseDimBuckets("0,8", buckets).IsOK());
+  EXPECT_FALSE(MemoryPatternCache::ParseDimBuckets("8,abc", buckets).IsOK());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -190,7 +190,8 @@ static void CompareGraphAndSessionState(const InferenceSessionWrapper& session_o
   }
 }
 
-static void SaveAndCompareModels(const std::string& onnx_file, const std::basic_string<ORTCHAR_T>& ort_file) {
+static void SaveAndCompareModels(const std::string& onnx_file, const std::basic_string<ORTCHAR_T>& ort_file,
+                                 bool use_mapped_ort_model = false) {
   SessionOptions so;
   so.session_logid = "SerializeToOrtFormat";
   so.optimized_model_filepath = ort_file;
@@ -207,6 +208,9 @@ static void SaveAndCompareModels(const std::string& onnx_file, const std::basic_
   // not strictly necessary - type should be inferred from the filename, but to be sure we're testing what we
   // think we're testing set it.
   so2.AddConfigEntry(kOrtSessionOptionsConfigLoadModelFormat, "ORT");
+  if (use_mapped_ort_model) {
+    so2.AddConfigEntry(kOrtSessionOptionsConfigUseMappedOrtModel, "1");
+  }
 
   // load serialized version
   InferenceSessionWrapper session_object2{so2, GetEnvironment()};
@@ -264,6 +268,32 @@ TEST(OrtModelOnlyTests, SerializeToOrtFormat) {
   RunOrtModel(test_info);
 }
 
+// initializers of a model saved by this version use the memory mapped model bytes in place
+TEST(OrtModelOnlyTests, LoadMappedOrtFormatModel) {
+  const std::basic_string<ORTCHAR_T> ort_file = ORT_TSTR("ort_github_issue_4031.mapped.onnx.ort");
+  SaveAndCompareModels("testdata/ort_github_issue_4031.onnx", ort_file, true);
+
+  OrtModelTestInfo test_info;
+  test_info.model_filename = ort_file;
+  test_info.logid = "LoadMappedOrtFormatModel";
+  test_info.configs.push_back(std::make_pair(kOrtSessionOptionsConfigLoadModelFormat, "ORT"));
+  test_info.configs.push_back(std::make_pair(kOrtSessionOptionsConfigUseMappedOrtModel, "1"));
+
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1}, {123.f},
+                       &ml_value);
+  test_info.inputs.insert(std::make_pair("state_var_in", ml_value));
+
+  test_info.output_names = {"state_var_out"};
+  test_info.output_verifier = [](const std::vector<OrtValue>& fetches) {
+    const auto& output = fetches[0].Get<Tensor>();
+    ASSERT_TRUE(output.Shape().Size() == 1);
+    ASSERT_TRUE(output.Data<float>()[0] == 125.f);
+  };
+
+  RunOrtModel(test_info);
+}
+
 #if !defined(DISABLE_ML_OPS)
 TEST(OrtModelOnlyTests, SerializeToOrtFormatMLOps) {
   const std::basic_string<ORTCHAR_T> ort_file = ORT_TSTR("sklearn_bin_voting_classifier_soft_converted.ort");
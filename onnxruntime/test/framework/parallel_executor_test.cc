@@ -1,10 +1,20 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/framework/customregistry.h"
 #include "core/framework/data_types.h"
+#include "core/framework/node_cost_model.h"
 #include "core/framework/op_kernel.h"
+#include "core/graph/model.h"
+#include "test/test_environment.h"
 #include "test/providers/provider_test_utils.h"
 #include "test_utils.h"
+#include "asserts.h"
 #include "core/session/inference_session.h"
 
 #include "gtest/gtest.h"
@@ -145,5 +155,152 @@ TEST_P(ParallelExecutorThreadPoolTest, TestNullInterOpThreadPool) {
 
 INSTANTIATE_TEST_SUITE_P(ParallelExecutorThreadPoolTests, ParallelExecutorThreadPoolTest,
                         testing::Values(1, 0));
+
+// X -> MatMul -> MatMul -> Add -> Y
+//   -> Relu ------------/
+TEST(ParallelExecutor, NodeCostModelPrioritizesCriticalPath) {
+  onnxruntime::Model model("critical_path", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(256);
+  TypeProto w_type;
+  w_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  w_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(256);
+  w_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(256);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& w = graph.GetOrCreateNodeArg("W", &w_type);
+  auto& a = graph.GetOrCreateNodeArg("A", &x_type);
+  auto& b = graph.GetOrCreateNodeArg("B", &x_type);
+  auto& c = graph.GetOrCreateNodeArg("C", &x_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &x_type);
+  auto& matmul_1 = graph.AddNode("matmul_1", "MatMul", "", {&x, &w}, {&a});
+  auto& matmul_2 = graph.AddNode("matmul_2", "MatMul", "", {&a, &w}, {&b});
+  auto& relu = graph.AddNode("relu", "Relu", "", {&x}, {&c});
+  auto& add = graph.AddNode("add", "Add", "", {&b, &c}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  EXPECT_EQ(NodeCostModel::EstimateNodeCost(matmul_1), 4. * 256 * 256);
+  EXPECT_EQ(NodeCostModel::EstimateNodeCost(relu), 4. * 256);
+  EXPECT_EQ(NodeCostModel::EstimateNodeCost(add), 2. * 4 * 256);
+
+  GraphViewer graph_viewer(graph);
+  NodeCostModel cost_model(graph_viewer);
+  auto priorities = cost_model.GetPriorities();
+  EXPECT_EQ((*priorities)[add.Index()], 2. * 4 * 256);
+  EXPECT_EQ((*priorities)[matmul_2.Index()], 4. * 256 * 256 + 2. * 4 * 256);
+  EXPECT_EQ((*priorities)[matmul_1.Index()], 2. * 4 * 256 * 256 + 2. * 4 * 256);
+  EXPECT_GT((*priorities)[matmul_1.Index()], (*priorities)[relu.Index()]);
+
+  // measured kernel times replace the estimates
+  std::vector<double> kernel_times(graph_viewer.MaxNodeIndex(), -1.);
+  kernel_times[matmul_1.Index()] = 1.;
+  kernel_times[matmul_2.Index()] = 1.;
+  kernel_times[relu.Index()] = 100.;
+  kernel_times[add.Index()] = 1.;
+  cost_model.UpdateMeasuredCosts(kernel_times);
+
+  // previously returned priorities are unchanged
+  EXPECT_GT((*priorities)[matmul_1.Index()], (*priorities)[relu.Index()]);
+  priorities = cost_model.GetPriorities();
+  EXPECT_EQ((*priorities)[matmul_1.Index()], 3.);
+  EXPECT_EQ((*priorities)[relu.Index()], 101.);
+
+  // unmeasured nodes are scaled to the measured time per estimated operation
+  kernel_times.assign(kernel_times.size(), -1.);
+  NodeCostModel partially_measured(graph_viewer);
+  kernel_times[add.Index()] = 4.;
+  partially_measured.UpdateMeasuredCosts(kernel_times);
+  priorities = partially_measured.GetPriorities();
+  EXPECT_DOUBLE_EQ((*priorities)[relu.Index()], 2. + 4.);
+}
+
+// Relu kernel recording the order the nodes run in
+class RecordingReluKernel final : public OpKernel {
+ public:
+  RecordingReluKernel(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* context) const override {
+    const auto* X = context->Input<Tensor>(0);
+    auto* Y = context->Output(0, X->Shape());
+    const float* x_data = X->Data<float>();
+    float* y_data = Y->MutableData<float>();
+    for (int64_t i = 0, size = X->Shape().Size(); i < size; ++i) {
+      y_data[i] = std::max(x_data[i], 0.f);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    order.push_back(Node().Name());
+    return Status::OK();
+  }
+
+  static std::mutex mutex;
+  static std::vector<std::string> order;
+};
+
+std::mutex RecordingReluKernel::mutex;
+std::vector<std::string> RecordingReluKernel::order;
+
+// X -> long_1 -> long_2 -> long_3 -> L
+//   -> short_1 -------------------> S
+// With a single inter-op thread the nodes run one at a time, and the root on the longest path runs first.
+TEST(ParallelExecutor, RunsCriticalPathFirst) {
+  onnxruntime::Model model("critical_path_order", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(8);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& long_1_out = graph.GetOrCreateNodeArg("long_1_out", &x_type);
+  auto& long_2_out = graph.GetOrCreateNodeArg("long_2_out", &x_type);
+  auto& l = graph.GetOrCreateNodeArg("L", &x_type);
+  auto& s = graph.GetOrCreateNodeArg("S", &x_type);
+  graph.AddNode("long_1", "Relu", "", {&x}, {&long_1_out});
+  graph.AddNode("long_2", "Relu", "", {&long_1_out}, {&long_2_out});
+  graph.AddNode("long_3", "Relu", "", {&long_2_out}, {&l});
+  graph.AddNode("short_1", "Relu", "", {&x}, {&s});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+
+  auto registry = std::make_shared<CustomRegistry>();
+  KernelDefBuilder kernel_def;
+  kernel_def.SetName("Relu")
+      .SetDomain(kOnnxDomain)
+      .SinceVersion(1)
+      .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+      .Provider(kCpuExecutionProvider);
+  ASSERT_STATUS_OK(registry->RegisterCustomKernel(
+      kernel_def, [](const OpKernelInfo& info) -> OpKernel* { return new RecordingReluKernel(info); }));
+
+  SessionOptions so;
+  so.session_logid = "ParallelExecutor.RunsCriticalPathFirst";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.graph_optimization_level = TransformerLevel::Default;
+  // the caller thread only schedules the nodes, so a pool of size 2 runs them on a single thread
+  so.inter_op_param.thread_pool_size = 2;
+  InferenceSession session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.RegisterCustomRegistry(registry));
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  OrtValue x_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 8},
+                       std::vector<float>(16, 1.f), &x_value);
+  NameMLValMap feeds{{"X", x_value}};
+  std::vector<OrtValue> fetches;
+  RecordingReluKernel::order.clear();
+  ASSERT_STATUS_OK(session.Run(RunOptions(), feeds, {"L", "S"}, &fetches));
+
+  const std::vector<std::string> expected_order{"long_1", "long_2", "long_3", "short_1"};
+  EXPECT_EQ(RecordingReluKernel::order, expected_order);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -181,9 +181,13 @@ class PrePackingTestOpKernel : public OpKernel {
     return Status::OK();
   }
 
-  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override {
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override {
     ORT_UNUSED_PARAMETER(tensor);
     ORT_UNUSED_PARAMETER(input_idx);
+    ORT_UNUSED_PARAMETER(alloc);
+    ORT_UNUSED_PARAMETER(prepacked_weights);
     is_packed = true;
     return Status::OK();
   }
@@ -271,5 +275,230 @@ TEST_P(SessionStatePrepackingTest, PrePackingTest) {
 
 INSTANTIATE_TEST_SUITE_P(SessionStateTests, SessionStatePrepackingTest, testing::Values(true, false));
 
+// Only packs input 1.
+class InputOnePrePackingTestOpKernel : public PrePackingTestOpKernel {
+ public:
+  InputOnePrePackingTestOpKernel(const OpKernelInfo& info) : PrePackingTestOpKernel(info) {}
+
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override {
+    ORT_RETURN_IF_ERROR(PrePackingTestOpKernel::PrePack(tensor, input_idx, alloc, is_packed, prepacked_weights));
+    is_packed = input_idx == 1;
+    return Status::OK();
+  }
+};
+
+// Kernels are pre-packed in parallel. An initializer shared by several nodes must only be released once all of them
+// packed it.
+TEST(SessionStateTest, ParallelPrePackingTest) {
+  OrtThreadPoolParams to;
+  to.thread_pool_size = 4;
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
+  ONNX_OPERATOR_SCHEMA(ParallelPrePackingTest)
+      .SetDoc("Faking Node for PrePacking")
+      .Input(0, "Input_0", "input 0", "tensor(float)")
+      .Input(1, "Input_1", "input 1", "tensor(float)")
+      .Output(0, "output_0", "docstr for output_0.", "tensor(float)");
+
+  onnxruntime::Model model("graph_1", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  ONNX_NAMESPACE::TensorProto tensor;
+  tensor.add_dims(1);
+  tensor.add_float_data(1.0f);
+  tensor.set_data_type(TensorProto_DataType_FLOAT);
+  tensor.set_name("shared_weight");
+  graph.AddInitializedTensor(tensor);
+
+  // the nodes packing shared_weight, and a node consuming it as an input that isn't packed
+  constexpr int num_nodes = 16;
+  auto& shared_weight_arg = graph.GetOrCreateNodeArg("shared_weight", &type);
+  for (int i = 0; i < num_nodes; ++i) {
+    auto& input_arg = graph.GetOrCreateNodeArg("input_" + std::to_string(i), &type);
+    auto& output_arg = graph.GetOrCreateNodeArg("output_" + std::to_string(i), &type);
+    auto& node = graph.AddNode("node_" + std::to_string(i), "ParallelPrePackingTest", "node",
+                               {&input_arg, &shared_weight_arg}, {&output_arg});
+    node.SetExecutionProviderType(kCpuExecutionProvider);
+  }
+
+  auto& unpacked_output_arg = graph.GetOrCreateNodeArg("unpacked_output", &type);
+  auto& unpacked_node = graph.AddNode("unpacked_node", "ParallelPrePackingTest", "node",
+                                      {&shared_weight_arg, &graph.GetOrCreateNodeArg("input_0", &type)},
+                                      {&unpacked_output_arg});
+  unpacked_node.SetExecutionProviderType(kCpuExecutionProvider);
+
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  ExecutionProviders execution_providers;
+  auto cpu_execution_provider = onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo(false));
+  execution_providers.Add(kCpuExecutionProvider, std::move(cpu_execution_provider));
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+  SessionState session_state(graph, execution_providers, true, tp.get(), nullptr, dtm,
+                             DefaultLoggingManager().DefaultLogger(), profiler);
+
+  KernelRegistryManager kernel_registry_manager;
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+  std::shared_ptr<KernelRegistry> kernel_registry = std::make_shared<KernelRegistry>();
+  auto kernel_def = KernelDefBuilder().SetName("ParallelPrePackingTest").Provider(kCpuExecutionProvider).SinceVersion(1).Build();
+  ASSERT_STATUS_OK(kernel_registry->Register(
+      KernelCreateInfo(std::move(kernel_def),
+                       [](const OpKernelInfo& info) -> OpKernel* { return new InputOnePrePackingTestOpKernel(info); })));
+  kernel_registry_manager.RegisterKernelRegistry(kernel_registry);
+
+  SessionOptions sess_options;
+  ASSERT_STATUS_OK(session_state.FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                      kernel_registry_manager,
+                                                      sess_options));
+
+  // unpacked_node still needs the initializer
+  ASSERT_EQ(session_state.GetConstantInitializedTensors().size(), size_t(1));
+}
+
+// Copies the initializer into a packed buffer that can be shared across kernel instances.
+class SharedPrePackingTestOpKernel : public OpKernel {
+ public:
+  SharedPrePackingTestOpKernel(const OpKernelInfo& info) : OpKernel(info) {}
+  Status Compute(OpKernelContext* context) const override {
+    ORT_UNUSED_PARAMETER(context);
+    return Status::OK();
+  }
+
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override {
+    ORT_UNUSED_PARAMETER(input_idx);
+    ++prepack_calls;
+    auto* data = alloc->Alloc(tensor.SizeInBytes());
+    memcpy(data, tensor.DataRaw(), tensor.SizeInBytes());
+    packed_buffer_ = BufferUniquePtr(data, BufferDeleter(alloc));
+    if (prepacked_weights != nullptr) {
+      prepacked_weights->buffers_.push_back(std::move(packed_buffer_));
+      prepacked_weights->buffer_sizes_.push_back(tensor.SizeInBytes());
+    }
+    is_packed = true;
+    return Status::OK();
+  }
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   const std::vector<size_t>& /*prepacked_buffer_sizes*/,
+                                   const Tensor& tensor, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override {
+    ORT_UNUSED_PARAMETER(tensor);
+    ORT_UNUSED_PARAMETER(input_idx);
+    packed_buffer_ = std::move(prepacked_buffers[0]);
+    used_shared_buffers = true;
+    return Status::OK();
+  }
+
+  const float* PackedData() const { return static_cast<const float*>(packed_buffer_.get()); }
+
+  static int prepack_calls;
+
+ private:
+  BufferUniquePtr packed_buffer_;
+};
+
+int SharedPrePackingTestOpKernel::prepack_calls = 0;
+
+// Creates a session state for a graph with a single SharedPrePackingTest node whose second input is an
+// initializer with the given value, and returns the kernel of the node.
+static const SharedPrePackingTestOpKernel* FinalizeSharedPrePackingSessionState(
+    float initializer_value, PrepackedWeightsContainer& container, concurrency::ThreadPool* tp,
+    std::unique_ptr<Model>& model, ExecutionProviders& execution_providers, DataTransferManager& dtm,
+    profiling::Profiler& profiler, KernelRegistryManager& kernel_registry_manager,
+    std::unique_ptr<SessionState>& session_state) {
+  model = onnxruntime::make_unique<Model>("graph_1", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model->MainGraph();
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  auto& input_0_arg = graph.GetOrCreateNodeArg("node_0_input_0", &type);
+  auto& input_1_arg = graph.GetOrCreateNodeArg("node_0_input_1", &type);
+  auto& output_arg = graph.GetOrCreateNodeArg("node_0_output_0", &type);
+  auto& node = graph.AddNode("node_0", "SharedPrePackingTest", "node 0", {&input_0_arg, &input_1_arg}, {&output_arg});
+  node.SetExecutionProviderType(kCpuExecutionProvider);
+
+  ONNX_NAMESPACE::TensorProto tensor;
+  tensor.add_dims(1);
+  tensor.add_float_data(initializer_value);
+  tensor.set_data_type(TensorProto_DataType_FLOAT);
+  tensor.set_name("node_0_input_1");
+  graph.AddInitializedTensor(tensor);
+  EXPECT_STATUS_OK(graph.Resolve());
+
+  session_state = onnxruntime::make_unique<SessionState>(graph, execution_providers, true /*enable_mem_pattern*/,
+                                                         tp, nullptr /*inter_op_thread_pool*/, dtm,
+                                                         DefaultLoggingManager().DefaultLogger(), profiler,
+                                                         false /*use_deterministic_compute*/, &container);
+  SessionOptions sess_options;
+  EXPECT_STATUS_OK(session_state->FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                       kernel_registry_manager, sess_options));
+  EXPECT_TRUE(session_state->GetConstantInitializedTensors().empty());
+
+  return static_cast<const SharedPrePackingTestOpKernel*>(session_state->GetKernel(node.Index()));
+}
+
+TEST(SessionStateTest, SharedPrePackedWeights) {
+  OrtThreadPoolParams to;
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
+  ONNX_OPERATOR_SCHEMA(SharedPrePackingTest)
+      .SetDoc("Faking Node for sharing pre-packed weights")
+      .Input(0, "Input_0", "input 0", "tensor(float)")
+      .Input(1, "Input_1", "input 1", "tensor(float)")
+      .Output(0, "output_0", "docstr for output_0.", "tensor(float)");
+
+  ExecutionProviders execution_providers;
+  auto cpu_execution_provider = onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo(false));
+  execution_providers.Add(kCpuExecutionProvider, std::move(cpu_execution_provider));
+
+  KernelRegistryManager kernel_registry_manager;
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+  std::shared_ptr<KernelRegistry> kernel_registry = std::make_shared<KernelRegistry>();
+  auto kernel_def = KernelDefBuilder().SetName("SharedPrePackingTest").Provider(kCpuExecutionProvider).SinceVersion(1).Build();
+  ASSERT_STATUS_OK(kernel_registry->Register(
+      KernelCreateInfo(std::move(kernel_def),
+                       [](const OpKernelInfo& info) -> OpKernel* { return new SharedPrePackingTestOpKernel(info); })));
+  kernel_registry_manager.RegisterKernelRegistry(kernel_registry);
+
+  PrepackedWeightsContainer container;
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+  SharedPrePackingTestOpKernel::prepack_calls = 0;
+
+  std::unique_ptr<Model> model_1, model_2, model_3;
+  std::unique_ptr<SessionState> session_state_1, session_state_2, session_state_3;
+  const auto* kernel_1 = FinalizeSharedPrePackingSessionState(1.f, container, tp.get(), model_1, execution_providers,
+                                                              dtm, profiler, kernel_registry_manager,
+                                                              session_state_1);
+  const auto* kernel_2 = FinalizeSharedPrePackingSessionState(1.f, container, tp.get(), model_2, execution_providers,
+                                                              dtm, profiler, kernel_registry_manager,
+                                                              session_state_2);
+
+  // the second session reuses the weights packed by the first one
+  EXPECT_EQ(SharedPrePackingTestOpKernel::prepack_calls, 1);
+  EXPECT_EQ(container.NumberOfEntries(), 1u);
+  ASSERT_NE(kernel_1->PackedData(), nullptr);
+  EXPECT_EQ(kernel_1->PackedData(), kernel_2->PackedData());
+
+  // an initializer with different content is packed separately
+  const auto* kernel_3 = FinalizeSharedPrePackingSessionState(2.f, container, tp.get(), model_3, execution_providers,
+                                                              dtm, profiler, kernel_registry_manager,
+                                                              session_state_3);
+  EXPECT_EQ(SharedPrePackingTestOpKernel::prepack_calls, 2);
+  EXPECT_EQ(container.NumberOfEntries(), 2u);
+  EXPECT_NE(kernel_3->PackedData(), kernel_1->PackedData());
+  EXPECT_EQ(*kernel_1->PackedData(), 1.f);
+  EXPECT_EQ(*kernel_3->PackedData(), 2.f);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,9 +1,12 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <fstream>
+
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/onnx_protobuf.h"
 #include "test/util/include/asserts.h"
+#include "test/util/include/file_util.h"
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
@@ -174,5 +177,110 @@ TEST(TensorProtoUtilsTest, ConstantTensorProto) {
 
   // sparse_tensor is covered by SparseTensorConversionTests.TestConstantNodeConversion
 }
+
+TEST(TensorProtoUtilsTest, ExternalDataInMemory) {
+  const std::vector<float> data{1.f, 2.f, 3.f, 4.f};
+  TensorProto tp;
+  tp.set_name("in_memory");
+  tp.set_data_type(TensorProto_DataType_FLOAT);
+  tp.add_dims(2);
+  tp.add_dims(2);
+  SetExternalDataInMemory(tp, data.data(), data.size() * sizeof(float));
+  ASSERT_TRUE(HasExternalDataInMemory(tp));
+  ASSERT_TRUE(CanUseTensorProtoDataInPlace(tp));
+
+  // the tensor uses the data in place, so doesn't need a preallocated buffer
+  OrtMemoryInfo cpu_info(CPU, OrtDeviceAllocator);
+  OrtValue value;
+  OrtCallback deleter;
+  ASSERT_STATUS_OK(TensorProtoToMLValue(Env::Default(), nullptr, tp, MemBuffer(nullptr, 0, cpu_info), value, deleter));
+  EXPECT_EQ(value.Get<Tensor>().DataRaw(), data.data());
+  EXPECT_TRUE(deleter.f == nullptr);
+
+  std::unique_ptr<uint8_t[]> unpacked;
+  size_t unpacked_size = 0;
+  ASSERT_STATUS_OK(UnpackInitializerData(tp, unpacked, unpacked_size));
+  ASSERT_EQ(unpacked_size, data.size() * sizeof(float));
+  EXPECT_EQ(memcmp(unpacked.get(), data.data(), unpacked_size), 0);
+
+  // misaligned data is copied into the preallocated buffer
+  std::vector<char> misaligned(data.size() * sizeof(float) + 1);
+  memcpy(misaligned.data() + 1, data.data(), data.size() * sizeof(float));
+  SetExternalDataInMemory(tp, misaligned.data() + 1, data.size() * sizeof(float));
+  EXPECT_FALSE(CanUseTensorProtoDataInPlace(tp));
+
+  std::vector<float> buffer(data.size());
+  ASSERT_STATUS_OK(TensorProtoToMLValue(Env::Default(), nullptr, tp,
+                                        MemBuffer(buffer.data(), buffer.size() * sizeof(float), cpu_info),
+                                        value, deleter));
+  EXPECT_EQ(value.Get<Tensor>().DataRaw(), buffer.data());
+  EXPECT_EQ(buffer, data);
+}
+
+TEST(TensorProtoUtilsTest, ExternalDataInFile) {
+  const std::vector<float> data{1.f, 2.f, 3.f, 4.f};
+  const size_t data_size = data.size() * sizeof(float);
+  const PathString file_path = ToPathString("TensorProtoUtilsTest_ExternalDataInFile.bin");
+  ScopedFileDeleter file_deleter{};
+  {
+    // the data at offset 0 and at the misaligned offset data_size + 1
+    std::ofstream out{file_path, std::ios::binary | std::ios::trunc};
+    out.write(reinterpret_cast<const char*>(data.data()), data_size);
+    out.put(0);
+    out.write(reinterpret_cast<const char*>(data.data()), data_size);
+    ASSERT_TRUE(out.good());
+    file_deleter = ScopedFileDeleter{file_path};
+  }
+
+  auto make_tensor_proto = [&](size_t offset) {
+    TensorProto tp;
+    tp.set_name("in_file");
+    tp.set_data_type(TensorProto_DataType_FLOAT);
+    tp.add_dims(static_cast<int64_t>(data.size()));
+    tp.set_data_location(TensorProto_DataLocation_EXTERNAL);
+    auto* location = tp.add_external_data();
+    location->set_key("location");
+    location->set_value(ToMBString(file_path));
+    auto* offset_entry = tp.add_external_data();
+    offset_entry->set_key("offset");
+    offset_entry->set_value(std::to_string(offset));
+    auto* length = tp.add_external_data();
+    length->set_key("length");
+    length->set_value(std::to_string(data_size));
+    return tp;
+  };
+
+  OrtMemoryInfo cpu_info(CPU, OrtDeviceAllocator);
+
+  // the tensor uses the mapped file in place. the caller owns the mapping through the deleter.
+  {
+    TensorProto tp = make_tensor_proto(0);
+    ASSERT_TRUE(CanUseTensorProtoDataInPlace(tp));
+
+    OrtValue value;
+    OrtCallback deleter;
+    ASSERT_STATUS_OK(TensorProtoToMLValue(Env::Default(), nullptr, tp, MemBuffer(nullptr, 0, cpu_info), value,
+                                          deleter));
+    const auto& tensor = value.Get<Tensor>();
+    EXPECT_EQ(std::vector<float>(tensor.Data<float>(), tensor.Data<float>() + data.size()), data);
+    ASSERT_TRUE(deleter.f != nullptr);
+    deleter.f(deleter.param);
+  }
+
+  // misaligned data is copied into the preallocated buffer
+  {
+    TensorProto tp = make_tensor_proto(data_size + 1);
+    EXPECT_FALSE(CanUseTensorProtoDataInPlace(tp));
+
+    std::vector<float> buffer(data.size());
+    OrtValue value;
+    OrtCallback deleter;
+    ASSERT_STATUS_OK(TensorProtoToMLValue(Env::Default(), nullptr, tp,
+                                          MemBuffer(buffer.data(), data_size, cpu_info), value, deleter));
+    EXPECT_EQ(value.Get<Tensor>().DataRaw(), buffer.data());
+    EXPECT_EQ(buffer, data);
+    EXPECT_TRUE(deleter.f == nullptr);
+  }
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <memory>
+#include "core/framework/tensorprotoutils.h"
 #include "core/platform/env.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
@@ -187,5 +188,80 @@ TEST_F(ONNXModelsTest, TestModelsWithAnOpContainingAFunctionBody) {
   ASSERT_STATUS_OK(model->MainGraph().Resolve());
 }
 
+// the location ORT uses for tensors it references in memory must not be accepted from a model, as the offset would
+// be read from as an address
+static ModelProto CreateModelWithExternalDataInMemory(const float* data, bool in_subgraph) {
+  ModelProto model_proto;
+  model_proto.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
+  model_proto.add_opset_import()->set_version(12);
+
+  TensorProto tensor;
+  tensor.set_name("W");
+  tensor.set_data_type(TensorProto_DataType_FLOAT);
+  tensor.add_dims(4);
+  utils::SetExternalDataInMemory(tensor, data, 4 * sizeof(float));
+
+  GraphProto& graph = *model_proto.mutable_graph();
+  graph.set_name("main");
+  auto* output = graph.add_output();
+  output->set_name("Y");
+  output->mutable_type()->mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+
+  if (!in_subgraph) {
+    *graph.add_initializer() = tensor;
+    auto& node = *graph.add_node();
+    node.set_op_type("Identity");
+    node.add_input("W");
+    node.add_output("Y");
+    return model_proto;
+  }
+
+  // If with a Constant node in each branch
+  auto* cond = graph.add_input();
+  cond->set_name("cond");
+  cond->mutable_type()->mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+  auto& node = *graph.add_node();
+  node.set_op_type("If");
+  node.add_input("cond");
+  node.add_output("Y");
+  for (const char* branch : {"then_branch", "else_branch"}) {
+    auto& attr = *node.add_attribute();
+    attr.set_name(branch);
+    attr.set_type(AttributeProto_AttributeType_GRAPH);
+    GraphProto& subgraph = *attr.mutable_g();
+    subgraph.set_name(branch);
+    *subgraph.add_output() = *output;
+    subgraph.mutable_output(0)->set_name(std::string(branch) + "_Y");
+    auto& constant = *subgraph.add_node();
+    constant.set_op_type("Constant");
+    constant.add_output(std::string(branch) + "_Y");
+    auto& value = *constant.add_attribute();
+    value.set_name("value");
+    value.set_type(AttributeProto_AttributeType_TENSOR);
+    *value.mutable_t() = tensor;
+  }
+  return model_proto;
+}
+
+TEST_F(ONNXModelsTest, RejectExternalDataInMemory) {
+  const std::vector<float> data{1.f, 2.f, 3.f, 4.f};
+
+  for (bool in_subgraph : {false, true}) {
+    std::shared_ptr<Model> model;
+    auto status = Model::Load(CreateModelWithExternalDataInMemory(data.data(), in_subgraph), model, nullptr,
+                              *logger_);
+    ASSERT_FALSE(status.IsOK()) << "in_subgraph: " << in_subgraph;
+    EXPECT_EQ(status.Code(), common::INVALID_ARGUMENT);
+    EXPECT_NE(status.ErrorMessage().find(utils::kTensorProtoMemoryAddressTag), std::string::npos)
+        << status.ErrorMessage();
+
+    // the same model is loaded from its serialized bytes
+    std::string bytes = CreateModelWithExternalDataInMemory(data.data(), in_subgraph).SerializeAsString();
+    status = Model::LoadFromBytes(static_cast<int>(bytes.size()), &bytes[0], model, nullptr, *logger_);
+    ASSERT_FALSE(status.IsOK()) << "in_subgraph: " << in_subgraph;
+    EXPECT_EQ(status.Code(), common::INVALID_ARGUMENT);
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -260,8 +260,44 @@ private:
     MatrixGuardBuffer<uint8_t> BufferBPacked;
 };
 
-template<typename T, bool Packed>
-class MlasFgemmTest : public MlasFgemmTestBase<T, Packed>
+template<MLAS_HALF_FORMAT PackedBFormat>
+class MlasSgemmHalfPackedTestBase : public MlasTestBase
+{
+public:
+    void
+    TestGemm(
+        CBLAS_TRANSPOSE TransA,
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        const float* A,
+        size_t lda,
+        const float* B,
+        size_t ldb,
+        float beta,
+        float* C,
+        size_t ldc
+        )
+    {
+        //
+        // The fill values of matrix B are small integers, which are exactly
+        // representable as half precision and bfloat16 values.
+        //
+
+        size_t PackedBSize = MlasGemmPackBSize(N, K, PackedBFormat);
+        void* PackedB = BufferBPacked.GetBuffer(PackedBSize, true);
+        MlasGemmPackB(TransB, N, K, B, ldb, PackedBFormat, PackedB);
+        MlasGemm(TransA, M, N, K, alpha, A, lda, PackedB, PackedBFormat, beta, C, ldc, threadpool);
+    }
+
+private:
+    MatrixGuardBuffer<uint8_t> BufferBPacked;
+};
+
+template<typename T, bool Packed, typename TestBase = MlasFgemmTestBase<T, Packed>>
+class MlasFgemmTest : public TestBase
 {
 private:
     void
@@ -2765,6 +2801,10 @@ RunThreadedTests(
     onnxruntime::make_unique<MlasFgemmTest<float, false>>()->ExecuteShort();
     printf("SGEMM packed tests.\n");
     onnxruntime::make_unique<MlasFgemmTest<float, true>>()->ExecuteShort();
+    printf("SGEMM half precision packed tests.\n");
+    onnxruntime::make_unique<MlasFgemmTest<float, true, MlasSgemmHalfPackedTestBase<MlasHalfFormatFloat16>>>()->ExecuteShort();
+    printf("SGEMM bfloat16 packed tests.\n");
+    onnxruntime::make_unique<MlasFgemmTest<float, true, MlasSgemmHalfPackedTestBase<MlasHalfFormatBFloat16>>>()->ExecuteShort();
 #ifdef MLAS_SUPPORTS_GEMM_DOUBLE
     printf("DGEMM tests.\n");
     onnxruntime::make_unique<MlasFgemmTest<double, false>>()->ExecuteShort();
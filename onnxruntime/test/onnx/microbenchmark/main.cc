@@ -18,8 +18,11 @@
 #include <core/session/ort_env.h>
 #include <core/util/thread_utils.h>
 
+#include <cstring>
 #include <unordered_map>
 
+#include "model_ops.h"
+
 const OrtApi* g_ort = OrtGetApiBase()->GetApi(ORT_API_VERSION);
 OrtEnv* env = nullptr;
 
@@ -73,11 +76,41 @@ BENCHMARK(BM_ResolveGraph);
     }                                                        \
   } while (0);
 
+// Removes the --model_ops=<model path> and --symbolic_dim=<value> arguments from argv. The benchmarks of the nodes of
+// the model are registered in addition to the ones defined in this directory; use --benchmark_filter to run only them.
+static void ParseModelOpsArguments(int* argc, char** argv, std::string& model_path, int64_t& symbolic_dim_value) {
+  static const char kModelOps[] = "--model_ops=";
+  static const char kSymbolicDim[] = "--symbolic_dim=";
+  int new_argc = 1;
+  for (int i = 1; i < *argc; ++i) {
+    if (strncmp(argv[i], kModelOps, sizeof(kModelOps) - 1) == 0) {
+      model_path = argv[i] + sizeof(kModelOps) - 1;
+    } else if (strncmp(argv[i], kSymbolicDim, sizeof(kSymbolicDim) - 1) == 0) {
+      symbolic_dim_value = std::stoll(argv[i] + sizeof(kSymbolicDim) - 1);
+    } else {
+      argv[new_argc++] = argv[i];
+    }
+  }
+  *argc = new_argc;
+}
+
 int main(int argc, char** argv) {
+  std::string model_ops_path;
+  int64_t symbolic_dim_value = 1;
+  ParseModelOpsArguments(&argc, argv, model_ops_path, symbolic_dim_value);
   ::benchmark::Initialize(&argc, argv);
   if (::benchmark::ReportUnrecognizedArguments(argc, argv))
     return -1;
   ORT_ABORT_ON_ERROR(g_ort->CreateEnv(ORT_LOGGING_LEVEL_ERROR, "test", &env));
+  if (!model_ops_path.empty()) {
+    auto st = RegisterModelOpBenchmarks(model_ops_path, symbolic_dim_value);
+    if (!st.IsOK()) {
+      fprintf(stderr, "Failed to register the benchmarks of %s: %s\n", model_ops_path.c_str(),
+              st.ErrorMessage().c_str());
+      g_ort->ReleaseEnv(env);
+      return -1;
+    }
+  }
   ::benchmark::RunSpecifiedBenchmarks();
   g_ort->ReleaseEnv(env);
   return 0;
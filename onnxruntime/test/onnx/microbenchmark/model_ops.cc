@@ -0,0 +1,428 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "model_ops.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <core/common/path_string.h>
+#include <core/framework/data_types.h>
+#include <core/graph/model.h>
+#include <core/platform/env.h>
+#include <core/session/onnxruntime_cxx_api.h>
+#include <core/session/ort_env.h>
+#include <core/util/math.h>
+
+extern OrtEnv* env;
+
+using namespace onnxruntime;
+using namespace ONNX_NAMESPACE;
+
+namespace {
+
+struct OpBenchmarkInput {
+  std::string name;
+  std::vector<int64_t> shape;
+  int32_t elem_type;
+};
+
+// Everything a benchmark needs to run a single node of the model.
+struct OpBenchmark {
+  std::string model_bytes;
+  std::vector<OpBenchmarkInput> inputs;
+  std::vector<std::string> output_names;
+  double flops;
+  double bytes;
+};
+
+int64_t ShapeSize(const std::vector<int64_t>& shape) {
+  int64_t size = 1;
+  for (int64_t dim : shape) {
+    size *= dim;
+  }
+  return size;
+}
+
+size_t ElementSize(int32_t elem_type) {
+  switch (elem_type) {
+    case TensorProto_DataType_DOUBLE:
+    case TensorProto_DataType_INT64:
+    case TensorProto_DataType_UINT64:
+      return 8;
+    case TensorProto_DataType_FLOAT:
+    case TensorProto_DataType_INT32:
+    case TensorProto_DataType_UINT32:
+      return 4;
+    case TensorProto_DataType_FLOAT16:
+    case TensorProto_DataType_BFLOAT16:
+    case TensorProto_DataType_INT16:
+    case TensorProto_DataType_UINT16:
+      return 2;
+    default:
+      return 1;
+  }
+}
+
+// Returns false if arg isn't a tensor with a fully known shape.
+bool GetTensorShape(const NodeArg& arg, std::vector<int64_t>& shape, int32_t& elem_type) {
+  const TypeProto* type = arg.TypeAsProto();
+  const TensorShapeProto* shape_proto = arg.Shape();
+  if (type == nullptr || !type->has_tensor_type() || shape_proto == nullptr) {
+    return false;
+  }
+
+  shape.clear();
+  for (const auto& dim : shape_proto->dim()) {
+    if (!dim.has_dim_value()) {
+      return false;
+    }
+    shape.push_back(dim.dim_value());
+  }
+  elem_type = type->tensor_type().elem_type();
+  return true;
+}
+
+int64_t GetIntAttribute(const Node& node, const std::string& name, int64_t default_value) {
+  const auto& attributes = node.GetAttributes();
+  auto it = attributes.find(name);
+  return it != attributes.end() && it->second.has_i() ? it->second.i() : default_value;
+}
+
+// Estimates the floating point operations of a node. The matrix multiplication and convolution ops are counted as a
+// multiply and an add per multiply-accumulate. Every other op is counted as one operation per output element.
+double EstimateFlops(const Node& node,
+                     const std::vector<std::vector<int64_t>>& input_shapes,
+                     const std::vector<std::vector<int64_t>>& output_shapes) {
+  const std::string& op_type = node.OpType();
+  if (output_shapes.empty()) {
+    return 0.0;
+  }
+  const double output_size = static_cast<double>(ShapeSize(output_shapes[0]));
+
+  if (op_type == "MatMul" || op_type == "FusedMatMul" || op_type == "MatMulInteger" ||
+      op_type == "MatMulIntegerToFloat" || op_type == "DynamicQuantizeMatMul") {
+    const auto& a = input_shapes[0];
+    if (!a.empty()) {
+      const bool trans_a = a.size() > 1 && GetIntAttribute(node, "transA", 0) != 0;
+      const int64_t k = trans_a ? a[a.size() - 2] : a.back();
+      return 2.0 * output_size * static_cast<double>(k);
+    }
+  } else if (op_type == "QLinearMatMul") {
+    const auto& a = input_shapes[0];
+    if (!a.empty()) {
+      return 2.0 * output_size * static_cast<double>(a.back());
+    }
+  } else if (op_type == "Gemm" || op_type == "FusedGemm") {
+    const auto& a = input_shapes[0];
+    if (a.size() == 2) {
+      const int64_t k = GetIntAttribute(node, "transA", 0) != 0 ? a[0] : a[1];
+      return 2.0 * output_size * static_cast<double>(k);
+    }
+  } else if (op_type == "Conv" || op_type == "FusedConv" || op_type == "ConvInteger" || op_type == "QLinearConv") {
+    // Each output element is a dot product over (C / group) * kernel_size weights.
+    const size_t w_index = op_type == "QLinearConv" ? 3 : 1;
+    if (w_index < input_shapes.size() && !input_shapes[w_index].empty() && input_shapes[w_index][0] != 0) {
+      const auto& w = input_shapes[w_index];
+      return 2.0 * output_size * static_cast<double>(ShapeSize(w) / w[0]);
+    }
+  } else if (op_type == "ConvTranspose") {
+    // Each input element is scattered to (M / group) * kernel_size outputs.
+    if (input_shapes.size() > 1 && !input_shapes[1].empty() && input_shapes[1][0] != 0) {
+      const auto& x = input_shapes[0];
+      const auto& w = input_shapes[1];
+      return 2.0 * static_cast<double>(ShapeSize(x)) * static_cast<double>(ShapeSize(w) / w[0]);
+    }
+  }
+
+  double flops = 0.0;
+  for (const auto& shape : output_shapes) {
+    flops += static_cast<double>(ShapeSize(shape));
+  }
+  return flops;
+}
+
+std::string ShapeToString(const std::vector<int64_t>& shape) {
+  std::ostringstream ss;
+  for (size_t i = 0; i < shape.size(); ++i) {
+    if (i > 0) ss << "x";
+    ss << shape[i];
+  }
+  return ss.str();
+}
+
+// Builds the benchmark of node. Returns false if the node can't be run on its own, e.g. because the shapes of its
+// inputs aren't known or it contains subgraphs.
+bool CreateOpBenchmark(const ModelProto& model_proto, const Graph& graph, const Node& node,
+                       std::string& key, std::string& name, OpBenchmark& op_benchmark) {
+  if (node.ContainsSubgraph()) {
+    return false;
+  }
+
+  ModelProto single_node_model;
+  // IR version 4 allows initializers that aren't graph inputs.
+  single_node_model.set_ir_version(std::max<int64_t>(model_proto.ir_version(), 4));
+  *single_node_model.mutable_opset_import() = model_proto.opset_import();
+  GraphProto& graph_proto = *single_node_model.mutable_graph();
+  graph_proto.set_name(node.OpType());
+  NodeProto& node_proto = *graph_proto.add_node();
+  node.ToProto(node_proto);
+
+  std::ostringstream key_stream;
+  std::ostringstream name_stream;
+  key_stream << node.Domain() << ":" << node.OpType() << "(";
+  name_stream << node.OpType() << "/";
+
+  // Sort the attributes so nodes with the same attributes produce the same key.
+  std::map<std::string, const AttributeProto*> attributes;
+  for (const auto& attribute : node.GetAttributes()) {
+    attributes.emplace(attribute.first, &attribute.second);
+  }
+  for (const auto& attribute : attributes) {
+    key_stream << attribute.second->SerializeAsString() << ";";
+  }
+  key_stream << ")";
+
+  std::vector<std::vector<int64_t>> input_shapes;
+  std::unordered_set<std::string> added_inputs;
+  double bytes = 0.0;
+  for (const NodeArg* input : node.InputDefs()) {
+    std::vector<int64_t> shape;
+    int32_t elem_type = TensorProto_DataType_UNDEFINED;
+    if (!input->Exists()) {
+      input_shapes.emplace_back();
+      continue;
+    }
+    if (!GetTensorShape(*input, shape, elem_type)) {
+      return false;
+    }
+
+    key_stream << ShapeToString(shape) << ":" << elem_type << ",";
+    if (!input_shapes.empty()) name_stream << ",";
+    name_stream << ShapeToString(shape);
+    bytes += static_cast<double>(ShapeSize(shape) * ElementSize(elem_type));
+    input_shapes.push_back(shape);
+
+    if (!added_inputs.insert(input->Name()).second) {
+      continue;
+    }
+
+    // Constant weights stay constant so the kernel can pre-pack them as it does in the full model. Initializers with
+    // external data are fed with random values as their data isn't available to the single node model.
+    const TensorProto* initializer = nullptr;
+    if (graph.GetInitializedTensor(input->Name(), initializer) &&
+        initializer->data_location() != TensorProto_DataLocation_EXTERNAL) {
+      *graph_proto.add_initializer() = *initializer;
+      key_stream << "const,";
+      continue;
+    }
+
+    const Node* producer = graph.GetProducerNode(input->Name());
+    if (producer != nullptr && producer->OpType() == "Constant") {
+      auto value = producer->GetAttributes().find("value");
+      if (value != producer->GetAttributes().end() && value->second.has_t()) {
+        TensorProto& constant = *graph_proto.add_initializer();
+        constant = value->second.t();
+        constant.set_name(input->Name());
+        // The value of a constant such as the target shape of a Reshape changes what the kernel does.
+        key_stream << constant.SerializeAsString() << ",";
+        continue;
+      }
+    }
+
+    *graph_proto.add_input() = input->ToProto();
+    op_benchmark.inputs.push_back({input->Name(), shape, elem_type});
+  }
+
+  std::vector<std::vector<int64_t>> output_shapes;
+  for (const NodeArg* output : node.OutputDefs()) {
+    if (!output->Exists()) {
+      continue;
+    }
+    std::vector<int64_t> shape;
+    int32_t elem_type = TensorProto_DataType_UNDEFINED;
+    if (GetTensorShape(*output, shape, elem_type)) {
+      bytes += static_cast<double>(ShapeSize(shape) * ElementSize(elem_type));
+      output_shapes.push_back(shape);
+    }
+    *graph_proto.add_output() = output->ToProto();
+    op_benchmark.output_names.push_back(output->Name());
+  }
+
+  if (op_benchmark.output_names.empty()) {
+    return false;
+  }
+
+  op_benchmark.flops = EstimateFlops(node, input_shapes, output_shapes);
+  op_benchmark.bytes = bytes;
+  op_benchmark.model_bytes = single_node_model.SerializeAsString();
+  key = key_stream.str();
+  name = name_stream.str();
+  return true;
+}
+
+template <typename T>
+T FromFloat(float value) {
+  return static_cast<T>(value);
+}
+
+template <>
+MLFloat16 FromFloat<MLFloat16>(float value) {
+  return MLFloat16(math::floatToHalf(value));
+}
+
+template <typename T>
+void FillRandom(Ort::Value& value, size_t count, float low, float high) {
+  static std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(low, high);
+  T* data = value.GetTensorMutableData<T>();
+  for (size_t i = 0; i < count; ++i) {
+    data[i] = FromFloat<T>(dist(gen));
+  }
+}
+
+// Creates an input tensor. Floating point and 8 bit inputs get random values. Wider integer inputs are set to 0 as
+// they are usually indices or sizes, for which 0 is always valid.
+Ort::Value CreateInput(OrtAllocator* allocator, const OpBenchmarkInput& input) {
+  Ort::Value value = Ort::Value::CreateTensor(allocator, input.shape.data(), input.shape.size(),
+                                              static_cast<ONNXTensorElementDataType>(input.elem_type));
+  const size_t count = static_cast<size_t>(ShapeSize(input.shape));
+  switch (input.elem_type) {
+    case TensorProto_DataType_FLOAT:
+      FillRandom<float>(value, count, -1.0f, 1.0f);
+      break;
+    case TensorProto_DataType_DOUBLE:
+      FillRandom<double>(value, count, -1.0f, 1.0f);
+      break;
+    case TensorProto_DataType_FLOAT16:
+      FillRandom<MLFloat16>(value, count, -1.0f, 1.0f);
+      break;
+    case TensorProto_DataType_INT8:
+      FillRandom<int8_t>(value, count, -128.0f, 127.0f);
+      break;
+    case TensorProto_DataType_UINT8:
+      FillRandom<uint8_t>(value, count, 0.0f, 255.0f);
+      break;
+    default:
+      memset(value.GetTensorMutableData<void>(), 0, count * ElementSize(input.elem_type));
+      break;
+  }
+  return value;
+}
+
+void RunOpBenchmark(benchmark::State& state, std::shared_ptr<const OpBenchmark> op_benchmark) {
+  try {
+    Ort::Unowned<Ort::Env> ort_env{env};
+    Ort::SessionOptions session_options;
+    session_options.SetIntraOpNumThreads(static_cast<int>(state.range(0)));
+    session_options.SetInterOpNumThreads(1);
+    session_options.SetExecutionMode(ORT_SEQUENTIAL);
+    // Run the node as it is in the model instead of what the optimizers would turn it into.
+    session_options.SetGraphOptimizationLevel(ORT_DISABLE_ALL);
+    Ort::Session session(ort_env, op_benchmark->model_bytes.data(), op_benchmark->model_bytes.size(),
+                         session_options);
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    std::vector<const char*> input_names;
+    std::vector<Ort::Value> inputs;
+    for (const auto& input : op_benchmark->inputs) {
+      input_names.push_back(input.name.c_str());
+      inputs.push_back(CreateInput(allocator, input));
+    }
+    std::vector<const char*> output_names;
+    for (const auto& output_name : op_benchmark->output_names) {
+      output_names.push_back(output_name.c_str());
+    }
+
+    Ort::RunOptions run_options;
+    // Warm up run so the one time costs of the first run aren't measured.
+    session.Run(run_options, input_names.data(), inputs.data(), inputs.size(), output_names.data(),
+                output_names.size());
+    for (auto _ : state) {
+      auto outputs = session.Run(run_options, input_names.data(), inputs.data(), inputs.size(), output_names.data(),
+                                 output_names.size());
+      benchmark::DoNotOptimize(outputs);
+    }
+  } catch (const Ort::Exception& ex) {
+    state.SkipWithError(ex.what());
+    return;
+  }
+
+  state.counters["FLOPS"] = benchmark::Counter(op_benchmark->flops, benchmark::Counter::kIsIterationInvariantRate,
+                                               benchmark::Counter::OneK::kIs1000);
+  state.counters["Bytes"] = benchmark::Counter(op_benchmark->bytes, benchmark::Counter::kIsIterationInvariantRate,
+                                               benchmark::Counter::OneK::kIs1024);
+}
+
+}  // namespace
+
+common::Status RegisterModelOpBenchmarks(const std::string& model_path, int64_t symbolic_dim_value) {
+  ModelProto model_proto;
+  ORT_RETURN_IF_ERROR(Model::Load(ToPathString(model_path), model_proto));
+
+  // Fix the dimensions of the model inputs so the shapes of all the nodes can be inferred.
+  for (auto& input : *model_proto.mutable_graph()->mutable_input()) {
+    if (!input.type().has_tensor_type() || !input.type().tensor_type().has_shape()) {
+      continue;
+    }
+    for (auto& dim : *input.mutable_type()->mutable_tensor_type()->mutable_shape()->mutable_dim()) {
+      if (!dim.has_dim_value()) {
+        dim.set_dim_value(symbolic_dim_value);
+      }
+    }
+  }
+
+  auto logger = env->GetLoggingManager()->CreateLogger("model_ops");
+  std::shared_ptr<Model> model;
+  ORT_RETURN_IF_ERROR(Model::Load(model_proto, ToPathString(model_path), model, nullptr, *logger));
+  const Graph& graph = model->MainGraph();
+
+  const int max_threads = std::max(1, Env::Default().GetNumCpuCores());
+  std::unordered_set<std::string> keys;
+  std::unordered_map<std::string, int> name_counts;
+  size_t skipped = 0;
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "Constant") {
+      continue;
+    }
+
+    std::string key;
+    std::string name;
+    auto op_benchmark = std::make_shared<OpBenchmark>();
+    if (!CreateOpBenchmark(model_proto, graph, node, key, name, *op_benchmark)) {
+      ++skipped;
+      continue;
+    }
+    if (!keys.insert(key).second) {
+      continue;
+    }
+
+    // Nodes with the same shapes but different attributes get a suffix to keep the benchmark names unique.
+    const int count = name_counts[name]++;
+    if (count > 0) {
+      name += "#" + std::to_string(count);
+    }
+
+    std::shared_ptr<const OpBenchmark> captured = op_benchmark;
+    benchmark::RegisterBenchmark(name.c_str(), [captured](benchmark::State& state) { RunOpBenchmark(state, captured); })
+        ->ArgName("threads")
+        ->RangeMultiplier(2)
+        ->Range(1, max_threads)
+        ->UseRealTime()
+        ->Unit(benchmark::TimeUnit::kMicrosecond);
+  }
+
+  if (skipped > 0) {
+    LOGS(*logger, WARNING) << "Skipped " << skipped << " nodes of " << model_path
+                           << " that have subgraphs or inputs with unknown shapes";
+  }
+  return common::Status::OK();
+}
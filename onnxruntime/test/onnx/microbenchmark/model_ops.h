@@ -0,0 +1,19 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "core/common/status.h"
+
+// Registers a benchmark for each distinct (op, attributes, input shapes) tuple of the nodes of the model at
+// model_path. Each benchmark runs a model with just that node on the CPU execution provider with 1, 2, 4, ... up to
+// the number of cores intra-op threads, and reports the FLOPS estimated from the node's shapes and the bytes of its
+// inputs and outputs processed per second.
+//
+// Dimensions of the model inputs that aren't fixed are set to symbolic_dim_value so that the shapes of all nodes can
+// be inferred. Pass a model optimized by onnxruntime (SessionOptions::optimized_model_filepath) to benchmark the
+// kernels of the fused nodes the model runs with.
+onnxruntime::common::Status RegisterModelOpBenchmarks(const std::string& model_path, int64_t symbolic_dim_value);
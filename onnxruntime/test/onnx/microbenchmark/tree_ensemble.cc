@@ -0,0 +1,165 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <core/graph/constants.h>
+#include <core/graph/onnx_protobuf.h>
+#include <core/session/onnxruntime_cxx_api.h>
+#include <core/session/onnxruntime_session_options_config_keys.h>
+#include <core/session/ort_env.h>
+
+extern OrtEnv* env;
+
+using namespace ONNX_NAMESPACE;
+
+namespace {
+
+constexpr int kNumFeatures = 100;
+
+template <typename T>
+void AddInts(NodeProto& node, const char* name, const std::vector<T>& values) {
+  AttributeProto& attribute = *node.add_attribute();
+  attribute.set_name(name);
+  attribute.set_type(AttributeProto_AttributeType_INTS);
+  for (auto value : values) attribute.add_ints(value);
+}
+
+void AddFloats(NodeProto& node, const char* name, const std::vector<float>& values) {
+  AttributeProto& attribute = *node.add_attribute();
+  attribute.set_name(name);
+  attribute.set_type(AttributeProto_AttributeType_FLOATS);
+  for (auto value : values) attribute.add_floats(value);
+}
+
+void AddTensorValueInfo(ValueInfoProto& value_info, const char* name, int64_t dim) {
+  value_info.set_name(name);
+  auto& tensor_type = *value_info.mutable_type()->mutable_tensor_type();
+  tensor_type.set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_type.mutable_shape()->add_dim()->set_dim_param("N");
+  tensor_type.mutable_shape()->add_dim()->set_dim_value(dim);
+}
+
+// Creates a TreeEnsembleRegressor with n_trees complete trees of the given depth and random splits, the shape of the
+// ensembles LightGBM and XGBoost models are converted to.
+std::string CreateTreeEnsembleModel(int n_trees, int depth) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int64_t> feature(0, kNumFeatures - 1);
+  std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+  std::vector<int64_t> treeids, nodeids, featureids, truenodeids, falsenodeids;
+  std::vector<float> values, target_weights;
+  std::vector<std::string> modes;
+  std::vector<int64_t> target_treeids, target_nodeids, target_ids;
+  const int64_t n_nodes = (int64_t{1} << (depth + 1)) - 1;
+  const int64_t first_leaf = (int64_t{1} << depth) - 1;
+  for (int tree = 0; tree < n_trees; ++tree) {
+    for (int64_t node = 0; node < n_nodes; ++node) {
+      treeids.push_back(tree);
+      nodeids.push_back(node);
+      values.push_back(value(gen));
+      if (node < first_leaf) {
+        featureids.push_back(feature(gen));
+        truenodeids.push_back(2 * node + 1);
+        falsenodeids.push_back(2 * node + 2);
+        modes.push_back("BRANCH_LEQ");
+      } else {
+        featureids.push_back(0);
+        truenodeids.push_back(0);
+        falsenodeids.push_back(0);
+        modes.push_back("LEAF");
+        target_treeids.push_back(tree);
+        target_nodeids.push_back(node);
+        target_ids.push_back(0);
+        target_weights.push_back(value(gen));
+      }
+    }
+  }
+
+  ModelProto model;
+  model.set_ir_version(IR_VERSION);
+  auto& opset = *model.add_opset_import();
+  opset.set_domain(onnxruntime::kMLDomain);
+  opset.set_version(1);
+  GraphProto& graph = *model.mutable_graph();
+  graph.set_name("tree_ensemble");
+  AddTensorValueInfo(*graph.add_input(), "X", kNumFeatures);
+  AddTensorValueInfo(*graph.add_output(), "Y", 1);
+
+  NodeProto& node = *graph.add_node();
+  node.set_op_type("TreeEnsembleRegressor");
+  node.set_domain(onnxruntime::kMLDomain);
+  node.add_input("X");
+  node.add_output("Y");
+  AddInts(node, "nodes_treeids", treeids);
+  AddInts(node, "nodes_nodeids", nodeids);
+  AddInts(node, "nodes_featureids", featureids);
+  AddInts(node, "nodes_truenodeids", truenodeids);
+  AddInts(node, "nodes_falsenodeids", falsenodeids);
+  AddFloats(node, "nodes_values", values);
+  AttributeProto& modes_attribute = *node.add_attribute();
+  modes_attribute.set_name("nodes_modes");
+  modes_attribute.set_type(AttributeProto_AttributeType_STRINGS);
+  for (const auto& mode : modes) modes_attribute.add_strings(mode);
+  AddInts(node, "target_treeids", target_treeids);
+  AddInts(node, "target_nodeids", target_nodeids);
+  AddInts(node, "target_ids", target_ids);
+  AddFloats(node, "target_weights", target_weights);
+  AttributeProto& n_targets = *node.add_attribute();
+  n_targets.set_name("n_targets");
+  n_targets.set_type(AttributeProto_AttributeType_INT);
+  n_targets.set_i(1);
+
+  return model.SerializeAsString();
+}
+
+}  // namespace
+
+// Runs a gradient boosted model of state.range(1) trees of depth state.range(2) on a batch of state.range(0) rows,
+// with QuickScorer if state.range(3) is 1.
+static void BM_TreeEnsembleRegressor(benchmark::State& state) {
+  const int64_t batch_size = state.range(0);
+  const std::string model = CreateTreeEnsembleModel(static_cast<int>(state.range(1)), static_cast<int>(state.range(2)));
+
+  Ort::Unowned<Ort::Env> ort_env{env};
+  Ort::SessionOptions session_options;
+  session_options.SetIntraOpNumThreads(1);
+  if (state.range(3) != 0) {
+    session_options.AddConfigEntry(kOrtSessionOptionsConfigCpuTreeEnsembleEvaluation, "quickscorer");
+  }
+  Ort::Session session(ort_env, model.data(), model.size(), session_options);
+
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+  std::vector<float> x(batch_size * kNumFeatures);
+  for (auto& v : x) v = value(gen);
+  const int64_t shape[] = {batch_size, kNumFeatures};
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+  Ort::Value input = Ort::Value::CreateTensor<float>(memory_info, x.data(), x.size(), shape, 2);
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+
+  for (auto _ : state) {
+    auto outputs = session.Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, 1);
+    benchmark::DoNotOptimize(outputs);
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+
+BENCHMARK(BM_TreeEnsembleRegressor)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({1, 1000, 8, 0})
+    ->Args({16, 1000, 8, 0})
+    ->Args({128, 1000, 8, 0})
+    ->Args({1024, 1000, 8, 0})
+    ->Args({128, 100, 12, 0})
+    ->Args({128, 1000, 6, 0})
+    ->Args({128, 1000, 6, 1})
+    ->Args({1024, 1000, 6, 0})
+    ->Args({1024, 1000, 6, 1})
+    ->Args({1024, 1000, 4, 0})
+    ->Args({1024, 1000, 4, 1});
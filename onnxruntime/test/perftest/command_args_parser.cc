@@ -27,8 +27,15 @@ namespace perftest {
   printf(
       "perf_test [options...] model_path [result_file]\n"
       "Options:\n"
-      "\t-m [test_mode]: Specifies the test mode. Value could be 'duration' or 'times'.\n"
+      "\t-m [test_mode]: Specifies the test mode. Value could be 'duration', 'times' or 'rate'.\n"
       "\t\tProvide 'duration' to run the test for a fix duration, and 'times' to repeated for a certain times. \n"
+      "\t\tProvide 'rate' to send requests at a target rate for the duration set with -t, whether or not the previous\n"
+      "\t\trequests completed. Latencies include the time requests wait for one of the -c concurrent runs.\n"
+      "\t-R [requests_per_second]: Specifies the request rate for 'rate' mode. Default: estimated from a single run.\n"
+      "\t-a [poisson|constant]: Specifies the arrival of the requests in 'rate' mode. Default:'poisson'.\n"
+      "\t-L [latency_slo_ms]: Searches for the maximum request rate whose latency meets the SLO in 'rate' mode.\n"
+      "\t\tEach rate tried runs for the duration set with -t.\n"
+      "\t-Q [percentile]: Specifies the latency percentile the SLO of -L applies to. Default:99.\n"
       "\t-M: Disable memory pattern.\n"
       "\t-A: Disable memory arena\n"
       "\t-I: Generate tensor input binding (Free dimensions are treated as 1.)\n"
@@ -45,6 +52,7 @@ namespace perftest {
       "\t-x [intra_op_num_threads]: Sets the number of threads used to parallelize the execution within nodes, A value of 0 means ORT will pick a default. Must >=0.\n"
       "\t-y [inter_op_num_threads]: Sets the number of threads used to parallelize the execution of the graph (across nodes), A value of 0 means ORT will pick a default. Must >=0.\n"
       "\t-P: Use parallel executor instead of sequential executor.\n"
+      "\t-S: Run the test with the sequential executor and then with the parallel executor and compare the latencies.\n"
       "\t-o [optimization level]: Default is 1. Valid values are 0 (disable), 1 (basic), 2 (extended), 99 (all).\n"
       "\t\tPlease see onnxruntime_c_api.h (enum GraphOptimizationLevel) for the full list of all optimization levels.\n"
       "\t-u [optimized_model_path]: Specify the optimized model path for saving.\n"
@@ -56,17 +64,48 @@ namespace perftest {
 
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:d:o:u:AMPIvhsqz"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:d:o:u:R:a:L:Q:AMPSIvhsqz"))) != -1) {
     switch (ch) {
       case 'm':
         if (!CompareCString(optarg, ORT_TSTR("duration"))) {
           test_config.run_config.test_mode = TestMode::kFixDurationMode;
         } else if (!CompareCString(optarg, ORT_TSTR("times"))) {
           test_config.run_config.test_mode = TestMode::KFixRepeatedTimesMode;
+        } else if (!CompareCString(optarg, ORT_TSTR("rate"))) {
+          test_config.run_config.test_mode = TestMode::kFixRateMode;
         } else {
           return false;
         }
         break;
+      case 'R':
+        test_config.run_config.request_rate = OrtStrtod<PATH_CHAR_TYPE>(optarg, nullptr);
+        if (test_config.run_config.request_rate <= 0) {
+          return false;
+        }
+        test_config.run_config.test_mode = TestMode::kFixRateMode;
+        break;
+      case 'a':
+        if (!CompareCString(optarg, ORT_TSTR("poisson"))) {
+          test_config.run_config.arrival_distribution = ArrivalDistribution::kPoisson;
+        } else if (!CompareCString(optarg, ORT_TSTR("constant"))) {
+          test_config.run_config.arrival_distribution = ArrivalDistribution::kConstant;
+        } else {
+          return false;
+        }
+        break;
+      case 'L':
+        test_config.run_config.latency_slo_ms = OrtStrtod<PATH_CHAR_TYPE>(optarg, nullptr);
+        if (test_config.run_config.latency_slo_ms <= 0) {
+          return false;
+        }
+        test_config.run_config.test_mode = TestMode::kFixRateMode;
+        break;
+      case 'Q':
+        test_config.run_config.slo_percentile = OrtStrtod<PATH_CHAR_TYPE>(optarg, nullptr);
+        if (test_config.run_config.slo_percentile <= 0 || test_config.run_config.slo_percentile > 100) {
+          return false;
+        }
+        break;
       case 'b':
         test_config.backend = optarg;
         break;
@@ -142,6 +181,9 @@ namespace perftest {
       case 'P':
         test_config.run_config.execution_mode = ExecutionMode::ORT_PARALLEL;
         break;
+      case 'S':
+        test_config.run_config.compare_execution_modes = true;
+        break;
       case 'c':
         test_config.run_config.concurrent_session_runs =
             static_cast<size_t>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+
+namespace onnxruntime {
+namespace perftest {
+
+// Values below kSubBucketCount microseconds get a bucket each. Above that, the values in [2^k, 2^(k+1)) are split in
+// kSubBucketHalfCount buckets of equal width, i.e. a value is shifted right until it's below kSubBucketCount and the
+// shift selects the group of buckets.
+size_t LatencyHistogram::BucketIndex(uint64_t value) {
+  if (value < kSubBucketCount) {
+    return static_cast<size_t>(value);
+  }
+
+  int shift = 0;
+  while ((value >> shift) >= kSubBucketCount) {
+    ++shift;
+  }
+  return static_cast<size_t>(shift * kSubBucketHalfCount + (value >> shift));
+}
+
+uint64_t LatencyHistogram::BucketHighestValue(size_t index) {
+  if (index < kSubBucketCount) {
+    return index;
+  }
+
+  const uint64_t shift = (index - kSubBucketHalfCount) / kSubBucketHalfCount;
+  const uint64_t sub_bucket = index - shift * kSubBucketHalfCount;
+  return ((sub_bucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(double seconds) {
+  const uint64_t microseconds = static_cast<uint64_t>(std::max(0.0, std::round(seconds * 1e6)));
+  const size_t index = BucketIndex(microseconds);
+  if (index >= buckets_.size()) {
+    buckets_.resize(index + 1);
+  }
+  ++buckets_[index];
+
+  min_ = count_ == 0 ? seconds : std::min(min_, seconds);
+  max_ = std::max(max_, seconds);
+  sum_ += seconds;
+  ++count_;
+}
+
+double LatencyHistogram::Percentile(double percentile) const {
+  if (count_ == 0) {
+    return 0.0;
+  }
+
+  const double clamped = std::min(100.0, std::max(0.0, percentile));
+  const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * count_)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < buckets_.size(); ++i) {
+    seen += buckets_[i];
+    if (seen >= target) {
+      // The bucket can extend past the largest recorded value.
+      return std::min(max_, BucketHighestValue(i) / 1e6);
+    }
+  }
+  return max_;
+}
+
+void LatencyHistogram::Print(std::ostream& ostream) const {
+  ostream << "Requests: " << count_ << "\n"
+          << "Mean Latency: " << Mean() * 1000 << " ms\n"
+          << "P50 Latency: " << Percentile(50) * 1000 << " ms\n"
+          << "P90 Latency: " << Percentile(90) * 1000 << " ms\n"
+          << "P99 Latency: " << Percentile(99) * 1000 << " ms\n"
+          << "P999 Latency: " << Percentile(99.9) * 1000 << " ms\n"
+          << "Max Latency: " << Max() * 1000 << " ms" << std::endl;
+}
+
+}  // namespace perftest
+}  // namespace onnxruntime
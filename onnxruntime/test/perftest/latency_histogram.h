@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace onnxruntime {
+namespace perftest {
+
+// Histogram of latencies with HDR style buckets: values are recorded in microseconds into buckets whose width grows
+// with the magnitude of the value, so every recorded value is within 1/kSubBucketHalfCount of the bucket it's
+// reported as, from microseconds to hours, with a few thousand buckets. Not thread safe.
+class LatencyHistogram {
+ public:
+  void Record(double seconds);
+
+  // Returns the highest latency, in seconds, of the bucket the given percentile (0-100) falls in.
+  double Percentile(double percentile) const;
+
+  size_t Count() const { return count_; }
+  double Mean() const { return count_ == 0 ? 0.0 : sum_ / count_; }
+  double Min() const { return count_ == 0 ? 0.0 : min_; }
+  double Max() const { return max_; }
+
+  // Prints the count, mean and the P50, P90, P99, P99.9 and max latencies in milliseconds.
+  void Print(std::ostream& ostream) const;
+
+ private:
+  static constexpr int kSubBucketBits = 8;
+  static constexpr uint64_t kSubBucketCount = uint64_t{1} << kSubBucketBits;
+  static constexpr uint64_t kSubBucketHalfCount = kSubBucketCount / 2;
+
+  static size_t BucketIndex(uint64_t value);
+  static uint64_t BucketHighestValue(size_t index);
+
+  std::vector<uint64_t> buckets_;
+  size_t count_{0};
+  double sum_{0.0};
+  double min_{0.0};
+  double max_{0.0};
+};
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -3,7 +3,9 @@
 
 // onnxruntime dependencies
 #include <core/session/onnxruntime_c_api.h>
+#include <algorithm>
 #include <random>
+#include <vector>
 #include "command_args_parser.h"
 #include "performance_runner.h"
 #include <google/protobuf/stubs/common.h>
@@ -11,6 +13,52 @@
 using namespace onnxruntime;
 const OrtApi* g_ort = NULL;
 
+// Runs the test with the sequential executor and with the parallel executor and prints the latencies of both.
+// Models with independent branches, e.g. multi-branch CNNs or ensembles, are expected to benefit from the
+// parallel executor.
+static int CompareExecutionModes(Ort::Env& env, const perftest::PerformanceTestConfig& test_config,
+                                 std::random_device& rd) {
+  const ExecutionMode execution_modes[] = {ExecutionMode::ORT_SEQUENTIAL, ExecutionMode::ORT_PARALLEL};
+  const char* execution_mode_names[] = {"sequential", "parallel"};
+  double average_latencies[2] = {};
+  double p90_latencies[2] = {};
+
+  for (size_t i = 0; i < 2; ++i) {
+    perftest::PerformanceTestConfig mode_config = test_config;
+    mode_config.run_config.execution_mode = execution_modes[i];
+    printf("Running with the %s executor\n", execution_mode_names[i]);
+
+    perftest::PerformanceRunner perf_runner(env, mode_config, rd);
+    auto status = perf_runner.Run();
+    if (!status.IsOK()) {
+      printf("Run failed:%s\n", status.ErrorMessage().c_str());
+      return -1;
+    }
+
+    perf_runner.SerializeResult();
+
+    const auto& result = perf_runner.GetResult();
+    if (result.time_costs.empty()) {
+      printf("No runs were completed with the %s executor\n", execution_mode_names[i]);
+      return -1;
+    }
+
+    std::vector<double> sorted_time = result.time_costs;
+    std::sort(sorted_time.begin(), sorted_time.end());
+    average_latencies[i] = result.total_time_cost / result.time_costs.size() * 1000;
+    p90_latencies[i] = sorted_time[static_cast<size_t>(sorted_time.size() * 0.9)] * 1000;
+  }
+
+  printf("\nExecutor comparison:\n");
+  for (size_t i = 0; i < 2; ++i) {
+    printf("%-10s average latency: %.4f ms, P90 latency: %.4f ms\n", execution_mode_names[i], average_latencies[i],
+           p90_latencies[i]);
+  }
+  printf("Parallel executor speedup: %.2fx\n", average_latencies[0] / average_latencies[1]);
+
+  return 0;
+}
+
 #ifdef _WIN32
 int real_main(int argc, wchar_t* argv[]) {
 #else
@@ -47,12 +95,18 @@ int real_main(int argc, char* argv[]) {
       fprintf(stderr, "OpenVINO doesn't support more than 1 session running simultaneously default value of 1 will be set \n");
       test_config.run_config.concurrent_session_runs = 1;
     }
-    if (test_config.run_config.execution_mode == ExecutionMode::ORT_PARALLEL) {
+    if (test_config.run_config.execution_mode == ExecutionMode::ORT_PARALLEL ||
+        test_config.run_config.compare_execution_modes) {
       fprintf(stderr, "OpenVINO doesn't support parallel executor using sequential executor\n");
       test_config.run_config.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+      test_config.run_config.compare_execution_modes = false;
     }
   }
   std::random_device rd;
+  if (test_config.run_config.compare_execution_modes) {
+    return CompareExecutionModes(env, test_config, rd);
+  }
+
   perftest::PerformanceRunner perf_runner(env, test_config, rd);
   auto status = perf_runner.Run();
   if (!status.IsOK()) {
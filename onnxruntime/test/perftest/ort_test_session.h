@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <core/platform/ort_mutex.h>
 #include <core/session/onnxruntime_cxx_api.h>
 #include <random>
 #include "test_configuration.h"
@@ -38,6 +39,7 @@ class OnnxRuntimeTestSession : public TestSession {
 
  private:
   Ort::Session session_{nullptr};
+  OrtMutex rand_mutex_;
   std::mt19937 rand_engine_;
   std::uniform_int_distribution<int> dist_;
   std::vector<std::vector<Ort::Value>> test_inputs_;
@@ -7,7 +7,10 @@
 #endif
 
 #include "performance_runner.h"
+#include <deque>
 #include <iostream>
+#include <numeric>
+#include <thread>
 
 #include "TestCase.h"
 #include "TFModelInfo.h"
@@ -119,6 +122,9 @@ Status PerformanceRunner::Run() {
     case TestMode::KFixRepeatedTimesMode:
       ORT_RETURN_IF_ERROR(RepeatedTimesTest());
       break;
+    case TestMode::kFixRateMode:
+      ORT_RETURN_IF_ERROR(FixRateTest());
+      break;
     default:
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
   }
@@ -230,6 +236,177 @@ Status PerformanceRunner::ForkJoinRepeat() {
   return Status::OK();
 }
 
+Status PerformanceRunner::FixRateTest() {
+  const auto& run_config = performance_test_config_.run_config;
+  const double request_rate = run_config.request_rate > 0 ? run_config.request_rate : EstimateRequestRate();
+
+  FixRateResult result;
+  if (run_config.latency_slo_ms > 0) {
+    ORT_RETURN_IF_ERROR(FindMaxRateMeetingSlo(request_rate, result));
+  } else {
+    ORT_RETURN_IF_ERROR(RunFixRate(request_rate, result));
+    std::cout << "Request rate: " << request_rate << " requests/s\n"
+              << "Completed rate: " << result.completed_rate << " requests/s\n";
+    result.histogram.Print(std::cout);
+  }
+
+  performance_result_.total_time_cost = std::accumulate(result.latencies.begin(), result.latencies.end(), 0.0);
+  performance_result_.time_costs = std::move(result.latencies);
+  return Status::OK();
+}
+
+// Estimates the rate the concurrent runs can sustain from the latency of a few requests run one after the other.
+double PerformanceRunner::EstimateRequestRate() {
+  constexpr int kRuns = 5;
+  double total_seconds = 0;
+  for (int i = 0; i < kRuns; ++i) {
+    total_seconds += session_->Run().count();
+  }
+  const double request_rate = performance_test_config_.run_config.concurrent_session_runs * kRuns / total_seconds;
+  std::cout << "Estimated request rate: " << request_rate << " requests/s" << std::endl;
+  return request_rate;
+}
+
+// Sends requests at request_rate for the configured duration. Requests are queued and served by
+// concurrent_session_runs threads, so a request that arrives while all of them are busy waits, and the wait is part of
+// its latency. Arrivals don't depend on completions (open loop) so queueing delays aren't hidden as they are when each
+// thread sends its next request once the previous one completed.
+Status PerformanceRunner::RunFixRate(double request_rate, FixRateResult& result) {
+  using Clock = std::chrono::steady_clock;
+  const auto& run_config = performance_test_config_.run_config;
+
+  std::deque<Clock::time_point> arrivals;
+  bool done = false;
+  Status status;
+  OrtMutex m;
+  OrtCondVar cv;
+
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i != run_config.concurrent_session_runs; ++i) {
+    workers.emplace_back([this, &arrivals, &done, &status, &m, &cv, &result]() {
+      for (;;) {
+        Clock::time_point arrival;
+        {
+          std::unique_lock<OrtMutex> lock(m);
+          cv.wait(lock, [&arrivals, &done]() { return done || !arrivals.empty(); });
+          if (arrivals.empty()) {
+            return;
+          }
+          arrival = arrivals.front();
+          arrivals.pop_front();
+        }
+
+        auto run_status = Status::OK();
+        ORT_TRY {
+          session_->Run();
+        }
+        ORT_CATCH(const std::exception& ex) {
+          ORT_HANDLE_EXCEPTION([&]() {
+            run_status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "PerformanceRunner::RunFixRate caught exception: ", ex.what());
+          });
+        }
+        const std::chrono::duration<double> latency = Clock::now() - arrival;
+
+        std::lock_guard<OrtMutex> guard(results_mutex_);
+        if (!run_status.IsOK()) {
+          if (status.IsOK()) {
+            status = run_status;
+          }
+          continue;
+        }
+        result.histogram.Record(latency.count());
+        result.latencies.push_back(latency.count());
+      }
+    });
+  }
+
+  std::mt19937 rand_engine{std::random_device{}()};
+  std::exponential_distribution<double> inter_arrival_seconds(request_rate);
+  const auto start = Clock::now();
+  const auto end = start + std::chrono::duration_cast<Clock::duration>(
+                               std::chrono::duration<double>(run_config.duration_in_seconds));
+  auto arrival = start;
+  for (size_t request = 1; arrival < end; ++request) {
+    // Requests that are due while the previous ones were queued are sent right away, still timed from when they
+    // were due.
+    std::this_thread::sleep_until(arrival);
+    {
+      std::lock_guard<OrtMutex> lock(m);
+      arrivals.push_back(arrival);
+    }
+    cv.notify_one();
+
+    if (run_config.arrival_distribution == ArrivalDistribution::kPoisson) {
+      arrival += std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(inter_arrival_seconds(rand_engine)));
+    } else {
+      arrival = start + std::chrono::duration_cast<Clock::duration>(
+                            std::chrono::duration<double>(request / request_rate));
+    }
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(m);
+    done = true;
+  }
+  cv.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  const std::chrono::duration<double> elapsed = Clock::now() - start;
+  result.completed_rate = result.latencies.size() / elapsed.count();
+  return status;
+}
+
+// Doubles the request rate until the latency SLO is violated, then bisects between the highest rate that met it and
+// the lowest rate that violated it until they are within 5% of each other.
+Status PerformanceRunner::FindMaxRateMeetingSlo(double initial_rate, FixRateResult& result) {
+  constexpr int kMaxProbes = 20;
+  constexpr double kTolerance = 0.05;
+  const auto& run_config = performance_test_config_.run_config;
+  const double slo_seconds = run_config.latency_slo_ms / 1000;
+
+  double met_rate = 0;
+  double violated_rate = 0;
+  double request_rate = initial_rate;
+  for (int probe = 0; probe < kMaxProbes; ++probe) {
+    FixRateResult probe_result;
+    ORT_RETURN_IF_ERROR(RunFixRate(request_rate, probe_result));
+
+    const double latency = probe_result.histogram.Percentile(run_config.slo_percentile);
+    const bool meets_slo = latency <= slo_seconds;
+    std::cout << "Request rate: " << request_rate << " requests/s, completed rate: " << probe_result.completed_rate
+              << " requests/s, P" << run_config.slo_percentile << " latency: " << latency * 1000 << " ms, SLO "
+              << (meets_slo ? "met" : "violated") << std::endl;
+
+    if (meets_slo) {
+      met_rate = request_rate;
+      result = std::move(probe_result);
+    } else {
+      violated_rate = request_rate;
+    }
+
+    if (violated_rate == 0) {
+      request_rate *= 2;
+    } else if (violated_rate - met_rate <= kTolerance * violated_rate) {
+      break;
+    } else {
+      request_rate = (met_rate + violated_rate) / 2;
+    }
+  }
+
+  if (met_rate == 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "no request rate met the P", run_config.slo_percentile,
+                           " latency SLO of ", run_config.latency_slo_ms, " ms");
+  }
+
+  std::cout << "\nMaximum request rate meeting the SLO: " << met_rate << " requests/s\n"
+            << "Completed rate: " << result.completed_rate << " requests/s\n";
+  result.histogram.Print(std::cout);
+  return Status::OK();
+}
+
 static std::unique_ptr<TestModelInfo> CreateModelInfo(const PerformanceTestConfig& performance_test_config_) {
   if (CompareCString(performance_test_config_.backend.c_str(), ORT_TSTR("ort")) == 0) {
     const auto& file_path = performance_test_config_.model_info.model_file_path;
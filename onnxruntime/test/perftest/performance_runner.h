@@ -18,6 +18,7 @@
 #include <core/session/onnxruntime_cxx_api.h>
 #include "test_configuration.h"
 #include "heap_buffer.h"
+#include "latency_histogram.h"
 #include "test_session.h"
 #include "OrtValueList.h"
 
@@ -84,10 +85,21 @@ class PerformanceRunner {
     return Status::OK();
   }
 
+  // Latencies of the requests sent at a fixed rate, from the time each request was due to its completion.
+  struct FixRateResult {
+    LatencyHistogram histogram;
+    std::vector<double> latencies;
+    double completed_rate{0};
+  };
+
   Status FixDurationTest();
   Status RepeatedTimesTest();
+  Status FixRateTest();
   Status ForkJoinRepeat();
   Status RunParallelDuration();
+  Status RunFixRate(double request_rate, FixRateResult& result);
+  Status FindMaxRateMeetingSlo(double initial_rate, FixRateResult& result);
+  double EstimateRequestRate();
 
   inline Status RunFixDuration() {
     while (performance_result_.total_time_cost < performance_test_config_.run_config.duration_in_seconds) {
@@ -14,7 +14,14 @@ namespace perftest {
 
 enum class TestMode : std::uint8_t {
   kFixDurationMode = 0,
-  KFixRepeatedTimesMode
+  KFixRepeatedTimesMode,
+  // open loop: requests arrive at a target rate regardless of how many are in flight
+  kFixRateMode
+};
+
+enum class ArrivalDistribution : std::uint8_t {
+  kPoisson = 0,
+  kConstant
 };
 
 enum class Platform : std::uint8_t {
@@ -40,12 +47,20 @@ struct RunConfig {
   size_t repeated_times{1000};
   size_t duration_in_seconds{600};
   size_t concurrent_session_runs{1};
+  // requests per second in kFixRateMode. 0 means it's estimated from the latency of a single request.
+  double request_rate{0};
+  ArrivalDistribution arrival_distribution{ArrivalDistribution::kPoisson};
+  // when > 0 in kFixRateMode, search for the maximum request rate whose slo_percentile latency is within the SLO
+  double latency_slo_ms{0};
+  double slo_percentile{99.0};
   bool f_dump_statistics{false};
   bool f_verbose{false};
   bool enable_memory_pattern{true};
   bool enable_cpu_mem_arena{true};
   bool generate_model_input_binding{false};
   ExecutionMode execution_mode{ExecutionMode::ORT_SEQUENTIAL};
+  // run the test with the sequential and the parallel executor and compare the latencies
+  bool compare_execution_modes{false};
   int intra_op_num_threads{0};
   int inter_op_num_threads{0};
   GraphOptimizationLevel optimization_level{ORT_ENABLE_ALL};
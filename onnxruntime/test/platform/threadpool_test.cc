@@ -4,6 +4,8 @@
 #include "core/platform/threadpool.h"
 #include "core/platform/EigenNonBlockingThreadPool.h"
 #include "core/platform/ort_mutex.h"
+#include "core/util/thread_utils.h"
+#include "test/util/include/asserts.h"
 
 #include <core/common/make_unique.h>
 
@@ -11,6 +13,8 @@
 #include <algorithm>
 #include <memory>
 #include <functional>
+#include <set>
+#include <thread>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -43,8 +47,9 @@ void ValidateTestData(TestData& test_data) {
   ASSERT_TRUE(std::count_if(test_data.data.cbegin(), test_data.data.cend(), [](int i) { return i != 1; }) == 0);
 }
 
-void CreateThreadPoolAndTest(const std::string&, int num_threads, const std::function<void(ThreadPool*)>& test_body) {
-  auto tp = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions(), nullptr,
+void CreateThreadPoolAndTest(const std::string&, int num_threads, const std::function<void(ThreadPool*)>& test_body,
+                             const onnxruntime::ThreadOptions& thread_options = onnxruntime::ThreadOptions()) {
+  auto tp = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), thread_options, nullptr,
                                                  num_threads, true);
   test_body(tp.get());
 }
@@ -67,6 +72,21 @@ void TestBatchParallelFor(const std::string& name, int num_threads, int num_task
   ValidateTestData(*test_data);
 }
 
+void TestDynamicBatchParallelFor(const std::string& name, int num_threads, int num_tasks, int batch_size,
+                                 int dynamic_block_base) {
+  auto test_data = CreateTestData(num_tasks);
+  onnxruntime::ThreadOptions thread_options;
+  thread_options.dynamic_block_base = dynamic_block_base;
+
+  CreateThreadPoolAndTest(
+      name, num_threads, [&](ThreadPool* tp) {
+        onnxruntime::concurrency::ThreadPool::TryBatchParallelFor(
+            tp, num_tasks, [&](ptrdiff_t i) { IncrementElement(*test_data, i); }, batch_size);
+      },
+      thread_options);
+  ValidateTestData(*test_data);
+}
+
 void TestMultipleParallelFor(const std::string& name, int num_threads, int num_concurrent, int num_tasks) {
   // Test running multiple concurrent loops over the same thread pool.  This aims to provoke a
   // more diverse mix of interleavings than with a single loop running at a time.
@@ -161,9 +181,46 @@ void TestPoolCreation(const std::string&, int iter) {
   ASSERT_EQ(ctr, iter * per_iter);
 }
 
+void TestParallelismLimit(const std::string& name, int num_threads, int limit) {
+  const int num_tasks = 1000;
+  auto test_data = CreateTestData(num_tasks);
+  std::set<std::thread::id> thread_ids;
+  CreateThreadPoolAndTest(name, num_threads, [&](ThreadPool* tp) {
+    const int d_of_p = ThreadPool::DegreeOfParallelism(tp);
+    {
+      ThreadPool::ScopedParallelismLimit parallelism_limit(limit);
+      ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp), std::min(limit, d_of_p));
+
+      // expensive enough iterations for the cost model to use every thread it is allowed to
+      ThreadPool::TryParallelFor(tp, num_tasks, onnxruntime::TensorOpCost{0, 0, 1e6},
+                                 [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+                                   for (std::ptrdiff_t i = first; i < last; ++i) {
+                                     IncrementElement(*test_data, i);
+                                   }
+                                   std::lock_guard<onnxruntime::OrtMutex> lock(test_data->mutex);
+                                   thread_ids.insert(std::this_thread::get_id());
+                                 });
+    }
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp), d_of_p);
+  });
+  ValidateTestData(*test_data);
+  ASSERT_LE(thread_ids.size(), static_cast<size_t>(limit));
+  if (limit == 1) {
+    ASSERT_EQ(*thread_ids.begin(), std::this_thread::get_id());
+  }
+}
+
 }  // namespace
 
 namespace onnxruntime {
+TEST(ThreadPoolTest, TestParallelismLimit_4_Thread_Limit_1) {
+  TestParallelismLimit("TestParallelismLimit_4_Thread_Limit_1", 4, 1);
+}
+
+TEST(ThreadPoolTest, TestParallelismLimit_4_Thread_Limit_2) {
+  TestParallelismLimit("TestParallelismLimit_4_Thread_Limit_2", 4, 2);
+}
+
 TEST(ThreadPoolTest, TestParallelFor_2_Thread_NoTask) {
   TestParallelFor("TestParallelFor_2_Thread_NoTask", 2, 0);
 }
@@ -196,6 +253,19 @@ TEST(ThreadPoolTest, TestBatchParallelFor_2_Thread_81_Task_20_Batch) {
   TestBatchParallelFor("TestBatchParallelFor_2_Thread_81_Task_20_Batch", 2, 81, 20);
 }
 
+TEST(ThreadPoolTest, TestDynamicBatchParallelFor_4_Thread_1000_Task_0_Batch) {
+  TestDynamicBatchParallelFor("TestDynamicBatchParallelFor_4_Thread_1000_Task_0_Batch", 4, 1000, 0, 4);
+}
+
+TEST(ThreadPoolTest, TestDynamicBatchParallelFor_4_Thread_81_Task_2_Batch) {
+  TestDynamicBatchParallelFor("TestDynamicBatchParallelFor_4_Thread_81_Task_2_Batch", 4, 81, 2, 4);
+}
+
+TEST(ThreadPoolTest, TestDynamicBatchParallelFor_2_Thread_5_Task_4_Batch) {
+  // more blocks than iterations
+  TestDynamicBatchParallelFor("TestDynamicBatchParallelFor_2_Thread_5_Task_4_Batch", 2, 5, 4, 8);
+}
+
 TEST(ThreadPoolTest, TestMultipleParallelFor_1Thread_1Conc_0Tasks) {
   TestMultipleParallelFor("TestMultipleParallelFor_1Thread_1Conc_0Tasks", 1, 1, 0);
 }
@@ -319,4 +389,93 @@ TEST(ThreadPoolTest, TestStackSize) {
 }
 #endif
 
+TEST(ThreadPoolTest, TestSetThreadAffinity) {
+  const auto& env = onnxruntime::Env::Default();
+
+  OrtThreadPoolParams params;
+  params.auto_set_affinity = true;
+  ASSERT_STATUS_OK(SetThreadAffinity(env, "", params));
+  EXPECT_TRUE(params.auto_set_affinity);
+  ASSERT_STATUS_OK(SetThreadAffinity(env, "none", params));
+  EXPECT_FALSE(params.auto_set_affinity);
+  EXPECT_TRUE(params.affinity.empty());
+
+  EXPECT_FALSE(SetThreadAffinity(env, "3-1", params).IsOK());
+  EXPECT_FALSE(SetThreadAffinity(env, "0,x", params).IsOK());
+  EXPECT_FALSE(SetThreadAffinity(env, "numa:x", params).IsOK());
+
+  const auto cores = env.GetPhysicalCoreProcessors(-1);
+  if (cores.empty()) {
+    // the topology is unknown on this platform
+    EXPECT_FALSE(SetThreadAffinity(env, "physical", params).IsOK());
+    return;
+  }
+
+  ASSERT_STATUS_OK(SetThreadAffinity(env, "physical", params));
+  ASSERT_EQ(params.affinity.size(), cores.size());
+  for (size_t i = 0; i < cores.size(); ++i) {
+    EXPECT_EQ(params.affinity[i], cores[i].front());
+  }
+
+  const std::string setting = std::to_string(cores.front().front());
+  params.affinity.clear();
+  ASSERT_STATUS_OK(SetThreadAffinity(env, setting + "-" + setting, params));
+  EXPECT_EQ(params.affinity, std::vector<size_t>{cores.front().front()});
+
+  // every processor the process may run on is on some NUMA node, so node 0 usually exists
+  const auto node_cores = env.GetPhysicalCoreProcessors(0);
+  if (!node_cores.empty()) {
+    ASSERT_STATUS_OK(SetThreadAffinity(env, "numa:0:physical", params));
+    EXPECT_EQ(params.affinity.size(), node_cores.size());
+  }
+}
+
+TEST(ThreadPoolTest, TestPinnedThreadPool) {
+  // a pool pinned to the processors of the first core runs loops like any other pool
+  const auto cores = onnxruntime::Env::Default().GetPhysicalCoreProcessors(-1);
+  if (cores.empty()) {
+    return;
+  }
+
+  OrtThreadPoolParams params;
+  params.thread_pool_size = 3;
+  ASSERT_STATUS_OK(SetThreadAffinity(onnxruntime::Env::Default(), std::to_string(cores.front().front()), params));
+  auto tp = CreateThreadPool(&onnxruntime::Env::Default(), params, ThreadPoolType::INTRA_OP);
+  ASSERT_NE(tp, nullptr);
+
+  auto test_data = CreateTestData(100);
+  tp->SimpleParallelFor(100, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+  ValidateTestData(*test_data);
+}
+
+TEST(ThreadPoolTest, TestSingleProcessorAffinity) {
+  // a one-entry list gives a pool of one thread, which runs its work on the unpinned calling thread
+  OrtThreadPoolParams params;
+  params.affinity = {0};
+  EXPECT_THROW(CreateThreadPool(&onnxruntime::Env::Default(), params, ThreadPoolType::INTER_OP),
+               OnnxRuntimeException);
+
+  params.thread_pool_size = 1;
+  params.affinity = {0, 1};
+  EXPECT_THROW(CreateThreadPool(&onnxruntime::Env::Default(), params, ThreadPoolType::INTER_OP),
+               OnnxRuntimeException);
+
+  // listing the processor twice gives a pool of two threads, whose one created thread is pinned to it
+  const auto cores = onnxruntime::Env::Default().GetPhysicalCoreProcessors(-1);
+  if (cores.empty()) {
+    return;
+  }
+
+  params.thread_pool_size = 0;
+  ASSERT_STATUS_OK(SetThreadAffinity(onnxruntime::Env::Default(), std::to_string(cores.front().front()) + "," +
+                                                                      std::to_string(cores.front().front()),
+                                     params));
+  auto tp = CreateThreadPool(&onnxruntime::Env::Default(), params, ThreadPoolType::INTER_OP);
+  ASSERT_NE(tp, nullptr);
+
+  auto test_data = CreateTestData(100);
+  tp->SimpleParallelFor(100, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+  ValidateTestData(*test_data);
+}
+
 }  // namespace onnxruntime
@@ -4,6 +4,8 @@
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
+#include "core/framework/prepacked_weights_container.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 
 namespace onnxruntime {
 namespace test {
@@ -302,6 +304,94 @@ TEST(GemmOpTest, GemmNoBiasOpset11) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kNGraphExecutionProvider, kTensorrtExecutionProvider});
 }
 
+// B is pre-packed by the CPU kernel when it is an initializer
+TEST(GemmOpTest, GemmTransABIsInitializerNoBias) {
+  OpTester test("Gemm", 11);
+
+  test.AddAttribute("transA", static_cast<int64_t>(1));
+  test.AddAttribute("transB", static_cast<int64_t>(1));
+  test.AddAttribute("alpha", 2.0f);
+
+  test.AddInput<float>("A", {4, 2},
+                       {1.0f, -1.0f,
+                        2.0f, -2.0f,
+                        3.0f, -3.0f,
+                        4.0f, -4.0f});
+  test.AddInput<float>("B", {3, 4},
+                       {1.0f, 2.0f, 3.0f, 4.0f,
+                        5.0f, 6.0f, 7.0f, 8.0f,
+                        9.0f, 10.0f, 11.0f, 12.0f},
+                       true);
+  test.AddOutput<float>("Y", {2, 3},
+                        {60.0f, 140.0f, 220.0f,
+                         -60.0f, -140.0f, -220.0f});
+  // NGraph and tensorRT don't seem to support missing bias
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kNGraphExecutionProvider, kTensorrtExecutionProvider});
+}
+
+// B is pre-packed in a half precision format when the CPU execution provider is configured for it. The weights and
+// inputs are small integers, which are exact in all formats, so the result matches the float result.
+// Returns the number of weights the session took from prepacked_weights_container.
+static size_t TestGemmHalfPackedB(GemmPackedBFormat format,
+                                  PrepackedWeightsContainer* prepacked_weights_container = nullptr) {
+  OpTester test("Gemm", 11);
+  test.SetPrePackedWeightsContainer(prepacked_weights_container);
+
+  test.AddAttribute("transA", static_cast<int64_t>(1));
+  test.AddAttribute("transB", static_cast<int64_t>(1));
+  test.AddAttribute("alpha", 2.0f);
+  test.AddAttribute("beta", 0.5f);
+
+  test.AddInput<float>("A", {4, 2},
+                       {1.0f, -1.0f,
+                        2.0f, -2.0f,
+                        3.0f, -3.0f,
+                        4.0f, -4.0f});
+  test.AddInput<float>("B", {3, 4},
+                       {1.0f, 2.0f, 3.0f, 4.0f,
+                        5.0f, 6.0f, 7.0f, 8.0f,
+                        9.0f, 10.0f, 11.0f, 12.0f},
+                       true);
+  test.AddInput<float>("C", {3}, {2.0f, 4.0f, 6.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {61.0f, 142.0f, 223.0f,
+                         -59.0f, -138.0f, -217.0f});
+
+  CPUExecutionProviderInfo info;
+  info.gemm_packed_b_format = format;
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(onnxruntime::make_unique<CPUExecutionProvider>(info));
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  return test.GetNumberOfSharedPrePackedWeights();
+}
+
+TEST(GemmOpTest, GemmFloat16PackedB) {
+  TestGemmHalfPackedB(GemmPackedBFormat::kFloat16);
+}
+
+TEST(GemmOpTest, GemmBFloat16PackedB) {
+  TestGemmHalfPackedB(GemmPackedBFormat::kBFloat16);
+}
+
+// sessions sharing a container only share B if their CPU execution providers pack it in the same format
+TEST(GemmOpTest, GemmSharedPrePackedBPerFormat) {
+  PrepackedWeightsContainer container;
+  const size_t shared_float16 = TestGemmHalfPackedB(GemmPackedBFormat::kFloat16, &container);
+  const size_t shared_float = TestGemmHalfPackedB(GemmPackedBFormat::kFloat, &container);
+  const size_t shared_float16_again = TestGemmHalfPackedB(GemmPackedBFormat::kFloat16, &container);
+
+#if !defined(USE_MKLML_FOR_BLAS)
+  EXPECT_EQ(shared_float16, 0u);
+  EXPECT_EQ(shared_float, 0u);
+  EXPECT_EQ(shared_float16_again, 1u);
+  EXPECT_EQ(container.NumberOfEntries(), 2u);
+#else
+  ORT_UNUSED_PARAMETER(shared_float16);
+  ORT_UNUSED_PARAMETER(shared_float);
+  ORT_UNUSED_PARAMETER(shared_float16_again);
+#endif
+}
+
 TEST(GemmOpTest, GemmWithAlphaOpset11) {
   OpTester test("Gemm", 11);
 
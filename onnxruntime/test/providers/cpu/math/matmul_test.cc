@@ -3,6 +3,7 @@
 
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 
 namespace onnxruntime {
 namespace test {
@@ -125,6 +126,31 @@ TEST(MathOpTest, MatMulFloatType) {
   RunMatMulTest<float>(7, true);
 }
 
+// MatMul with constant weights packed to half precision formats. The weights are small integers, which are exact in
+// all formats, so the result matches the float result.
+TEST(MathOpTest, MatMulFloatTypeHalfPackedB) {
+  for (auto format : {GemmPackedBFormat::kFloat16, GemmPackedBFormat::kBFloat16}) {
+    for (auto t : GenerateTestCases<float>()) {
+      OpTester test("MatMul", 7);
+      std::vector<float> common_input_vals{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+
+      int64_t size0 = TensorShape::ReinterpretBaseType(t.input0_dims).SizeHelper(0, t.input0_dims.size());
+      test.AddInput<float>("A", t.input0_dims,
+                           std::vector<float>(common_input_vals.cbegin(), common_input_vals.cbegin() + size0));
+      int64_t size1 = TensorShape::ReinterpretBaseType(t.input1_dims).SizeHelper(0, t.input1_dims.size());
+      test.AddInput<float>("B", t.input1_dims,
+                           std::vector<float>(common_input_vals.cbegin(), common_input_vals.cbegin() + size1), true);
+      test.AddOutput<float>("Y", t.expected_dims, t.expected_vals);
+
+      CPUExecutionProviderInfo info;
+      info.gemm_packed_b_format = format;
+      std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+      execution_providers.push_back(onnxruntime::make_unique<CPUExecutionProvider>(info));
+      test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+    }
+  }
+}
+
 TEST(MathOpTest, MatMulDoubleType) {
   RunMatMulTest<double>(7);
 }
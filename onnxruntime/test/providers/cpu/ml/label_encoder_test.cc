@@ -63,6 +63,38 @@ TEST(LabelEncoder, StringToIntOpset2) {
   test.Run();
 }
 
+// Enough keys and elements for the lookups to be split across threads, with a duplicated key.
+TEST(LabelEncoder, StringToIntManyOpset2) {
+  std::vector<std::string> keys;
+  std::vector<std::int64_t> values;
+  for (std::int64_t i = 0; i < 1000; ++i) {
+    keys.push_back("key_" + std::to_string(i));
+    values.push_back(3 * i);
+  }
+  // The last value of a duplicated key is used.
+  keys.push_back("key_0");
+  values.push_back(-7);
+
+  std::vector<std::string> input;
+  std::vector<std::int64_t> output;
+  for (std::int64_t i = 0; i < 20000; ++i) {
+    const std::int64_t key = (i * 7919) % 1200;
+    input.push_back("key_" + std::to_string(key));
+    output.push_back(key == 0 ? -7 : key < 1000 ? 3 * key : 5566);
+  }
+
+  OpTester test("LabelEncoder", 2, onnxruntime::kMLDomain);
+
+  test.AddAttribute("keys_strings", keys);
+  test.AddAttribute("values_int64s", values);
+  test.AddAttribute("default_int64", (std::int64_t)5566);
+
+  test.AddInput<std::string>("X", {20000}, input);
+  test.AddOutput<std::int64_t>("Y", {20000}, output);
+
+  test.Run();
+}
+
 TEST(LabelEncoder, IntToStringOpset2) {
   std::vector<std::int64_t> dims{1, 5};
 
@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -221,6 +224,72 @@ TEST(MLOpTest, SVMClassifierSVCDouble) {
   test.Run();
 }
 
+// Rows close to support vectors with large values, for which |x|^2 + |s|^2 - 2 x.s in float loses all the digits of
+// the distance. The scores must match the RBF kernel computed from x - s.
+TEST(MLOpTest, SVMClassifierSVCRBFLargeValues) {
+  OpTester test("SVMClassifier", 1, onnxruntime::kMLDomain);
+
+  const int64_t feature_count = 4;
+  const int64_t class_count = 3;
+  const float gamma = 0.5f;
+  std::vector<float> support_vectors = {10000.f, 20000.f, -30000.f, 40000.f,
+                                        10001.f, 20000.f, -30001.f, 40000.f,
+                                        10000.f, 20002.f, -30000.f, 40001.f};
+  std::vector<float> coefficients = {1.f, -0.5f, 0.75f,
+                                     -1.f, 0.5f, -0.25f};
+  std::vector<float> rho = {0.1f, -0.2f, 0.05f};
+  std::vector<float> kernel_params = {gamma, 0.f, 3.f};  //gamma, coef0, degree
+  std::vector<int64_t> classes = {0, 1, 2};
+  std::vector<int64_t> vectors_per_class = {1, 1, 1};
+
+  std::vector<float> X = {10000.25f, 20000.f, -30000.f, 40000.f,
+                          10001.f, 20000.5f, -30001.f, 40000.f,
+                          10000.f, 20002.f, -30000.f, 40001.f,
+                          10000.5f, 20001.f, -30000.5f, 40000.5f};
+  const int64_t n_rows = static_cast<int64_t>(X.size()) / feature_count;
+
+  // one support vector per class, so the score of classes i and j combines the kernels of support vectors i and j
+  std::vector<float> scores;
+  std::vector<int64_t> predictions;
+  for (int64_t n = 0; n < n_rows; ++n) {
+    double kernels[3];
+    for (int64_t v = 0; v < class_count; ++v) {
+      double distance = 0;
+      for (int64_t f = 0; f < feature_count; ++f) {
+        const double diff = static_cast<double>(X[n * feature_count + f]) - support_vectors[v * feature_count + f];
+        distance += diff * diff;
+      }
+      kernels[v] = std::exp(-gamma * distance);
+    }
+
+    int64_t votes[3] = {0, 0, 0};
+    int64_t classifier_idx = 0;
+    for (int64_t i = 0; i < class_count - 1; ++i) {
+      for (int64_t j = i + 1; j < class_count; ++j, ++classifier_idx) {
+        const double score = coefficients[(j - 1) * class_count + i] * kernels[i] +
+                             coefficients[i * class_count + j] * kernels[j] + rho[classifier_idx];
+        scores.push_back(static_cast<float>(score));
+        ++votes[score > 0 ? i : j];
+      }
+    }
+    predictions.push_back(std::max_element(votes, votes + class_count) - votes);
+  }
+
+  test.AddAttribute("kernel_type", std::string("RBF"));
+  test.AddAttribute("coefficients", coefficients);
+  test.AddAttribute("support_vectors", support_vectors);
+  test.AddAttribute("vectors_per_class", vectors_per_class);
+  test.AddAttribute("rho", rho);
+  test.AddAttribute("kernel_params", kernel_params);
+  test.AddAttribute("classlabels_ints", classes);
+
+  test.AddInput<float>("X", {n_rows, feature_count}, X);
+  test.AddOutput<int64_t>("Y", {n_rows}, predictions);
+  test.AddOutput<float>("Z", {n_rows, class_count}, scores);
+
+  test.Run();
+}
+
 TEST(MLOpTest, SVMClassifierLinear) {
   OpTester test("SVMClassifier", 1, onnxruntime::kMLDomain);
 
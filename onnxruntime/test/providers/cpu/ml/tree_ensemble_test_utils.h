@@ -0,0 +1,139 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// An ensemble of complete binary trees whose nodes test several features against small integer thresholds, and a
+// reference evaluation of it. The tree ensemble tests compare the traversal and the QuickScorer evaluations of the
+// kernels to it on inputs generated by GenerateTreeEnsembleInput.
+class TestTreeEnsemble {
+ public:
+  // mode is the mode of all the nodes which aren't leaves. If missing_tracks is true, a missing value goes to the
+  // true child of every other node.
+  TestTreeEnsemble(int64_t n_trees, int64_t depth, int64_t n_features,
+                   const std::string& mode = "BRANCH_LEQ", bool missing_tracks = false)
+      : mode_(mode), missing_tracks_(missing_tracks) {
+    for (int64_t tree = 0; tree < n_trees; ++tree) {
+      tree_begin_.push_back(nodeids_.size());
+      AddNode(tree, depth, n_features);
+    }
+  }
+
+  // Adds the nodes_* attributes of the ensemble to test.
+  void AddAttributes(OpTester& test) const {
+    test.AddAttribute("nodes_truenodeids", truenodeids_);
+    test.AddAttribute("nodes_falsenodeids", falsenodeids_);
+    test.AddAttribute("nodes_treeids", treeids_);
+    test.AddAttribute("nodes_nodeids", nodeids_);
+    test.AddAttribute("nodes_featureids", featureids_);
+    test.AddAttribute("nodes_values", values_);
+    test.AddAttribute("nodes_modes", modes_);
+    if (missing_tracks_) {
+      test.AddAttribute("nodes_missing_value_tracks_true", missing_value_tracks_true_);
+    }
+  }
+
+  size_t NumTrees() const { return tree_begin_.size(); }
+
+  // Leaves of the trees, the ones of a tree from its true side to its false side.
+  size_t NumLeaves() const { return leaf_treeids_.size(); }
+  int64_t LeafTreeId(size_t leaf) const { return leaf_treeids_[leaf]; }
+  int64_t LeafNodeId(size_t leaf) const { return leaf_nodeids_[leaf]; }
+
+  // Returns the leaf the row x ends in for the tree.
+  size_t FindLeaf(size_t tree, const float* x) const {
+    size_t node = tree_begin_[tree];
+    while (modes_[node] != "LEAF") {
+      const float value = x[featureids_[node]];
+      const bool condition = mode_ == "BRANCH_LEQ" ? value <= values_[node] : value < values_[node];
+      const bool track_true = condition || (missing_value_tracks_true_[node] != 0 && std::isnan(value));
+      node = tree_begin_[tree] + static_cast<size_t>(track_true ? truenodeids_[node] : falsenodeids_[node]);
+    }
+    return static_cast<size_t>(leaf_of_node_[node]);
+  }
+
+ private:
+  // Adds the subtree of the given depth in depth first order, returns the id of its root.
+  int64_t AddNode(int64_t tree, int64_t depth, int64_t n_features) {
+    const int64_t id = static_cast<int64_t>(nodeids_.size() - tree_begin_.back());
+    const size_t index = nodeids_.size();
+    treeids_.push_back(tree);
+    nodeids_.push_back(id);
+    featureids_.push_back(depth == 0 ? 0 : (tree * 3 + id) % n_features);
+    values_.push_back(depth == 0 ? 0.f : static_cast<float>((tree * 5 + id * 3) % 17 - 8));
+    modes_.push_back(depth == 0 ? "LEAF" : mode_);
+    missing_value_tracks_true_.push_back(depth != 0 && missing_tracks_ && id % 2 == 0 ? 1 : 0);
+    truenodeids_.push_back(0);
+    falsenodeids_.push_back(0);
+    if (depth == 0) {
+      leaf_of_node_.push_back(static_cast<int64_t>(leaf_treeids_.size()));
+      leaf_treeids_.push_back(tree);
+      leaf_nodeids_.push_back(id);
+      return id;
+    }
+
+    leaf_of_node_.push_back(-1);
+    const int64_t true_id = AddNode(tree, depth - 1, n_features);
+    const int64_t false_id = AddNode(tree, depth - 1, n_features);
+    truenodeids_[index] = true_id;
+    falsenodeids_[index] = false_id;
+    return id;
+  }
+
+  std::string mode_;
+  bool missing_tracks_;
+  std::vector<size_t> tree_begin_;
+  std::vector<int64_t> truenodeids_;
+  std::vector<int64_t> falsenodeids_;
+  std::vector<int64_t> treeids_;
+  std::vector<int64_t> nodeids_;
+  std::vector<int64_t> featureids_;
+  std::vector<float> values_;
+  std::vector<std::string> modes_;
+  std::vector<int64_t> missing_value_tracks_true_;
+  std::vector<int64_t> leaf_of_node_;
+  std::vector<int64_t> leaf_treeids_;
+  std::vector<int64_t> leaf_nodeids_;
+};
+
+// Generates n_rows rows of n_features values around the thresholds of TestTreeEnsemble, equal to some of them. Every
+// fifth row misses feature 1, and feature 0 is below all the thresholds for the rows 16 to 31, a whole block of
+// kRowBlockSize rows of the kernels, so the QuickScorer evaluation skips all the nodes of that feature for the block.
+inline std::vector<float> GenerateTreeEnsembleInput(int64_t n_rows, int64_t n_features) {
+  std::vector<float> X;
+  for (int64_t r = 0; r < n_rows; ++r) {
+    for (int64_t f = 0; f < n_features; ++f) {
+      float value = static_cast<float>((r * 7 + f * 5) % 19 - 9);
+      if (f == 0 && r >= 16 && r < 32) {
+        value = static_cast<float>(-9 - r % 3);
+      } else if (f == 1 && r % 5 == 0) {
+        value = std::numeric_limits<float>::quiet_NaN();
+      }
+      X.push_back(value);
+    }
+  }
+  return X;
+}
+
+// Runs test with the trees evaluated the given way.
+inline void RunWithTreeEnsembleEvaluation(OpTester& test, TreeEnsembleEvaluation evaluation) {
+  CPUExecutionProviderInfo info;
+  info.tree_ensemble_evaluation = evaluation;
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(onnxruntime::make_unique<CPUExecutionProvider>(info));
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -1,8 +1,11 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/providers/cpu/ml/tree_ensemble_test_utils.h"
 
 namespace onnxruntime {
 namespace test {
@@ -254,5 +257,75 @@ TEST(MLOpTest, TreeEnsembleClassifierBinaryProbabilities) {
   test.Run();
 }
 
+// Every leaf has a weight for each of the three classes. The weights are small integers so the scores are exact.
+static void RunTreeEnsembleClassifierEnsembleTest(const TestTreeEnsemble& trees, TreeEnsembleEvaluation evaluation) {
+  OpTester test("TreeEnsembleClassifier", 1, onnxruntime::kMLDomain);
+
+  const int64_t n_classes = 3;
+  const int64_t n_features = 4;
+  const int64_t n_rows = 40;
+  std::vector<int64_t> class_treeids;
+  std::vector<int64_t> class_nodeids;
+  std::vector<int64_t> class_ids;
+  std::vector<float> class_weights;
+  std::vector<std::vector<float>> leaf_weights(trees.NumLeaves(), std::vector<float>(n_classes));
+  for (size_t leaf = 0; leaf < trees.NumLeaves(); ++leaf) {
+    for (int64_t c = 0; c < n_classes; ++c) {
+      leaf_weights[leaf][c] = static_cast<float>((static_cast<int64_t>(leaf) * 5 + c * 7) % 13 - 6);
+      class_treeids.push_back(trees.LeafTreeId(leaf));
+      class_nodeids.push_back(trees.LeafNodeId(leaf));
+      class_ids.push_back(c);
+      class_weights.push_back(leaf_weights[leaf][c]);
+    }
+  }
+  const std::vector<float> base_values = {0.5f, 0.f, -0.5f};
+  const std::vector<int64_t> classes = {10, 20, 30};
+
+  trees.AddAttributes(test);
+  test.AddAttribute("class_treeids", class_treeids);
+  test.AddAttribute("class_nodeids", class_nodeids);
+  test.AddAttribute("class_ids", class_ids);
+  test.AddAttribute("class_weights", class_weights);
+  test.AddAttribute("base_values", base_values);
+  test.AddAttribute("classlabels_int64s", classes);
+
+  const std::vector<float> X = GenerateTreeEnsembleInput(n_rows, n_features);
+  std::vector<int64_t> labels;
+  std::vector<float> scores;
+  for (int64_t r = 0; r < n_rows; ++r) {
+    std::vector<float> row_scores(base_values);
+    for (size_t tree = 0; tree < trees.NumTrees(); ++tree) {
+      const size_t leaf = trees.FindLeaf(tree, X.data() + r * n_features);
+      for (int64_t c = 0; c < n_classes; ++c) {
+        row_scores[c] += leaf_weights[leaf][c];
+      }
+    }
+    // the first class with the highest score
+    labels.push_back(classes[std::max_element(row_scores.begin(), row_scores.end()) - row_scores.begin()]);
+    scores.insert(scores.end(), row_scores.begin(), row_scores.end());
+  }
+
+  test.AddInput<float>("X", {n_rows, n_features}, X);
+  test.AddOutput<int64_t>("Y", {n_rows}, labels);
+  test.AddOutput<float>("Z", {n_rows, n_classes}, scores);
+  RunWithTreeEnsembleEvaluation(test, evaluation);
+}
+
+// Deeper trees testing several features, with missing values and blocks of rows QuickScorer skips features for.
+TEST(MLOpTest, TreeEnsembleClassifierQuickScorerMatchesTraversal) {
+  const TestTreeEnsemble trees(5, 4, 4);
+  RunTreeEnsembleClassifierEnsembleTest(trees, TreeEnsembleEvaluation::kTraversal);
+  RunTreeEnsembleClassifierEnsembleTest(trees, TreeEnsembleEvaluation::kQuickScorer);
+}
+
+// Ensembles QuickScorer can't evaluate are traversed instead.
+TEST(MLOpTest, TreeEnsembleClassifierQuickScorerFallback) {
+  // more leaves than the bits of a bitvector
+  RunTreeEnsembleClassifierEnsembleTest(TestTreeEnsemble(2, 7, 4), TreeEnsembleEvaluation::kQuickScorer);
+  RunTreeEnsembleClassifierEnsembleTest(TestTreeEnsemble(3, 3, 4, "BRANCH_LT"), TreeEnsembleEvaluation::kQuickScorer);
+  RunTreeEnsembleClassifierEnsembleTest(TestTreeEnsemble(3, 3, 4, "BRANCH_LEQ", true),
+                                        TreeEnsembleEvaluation::kQuickScorer);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
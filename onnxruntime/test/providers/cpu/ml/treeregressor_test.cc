@@ -2,7 +2,9 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/providers/cpu/ml/tree_ensemble_test_utils.h"
 
 namespace onnxruntime {
 namespace test {
@@ -183,5 +185,188 @@ TEST(MLOpTest, TreeRegressorSingleTargetMax) {
   GenTreeAndRunTest1("MAX", true);
 }
 
+static void RunSingleTargetSumManyRowsTest(TreeEnsembleEvaluation evaluation) {
+  OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
+
+  // same trees as GenTreeAndRunTest1 with the false child listed before the true child in the second tree
+  std::vector<int64_t> lefts = {1, 0, 0, 1, 0, 0, 1, 0, 0};
+  std::vector<int64_t> rights = {2, 0, 0, 2, 0, 0, 2, 0, 0};
+  std::vector<int64_t> treeids = {0, 0, 0, 1, 1, 1, 2, 2, 2};
+  std::vector<int64_t> nodeids = {0, 1, 2, 0, 2, 1, 0, 1, 2};
+  std::vector<int64_t> featureids = {0, 0, 0, 0, 0, 0, 1, 0, 0};
+  std::vector<float> thresholds = {1, 0, 0, 0.5, 0, 0, 0.5, 0, 0};
+  std::vector<std::string> modes = {"BRANCH_LEQ", "LEAF", "LEAF", "BRANCH_LEQ", "LEAF", "LEAF", "BRANCH_LEQ", "LEAF", "LEAF"};
+
+  std::vector<int64_t> target_treeids = {0, 0, 1, 1, 2, 2};
+  std::vector<int64_t> target_nodeids = {1, 2, 1, 2, 1, 2};
+  std::vector<int64_t> target_classids = {0, 0, 0, 0, 0, 0};
+  std::vector<float> target_weights = {33.33333f, 16.66666f, 33.33333f, -3.33333f, 16.66666f, -3.333333f};
+
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_classids);
+  test.AddAttribute("target_weights", target_weights);
+  test.AddAttribute("n_targets", (int64_t)1);
+
+  // enough rows to be split in several blocks of rows and across threads
+  const int64_t n_rows = 101;
+  const std::vector<float> rows = {0, 1, 1, 1, 2, 0};
+  const std::vector<float> row_results = {63.33333333f, 26.66666667f, 30.0f};
+  std::vector<float> X;
+  std::vector<float> results;
+  for (int64_t i = 0; i < n_rows; ++i) {
+    X.push_back(rows[(i % 3) * 2]);
+    X.push_back(rows[(i % 3) * 2 + 1]);
+    results.push_back(row_results[i % 3]);
+  }
+
+  test.AddInput<float>("X", {n_rows, 2}, X);
+  test.AddOutput<float>("Y", {n_rows, 1}, results);
+
+  if (evaluation == TreeEnsembleEvaluation::kTraversal) {
+    test.Run();
+    return;
+  }
+
+  CPUExecutionProviderInfo info;
+  info.tree_ensemble_evaluation = evaluation;
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(onnxruntime::make_unique<CPUExecutionProvider>(info));
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(MLOpTest, TreeRegressorSingleTargetSumManyRows) {
+  RunSingleTargetSumManyRowsTest(TreeEnsembleEvaluation::kTraversal);
+}
+
+TEST(MLOpTest, TreeRegressorSingleTargetSumManyRowsQuickScorer) {
+  RunSingleTargetSumManyRowsTest(TreeEnsembleEvaluation::kQuickScorer);
+}
+
+// Every leaf has weights for two of the three targets. The weights are small integers so the sums are exact.
+static void RunTreeRegressorEnsembleTest(const TestTreeEnsemble& trees, const std::string& aggregate_function,
+                                         TreeEnsembleEvaluation evaluation) {
+  OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
+
+  const int64_t n_targets = 3;
+  const int64_t n_features = 4;
+  const int64_t n_rows = 40;
+  std::vector<int64_t> target_treeids;
+  std::vector<int64_t> target_nodeids;
+  std::vector<int64_t> target_ids;
+  std::vector<float> target_weights;
+  std::vector<std::vector<float>> leaf_weights(trees.NumLeaves(), std::vector<float>(n_targets, 0.f));
+  for (size_t leaf = 0; leaf < trees.NumLeaves(); ++leaf) {
+    for (int64_t target = 0; target < n_targets; ++target) {
+      if ((static_cast<int64_t>(leaf) + target) % 3 == 0) {
+        continue;
+      }
+      leaf_weights[leaf][target] = static_cast<float>((static_cast<int64_t>(leaf) * 7 + target * 3) % 19 - 9);
+      target_treeids.push_back(trees.LeafTreeId(leaf));
+      target_nodeids.push_back(trees.LeafNodeId(leaf));
+      target_ids.push_back(target);
+      target_weights.push_back(leaf_weights[leaf][target]);
+    }
+  }
+  const std::vector<float> base_values = {0.5f, -1.f, 2.f};
+
+  trees.AddAttributes(test);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_ids);
+  test.AddAttribute("target_weights", target_weights);
+  test.AddAttribute("base_values", base_values);
+  test.AddAttribute("n_targets", n_targets);
+  test.AddAttribute("aggregate_function", aggregate_function);
+
+  const std::vector<float> X = GenerateTreeEnsembleInput(n_rows, n_features);
+  std::vector<float> results;
+  for (int64_t r = 0; r < n_rows; ++r) {
+    std::vector<float> sums(n_targets, 0.f);
+    for (size_t tree = 0; tree < trees.NumTrees(); ++tree) {
+      const size_t leaf = trees.FindLeaf(tree, X.data() + r * n_features);
+      for (int64_t target = 0; target < n_targets; ++target) {
+        sums[target] += leaf_weights[leaf][target];
+      }
+    }
+    for (int64_t target = 0; target < n_targets; ++target) {
+      results.push_back((aggregate_function == "AVERAGE" ? sums[target] / trees.NumTrees() : sums[target]) +
+                        base_values[target]);
+    }
+  }
+
+  test.AddInput<float>("X", {n_rows, n_features}, X);
+  test.AddOutput<float>("Y", {n_rows, n_targets}, results);
+  RunWithTreeEnsembleEvaluation(test, evaluation);
+}
+
+// Deeper trees testing several features, with missing values and blocks of rows QuickScorer skips features for.
+TEST(MLOpTest, TreeRegressorMultiTargetQuickScorerMatchesTraversal) {
+  const TestTreeEnsemble trees(5, 4, 4);
+  for (const char* aggregate_function : {"SUM", "AVERAGE"}) {
+    RunTreeRegressorEnsembleTest(trees, aggregate_function, TreeEnsembleEvaluation::kTraversal);
+    RunTreeRegressorEnsembleTest(trees, aggregate_function, TreeEnsembleEvaluation::kQuickScorer);
+  }
+}
+
+// Ensembles QuickScorer can't evaluate are traversed instead.
+TEST(MLOpTest, TreeRegressorMultiTargetQuickScorerFallback) {
+  // more leaves than the bits of a bitvector
+  RunTreeRegressorEnsembleTest(TestTreeEnsemble(2, 7, 4), "SUM", TreeEnsembleEvaluation::kQuickScorer);
+  RunTreeRegressorEnsembleTest(TestTreeEnsemble(3, 3, 4, "BRANCH_LT"), "SUM", TreeEnsembleEvaluation::kQuickScorer);
+  RunTreeRegressorEnsembleTest(TestTreeEnsemble(3, 3, 4, "BRANCH_LEQ", true), "SUM",
+                               TreeEnsembleEvaluation::kQuickScorer);
+}
+
+// A tree whose nodes aren't reached exactly once from its root is rejected.
+static void RunTreeRegressorInvalidTreeTest(const std::vector<int64_t>& lefts, const std::vector<int64_t>& rights,
+                                            const std::vector<std::string>& modes) {
+  OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
+
+  const size_t n_nodes = modes.size();
+  std::vector<int64_t> treeids(n_nodes, 0);
+  std::vector<int64_t> nodeids;
+  std::vector<int64_t> target_nodeids;
+  for (size_t i = 0; i < n_nodes; ++i) {
+    nodeids.push_back(static_cast<int64_t>(i));
+    if (modes[i] == "LEAF") {
+      target_nodeids.push_back(static_cast<int64_t>(i));
+    }
+  }
+
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", std::vector<int64_t>(n_nodes, 0));
+  test.AddAttribute("nodes_values", std::vector<float>(n_nodes, 0.5f));
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("target_treeids", std::vector<int64_t>(target_nodeids.size(), 0));
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", std::vector<int64_t>(target_nodeids.size(), 0));
+  test.AddAttribute("target_weights", std::vector<float>(target_nodeids.size(), 1.f));
+  test.AddAttribute("n_targets", (int64_t)1);
+
+  test.AddInput<float>("X", {1, 1}, {0.f});
+  test.AddOutput<float>("Y", {1, 1}, {1.f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "is reached more than once");
+}
+
+TEST(MLOpTest, TreeRegressorSharedChild) {
+  // node 2 is the false child of both node 0 and node 1
+  RunTreeRegressorInvalidTreeTest({1, 3, 0, 0}, {2, 2, 0, 0}, {"BRANCH_LEQ", "BRANCH_LEQ", "LEAF", "LEAF"});
+}
+
+TEST(MLOpTest, TreeRegressorSameTrueAndFalseChild) {
+  RunTreeRegressorInvalidTreeTest({1, 0}, {1, 0}, {"BRANCH_LEQ", "LEAF"});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
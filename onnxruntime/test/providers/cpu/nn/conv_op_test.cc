@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "core/framework/prepacked_weights_container.h"
 #include "test/providers/provider_test_utils.h"
 using namespace std;
 namespace onnxruntime {
@@ -27,8 +28,11 @@ void TestConvOp(const ConvOpAndTestAttributes& attributes,
                 bool weight_is_initializer = false,
                 OpTester::ExpectResult expect_result = OpTester::ExpectResult::kExpectSuccess,
                 const std::string& err_str = "",
-                int opset = 7) {
+                int opset = 7,
+                PrepackedWeightsContainer* prepacked_weights_container = nullptr,
+                size_t* number_of_shared_prepacked_weights = nullptr) {
   OpTester test("Conv", opset);
+  test.SetPrePackedWeightsContainer(prepacked_weights_container);
   test.AddAttribute("auto_pad", attributes.auto_pad);
   test.AddAttribute("group", attributes.group);
   test.AddAttribute("kernel_shape", attributes.kernel_shape);
@@ -59,6 +63,9 @@ void TestConvOp(const ConvOpAndTestAttributes& attributes,
   excluded_providers.insert(kTensorrtExecutionProvider);
 
   test.Run(expect_result, err_str, excluded_providers);
+  if (number_of_shared_prepacked_weights != nullptr) {
+    *number_of_shared_prepacked_weights = test.GetNumberOfSharedPrePackedWeights();
+  }
 }
 
 }  // namespace
@@ -206,6 +213,44 @@ TEST(ConvTest, Conv2D_1) {
   TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape, true);
 }
 
+// sessions sharing a container use a single copy of a constant filter
+TEST(ConvTest, Conv2D_SharedPrePackedWeights) {
+  ConvOpAndTestAttributes attrs = {
+      "",                           // auto_pad
+      vector<int64_t>{1, 1},        // dilations
+      1,                            // group
+      vector<int64_t>{3, 3},        // kernel_shape
+      vector<int64_t>{1, 1, 1, 2},  // pads
+      vector<int64_t>{3, 1},        // strides
+      {}                            // excluded EPs
+  };
+
+  vector<float> X = {-0.09103918075561523f, -0.32513630390167236f};
+  vector<int64_t> X_shape = {2, 1, 1, 1};
+  vector<float> W = {0.4312484860420227f, -0.12559029459953308f, 0.44889551401138306f, -0.3100617825984955f,
+                     0.13522827625274658f, -0.06791308522224426f, 0.22671669721603394f, -0.17391827702522278f,
+                     -0.31299442052841187f, -0.31545522809028625f, 0.06560015678405762f, 0.2656586766242981f,
+                     0.41363757848739624f, 0.31231558322906494f, -0.376018226146698f, -0.005708813667297363f,
+                     0.34922850131988525f, 0.45095211267471313f};
+  vector<int64_t> W_shape = {2, 1, 3, 3};
+  vector<int64_t> Y_shape = {2, 2, 1, 2};
+  auto expected_vals = {-0.012311071157455444f, 0.02822777070105076f, -0.028432954102754593f, -0.037657227367162704f,
+                        -0.04396762326359749f, 0.10081233829259872f, -0.10154513269662857f, -0.13448859751224518f};
+
+  PrepackedWeightsContainer container;
+  size_t number_of_shared_prepacked_weights = 0;
+  TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape, true,
+             OpTester::ExpectResult::kExpectSuccess, "", 7, &container, &number_of_shared_prepacked_weights);
+  ASSERT_EQ(container.NumberOfEntries(), 1u);
+  EXPECT_EQ(number_of_shared_prepacked_weights, 0u);
+
+  // the second session uses the filter held for the first one
+  TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape, true,
+             OpTester::ExpectResult::kExpectSuccess, "", 7, &container, &number_of_shared_prepacked_weights);
+  EXPECT_EQ(container.NumberOfEntries(), 1u);
+  EXPECT_EQ(number_of_shared_prepacked_weights, 1u);
+}
+
 TEST(ConvTest, Conv1D_Invalid_Input_Shape) {
   ConvOpAndTestAttributes attrs = {
       "",                     // auto_pad
@@ -6,6 +6,8 @@
 #include <iterator>
 #include <vector>
 
+#include "core/framework/prepacked_weights_container.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/providers/cpu/rnn/deep_cpu_gru.h"
 #include "test/providers/provider_test_utils.h"
 using namespace std;
@@ -33,8 +35,10 @@ static void RunGruTest(const std::vector<float>& X_data,
                        // copy the following vectors as we may modify them
                        std::vector<string> activations = default_activations,
                        std::vector<float> activation_alphas = {},
-                       std::vector<float> activation_betas = {}) {
+                       std::vector<float> activation_betas = {},
+                       PrepackedWeightsContainer* prepacked_weights_container = nullptr) {
   OpTester test("GRU");
+  test.SetPrePackedWeightsContainer(prepacked_weights_container);
 
   test.AddShapeToTensorData();
 
@@ -162,6 +166,45 @@ TEST(GRUTest, ForwardDefaultActivationsSimpleWeightsNoBiasTwoRows) {
   DefaultActivationsSimpleWeightsNoBias("forward", Y_data, {});
 }
 
+// sessions sharing a container use a single copy of the packed W and R
+TEST(GRUTest, ForwardSharedPrePackedWeights) {
+  const int64_t seq_length = 2;
+  const int batch_size = 2;
+  const int64_t input_size = 1;
+  const int64_t hidden_size = 3;
+
+  std::vector<float> X_data{1.f, 2.f,
+                            10.f, 11.f};
+  std::vector<float> W_data{0.1f, 0.2f, 0.3f,   // wz
+                            1.f, 2.f, 3.f,      // wr
+                            10.f, 11.f, 12.f};  // wh
+  std::vector<float> R_data(3 * hidden_size * hidden_size, 0.1f);
+
+  std::vector<float> Y_data{
+      0.4750208f, 0.450166f, 0.4255575f,
+      0.45016602f, 0.40131235f, 0.35434368f,
+
+      0.6027093f, 0.5083023f, 0.44950223f,
+      0.5754369f, 0.45485455f, 0.3747841f};
+
+  std::vector<float> Y_h_data{
+      0.6027093f, 0.5083023f, 0.44950223f,
+      0.5754369f, 0.45485455f, 0.3747841f};
+
+  PrepackedWeightsContainer container;
+  for (int session = 0; session < 2; ++session) {
+    RunGruTest(X_data, W_data, R_data, Y_data, Y_h_data, input_size, batch_size, hidden_size, seq_length,
+               nullptr, nullptr, nullptr, "forward", 9999.0, true, false, default_activations, {}, {}, &container);
+
+#if !defined(USE_MKLML_FOR_BLAS)
+    // W and R are packed if MLAS has a packed format on this platform, and the second session uses the weights
+    // packed for the first one
+    const bool packed = MlasGemmPackBSize(static_cast<size_t>(3 * hidden_size), static_cast<size_t>(input_size)) != 0;
+    EXPECT_EQ(container.NumberOfEntries(), packed ? 2u : 0u) << "session " << session;
+#endif
+  }
+}
+
 TEST(GRUTest, ReverseDefaultActivationsSimpleWeightsNoBiasTwoRows) {
   std::vector<float> Y_data{
       0.6082785f, 0.50623393f, 0.4426924f,
@@ -11,6 +11,7 @@
 #include "gmock/gmock.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/util/include/default_providers.h"
+#include "test/util/include/inference_session_wrapper.h"
 #include <csignal>
 #include <exception>
 #include <memory>
@@ -526,6 +527,11 @@ std::vector<MLValue> OpTester::ExecuteModel(
     LOGS_DEFAULT(ERROR) << "Failed to serialize proto to string";
     return {};
   }
+  if (prepacked_weights_container_ != nullptr) {
+    auto status = session_object.AddPrePackedWeightsContainer(prepacked_weights_container_);
+    EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  }
+
   std::stringstream sstr(s1);
   auto status = session_object.Load(sstr);
   EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
@@ -765,7 +771,7 @@ void OpTester::Run(
         }
       }
 
-      InferenceSession session_object{so, GetEnvironment()};
+      InferenceSessionWrapper session_object{so, GetEnvironment()};
 
       ASSERT_TRUE(!execution_providers->empty())
           << "Empty execution providers vector.";
@@ -780,6 +786,7 @@ void OpTester::Run(
           *p_model, session_object, expect_result, expected_failure_string,
           run_options, feeds, output_names, provider_types,
           custom_output_verifier);
+      RecordSharedPrePackedWeights(session_object);
 
     } else {
       for (const std::string& provider_type : all_provider_types) {
@@ -792,7 +799,7 @@ void OpTester::Run(
           so.enable_mem_pattern = false;
           so.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
         }
-        InferenceSession session_object{so, GetEnvironment()};
+        InferenceSessionWrapper session_object{so, GetEnvironment()};
 
         for (auto& custom_session_registry : custom_session_registries_)
           ASSERT_PROVIDER_STATUS_OK(session_object.RegisterCustomRegistry(custom_session_registry));
@@ -869,6 +876,7 @@ void OpTester::Run(
             *p_model, session_object, expect_result, expected_failure_string,
             run_options, feeds, output_names, provider_type,
             custom_output_verifier);
+        RecordSharedPrePackedWeights(session_object);
 
         cur_provider = "not set";
       }
@@ -886,6 +894,11 @@ void OpTester::Run(
   }
 }
 
+void OpTester::RecordSharedPrePackedWeights(const InferenceSessionWrapper& session_object) {
+  number_of_shared_prepacked_weights_ =
+      session_object.IsInitialized() ? session_object.GetSessionState().GetNumberOfSharedPrePackedWeights() : 0;
+}
+
 void OpTester::AddReferenceOutputs(const std::string& model_path) {
   SessionOptions so;
   so.session_logid = op_;
@@ -31,6 +31,8 @@ class InferenceSession;
 struct SessionOptions;
 
 namespace test {
+class InferenceSessionWrapper;
+
 template <typename T>
 struct SeqTensors {
   void AddTensor(const std::vector<int64_t>& shape0, const std::vector<T>& data0) {
@@ -394,6 +396,16 @@ class OpTester {
   void SetOutputAbsErr(const char* name, float v);
   void SetOutputRelErr(const char* name, float v);
 
+  // Share the weights pre-packed by the kernels with the other sessions using the container.
+  // The container must outlive the OpTester.
+  void SetPrePackedWeightsContainer(PrepackedWeightsContainer* prepacked_weights_container) {
+    prepacked_weights_container_ = prepacked_weights_container;
+  }
+
+  // Number of constant initializers the last session that ran took the packed weights of from the container set
+  // with SetPrePackedWeightsContainer instead of packing them itself.
+  size_t GetNumberOfSharedPrePackedWeights() const { return number_of_shared_prepacked_weights_; }
+
   // Number of times to call InferenceSession::Run. The same feeds are used each time.
   // e.g. used to verify the generator ops behave as expected
   void SetNumRunCalls(int n) {
@@ -504,6 +516,8 @@ class OpTester {
                                     const std::string& provider_type,
                                     const CustomOutputVerifierFn& custom_output_verifier);
 
+  void RecordSharedPrePackedWeights(const InferenceSessionWrapper& session_object);
+
   const char* op_;
   std::vector<Data> input_data_;
   std::vector<Data> output_data_;
@@ -616,6 +630,8 @@ class OpTester {
   bool add_shape_to_tensor_data_ = true;
   int add_symbolic_dim_to_tensor_data_ = -1;
   int num_run_calls_ = 1;
+  PrepackedWeightsContainer* prepacked_weights_container_ = nullptr;
+  size_t number_of_shared_prepacked_weights_ = 0;
   std::vector<size_t> initializer_index_;
   std::vector<std::function<void(onnxruntime::Node& node)>> add_attribute_funcs_;
 
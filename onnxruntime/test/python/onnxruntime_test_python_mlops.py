@@ -54,6 +54,25 @@ class TestInferenceSession(unittest.TestCase):
         res = sess.run([output_name], {x_name: x})
         self.assertEqual(output_expected, res[0])
 
+    def testZipMapOutputAsTensors(self):
+        so = onnxrt.SessionOptions()
+        so.add_session_config_entry("session.zipmap_output_as_tensors", "1")
+        x = np.array([1.0, 0.0, 3.0, 44.0, 23.0, 11.0], dtype=np.float32).reshape((2, 3))
+
+        for model, labels_type, labels_expected in [
+                ("zipmap_stringfloat.onnx", 'tensor(string)', ['class1', 'class2', 'class3']),
+                ("zipmap_int64float.onnx", 'tensor(int64)', [10, 20, 30])]:
+            sess = onnxrt.InferenceSession(get_name(model), sess_options=so)
+
+            outputs = sess.get_outputs()
+            self.assertEqual([output.name for output in outputs], ["Z", "Z_labels"])
+            self.assertEqual(outputs[0].type, 'tensor(float)')
+            self.assertEqual(outputs[1].type, labels_type)
+
+            scores, labels = sess.run(None, {"X": x})
+            np.testing.assert_allclose(x, scores)
+            self.assertEqual(labels_expected, labels.tolist())
+
     def testDictVectorizer(self):
         sess = onnxrt.InferenceSession(get_name("pipeline_vectorize.onnx"))
         input_name = sess.get_inputs()[0].name
@@ -11,4 +11,9 @@ TEST(CApiTest, run_options) {
   options.SetRunTag("abc");
   ASSERT_STREQ(options.GetRunTag(), "abc");
   ASSERT_EQ(options.GetRunLogVerbosityLevel(), 1);
+  ASSERT_FALSE(options.GetTerminate());
+  options.SetTerminate();
+  ASSERT_TRUE(options.GetTerminate());
+  options.UnsetTerminate();
+  ASSERT_FALSE(options.GetTerminate());
 }
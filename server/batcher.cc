@@ -0,0 +1,500 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstring>
+#include <locale>
+#include <numeric>
+#include <sstream>
+
+#include "batcher.h"
+
+namespace onnxruntime {
+namespace server {
+
+static size_t ElementSize(ONNXTensorElementDataType type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+      return 1;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+      return 2;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+      return 4;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_COMPLEX64:
+      return 8;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_COMPLEX128:
+      return 16;
+    default:
+      // strings and unknown types can't be copied as raw bytes
+      return 0;
+  }
+}
+
+static std::vector<const char*> ToCStrings(const std::vector<std::string>& strings) {
+  std::vector<const char*> ptrs;
+  ptrs.reserve(strings.size());
+  for (const auto& s : strings) {
+    ptrs.push_back(s.c_str());
+  }
+
+  return ptrs;
+}
+
+static std::vector<Ort::Value> RunSession(const Ort::Session& session, const Ort::RunOptions& run_options,
+                                          const std::vector<const char*>& input_names,
+                                          const std::vector<Ort::Value>& input_values,
+                                          const std::vector<std::string>& output_names) {
+  auto output_ptrs = ToCStrings(output_names);
+  return const_cast<Ort::Session&>(session).Run(run_options, input_names.data(),
+                                                input_values.data(), input_values.size(),
+                                                output_ptrs.data(), output_ptrs.size());
+}
+
+// How often a thread waiting for its batch checks whether its run options were terminated.
+static constexpr std::chrono::milliseconds kTerminatePollInterval{10};
+
+// Tags the combined Run with the tags of the requests and logs it at the most verbose level any of them asks for.
+static void MergeRunOptions(const std::vector<const Ort::RunOptions*>& request_options, Ort::RunOptions& run_options) {
+  std::string tag = "batch";
+  int log_severity_level = -1;  // the log severity of the session
+  int log_verbosity_level = 0;
+  for (size_t i = 0; i < request_options.size(); ++i) {
+    const auto& options = *request_options[i];
+    tag += i == 0 ? ':' : ',';
+    tag += options.GetRunTag();
+    const int severity = options.GetRunLogSeverityLevel();
+    if (severity >= 0 && (log_severity_level < 0 || severity < log_severity_level)) {
+      log_severity_level = severity;
+    }
+    log_verbosity_level = std::max(log_verbosity_level, options.GetRunLogVerbosityLevel());
+  }
+
+  run_options.SetRunTag(tag.c_str());
+  run_options.SetRunLogSeverityLevel(log_severity_level);
+  run_options.SetRunLogVerbosityLevel(log_verbosity_level);
+}
+
+std::string BatcherStats::ToPrometheusText() const {
+  struct Metric {
+    const char* name;
+    const char* type;
+    const char* help;
+    double (*get_value)(const BatcherStats&);
+  };
+
+  static const Metric metrics[] = {
+      {"requests_total", "counter", "Number of requests.",
+       [](const BatcherStats& s) { return static_cast<double>(s.num_requests); }},
+      {"unbatched_requests_total", "counter", "Number of requests run on their own without a batch.",
+       [](const BatcherStats& s) { return static_cast<double>(s.num_unbatched_requests); }},
+      {"batches_total", "counter", "Number of runs of several requests combined.",
+       [](const BatcherStats& s) { return static_cast<double>(s.num_batches); }},
+      {"fallback_requests_total", "counter", "Number of requests run on their own after their batch failed.",
+       [](const BatcherStats& s) { return static_cast<double>(s.num_fallback_requests); }},
+      {"batch_rows_total", "counter", "Total number of rows of the batches.",
+       [](const BatcherStats& s) { return static_cast<double>(s.total_batch_rows); }},
+      {"queued_requests_total", "counter", "Number of requests queued for batching.",
+       [](const BatcherStats& s) { return static_cast<double>(s.num_queued_requests); }},
+      {"queue_time_seconds_total", "counter", "Total time the queued requests waited for their batch.",
+       [](const BatcherStats& s) { return static_cast<double>(s.total_queue_time.count()) / 1e6; }},
+      {"max_queue_time_seconds", "gauge", "Longest time a queued request waited for its batch.",
+       [](const BatcherStats& s) { return static_cast<double>(s.max_queue_time.count()) / 1e6; }},
+      {"run_time_seconds_total", "counter", "Total time of the batch runs.",
+       [](const BatcherStats& s) { return static_cast<double>(s.total_run_time.count()) / 1e6; }},
+  };
+
+  std::ostringstream ss;
+  ss.imbue(std::locale::classic());
+  ss.precision(17);
+
+  for (const auto& metric : metrics) {
+    ss << "# HELP onnxruntime_server_batcher_" << metric.name << " " << metric.help << "\n"
+       << "# TYPE onnxruntime_server_batcher_" << metric.name << " " << metric.type << "\n"
+       << "onnxruntime_server_batcher_" << metric.name << " " << metric.get_value(*this) << "\n";
+  }
+
+  return ss.str();
+}
+
+Batcher::Batcher(const Ort::Session& session, const BatchingOptions& options, std::shared_ptr<spdlog::logger> logger)
+    : session_(session),
+      options_(options),
+      logger_(std::move(logger)),
+      last_stats_log_time_(std::chrono::steady_clock::now()) {
+  for (int i = 0; i < std::max(options_.num_workers, 1); ++i) {
+    workers_.emplace_back([this]() { ProcessBatches(); });
+  }
+}
+
+Batcher::~Batcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  queue_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+std::vector<Ort::Value> Batcher::Run(const Ort::RunOptions& run_options,
+                                     const std::vector<std::string>& input_names,
+                                     const std::vector<Ort::Value>& input_values,
+                                     const std::vector<std::string>& output_names) {
+  Request request;
+  request.run_options = &run_options;
+  request.input_names = &input_names;
+  request.input_values = &input_values;
+  request.output_names = &output_names;
+  request.batch_rows = 0;
+
+  // the inputs of a request may come in any order, e.g. from a protobuf map
+  request.input_order.resize(input_names.size());
+  std::iota(request.input_order.begin(), request.input_order.end(), size_t{0});
+  std::sort(request.input_order.begin(), request.input_order.end(),
+            [&input_names](size_t a, size_t b) { return input_names[a] < input_names[b]; });
+
+  bool batchable = !input_names.empty();
+  std::ostringstream signature;
+  for (auto i : request.input_order) {
+    const auto& value = input_values[i];
+    if (!value.IsTensor()) {
+      batchable = false;
+      break;
+    }
+
+    auto info = value.GetTensorTypeAndShapeInfo();
+    auto type = info.GetElementType();
+    auto shape = info.GetShape();
+    if (ElementSize(type) == 0 || shape.empty() || shape[0] <= 0 ||
+        (request.batch_rows != 0 && shape[0] != request.batch_rows)) {
+      batchable = false;
+      break;
+    }
+
+    request.batch_rows = shape[0];
+    signature << input_names[i].size() << ':' << input_names[i] << ':' << type;
+    for (size_t d = 1; d < shape.size(); ++d) {
+      signature << ',' << shape[d];
+    }
+    signature << ';';
+  }
+
+  // a request as large as a batch gains nothing from waiting for others
+  if (batchable && request.batch_rows < options_.max_batch_size) {
+    signature << '|';
+    for (const auto& name : output_names) {
+      signature << name.size() << ':' << name << ';';
+    }
+    request.signature = signature.str();
+  }
+
+  // requests that can't be batched, or are terminated already, don't wait for a worker
+  const bool unbatched = request.signature.empty() || run_options.GetTerminate();
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.num_requests += 1;
+    if (unbatched) {
+      stats_.num_unbatched_requests += 1;
+    }
+  }
+
+  if (unbatched) {
+    LogStats();
+    return RunSeparately(request);
+  }
+
+  auto result = request.result.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    request.enqueue_time = std::chrono::steady_clock::now();
+    queue_.push_back(&request);
+  }
+  queue_cv_.notify_all();
+
+  bool terminated = false;
+  while (result.wait_for(kTerminatePollInterval) != std::future_status::ready) {
+    if (!terminated && run_options.GetTerminate()) {
+      Terminate(request);
+      terminated = true;
+    }
+  }
+
+  // rethrows the exception of a failed run
+  auto outputs = result.get();
+  if (request.run_separately) {
+    return RunSeparately(request);
+  }
+
+  return outputs;
+}
+
+std::vector<Ort::Value> Batcher::RunSeparately(const Request& request) {
+  return RunSession(session_, *request.run_options, ToCStrings(*request.input_names), *request.input_values,
+                    *request.output_names);
+}
+
+void Batcher::Terminate(Request& request) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = std::find(queue_.begin(), queue_.end(), &request);
+  if (it != queue_.end()) {
+    // the request is run on its own, where the session fails it
+    queue_.erase(it);
+    {
+      std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+      stats_.num_unbatched_requests += 1;
+    }
+    request.run_separately = true;
+    request.result.set_value({});
+    return;
+  }
+
+  request.terminated = true;
+  if (request.batch_run_options != nullptr) {
+    // the batch fails and its other requests are run on their own
+    request.batch_run_options->SetTerminate();
+  }
+}
+
+void Batcher::ProcessBatches() {
+  const int64_t max_batch_rows = options_.max_batch_size;
+  std::vector<Request*> batch;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    // one worker at a time collects a batch while the others run the batches collected before
+    queue_cv_.wait(lock, [this]() { return (shutdown_ && queue_.empty()) || (!collecting_ && !queue_.empty()); });
+    if (queue_.empty()) {
+      return;
+    }
+
+    collecting_ = true;
+    // the oldest request determines which requests can join the batch and how long to wait for them
+    Request* first = queue_.front();
+    const auto deadline = first->enqueue_time + options_.max_queue_delay;
+    int64_t batch_rows = 0;
+    batch.clear();
+
+    auto collect = [&]() {
+      for (auto it = queue_.begin(); it != queue_.end() && batch_rows < max_batch_rows;) {
+        Request* request = *it;
+        if (request->signature == first->signature && batch_rows + request->batch_rows <= max_batch_rows) {
+          batch.push_back(request);
+          batch_rows += request->batch_rows;
+          it = queue_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    };
+
+    collect();
+    while (!shutdown_ && batch_rows < max_batch_rows) {
+      if (queue_cv_.wait_until(lock, deadline) == std::cv_status::timeout) {
+        collect();
+        break;
+      }
+      collect();
+    }
+
+    collecting_ = false;
+    lock.unlock();
+    queue_cv_.notify_all();
+    RunBatch(batch);
+    lock.lock();
+  }
+}
+
+void Batcher::RunBatch(std::vector<Request*>& batch) {
+  const auto start_time = std::chrono::steady_clock::now();
+
+  std::chrono::microseconds queue_time{0};
+  std::chrono::microseconds max_queue_time{0};
+  for (const auto* request : batch) {
+    auto request_queue_time =
+        std::chrono::duration_cast<std::chrono::microseconds>(start_time - request->enqueue_time);
+    queue_time += request_queue_time;
+    max_queue_time = std::max(max_queue_time, request_queue_time);
+  }
+  const size_t num_queued_requests = batch.size();
+
+  // requests whose run options were terminated while the batch was collected are run, and fail, on their own
+  std::vector<Request*> separate;
+  Ort::RunOptions run_options;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto terminated = std::stable_partition(batch.begin(), batch.end(),
+                                            [](const Request* request) { return !request->terminated; });
+    separate.assign(terminated, batch.end());
+    batch.erase(terminated, batch.end());
+    if (batch.size() > 1) {
+      for (auto* request : batch) {
+        request->batch_run_options = &run_options;
+      }
+    } else {
+      separate.insert(separate.end(), batch.begin(), batch.end());
+      batch.clear();
+    }
+  }
+
+  const size_t num_requests = batch.size();
+  int64_t total_rows = 0;
+  std::vector<std::vector<Ort::Value>> results;
+  bool batch_failed = false;
+  if (num_requests > 1) {
+    std::vector<const Ort::RunOptions*> request_options;
+    for (const auto* request : batch) {
+      total_rows += request->batch_rows;
+      request_options.push_back(request->run_options);
+    }
+
+    try {
+      MergeRunOptions(request_options, run_options);
+      results = RunCombined(batch, total_rows, run_options);
+    } catch (const std::exception& e) {
+      logger_->warn("Batched run of {} requests failed, running them one at a time. Error: {}",
+                    num_requests, e.what());
+      batch_failed = true;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto* request : batch) {
+      request->batch_run_options = nullptr;
+    }
+  }
+
+  if (batch_failed) {
+    separate.insert(separate.end(), batch.begin(), batch.end());
+  }
+
+  const auto run_time =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    if (num_requests > 1) {
+      stats_.num_batches += 1;
+      stats_.total_batch_rows += total_rows;
+      stats_.total_run_time += run_time;
+    }
+    if (batch_failed) {
+      stats_.num_fallback_requests += num_requests;
+    }
+    stats_.num_unbatched_requests += separate.size() - (batch_failed ? num_requests : 0);
+    stats_.num_queued_requests += num_queued_requests;
+    stats_.total_queue_time += queue_time;
+    stats_.max_queue_time = std::max(stats_.max_queue_time, max_queue_time);
+  }
+
+  // a request must not be accessed after its result was set as the thread waiting for it will destroy it.
+  // the threads waiting for the requests run separately run them with their own run options.
+  if (!batch_failed) {
+    for (size_t i = 0; i < num_requests; ++i) {
+      batch[i]->result.set_value(std::move(results[i]));
+    }
+  }
+  for (auto* request : separate) {
+    request->run_separately = true;
+    request->result.set_value({});
+  }
+
+  LogStats();
+}
+
+std::vector<std::vector<Ort::Value>> Batcher::RunCombined(const std::vector<Request*>& batch, int64_t total_rows,
+                                                          const Ort::RunOptions& run_options) {
+  // all requests have the same signature, so their inputs are the same when visited in input_order
+  const Request& first = *batch.front();
+  std::vector<const char*> input_names;
+  std::vector<Ort::Value> input_values;
+  for (size_t k = 0; k < first.input_order.size(); ++k) {
+    const size_t input_idx = first.input_order[k];
+    auto info = (*first.input_values)[input_idx].GetTensorTypeAndShapeInfo();
+    auto type = info.GetElementType();
+    auto shape = info.GetShape();
+    shape[0] = total_rows;
+
+    auto combined = Ort::Value::CreateTensor(allocator_, shape.data(), shape.size(), type);
+    auto* dst = combined.GetTensorMutableData<uint8_t>();
+    for (const auto* request : batch) {
+      const auto& value = (*request->input_values)[request->input_order[k]];
+      const size_t num_bytes = value.GetTensorTypeAndShapeInfo().GetElementCount() * ElementSize(type);
+      memcpy(dst, value.GetTensorData<uint8_t>(), num_bytes);
+      dst += num_bytes;
+    }
+
+    input_names.push_back((*first.input_names)[input_idx].c_str());
+    input_values.push_back(std::move(combined));
+  }
+
+  auto outputs = RunSession(session_, run_options, input_names, input_values, *first.output_names);
+
+  std::vector<std::vector<Ort::Value>> results(batch.size());
+  for (auto& output : outputs) {
+    if (!output.IsTensor()) {
+      throw Ort::Exception("Only tensor outputs can be split into the requests of a batch.", ORT_FAIL);
+    }
+
+    auto info = output.GetTensorTypeAndShapeInfo();
+    auto type = info.GetElementType();
+    auto shape = info.GetShape();
+    if (ElementSize(type) == 0 || shape.empty() || shape[0] != total_rows) {
+      throw Ort::Exception("Output can't be split into the requests of a batch. Dimension 0 must be the batch size.",
+                           ORT_FAIL);
+    }
+
+    const size_t row_bytes = info.GetElementCount() / total_rows * ElementSize(type);
+    const auto* src = output.GetTensorData<uint8_t>();
+    for (size_t i = 0; i < batch.size(); ++i) {
+      shape[0] = batch[i]->batch_rows;
+      auto part = Ort::Value::CreateTensor(allocator_, shape.data(), shape.size(), type);
+      const size_t num_bytes = row_bytes * batch[i]->batch_rows;
+      memcpy(part.GetTensorMutableData<uint8_t>(), src, num_bytes);
+      src += num_bytes;
+      results[i].push_back(std::move(part));
+    }
+  }
+
+  return results;
+}
+
+BatcherStats Batcher::GetStats() const {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  return stats_;
+}
+
+void Batcher::LogStats() {
+  if (options_.stats_log_interval.count() == 0) {
+    return;
+  }
+
+  BatcherStats stats;
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_stats_log_time_ < options_.stats_log_interval) {
+      return;
+    }
+    last_stats_log_time_ = now;
+    stats = stats_;
+  }
+
+  logger_->info(
+      "Batching: {} requests, {} run on their own, {} in {} batches, average batch size {:.2f} rows, {} requests run "
+      "separately after a failed batch, average queue time {:.1f}us (max {}us), average batch run time {:.1f}us",
+      stats.num_requests, stats.num_unbatched_requests, stats.num_requests - stats.num_unbatched_requests,
+      stats.num_batches, stats.AverageBatchRows(), stats.num_fallback_requests, stats.AverageQueueTimeUs(),
+      stats.max_queue_time.count(), stats.AverageRunTimeUs());
+}
+
+}  // namespace server
+}  // namespace onnxruntime
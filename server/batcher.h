@@ -0,0 +1,140 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "onnxruntime_cxx_api.h"
+
+namespace onnxruntime {
+namespace server {
+
+struct BatchingOptions {
+  // Maximum number of rows (sum of dim 0 of the requests) run together. 1 disables batching.
+  int max_batch_size = 1;
+  // Maximum time the oldest queued request waits for more requests to arrive before its batch is run.
+  std::chrono::microseconds max_queue_delay{1000};
+  // Number of threads running batches. One of them collects the next batch while the others run theirs.
+  int num_workers = 2;
+  // Interval at which the batching statistics are logged. 0 disables logging.
+  std::chrono::seconds stats_log_interval{60};
+};
+
+struct BatcherStats {
+  uint64_t num_requests = 0;
+  // number of requests run on their own because they can't be batched, no other request joined them within the
+  // queue delay or their run options were terminated while they were queued
+  uint64_t num_unbatched_requests = 0;
+  // number of runs of several requests combined, including the ones that failed
+  uint64_t num_batches = 0;
+  // number of requests that were run on their own after the batch they were part of failed
+  uint64_t num_fallback_requests = 0;
+  uint64_t total_batch_rows = 0;
+  // number of requests queued for batching and the time from enqueueing them until their batch starts to run
+  uint64_t num_queued_requests = 0;
+  std::chrono::microseconds total_queue_time{0};
+  std::chrono::microseconds max_queue_time{0};
+  // time spent in the combined runs, including concatenating inputs and splitting outputs
+  std::chrono::microseconds total_run_time{0};
+
+  double AverageBatchRows() const { return num_batches == 0 ? 0. : static_cast<double>(total_batch_rows) / num_batches; }
+  double AverageQueueTimeUs() const {
+    return num_queued_requests == 0 ? 0. : static_cast<double>(total_queue_time.count()) / num_queued_requests;
+  }
+  double AverageRunTimeUs() const {
+    return num_batches == 0 ? 0. : static_cast<double>(total_run_time.count()) / num_batches;
+  }
+
+  // Returns the statistics in the Prometheus text exposition format.
+  std::string ToPrometheusText() const;
+};
+
+// Combines concurrent prediction requests for one model into a single Run.
+//
+// Requests are compatible if they have the same inputs with the same element types and the same dimensions except
+// for dim 0, which has to be the same for all inputs of a request, and request the same outputs. The inputs of
+// compatible requests are concatenated along dim 0 and every output of the batched Run is split along dim 0 back
+// into the requests. This assumes that dim 0 is the batch dimension of all inputs and outputs of the model.
+// If the batched Run fails, or its outputs can't be split, each request is run on its own so it gets its own result
+// or error.
+//
+// Requests that can't be batched, such as requests with string tensors or scalars, requests with at least
+// max_batch_size rows and requests that no other request joined, are run on the calling thread with their own run
+// options. Batches are run on num_workers threads with the run tags of their requests, the most verbose of their
+// log levels, and terminated if the run options of one of their requests are.
+class Batcher {
+ public:
+  Batcher(const Ort::Session& session, const BatchingOptions& options, std::shared_ptr<spdlog::logger> logger);
+  ~Batcher();
+  Batcher(const Batcher&) = delete;
+  Batcher& operator=(const Batcher&) = delete;
+
+  // Queues the request and blocks until its batch was run. Throws Ort::Exception on failure.
+  // run_options are used if the request is run on its own and merged into the run options of its batch otherwise.
+  std::vector<Ort::Value> Run(const Ort::RunOptions& run_options,
+                              const std::vector<std::string>& input_names,
+                              const std::vector<Ort::Value>& input_values,
+                              const std::vector<std::string>& output_names);
+
+  BatcherStats GetStats() const;
+
+ private:
+  struct Request {
+    const Ort::RunOptions* run_options;
+    const std::vector<std::string>* input_names;
+    const std::vector<Ort::Value>* input_values;
+    const std::vector<std::string>* output_names;
+    // input indexes ordered by input name
+    std::vector<size_t> input_order;
+    // identifies compatible requests. empty if the request can't be batched.
+    std::string signature;
+    int64_t batch_rows;
+    std::chrono::steady_clock::time_point enqueue_time;
+    // the run options of the combined Run while the request is part of it. GUARDED_BY(mutex_)
+    Ort::RunOptions* batch_run_options = nullptr;
+    // set if run_options were terminated after the request was taken from the queue. GUARDED_BY(mutex_)
+    bool terminated = false;
+    // set before result if the calling thread has to run the request on its own
+    bool run_separately = false;
+    std::promise<std::vector<Ort::Value>> result;
+  };
+
+  std::vector<Ort::Value> RunSeparately(const Request& request);
+  void Terminate(Request& request);
+  void ProcessBatches();
+  void RunBatch(std::vector<Request*>& batch);
+  std::vector<std::vector<Ort::Value>> RunCombined(const std::vector<Request*>& batch, int64_t total_rows,
+                                                   const Ort::RunOptions& run_options);
+  void LogStats();
+
+  const Ort::Session& session_;
+  const BatchingOptions options_;
+  std::shared_ptr<spdlog::logger> logger_;
+  Ort::AllocatorWithDefaultOptions allocator_;
+
+  std::mutex mutex_;
+  std::condition_variable queue_cv_;
+  std::deque<Request*> queue_;  // GUARDED_BY(mutex_)
+  bool collecting_ = false;     // GUARDED_BY(mutex_). whether a worker is collecting a batch
+  bool shutdown_ = false;       // GUARDED_BY(mutex_)
+
+  mutable std::mutex stats_mutex_;
+  BatcherStats stats_;                                          // GUARDED_BY(stats_mutex_)
+  std::chrono::steady_clock::time_point last_stats_log_time_;  // GUARDED_BY(stats_mutex_)
+
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -4,6 +4,7 @@
 #include <memory>
 #include "environment.h"
 #include "onnxruntime_cxx_api.h"
+#include "onnxruntime_session_options_config_keys.h"
 
 #ifdef USE_DNNL
 
@@ -103,6 +104,10 @@ void ServerEnvironment::InitializeModel(const std::string& model_path, const std
     (iterator->second).output_names.push_back(name);
     allocator.Free(name);
   }
+
+  if (batching_options_.max_batch_size > 1) {
+    (iterator->second).batcher = std::make_unique<Batcher>((iterator->second).session, batching_options_, default_logger_);
+  }
 }
 
 const std::vector<std::string>& ServerEnvironment::GetModelOutputNames(const std::string& model_name, const std::string& model_version) const {
@@ -115,6 +120,29 @@ const std::vector<std::string>& ServerEnvironment::GetModelOutputNames(const std
   return it->second.output_names;
 }
 
+Batcher* ServerEnvironment::GetBatcher(const std::string& model_name, const std::string& model_version) const {
+  auto identifier = std::make_pair(model_name, model_version);
+  auto it = sessions_.find(identifier);
+  if (it == sessions_.end()) {
+    throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+  }
+
+  return it->second.batcher.get();
+}
+
+void ServerEnvironment::SetBatchingOptions(const BatchingOptions& options) {
+  batching_options_ = options;
+}
+
+void ServerEnvironment::EnableNodeMetrics() {
+  options_.AddConfigEntry(kOrtSessionOptionsConfigEnableNodeMetrics, "1");
+  node_metrics_enabled_ = true;
+}
+
+bool ServerEnvironment::NodeMetricsEnabled() const {
+  return node_metrics_enabled_;
+}
+
 OrtLoggingLevel ServerEnvironment::GetLogSeverity() const {
   return severity_;
 }
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "onnxruntime_cxx_api.h"
+#include "batcher.h"
 #include <spdlog/spdlog.h>
 #include <unordered_map>
 #include <boost/functional/hash.hpp>
@@ -25,6 +26,13 @@ class ServerEnvironment {
   const Ort::Session& GetSession(const std::string& model_name, const std::string& model_version) const;
   void InitializeModel(const std::string& model_path, const std::string& model_name, const std::string& model_version);
   const std::vector<std::string>& GetModelOutputNames(const std::string& model_name, const std::string& model_version) const;
+  // Returns the batcher of the model, or nullptr if batching is disabled.
+  Batcher* GetBatcher(const std::string& model_name, const std::string& model_version) const;
+  // Applies to models initialized afterwards.
+  void SetBatchingOptions(const BatchingOptions& options);
+  // Applies to models initialized afterwards.
+  void EnableNodeMetrics();
+  bool NodeMetricsEnabled() const;
   std::shared_ptr<spdlog::logger> GetLogger(const std::string& request_id) const;
   std::shared_ptr<spdlog::logger> GetAppLogger() const;
   void UnloadModel(const std::string& model_name, const std::string& model_version);
@@ -38,10 +46,14 @@ class ServerEnvironment {
 
   Ort::Env runtime_environment_;
   Ort::SessionOptions options_;
+  BatchingOptions batching_options_;
+  bool node_metrics_enabled_ = false;
 
   struct SessionHolder {
     Ort::Session session;
     std::vector<std::string> output_names;
+    // declared after session so that it is destroyed first
+    std::unique_ptr<Batcher> batcher;
     explicit SessionHolder(Ort::Env& env, std::string path, const Ort::SessionOptions& options) : session(nullptr) {
       session = Ort::Session(env, path.c_str(), options);
     };
@@ -130,7 +130,12 @@ protobufutil::Status Executor::Predict(const std::string& model_name,
 
   std::vector<Ort::Value> outputs;
   try {
-    outputs = Run(env_->GetSession(model_name, model_version), run_options, input_names, input_values, output_names);
+    auto* batcher = env_->GetBatcher(model_name, model_version);
+    if (batcher != nullptr) {
+      outputs = batcher->Run(run_options, input_names, input_values, output_names);
+    } else {
+      outputs = Run(env_->GetSession(model_name, model_version), run_options, input_names, input_values, output_names);
+    }
   } catch (const Ort::Exception& e) {
     return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
   }
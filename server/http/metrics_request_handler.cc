@@ -0,0 +1,71 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "environment.h"
+#include "http_server.h"
+#include "json_handling.h"
+#include "metrics_request_handler.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace http = boost::beast::http;
+
+static void RespondWithError(const std::shared_ptr<spdlog::logger>& logger, http::status error_code,
+                             const std::string& message, /* in, out */ HttpContext& context) {
+  auto json_error_message = CreateJsonError(error_code, message);
+  logger->debug(json_error_message);
+  context.response.result(error_code);
+  context.response.body() = json_error_message;
+  context.response.set(http::field::content_type, "application/json");
+}
+
+void Metrics(const std::string& name,
+             const std::string& version,
+             /* in, out */ HttpContext& context,
+             const std::shared_ptr<ServerEnvironment>& env) {
+  auto logger = env->GetLogger(context.request_id);
+  logger->debug("Model Name: {}, Version: {}, Action: metrics", name, version);
+
+  auto effective_name = name.empty() ? "default" : name;
+  auto effective_version = version.empty() ? "1" : version;
+
+  context.response.insert(util::MS_REQUEST_ID_HEADER, context.request_id);
+  if (!context.client_request_id.empty()) {
+    context.response.insert(util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
+  }
+
+  std::string metrics;
+  try {
+    const auto& session = env->GetSession(effective_name, effective_version);
+    auto* batcher = env->GetBatcher(effective_name, effective_version);
+    if (!env->NodeMetricsEnabled() && batcher == nullptr) {
+      RespondWithError(logger, http::status::not_found,
+                       "Metrics are disabled. Start the server with --enable_node_metrics 1 to collect them.", context);
+      return;
+    }
+
+    if (env->NodeMetricsEnabled()) {
+      Ort::AllocatorWithDefaultOptions allocator;
+      char* text = session.GetNodeMetrics(allocator);
+      metrics = text;
+      allocator.Free(text);
+    }
+
+    if (batcher != nullptr) {
+      metrics += batcher->GetStats().ToPrometheusText();
+    }
+  } catch (const Ort::Exception& e) {
+    RespondWithError(logger,
+                     e.GetOrtErrorCode() == ORT_NO_MODEL ? http::status::not_found : http::status::internal_server_error,
+                     e.what(), context);
+    return;
+  }
+
+  context.response.set(http::field::content_type, "text/plain; version=0.0.4");
+  context.response.body() = metrics;
+  context.response.result(http::status::ok);
+}
+
+}  // namespace server
+}  // namespace onnxruntime
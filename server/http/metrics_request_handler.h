@@ -0,0 +1,20 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "http_server.h"
+#include "environment.h"
+
+namespace onnxruntime {
+namespace server {
+
+// Responds with the node metrics of the model, if enabled, and the statistics of its batcher, if batching is enabled,
+// in the Prometheus text exposition format.
+void Metrics(const std::string& name,
+             const std::string& version,
+             /* in, out */ HttpContext& context,
+             const std::shared_ptr<ServerEnvironment>& env);
+
+}  // namespace server
+}  // namespace onnxruntime
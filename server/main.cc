@@ -3,6 +3,7 @@
 
 #include "environment.h"
 #include "http_server.h"
+#include "metrics_request_handler.h"
 #include "predict_request_handler.h"
 #include "server_configuration.h"
 #include "grpc/grpc_app.h"
@@ -64,6 +65,19 @@ int main(int argc, char* argv[]) {
   logger->info("Model name: {}", config.model_name);
   logger->info("Model version: {}", config.model_version);
 
+  if (config.max_batch_size > 1) {
+    logger->info("Batching requests: max batch size: {}, max delay: {}us, threads: {}", config.max_batch_size, config.max_batch_delay_us, config.num_batch_threads);
+    server::BatchingOptions batching_options{};
+    batching_options.max_batch_size = config.max_batch_size;
+    batching_options.max_queue_delay = std::chrono::microseconds(config.max_batch_delay_us);
+    batching_options.num_workers = config.num_batch_threads;
+    env->SetBatchingOptions(batching_options);
+  }
+
+  if (config.enable_node_metrics) {
+    env->EnableNodeMetrics();
+  }
+
   try {
     env->InitializeModel(config.model_path, config.model_name, config.model_version);
     logger->debug("Initialize Model Successfully!");
@@ -118,6 +132,12 @@ int main(int argc, char* argv[]) {
       }
   );
 
+  app.RegisterGet(
+      R"(/(?:v1/models/([^/:]+)(?:/versions/(\d+))?/metrics|metrics()()))",
+      [&env](const auto& name, const auto& version, const auto& /*action*/, auto& context) -> void {
+        server::Metrics(name, version, context, env);
+      });
+
   app.Bind(boost_address, config.http_port)
       .NumThreads(config.num_http_threads)
       .Run();
@@ -0,0 +1,173 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "batcher.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+// Runs a request with rows * 2 floats as input "X" and returns output "Y"
+static std::vector<float> RunRequest(Batcher& batcher, std::vector<float> values,
+                                     const Ort::RunOptions& run_options = Ort::RunOptions()) {
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+  std::vector<int64_t> shape{static_cast<int64_t>(values.size() / 2), 2};
+
+  std::vector<std::string> input_names{"X"};
+  std::vector<Ort::Value> input_values;
+  input_values.push_back(Ort::Value::CreateTensor<float>(memory_info, values.data(), values.size(),
+                                                         shape.data(), shape.size()));
+  std::vector<std::string> output_names{"Y"};
+
+  auto outputs = batcher.Run(run_options, input_names, input_values, output_names);
+  EXPECT_EQ(outputs.size(), 1u);
+  EXPECT_EQ(outputs[0].GetTensorTypeAndShapeInfo().GetShape(), shape);
+
+  const auto* data = outputs[0].GetTensorData<float>();
+  return std::vector<float>(data, data + values.size());
+}
+
+TEST(BatcherTest, CombinesConcurrentRequests) {
+  ServerEnvironment* env = ServerEnv();
+  env->InitializeModel("testdata/relu_dynamic_batch.onnx", "Relu", "1");
+
+  BatchingOptions options{};
+  options.max_batch_size = 8;
+  // long enough for all requests to be queued before the first batch runs
+  options.max_queue_delay = std::chrono::milliseconds(200);
+  {
+    Batcher batcher(env->GetSession("Relu", "1"), options, env->GetAppLogger());
+
+    constexpr int num_requests = 4;
+    std::vector<std::vector<float>> results(num_requests);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_requests; ++i) {
+      threads.emplace_back([&batcher, &results, i]() {
+        // requests with 1 or 2 rows and some negative values that Relu clamps
+        std::vector<float> values;
+        for (int j = 0; j < 2 * (1 + i % 2); ++j) {
+          values.push_back(static_cast<float>(j % 2 == 0 ? i * 10 + j : -(i * 10 + j)));
+        }
+        results[i] = RunRequest(batcher, values);
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (int i = 0; i < num_requests; ++i) {
+      ASSERT_EQ(results[i].size(), static_cast<size_t>(2 * (1 + i % 2)));
+      for (size_t j = 0; j < results[i].size(); ++j) {
+        EXPECT_EQ(results[i][j], j % 2 == 0 ? static_cast<float>(i * 10 + j) : 0.f);
+      }
+    }
+
+    auto stats = batcher.GetStats();
+    EXPECT_EQ(stats.num_requests, static_cast<uint64_t>(num_requests));
+    EXPECT_EQ(stats.num_unbatched_requests, 0u);
+    EXPECT_EQ(stats.total_batch_rows, 6u);
+    EXPECT_LT(stats.num_batches, static_cast<uint64_t>(num_requests));
+    EXPECT_EQ(stats.num_fallback_requests, 0u);
+
+    auto text = stats.ToPrometheusText();
+    EXPECT_NE(text.find("onnxruntime_server_batcher_requests_total 4\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("onnxruntime_server_batcher_batch_rows_total 6\n"), std::string::npos) << text;
+  }
+
+  env->UnloadModel("Relu", "1");
+}
+
+TEST(BatcherTest, RunsRequestsAsLargeAsABatchRightAway) {
+  ServerEnvironment* env = ServerEnv();
+  env->InitializeModel("testdata/relu_dynamic_batch.onnx", "Relu", "1");
+
+  BatchingOptions options{};
+  options.max_batch_size = 2;
+  // a request waiting for a batch would time out the test
+  options.max_queue_delay = std::chrono::seconds(600);
+  {
+    Batcher batcher(env->GetSession("Relu", "1"), options, env->GetAppLogger());
+
+    EXPECT_EQ(RunRequest(batcher, {1, -2, -3, 4}), (std::vector<float>{1, 0, 0, 4}));
+
+    auto stats = batcher.GetStats();
+    EXPECT_EQ(stats.num_requests, 1u);
+    EXPECT_EQ(stats.num_unbatched_requests, 1u);
+    EXPECT_EQ(stats.num_queued_requests, 0u);
+    EXPECT_EQ(stats.num_batches, 0u);
+  }
+
+  env->UnloadModel("Relu", "1");
+}
+
+TEST(BatcherTest, TerminatesOnlyTheRequestWhoseRunOptionsAreTerminated) {
+  ServerEnvironment* env = ServerEnv();
+  env->InitializeModel("testdata/relu_dynamic_batch.onnx", "Relu", "1");
+
+  BatchingOptions options{};
+  options.max_batch_size = 8;
+  // long enough to terminate a request while it waits for its batch
+  options.max_queue_delay = std::chrono::milliseconds(500);
+  {
+    Batcher batcher(env->GetSession("Relu", "1"), options, env->GetAppLogger());
+
+    Ort::RunOptions terminated_options;
+    bool terminated_failed = false;
+    std::vector<float> result;
+    std::thread terminated_thread([&]() {
+      try {
+        RunRequest(batcher, {1, -1}, terminated_options);
+      } catch (const Ort::Exception&) {
+        terminated_failed = true;
+      }
+    });
+    std::thread thread([&]() { result = RunRequest(batcher, {-2, 2}); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    terminated_options.SetTerminate();
+    terminated_thread.join();
+    thread.join();
+
+    EXPECT_TRUE(terminated_failed);
+    EXPECT_EQ(result, (std::vector<float>{0, 2}));
+    EXPECT_EQ(batcher.GetStats().num_requests, 2u);
+  }
+
+  env->UnloadModel("Relu", "1");
+}
+
+TEST(BatcherTest, RunsRequestsSeparatelyIfBatchFails) {
+  // the model has a fixed batch size of 3, so running a batch of 6 rows fails
+  ServerEnvironment* env = ServerEnv();
+  env->InitializeModel("testdata/mul_1.onnx", "Mul", "1");
+
+  BatchingOptions options{};
+  options.max_batch_size = 6;
+  options.max_queue_delay = std::chrono::milliseconds(200);
+  {
+    Batcher batcher(env->GetSession("Mul", "1"), options, env->GetAppLogger());
+
+    std::vector<float> result_1;
+    std::vector<float> result_2;
+    std::thread thread_1([&]() { result_1 = RunRequest(batcher, {1, 2, 3, 4, 5, 6}); });
+    std::thread thread_2([&]() { result_2 = RunRequest(batcher, {2, 2, 2, 2, 2, 2}); });
+    thread_1.join();
+    thread_2.join();
+
+    EXPECT_EQ(result_1, (std::vector<float>{1, 4, 9, 16, 25, 36}));
+    EXPECT_EQ(result_2, (std::vector<float>{2, 4, 6, 8, 10, 12}));
+    EXPECT_EQ(batcher.GetStats().num_requests, 2u);
+  }
+
+  env->UnloadModel("Mul", "1");
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -87,6 +87,18 @@ TEST(HttpRouteTests, PostRouteSpecialMethodTest){
   run_route(R"(/score()()())", http::verb::post, actions, true);
 }
 
+TEST(HttpRouteTests, GetMetricsRouteTest) {
+  std::vector<test_data> actions{
+      std::make_tuple(http::verb::get, "/metrics", "", "", "", http::status::ok),
+      std::make_tuple(http::verb::get, "/v1/models/abc/metrics", "abc", "", "", http::status::ok),
+      std::make_tuple(http::verb::get, "/v1/models/abc/versions/23/metrics", "abc", "23", "", http::status::ok),
+      std::make_tuple(http::verb::get, "/v1/models/metrics", "", "", "", http::status::not_found),
+      std::make_tuple(http::verb::get, "/v1/models/abc/versions/metrics", "", "", "", http::status::not_found),
+      std::make_tuple(http::verb::post, "/metrics", "", "", "", http::status::method_not_allowed)};
+
+  run_route(R"(/(?:v1/models/([^/:]+)(?:/versions/(\d+))?/metrics|metrics()()))", http::verb::get, actions, true);
+}
+
 void run_route(const std::string& pattern, http::verb method, const std::vector<test_data>& data, bool does_validate_data) {
   Routes routes;
   EXPECT_TRUE(routes.RegisterController(method, pattern, do_something));
@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+
+#include "http/metrics_request_handler.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+TEST(MetricsRequestHandlerTest, RespondsNotFoundWhenMetricsAreDisabled) {
+  ServerEnvironment* env = ServerEnv();
+  env->InitializeModel("testdata/mul_1.onnx", "Mul", "1");
+  ASSERT_FALSE(env->NodeMetricsEnabled());
+  ASSERT_EQ(env->GetBatcher("Mul", "1"), nullptr);
+
+  // the test environment is owned by TestServerEnvironment
+  std::shared_ptr<ServerEnvironment> shared_env(env, [](ServerEnvironment*) {});
+  HttpContext context;
+  Metrics("Mul", "1", context, shared_env);
+
+  EXPECT_EQ(context.response.result(), http::status::not_found);
+  EXPECT_EQ(context.response[http::field::content_type], "application/json");
+  EXPECT_NE(context.response.body().find("Metrics are disabled"), std::string::npos) << context.response.body();
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime